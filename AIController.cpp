@@ -7,6 +7,7 @@
 /*******************************************************************************
  *                 DECLARATIONS, INCLUDES, AND NAMESPACES
 *******************************************************************************/
+#include <cmath>
 #include "AIController.h"
 
 /*******************************************************************************
@@ -20,9 +21,14 @@
  * 
  * @param[in]	paddle - Pointer to paddle that this controller controls.
  * @param[in]	ball - Pointer to the ball object to track.
+ * @param[in]	random - The game's random number generator.
+ * @param[in]	difficulty - How offsets are picked; must outlast the
+ *				controller.
 *******************************************************************************/
-AIController::AIController(Paddle* paddle, Ball* ball) :
-paddle(paddle), ball(ball), offset(0)
+AIController::AIController(Paddle* paddle, Ball* ball, PongRandom* random,
+	const Difficulty* difficulty) :
+paddle(paddle), ball(ball), random(random), difficulty(difficulty), offset(0),
+steps(0), chase(0), chase_y(0), chase_step(0), chase_speed(0), chase_to(0)
 {
 	ballHit();
 }
@@ -67,22 +73,196 @@ void AIController::keySpecialUp(int key)
 *******************************************************************************/
 void AIController::ballHit()
 {
-	offset = (rand() % 3 * Pong::unit - (3 * Pong::unit / 2)) * 0.8;
+	if (random == NULL) return;
+	offset = difficulty->randomOffset(*random);
 }
 
 /***************************************************************************//**
  * @author Daniel Andrus
  * 
  * @par Description: Moves the paddle vertically if it is not aligned with the
- *		ball.
+ *		ball. If the paddle can get there this step it goes straight there,
+ *		otherwise it moves toward it at full speed. A run at full speed is
+ *		worked out from where and when it started rather than added up step
+ *		by step, so that where the paddle will be can be found for any step
+ *		of the run without going through the ones before it.
 *******************************************************************************/
 void AIController::step()
 {
+	steps++;
+
 	if (ball != NULL)		// This is entirely a possibility
 	{
-		if (paddle->getY() + offset != ball->center_y)
+		double target = ball->center_y - offset;
+		double y = paddle->getY();
+		double speed = paddle->getVerticalSpeed();
+		int direction = 0;
+
+		if (target - y > speed)
+		{
+			direction = 1;
+		}
+		else if (y - target > speed)
+		{
+			direction = -1;
+		}
+
+		if (direction == 0)
+		{
+			paddle->verticalPosition(target);
+		}
+		else
+		{
+			// Start a new run unless carrying on with the last one unchanged
+			if (direction != chase || y != chase_to || speed != chase_speed)
+			{
+				chase_y = y;
+				chase_step = steps - 1;
+				chase_speed = speed;
+			}
+			chase_to = chase_y
+				+ direction * speed * (double) (steps - chase_step);
+			paddle->verticalPosition(chase_to);
+		}
+		chase = direction;
+	}
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: Counts how many of the coming steps the paddle surely
+ *		keeps doing what it did last step: following the ball exactly,
+ *		running toward it at full speed, or running into the edge of its area.
+ *		Assumes the ball carries on along its path without bouncing for at
+ *		least that many steps. Errs on the short side near any change, so
+ *		that rounding can never make step() do something else.
+ *
+ * @param[in]	limit - Most steps to count.
+ *
+ * @returns Number of steps, up to limit, that skip() may be given.
+*******************************************************************************/
+long AIController::quietSteps(long limit)
+{
+	if (ball == NULL) return limit;
+
+	const double margin = 1e-6;
+	double y = paddle->getY();
+	double speed = paddle->getVerticalSpeed();
+	double highest = paddle->getHighestY();
+	double lowest = paddle->getLowestY();
+	double target = ball->center_y - offset;
+	double dy = ball->y_velocity * ball->s_velocity;
+	double steps = limit;
+
+	if (chase == 0)
+	{
+		// Following the ball, as long as it doesn't outrun the paddle or
+		// take it to the edge
+		if (y != target || fabs(dy) > speed - margin) return 0;
+		if (dy > 0) steps = min(steps, floor((highest - margin - target) / dy));
+		if (dy < 0) steps = min(steps, floor((lowest + margin - target) / dy));
+	}
+	else if (speed != chase_speed)
+	{
+		return 0;
+	}
+	else if (y != chase_to)
+	{
+		// Stuck at the edge, as long as the ball stays out of reach past it
+		if (y != (chase > 0 ? highest : lowest)) return 0;
+		double gap = chase * (target - y) - speed - margin;
+		double closing = -chase * dy;
+		if (gap <= closing) return 0;
+		if (closing > 0) steps = min(steps, floor(gap / closing));
+	}
+	else
+	{
+		// Running at full speed, as long as it doesn't catch up with the
+		// ball or reach the edge
+		double gap = chase * (target - y) - margin;
+		double closing = speed - chase * dy;
+		if (gap <= closing) return 0;
+		if (closing > 0) steps = min(steps, floor(gap / closing));
+		if (chase > 0)
+		{
+			steps = min(steps, floor((highest - margin - y) / speed));
+		}
+		else
+		{
+			steps = min(steps, floor((y - lowest - margin) / speed));
+		}
+	}
+
+	return steps < 0 ? 0 : (long) steps;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: Moves the paddle to where it would be after the given
+ *		number of steps, without taking them one at a time. Only valid for as
+ *		many steps as quietSteps() allows, and only once the ball has been
+ *		moved along to the same step.
+ *
+ * @param[in]	steps - Number of steps to skip.
+*******************************************************************************/
+void AIController::skip(long steps)
+{
+	if (steps <= 0 || ball == NULL) return;
+	this -> steps += steps;
+
+	if (chase == 0)
+	{
+		paddle->verticalPosition(ball->center_y - offset);
+	}
+	else
+	{
+		if (paddle->getY() != chase_to)
 		{
-			paddle->verticalMotion(ball->center_y - (paddle->getY() + offset));
+			// Stuck at the edge; every step starts a run from there
+			chase_y = paddle->getY();
+			chase_step = this -> steps - 1;
 		}
+		chase_to = chase_y
+			+ chase * chase_speed * (double) (this -> steps - chase_step);
+		paddle->verticalPosition(chase_to);
 	}
 }
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: Copies everything the AI remembers from step to step
+ *		into a ControllerState.
+ *
+ * @param[out]	state - Where to copy it.
+*******************************************************************************/
+void AIController::getState(ControllerState& state)
+{
+	state.offset = offset;
+	state.chase_y = chase_y;
+	state.chase_speed = chase_speed;
+	state.chase_to = chase_to;
+	state.steps = steps;
+	state.chase_step = chase_step;
+	state.chase = chase;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: Puts back what getState() copied.
+ *
+ * @param[in]	state - What to put back.
+*******************************************************************************/
+void AIController::setState(const ControllerState& state)
+{
+	offset = state.offset;
+	chase_y = state.chase_y;
+	chase_speed = state.chase_speed;
+	chase_to = state.chase_to;
+	steps = (long) state.steps;
+	chase_step = (long) state.chase_step;
+	chase = state.chase;
+}
@@ -14,6 +14,8 @@ class AIController;
 #include "PaddleController.h"
 #include "Paddle.h"
 #include "Ball.h"
+#include "PongRandom.h"
+#include "Difficulty.h"
 
 /***************************************************************************//**
  * @brief The AIController class moves a pong paddle to intersect a ball with
@@ -27,13 +29,25 @@ class AIController : public PaddleController
 	private:
 		Paddle* paddle;		/*!< Pointer to paddle under AI control */
 		Ball* ball;			/*!< Pointer to ball to watch */
+		PongRandom* random;	/*!< Where random offsets are drawn from */
+		const Difficulty* difficulty;	/*!< How offsets are picked */
 		double offset;		/*!< Random offset to align the ball with */
+		long steps;			/*!< Number of steps taken */
+		int chase;			/*!< Direction the paddle was last moved at full
+								speed, 1 up, -1 down, 0 if it wasn't */
+		double chase_y;		/*!< Where the paddle started moving at full
+								speed from */
+		long chase_step;	/*!< Step it started moving at full speed on */
+		double chase_speed;	/*!< Speed it started moving at */
+		double chase_to;	/*!< Where the paddle was last sent at full
+								speed, before being kept in bounds */
 
 	public:
 		/*!
 		 * @brief The constructor. Initializes variables.
 		 */
-		AIController(Paddle* paddle, Ball* ball);
+		AIController(Paddle* paddle, Ball* ball, PongRandom* random,
+			const Difficulty* difficulty);
 		
 		/*!
 		 * @brief Does nothing; fulfulls superclass requirements
@@ -64,6 +78,28 @@ class AIController : public PaddleController
 		 * @brief Moves the paddle a little closer to be aligned with the ball.
 		 */
 		void step();
+
+		/*!
+		 * @brief Counts the steps ahead in which the paddle surely keeps
+		 *		doing what it's doing.
+		 */
+		long quietSteps(long limit);
+
+		/*!
+		 * @brief Moves the paddle to where a number of steps would.
+		 */
+		void skip(long steps);
+
+		/*!
+		 * @brief Copies the offset and run at full speed into a
+		 *		ControllerState.
+		 */
+		void getState(ControllerState& state);
+
+		/*!
+		 * @brief Puts back what getState() copied.
+		 */
+		void setState(const ControllerState& state);
 };
 
 #endif
@@ -0,0 +1,88 @@
+/***************************************************************************//**
+ * @file File containing the AlignedAllocator class template.
+ *
+ * @brief Contains the AlignedAllocator class template, which lets a vector
+ *		hold things that must start on a cache line.
+*******************************************************************************/
+#ifndef _ALIGNEDALLOCATOR_H_
+#define _ALIGNEDALLOCATOR_H_
+
+/*******************************************************************************
+ *                 DECLARATIONS, INCLUDES, AND NAMESPACES
+*******************************************************************************/
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+using namespace std;
+
+/***************************************************************************//**
+ * @brief The AlignedAllocator class template gets memory for a vector lined
+ *		up the way its type asks with alignas().
+ *
+ * @details Before C++17, operator new, and so the allocator a vector uses by
+ *		default, need only line memory up for the plain types, 16 bytes at
+ *		most. A vector of a type aligned to a cache line may then start
+ *		partway into one, so neighbouring elements share a line after all.
+ *		This allocator gets its memory from posix_memalign() instead.
+*******************************************************************************/
+template <class T>
+class AlignedAllocator
+{
+	public:
+		typedef T value_type;	/*!< What is allocated */
+
+		/*!
+		 * @brief The constructor. Holds nothing.
+		 */
+		AlignedAllocator() { }
+
+		/*!
+		 * @brief Converts from an allocator of another type.
+		 */
+		template <class U>
+		AlignedAllocator(const AlignedAllocator<U>&) { }
+
+		/*!
+		 * @brief Gets room for count things, lined up as T asks.
+		 */
+		T* allocate(size_t count)
+		{
+			size_t alignment = alignof(T) < sizeof(void*) ? sizeof(void*)
+				: alignof(T);
+			void* memory = NULL;
+			if (posix_memalign(&memory, alignment, count * sizeof(T)) != 0)
+			{
+				throw bad_alloc();
+			}
+			return (T*) memory;
+		}
+
+		/*!
+		 * @brief Gives back room from allocate().
+		 */
+		void deallocate(T* memory, size_t)
+		{
+			free(memory);
+		}
+};
+
+/*!
+ * @brief Any AlignedAllocator can free what another got.
+ */
+template <class T, class U>
+bool operator==(const AlignedAllocator<T>&, const AlignedAllocator<U>&)
+{
+	return true;
+}
+
+/*!
+ * @brief Any AlignedAllocator can free what another got.
+ */
+template <class T, class U>
+bool operator!=(const AlignedAllocator<T>&, const AlignedAllocator<U>&)
+{
+	return false;
+}
+
+#endif
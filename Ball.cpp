@@ -27,116 +27,431 @@
  *****************************************************************************/
 Ball::Ball(PongGame* game, double x, double y, int width, 
 						double x_velocity, double y_velocity) : 
-		game(game), center_x(x), center_y(y), width(width),
-		x_velocity(x_velocity), y_velocity(y_velocity), s_velocity(1.0)
-{ }
+		center_x(x), center_y(y), prev_x(x), prev_y(y), width(width),
+		x_velocity(x_velocity), y_velocity(y_velocity), s_velocity(1.0),
+		clock(0), game(game)
+{
+	path.x = x;
+	path.y = y;
+	path.t = 0;
+}
 
 /**************************************************************************//** 
  * @author Johnathan Ackerman, Daniel Andrus
  * 
- * @par Description: moves the ball across the game grid & handle collisions
+ * @par Description: moves the ball across the game grid & handle collisions.
+ *		The ball is followed along its path through the whole step, so it
+ *		bounces off everything it passes no matter how fast it is going.
  *****************************************************************************/
 void Ball::step( )
 {	
-	//changes possition based on velocity
-	center_x += x_velocity * s_velocity;
-	center_y += y_velocity * s_velocity;
+	// Remember where we were for drawing between steps
+	prev_x = center_x;
+	prev_y = center_y;
+
+	clock++;
+	while (true)
+	{
+		// Paddles may change size on every hit, so look again each time
+		BallArena arena;
+		getArena(arena);
+
+		int result = sweep(path, x_velocity, y_velocity, s_velocity, width,
+			clock, arena);
+		if (result == BOUNCE_PADDLE)
+		{
+			// Let game know that a collision has happened
+			game->ballHit(x_velocity < 0);
+			continue;
+		}
+
+		center_x = pathPosition(path.x, x_velocity, s_velocity, path.t, clock);
+		center_y = pathPosition(path.y, y_velocity, s_velocity, path.t, clock);
+		if (result == BOUNCE_GOAL)
+		{
+			if (x_velocity > 0)
+			{
+				game -> scoreLeft();
+			}
+			else
+			{
+				game -> scoreRight();
+			}
+		}
+		return;
+	}
+}
+
+/**************************************************************************//** 
+ * @author Daniel Andrus
+ * 
+ * @par Description: Counts how many of the coming steps the ball spends
+ *		travelling along its path without reaching a wall or the face of a
+ *		paddle. The times it reaches each are worked out exactly as sweep()
+ *		works them out, so the count is exact. A ball that has already
+ *		passed the face of a paddle gets no steps, since the paddle may yet
+ *		move into it.
+ *
+ * @param[in]	limit - Most steps to count.
+ *
+ * @returns Number of steps, up to limit, that skip() may be given.
+ *****************************************************************************/
+long Ball::quietSteps(long limit)
+{
+	BallArena arena;
+	getArena(arena);
+
+	double top = arena.top - width / 2;
+	double bottom = arena.bottom + width / 2;
+	double dx = x_velocity * s_velocity;
+	double dy = y_velocity * s_velocity;
+	double next = INFINITY;
 
-	// Upper/lower wall reflections
-	if (center_y >= game->getBoard()->getY() + 
-				game->getBoard()->getHeight() - width / 2)
+	if (dy > 0)
 	{
-		y_velocity = -abs(y_velocity);
+		next = path.y < top ? path.t + (top - path.y) / dy : path.t;
 	}
-	if (center_y <= game->getBoard()->getY() + width / 2)
+	else if (dy < 0)
 	{
-		y_velocity = abs(y_velocity);
+		next = path.y > bottom ? path.t + (bottom - path.y) / dy : path.t;
 	}
 
-	// Check collision with paddles
-	if (x_velocity > 0) //Right paddle
+	if (dx != 0)
 	{
-		double left_bound = game->getRightPaddle()->getX()
-							- game->getRightPaddle()->getWidth()/2;
-		double right_bound = game->getRightPaddle()->getX()
-							- game->getRightPaddle()->getWidth()/2
-							+ x_velocity * s_velocity + 1;
-		double top_bound = game->getRightPaddle()->getY()
-							+ game->getRightPaddle()->getHeight() / 2;
-		double bot_bound = game->getRightPaddle()->getY()
-							- game->getRightPaddle()->getHeight() / 2;
-		if (center_x + width / 2 >= left_bound
-			&& center_x + width / 2 <= right_bound
-			&& center_y + width / 2 >= bot_bound
-			&& center_y - width / 2 <= top_bound)
+		double face = arena.left_x + arena.left_width / 2;
+		double lead = -width / 2;
+		if (dx > 0)
 		{
-			// Move to contact with paddle
-			center_x = left_bound - width / 2;
+			face = arena.right_x - arena.right_width / 2;
+			lead = width / 2;
+		}
+		if ((path.x + lead - face) * dx >= 0) return 0;
+		next = min(next, path.t + (face - (path.x + lead)) / dx);
+	}
 
-			// Start moving left
-			x_velocity = -abs(x_velocity);
+	// Whatever comes next is dealt with on the step it falls in
+	double steps = ceil(next) - 1 - clock;
+	if (steps < 0) return 0;
+	return steps < limit ? (long) steps : limit;
+}
 
-			// Adjust y velocity
-			y_velocity += (center_y - game->getRightPaddle()->getY())
-					/ (game->getRightPaddle()->getHeight() / 12.0);
+/**************************************************************************//** 
+ * @author Daniel Andrus
+ * 
+ * @par Description: Moves the ball along its path to where it would be after
+ *		the given number of steps, without taking them one at a time. Only
+ *		valid for as many steps as quietSteps() allows.
+ *
+ * @param[in]	steps - Number of steps to skip.
+ *****************************************************************************/
+void Ball::skip(long steps)
+{
+	if (steps <= 0) return;
+	clock += steps;
+	prev_x = pathPosition(path.x, x_velocity, s_velocity, path.t, clock - 1);
+	prev_y = pathPosition(path.y, y_velocity, s_velocity, path.t, clock - 1);
+	center_x = pathPosition(path.x, x_velocity, s_velocity, path.t, clock);
+	center_y = pathPosition(path.y, y_velocity, s_velocity, path.t, clock);
+}
 
-			// Govern y_velocity speed, lest we lose the ball!
-			if (y_velocity > 8.0) y_velocity = 8.0;
-			if (y_velocity < -8.0) y_velocity = -8.0;
+/**************************************************************************//** 
+ * @author Daniel Andrus
+ * 
+ * @par Description: Copies everything about the ball that changes during a
+ *		game into a BallState.
+ *
+ * @param[out]	state - Where to copy it.
+ *****************************************************************************/
+void Ball::getState(BallState& state)
+{
+	state.center_x = center_x;
+	state.center_y = center_y;
+	state.prev_x = prev_x;
+	state.prev_y = prev_y;
+	state.x_velocity = x_velocity;
+	state.y_velocity = y_velocity;
+	state.s_velocity = s_velocity;
+	state.path_x = path.x;
+	state.path_y = path.y;
+	state.path_t = path.t;
+	state.clock = clock;
+}
 
-			// Let game know that a collision has happened
-			game->ballHit(true);
-		}
+/**************************************************************************//** 
+ * @author Daniel Andrus
+ * 
+ * @par Description: Puts the ball back the way getState() found it.
+ *
+ * @param[in]	state - What to put back.
+ *****************************************************************************/
+void Ball::setState(const BallState& state)
+{
+	center_x = state.center_x;
+	center_y = state.center_y;
+	prev_x = state.prev_x;
+	prev_y = state.prev_y;
+	x_velocity = state.x_velocity;
+	y_velocity = state.y_velocity;
+	s_velocity = state.s_velocity;
+	path.x = state.path_x;
+	path.y = state.path_y;
+	path.t = state.path_t;
+	clock = (long) state.clock;
+}
 
-		// Passed the paddle and off the board!
-		else if (center_x - width / 2 > game->getBoard()->getX()
-							+ game->getBoard()->getWidth())
+/**************************************************************************//** 
+ * @author Daniel Andrus
+ * 
+ * @par Description: Moves the ball to a point and sets it travelling from
+ *		there with the given velocity, starting from the current step.
+ *
+ * @param[in]	x - x coordinate to put the ball at
+ * @param[in]	y - y coordinate to put the ball at
+ * @param[in]	x_velocity - new x speed of the ball
+ * @param[in]	y_velocity - new y speed of the ball
+ *****************************************************************************/
+void Ball::setMotion(double x, double y, double x_velocity, double y_velocity)
+{
+	center_x = x;
+	center_y = y;
+	this -> x_velocity = x_velocity;
+	this -> y_velocity = y_velocity;
+	path.x = x;
+	path.y = y;
+	path.t = clock;
+}
+
+/**************************************************************************//** 
+ * @author Daniel Andrus
+ * 
+ * @par Description: Works out where along one axis a ball travelling in a
+ *		straight line is at a given time. Every part of the game that needs
+ *		to know where a ball is goes through here, so that they all agree to
+ *		the last bit.
+ *
+ * @param[in]	origin - coordinate the ball started from
+ * @param[in]	velocity - speed of the ball along this axis
+ * @param[in]	s_velocity - speed modifier of the ball
+ * @param[in]	origin_t - step count the ball started at
+ * @param[in]	t - step count to find the ball at
+ *
+ * @returns The coordinate of the ball at step count t.
+ *****************************************************************************/
+double Ball::pathPosition(double origin, double velocity, double s_velocity,
+	double origin_t, double t)
+{
+	return origin + velocity * s_velocity * (t - origin_t);
+}
+
+/**************************************************************************//** 
+ * @author Johnathan Ackerman, Daniel Andrus
+ * 
+ * @par Description: Follows a ball along its path through the step that ends
+ *		at step count now, bouncing it off the top and bottom walls on the
+ *		way. The ball is treated as a box and its path as a line, and the
+ *		time it reaches each wall or paddle face is worked out directly from
+ *		the path, so nothing is skipped over however far the ball travels in
+ *		one step. Stops at the moment the ball touches the face of the paddle
+ *		it is heading toward and bounces it off. A ball that finds a paddle
+ *		moved on top of it at the start of the step also bounces off. Works
+ *		on plain values rather than on a Ball so that BatchGame can apply the
+ *		exact same rule to its matches.
+ *
+ *		Every bounce starts the path over from the point of the bounce.
+ *
+ * @param[in,out]	path - where the ball is travelling from
+ * @param[in,out]	x_velocity - x speed of the ball
+ * @param[in,out]	y_velocity - y speed of the ball
+ * @param[in]	s_velocity - speed modifier of the ball
+ * @param[in]	width - diameter of the ball
+ * @param[in]	now - step count at the end of the step
+ * @param[in]	arena - walls, paddles, and goals the ball can run into
+ *
+ * @returns BOUNCE_PADDLE if the ball hit a paddle, in which case the rest of
+ *		the step still needs following. BOUNCE_GOAL if the ball ends the step
+ *		past a paddle and off the board, BOUNCE_NONE otherwise.
+ *****************************************************************************/
+int Ball::sweep(BallPath& path, double& x_velocity, double& y_velocity,
+	double s_velocity, int width, double now, const BallArena& arena)
+{
+	double top = arena.top - width / 2;
+	double bottom = arena.bottom + width / 2;
+	double start = now - 1;
+	double dx = x_velocity * s_velocity;
+	double dy = y_velocity * s_velocity;
+
+	// Face of the paddle the ball is heading toward
+	double face = 0;
+	double depth = 0;
+	double paddle_y = 0;
+	int paddle_height = 0;
+	double lead = width / 2;
+	if (dx > 0)
+	{
+		face = arena.right_x - arena.right_width / 2;
+		depth = arena.right_width;
+		paddle_y = arena.right_y;
+		paddle_height = arena.right_height;
+	}
+	else if (dx < 0)
+	{
+		face = arena.left_x + arena.left_width / 2;
+		depth = -arena.left_width;
+		paddle_y = arena.left_y;
+		paddle_height = arena.left_height;
+		lead = -lead;
+	}
+
+	// Did the paddle move on top of the ball?
+	if (dx != 0 && path.t <= start)
+	{
+		double x = pathPosition(path.x, x_velocity, s_velocity, path.t, start);
+		double y = pathPosition(path.y, y_velocity, s_velocity, path.t, start);
+		if ((x + lead - face) * dx >= 0
+			&& (x + lead - (face + depth)) * dx <= 0
+			&& y + width / 2 >= paddle_y - paddle_height / 2
+			&& y - width / 2 <= paddle_y + paddle_height / 2)
 		{
-			game -> scoreLeft();
+			path.x = x;
+			path.y = y;
+			path.t = start;
+			return bounce(path, x_velocity, y_velocity, width, face,
+				paddle_y, paddle_height);
 		}
 	}
-	else // left paddle
+
+	// Stop counting wall bounces at some point in case of absurd speeds
+	for (int walls = 0; walls < 64; walls++)
 	{
-		double left_bound = game->getLeftPaddle()->getX()
-							+ game->getLeftPaddle()->getWidth()/2
-							+ x_velocity * s_velocity - 1;
-		double right_bound = game->getLeftPaddle()->getX()
-							+ game->getLeftPaddle()->getWidth() / 2;
-		double top_bound = game->getLeftPaddle()->getY()
-							+ game->getLeftPaddle()->getHeight() / 2;
-		double bot_bound = game->getLeftPaddle()->getY()
-							- game->getLeftPaddle()->getHeight() / 2;
-		if (center_x - width / 2 >= left_bound
-			&& center_x - width / 2 <= right_bound
-			&& center_y + width / 2 >= bot_bound
-			&& center_y - width / 2 <= top_bound)
+		double wall_t = INFINITY;
+		if (dy > 0)
 		{
-			// Move to contact with paddle
-			center_x = right_bound + width / 2;
-
-			// Start moving riht
-			x_velocity = abs(x_velocity);
+			wall_t = path.y < top ? path.t + (top - path.y) / dy : path.t;
+		}
+		else if (dy < 0)
+		{
+			wall_t = path.y > bottom ? path.t + (bottom - path.y) / dy
+				: path.t;
+		}
 
-			// Adjust y velocity
-			y_velocity += (center_y - game->getLeftPaddle()->getY())
-				/ (game->getLeftPaddle()->getHeight() / 12.0);
+		double face_t = INFINITY;
+		if ((path.x + lead - face) * dx < 0)
+		{
+			face_t = path.t + (face - (path.x + lead)) / dx;
+		}
 
-			// Govern y_velocity speed, lest we lose the ball!
-			if (y_velocity > 8.0) y_velocity = 8.0;
-			if (y_velocity < -8.0) y_velocity = -8.0;
+		if (face_t <= wall_t && face_t <= now)
+		{
+			path.y = pathPosition(path.y, y_velocity, s_velocity, path.t,
+				face_t);
+			path.x = face - lead;
+			path.t = face_t;
 
-			// Let game know that a collision has happened
-			game->ballHit(false);
+			// Is the paddle there?
+			if (path.y + width / 2 >= paddle_y - paddle_height / 2
+				&& path.y - width / 2 <= paddle_y + paddle_height / 2)
+			{
+				return bounce(path, x_velocity, y_velocity, width, face,
+					paddle_y, paddle_height);
+			}
+		}
+		else if (wall_t <= now)
+		{
+			// Upper/lower wall reflections
+			if (wall_t > path.t)
+			{
+				path.x = pathPosition(path.x, x_velocity, s_velocity, path.t,
+					wall_t);
+				path.y = dy > 0 ? top : bottom;
+				path.t = wall_t;
+			}
+			y_velocity = -y_velocity;
+			dy = -dy;
 		}
-		
-		// Passed the paddle and off the board!
-		else if (center_x + width / 2 < game->getBoard()->getX())
+		else
 		{
-			game -> scoreRight();
+			break;
 		}
 	}
-	
 
+	// Passed the paddle and off the board!
+	double x = pathPosition(path.x, x_velocity, s_velocity, path.t, now);
+	if (x - width / 2 > arena.right_goal || x + width / 2 < arena.left_goal)
+	{
+		return BOUNCE_GOAL;
+	}
+	return BOUNCE_NONE;
+}
+
+/**************************************************************************//** 
+ * @author Johnathan Ackerman, Daniel Andrus
+ * 
+ * @par Description: Bounces a ball that is touching the face of a paddle.
+ *		Sends it back the way it came, angled by how far from the middle of
+ *		the paddle it hit.
+ *
+ * @param[in,out]	path - where the ball is travelling from; moved to be
+ *				just touching the paddle face
+ * @param[in,out]	x_velocity - x speed of the ball
+ * @param[in,out]	y_velocity - y speed of the ball
+ * @param[in]	width - diameter of the ball
+ * @param[in]	face - x coordinate of the face of the paddle
+ * @param[in]	paddle_y - y coordinate of the center of the paddle
+ * @param[in]	paddle_height - height of the paddle
+ *
+ * @returns BOUNCE_PADDLE
+ *****************************************************************************/
+int Ball::bounce(BallPath& path, double& x_velocity, double& y_velocity,
+	int width, double face, double paddle_y, int paddle_height)
+{
+	// Move to contact with paddle and start moving the other way
+	if (x_velocity > 0)
+	{
+		path.x = face - width / 2;
+		x_velocity = -abs(x_velocity);
+	}
+	else
+	{
+		path.x = face + width / 2;
+		x_velocity = abs(x_velocity);
+	}
+
+	// Adjust y velocity
+	y_velocity += (path.y - paddle_y) / (paddle_height / 12.0);
+
+	// Keep the ball from going too steep to be playable
+	if (y_velocity > 8.0) y_velocity = 8.0;
+	if (y_velocity < -8.0) y_velocity = -8.0;
+
+	return BOUNCE_PADDLE;
+}
+
+/**************************************************************************//** 
+ * @author Daniel Andrus
+ * 
+ * @par Description: Fills in the walls, paddles, and goals of the game the
+ *		ball is in.
+ *
+ * @param[out]	arena - Where to put them.
+ *****************************************************************************/
+void Ball::getArena(BallArena& arena)
+{
+	Board* board = game->getBoard();
+	Paddle* left = game->getLeftPaddle();
+	Paddle* right = game->getRightPaddle();
+
+	arena.top = board->getY() + board->getHeight();
+	arena.bottom = board->getY();
+	arena.left_goal = board->getX();
+	arena.right_goal = board->getX() + board->getWidth();
+	arena.left_x = left->getX();
+	arena.left_y = left->getY();
+	arena.left_width = left->getWidth();
+	arena.left_height = left->getHeight();
+	arena.right_x = right->getX();
+	arena.right_y = right->getY();
+	arena.right_width = right->getWidth();
+	arena.right_height = right->getHeight();
 }
 
 /**************************************************************************//** 
@@ -153,6 +468,10 @@ void Ball::setSpeedModifier(double s_velocity)
 	// Make sure value is valid
 	if (s_velocity <= 0.0) return;
 
+	// Carry on from where the ball is now at the new speed
+	path.x = center_x;
+	path.y = center_y;
+	path.t = clock;
 	this -> s_velocity = s_velocity;
 }
 
@@ -168,41 +487,3 @@ double Ball::getSpeedModifier()
 {
 	return s_velocity;
 }
-
-/**************************************************************************//** 
- * @author Johnathan Ackerman, Daniel Andrus
- * 
- * @par Description: Draws the ball, including motion blur effect
- *****************************************************************************/
-void Ball::draw( )
-{
-	float radius = (float) (width / 2.0);
-	int slices = (int) radius * 2;
-	GLUquadricObj *disk;
-	
-	// Add blur effect. Don't know how to use transparency, so use dark pink
-	glColor3f( 0.25, 0.0, 0.25 );
-	glPushMatrix();
-	glTranslated( center_x - x_velocity * s_velocity * 2, center_y - y_velocity * s_velocity * 2, 0 );
-	disk = gluNewQuadric();
-	gluDisk( disk, 0, radius, slices, 1 );
-	gluDeleteQuadric( disk );
-	glPopMatrix();
-	
-	glColor3f( 0.5, 0.0, 0.5 );
-	glPushMatrix();
-	glTranslated( center_x - x_velocity * s_velocity, center_y - y_velocity * s_velocity, 0 );
-	disk = gluNewQuadric();
-	gluDisk( disk, 0, radius, slices, 1 );
-	gluDeleteQuadric( disk );
-	glPopMatrix();
-
-	//Draws the ball with freeGlut
-    glColor3f( 1.0, 0.0, 1.0 );
-    glPushMatrix();
-    glTranslated( center_x, center_y, 0 );
-    disk = gluNewQuadric();
-    gluDisk( disk, 0, radius, slices, 1 );
-    gluDeleteQuadric( disk );
-    glPopMatrix();
-}
@@ -14,10 +14,54 @@ class Ball;
 #include <cmath>
 #include "Drawable.h"
 #include "Steppable.h"
+#include "PongState.h"
 #include "PongGame.h"
 
 using namespace std;
 
+/*!
+ * @brief Results of Ball::sweep()
+ */
+enum BounceResult
+{
+	BOUNCE_NONE,	/*!< Ball is still in play and touched no paddle */
+	BOUNCE_PADDLE,	/*!< Ball bounced off a paddle */
+	BOUNCE_GOAL		/*!< Ball got past a paddle and off the board */
+};
+
+/*!
+ * @brief Everything a ball can run into, as plain values
+ */
+struct BallArena
+{
+	double top;			/*!< y coordinate of the top wall */
+	double bottom;		/*!< y coordinate of the bottom wall */
+	double left_goal;	/*!< x coordinate of the left edge of the board */
+	double right_goal;	/*!< x coordinate of the right edge of the board */
+	double left_x;		/*!< x coordinate of the center of the left paddle */
+	double left_y;		/*!< y coordinate of the center of the left paddle */
+	int left_width;		/*!< width of the left paddle */
+	int left_height;	/*!< height of the left paddle */
+	double right_x;		/*!< x coordinate of the center of the right paddle */
+	double right_y;		/*!< y coordinate of the center of the right paddle */
+	int right_width;	/*!< width of the right paddle */
+	int right_height;	/*!< height of the right paddle */
+};
+
+/*!
+ * @brief A ball's straight line of travel since it last bounced, was served,
+ *		or was put in place. Where the ball is at any step is worked out from
+ *		here rather than added up step by step, so that it can be found for
+ *		any step without going through the ones before it.
+ */
+struct BallPath
+{
+	double x;	/*!< x coordinate the ball started from */
+	double y;	/*!< y coordinate the ball started from */
+	double t;	/*!< step count the ball was there at; may be part way
+					through a step */
+};
+
 /***************************************************************************//**
  * @brief The Ball Class Holds all the information to draw a ball for Pong
  *
@@ -30,10 +74,14 @@ class Ball : public Drawable, public Steppable
 									in the coordinate plane */
 		double center_y;	/*!< y coordinate for the center of the ball on
 									in the coordinate plane */
+		double prev_x;		/*!< center_x as of the previous step */
+		double prev_y;		/*!< center_y as of the previous step */
 		int width;			/*!< radius of the ball */
 		double x_velocity;	/*!< x speed of the ball */
 		double y_velocity;	/*!< y speed of the ball */
 		double s_velocity;	/*!< Velocity scalar for varying speeds */
+		BallPath path;		/*!< Line the ball is travelling along */
+		long clock;			/*!< Number of steps taken */
 		PongGame* game;		/*!< instance of the pongGame class that is in
 									charge of the ball class */
 
@@ -49,6 +97,59 @@ class Ball : public Drawable, public Steppable
 		 */
 		void step();
 
+		/*!
+		 *  @brief Counts the steps ahead in which the ball touches nothing
+		 */
+		long quietSteps(long limit);
+
+		/*!
+		 *  @brief Moves the ball to where a number of steps would
+		 */
+		void skip(long steps);
+
+		/*!
+		 *  @brief Copies everything about the ball that changes into a
+		 *		BallState
+		 */
+		void getState(BallState& state);
+
+		/*!
+		 *  @brief Puts the ball back the way getState() found it
+		 */
+		void setState(const BallState& state);
+
+		/*!
+		 *  @brief Puts the ball somewhere and sets it moving
+		 */
+		void setMotion(double x, double y, double x_velocity,
+			double y_velocity);
+
+		/*!
+		 *  @brief Works out a coordinate of a ball along its path
+		 */
+		static double pathPosition(double origin, double velocity,
+			double s_velocity, double origin_t, double t);
+
+		/*!
+		 *  @brief Follows a ball's path through a step until it hits a paddle
+		 *		or the step ends
+		 */
+		static int sweep(BallPath& path, double& x_velocity,
+			double& y_velocity, double s_velocity, int width, double now,
+			const BallArena& arena);
+
+		/*!
+		 *  @brief Bounces a ball off the face of a paddle
+		 */
+		static int bounce(BallPath& path, double& x_velocity,
+			double& y_velocity, int width, double face, double paddle_y,
+			int paddle_height);
+
+		/*!
+		 *  @brief Gets the walls, paddles, and goals the ball can run into
+		 */
+		void getArena(BallArena& arena);
+
 		/*!
 		 * @brief Sets a modifier on the ball's speed. 1 means normal, less
 		 *		than 1 will slow the ball down, greater than 1 will speed it up.
@@ -0,0 +1,45 @@
+/***************************************************************************//**
+ * @file File containing the drawing implementation for the Ball class.
+ *
+ * @brief Contains the drawing implementation for the Ball class. Kept apart
+ *		from Ball.cpp so the game logic can be built without OpenGL.
+*******************************************************************************/
+
+/*******************************************************************************
+ *                 DECLARATIONS, INCLUDES, AND NAMESPACES
+*******************************************************************************/
+#include "Ball.h"
+#include "Pong.h"
+
+/*******************************************************************************
+ *                          FUNCTION DEFINITIONS
+*******************************************************************************/
+/**************************************************************************//** 
+ * @author Johnathan Ackerman, Daniel Andrus
+ * 
+ * @par Description: Draws the ball, including motion blur effect. The ball
+ *		is drawn between its last two positions according to how far the
+ *		frame is between game steps.
+ *****************************************************************************/
+void Ball::draw( )
+{
+	float radius = (float) (width / 2.0);
+	int slices = (int) radius * 2;
+	Renderer* out = Pong::getInstance()->getRenderer();
+	double a = Pong::getInstance()->getInterpolation();
+	double x = prev_x + (center_x - prev_x) * a;
+	double y = prev_y + (center_y - prev_y) * a;
+	
+	// Add blur effect. Don't know how to use transparency, so use dark pink
+	out->color( 0.25, 0.0, 0.25 );
+	out->disk( x - x_velocity * s_velocity * 2, y - y_velocity * s_velocity * 2,
+		radius, slices );
+	
+	out->color( 0.5, 0.0, 0.5 );
+	out->disk( x - x_velocity * s_velocity, y - y_velocity * s_velocity,
+		radius, slices );
+
+	//Draws the ball
+	out->color( 1.0, 0.0, 1.0 );
+	out->disk( x, y, radius, slices );
+}
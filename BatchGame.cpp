@@ -0,0 +1,943 @@
+/***************************************************************************//**
+ * @file File containing the implementation of the BatchGame class.
+ *
+ * @brief Contains the implementation for the BatchGame class.
+*******************************************************************************/
+
+/*******************************************************************************
+ *                 DECLARATIONS, INCLUDES, AND NAMESPACES
+*******************************************************************************/
+#include <cmath>
+#include "BatchGame.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define BATCH_X86
+#endif
+
+/*******************************************************************************
+ *                            VECTOR KERNELS
+*******************************************************************************/
+/* These work on plain arrays so that the compiler can be told to use AVX for
+ * one copy of them and SSE2 for the other. Each does exactly the arithmetic
+ * that Ball::step() and AIController::step() do for a single match when
+ * nothing gets in the way, in the same order, so results are the same down
+ * to the last bit. */
+
+/*!
+ * @brief The arrays the ball kernels work on
+ */
+struct BallLanes
+{
+	double* x;					/*!< x coordinate of each ball */
+	double* y;					/*!< y coordinate of each ball */
+	const double* path_x;		/*!< x coordinate each path starts at */
+	const double* path_y;		/*!< y coordinate each path starts at */
+	const double* path_t;		/*!< step count each path starts at */
+	const double* vx;			/*!< x speed of each ball */
+	const double* vy;			/*!< y speed of each ball */
+	const double* s;			/*!< speed modifier of each ball */
+	unsigned char* contact;		/*!< set for balls that need sweeping */
+};
+
+/*!
+ * @brief The arrays the paddle kernels work on, for one side
+ */
+struct PaddleLanes
+{
+	double* y;					/*!< y coordinate of each paddle */
+	const double* offset;		/*!< AI offset of each paddle */
+	const double* speed;		/*!< max speed of each paddle */
+	const double* half;			/*!< half height of each paddle */
+	double* chase;				/*!< direction of each run at full speed */
+	double* chase_y;			/*!< where each run started */
+	double* chase_t;			/*!< step count each run started at */
+	double* chase_speed;		/*!< speed each run started at */
+	double* chase_to;			/*!< where each run last sent its paddle */
+};
+
+#ifdef BATCH_X86
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Moves balls along their paths to where they are at step
+ *		count now, and flags the ones that come within a unit of a wall or
+ *		the paddle they're heading toward so that they can be swept one at a
+ *		time instead. Handles four balls at a time.
+*******************************************************************************/
+__attribute__((target("avx")))
+static void move_balls_avx(int lanes, const BallLanes& b, double now,
+	double top, double bottom, double radius, double left_edge,
+	double right_edge)
+{
+	const __m256d zero = _mm256_setzero_pd();
+	const __m256d v_now = _mm256_set1_pd(now);
+	const __m256d v_top = _mm256_set1_pd(top);
+	const __m256d v_bottom = _mm256_set1_pd(bottom);
+	const __m256d v_radius = _mm256_set1_pd(radius);
+	const __m256d v_left = _mm256_set1_pd(left_edge);
+	const __m256d v_right = _mm256_set1_pd(right_edge);
+
+	for (int i = 0; i < lanes; i += 4)
+	{
+		__m256d bs = _mm256_loadu_pd(b.s + i);
+		__m256d bvx = _mm256_loadu_pd(b.vx + i);
+		__m256d e = _mm256_sub_pd(v_now, _mm256_loadu_pd(b.path_t + i));
+		__m256d bx = _mm256_add_pd(_mm256_loadu_pd(b.path_x + i),
+			_mm256_mul_pd(_mm256_mul_pd(bvx, bs), e));
+		__m256d by = _mm256_add_pd(_mm256_loadu_pd(b.path_y + i),
+			_mm256_mul_pd(_mm256_mul_pd(_mm256_loadu_pd(b.vy + i), bs), e));
+		_mm256_storeu_pd(b.x + i, bx);
+		_mm256_storeu_pd(b.y + i, by);
+
+		// Near a wall, or near the paddle the ball is heading toward?
+		__m256d m = _mm256_or_pd(_mm256_cmp_pd(by, v_top, _CMP_GE_OQ),
+			_mm256_cmp_pd(by, v_bottom, _CMP_LE_OQ));
+		__m256d going_right = _mm256_cmp_pd(bvx, zero, _CMP_GT_OQ);
+		__m256d near_right = _mm256_cmp_pd(_mm256_add_pd(bx, v_radius),
+			v_right, _CMP_GE_OQ);
+		__m256d near_left = _mm256_cmp_pd(_mm256_sub_pd(bx, v_radius),
+			v_left, _CMP_LE_OQ);
+		m = _mm256_or_pd(m, _mm256_blendv_pd(near_left, near_right,
+			going_right));
+
+		int bits = _mm256_movemask_pd(m);
+		b.contact[i] = bits & 1;
+		b.contact[i + 1] = (bits >> 1) & 1;
+		b.contact[i + 2] = (bits >> 2) & 1;
+		b.contact[i + 3] = (bits >> 3) & 1;
+	}
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Moves AI paddles toward their balls, keeping track of
+ *		runs at full speed, and keeps them in bounds. Handles four paddles at
+ *		a time.
+*******************************************************************************/
+__attribute__((target("avx")))
+static void move_paddles_avx(int lanes, const PaddleLanes& p,
+	const double* ball, double now, double maxy, double miny)
+{
+	const __m256d zero = _mm256_setzero_pd();
+	const __m256d one = _mm256_set1_pd(1.0);
+	const __m256d minus_one = _mm256_set1_pd(-1.0);
+	const __m256d v_now = _mm256_set1_pd(now);
+	const __m256d v_last = _mm256_set1_pd(now - 1);
+	const __m256d v_maxy = _mm256_set1_pd(maxy);
+	const __m256d v_miny = _mm256_set1_pd(miny);
+
+	for (int i = 0; i < lanes; i += 4)
+	{
+		__m256d py = _mm256_loadu_pd(p.y + i);
+		__m256d v = _mm256_loadu_pd(p.speed + i);
+		__m256d h = _mm256_loadu_pd(p.half + i);
+		__m256d target = _mm256_sub_pd(_mm256_loadu_pd(ball + i),
+			_mm256_loadu_pd(p.offset + i));
+
+		// Which way to run at full speed, if at all
+		__m256d up = _mm256_cmp_pd(_mm256_sub_pd(target, py), v, _CMP_GT_OQ);
+		__m256d down = _mm256_andnot_pd(up,
+			_mm256_cmp_pd(_mm256_sub_pd(py, target), v, _CMP_GT_OQ));
+		__m256d dir = _mm256_blendv_pd(zero, one, up);
+		dir = _mm256_blendv_pd(dir, minus_one, down);
+		__m256d running = _mm256_or_pd(up, down);
+
+		// Start a new run unless carrying on with the last one unchanged
+		__m256d chase = _mm256_loadu_pd(p.chase + i);
+		__m256d chase_y = _mm256_loadu_pd(p.chase_y + i);
+		__m256d chase_t = _mm256_loadu_pd(p.chase_t + i);
+		__m256d chase_speed = _mm256_loadu_pd(p.chase_speed + i);
+		__m256d chase_to = _mm256_loadu_pd(p.chase_to + i);
+		__m256d restart = _mm256_or_pd(
+			_mm256_cmp_pd(dir, chase, _CMP_NEQ_UQ),
+			_mm256_or_pd(_mm256_cmp_pd(py, chase_to, _CMP_NEQ_UQ),
+				_mm256_cmp_pd(v, chase_speed, _CMP_NEQ_UQ)));
+		restart = _mm256_and_pd(restart, running);
+		chase_y = _mm256_blendv_pd(chase_y, py, restart);
+		chase_t = _mm256_blendv_pd(chase_t, v_last, restart);
+		chase_speed = _mm256_blendv_pd(chase_speed, v, restart);
+		__m256d to = _mm256_add_pd(chase_y, _mm256_mul_pd(
+			_mm256_mul_pd(dir, v), _mm256_sub_pd(v_now, chase_t)));
+		chase_to = _mm256_blendv_pd(chase_to, to, running);
+		py = _mm256_blendv_pd(target, to, running);
+
+		// Keep in bounds
+		__m256d m = _mm256_cmp_pd(_mm256_add_pd(py, h), v_maxy, _CMP_GT_OQ);
+		py = _mm256_blendv_pd(py, _mm256_sub_pd(v_maxy, h), m);
+		m = _mm256_cmp_pd(_mm256_sub_pd(py, h), v_miny, _CMP_LT_OQ);
+		py = _mm256_blendv_pd(py, _mm256_add_pd(v_miny, h), m);
+
+		_mm256_storeu_pd(p.y + i, py);
+		_mm256_storeu_pd(p.chase + i, dir);
+		_mm256_storeu_pd(p.chase_y + i, chase_y);
+		_mm256_storeu_pd(p.chase_t + i, chase_t);
+		_mm256_storeu_pd(p.chase_speed + i, chase_speed);
+		_mm256_storeu_pd(p.chase_to + i, chase_to);
+	}
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Picks a where m is set, b where it isn't.
+*******************************************************************************/
+static inline __m128d select_sse2(__m128d m, __m128d a, __m128d b)
+{
+	return _mm_or_pd(_mm_and_pd(m, a), _mm_andnot_pd(m, b));
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: SSE2 version of move_balls_avx(). Handles two balls at a
+ *		time.
+*******************************************************************************/
+static void move_balls_sse2(int lanes, const BallLanes& b, double now,
+	double top, double bottom, double radius, double left_edge,
+	double right_edge)
+{
+	const __m128d zero = _mm_setzero_pd();
+	const __m128d v_now = _mm_set1_pd(now);
+	const __m128d v_top = _mm_set1_pd(top);
+	const __m128d v_bottom = _mm_set1_pd(bottom);
+	const __m128d v_radius = _mm_set1_pd(radius);
+	const __m128d v_left = _mm_set1_pd(left_edge);
+	const __m128d v_right = _mm_set1_pd(right_edge);
+
+	for (int i = 0; i < lanes; i += 2)
+	{
+		__m128d bs = _mm_loadu_pd(b.s + i);
+		__m128d bvx = _mm_loadu_pd(b.vx + i);
+		__m128d e = _mm_sub_pd(v_now, _mm_loadu_pd(b.path_t + i));
+		__m128d bx = _mm_add_pd(_mm_loadu_pd(b.path_x + i),
+			_mm_mul_pd(_mm_mul_pd(bvx, bs), e));
+		__m128d by = _mm_add_pd(_mm_loadu_pd(b.path_y + i),
+			_mm_mul_pd(_mm_mul_pd(_mm_loadu_pd(b.vy + i), bs), e));
+		_mm_storeu_pd(b.x + i, bx);
+		_mm_storeu_pd(b.y + i, by);
+
+		// Near a wall, or near the paddle the ball is heading toward?
+		__m128d m = _mm_or_pd(_mm_cmpge_pd(by, v_top),
+			_mm_cmple_pd(by, v_bottom));
+		__m128d going_right = _mm_cmpgt_pd(bvx, zero);
+		__m128d near_right = _mm_cmpge_pd(_mm_add_pd(bx, v_radius), v_right);
+		__m128d near_left = _mm_cmple_pd(_mm_sub_pd(bx, v_radius), v_left);
+		m = _mm_or_pd(m, select_sse2(going_right, near_right, near_left));
+
+		int bits = _mm_movemask_pd(m);
+		b.contact[i] = bits & 1;
+		b.contact[i + 1] = (bits >> 1) & 1;
+	}
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: SSE2 version of move_paddles_avx(). Handles two paddles at
+ *		a time.
+*******************************************************************************/
+static void move_paddles_sse2(int lanes, const PaddleLanes& p,
+	const double* ball, double now, double maxy, double miny)
+{
+	const __m128d zero = _mm_setzero_pd();
+	const __m128d one = _mm_set1_pd(1.0);
+	const __m128d minus_one = _mm_set1_pd(-1.0);
+	const __m128d v_now = _mm_set1_pd(now);
+	const __m128d v_last = _mm_set1_pd(now - 1);
+	const __m128d v_maxy = _mm_set1_pd(maxy);
+	const __m128d v_miny = _mm_set1_pd(miny);
+
+	for (int i = 0; i < lanes; i += 2)
+	{
+		__m128d py = _mm_loadu_pd(p.y + i);
+		__m128d v = _mm_loadu_pd(p.speed + i);
+		__m128d h = _mm_loadu_pd(p.half + i);
+		__m128d target = _mm_sub_pd(_mm_loadu_pd(ball + i),
+			_mm_loadu_pd(p.offset + i));
+
+		// Which way to run at full speed, if at all
+		__m128d up = _mm_cmpgt_pd(_mm_sub_pd(target, py), v);
+		__m128d down = _mm_andnot_pd(up,
+			_mm_cmpgt_pd(_mm_sub_pd(py, target), v));
+		__m128d dir = select_sse2(up, one, zero);
+		dir = select_sse2(down, minus_one, dir);
+		__m128d running = _mm_or_pd(up, down);
+
+		// Start a new run unless carrying on with the last one unchanged
+		__m128d chase = _mm_loadu_pd(p.chase + i);
+		__m128d chase_y = _mm_loadu_pd(p.chase_y + i);
+		__m128d chase_t = _mm_loadu_pd(p.chase_t + i);
+		__m128d chase_speed = _mm_loadu_pd(p.chase_speed + i);
+		__m128d chase_to = _mm_loadu_pd(p.chase_to + i);
+		__m128d restart = _mm_or_pd(_mm_cmpneq_pd(dir, chase),
+			_mm_or_pd(_mm_cmpneq_pd(py, chase_to),
+				_mm_cmpneq_pd(v, chase_speed)));
+		restart = _mm_and_pd(restart, running);
+		chase_y = select_sse2(restart, py, chase_y);
+		chase_t = select_sse2(restart, v_last, chase_t);
+		chase_speed = select_sse2(restart, v, chase_speed);
+		__m128d to = _mm_add_pd(chase_y, _mm_mul_pd(_mm_mul_pd(dir, v),
+			_mm_sub_pd(v_now, chase_t)));
+		chase_to = select_sse2(running, to, chase_to);
+		py = select_sse2(running, to, target);
+
+		// Keep in bounds
+		py = select_sse2(_mm_cmpgt_pd(_mm_add_pd(py, h), v_maxy),
+			_mm_sub_pd(v_maxy, h), py);
+		py = select_sse2(_mm_cmplt_pd(_mm_sub_pd(py, h), v_miny),
+			_mm_add_pd(v_miny, h), py);
+
+		_mm_storeu_pd(p.y + i, py);
+		_mm_storeu_pd(p.chase + i, dir);
+		_mm_storeu_pd(p.chase_y + i, chase_y);
+		_mm_storeu_pd(p.chase_t + i, chase_t);
+		_mm_storeu_pd(p.chase_speed + i, chase_speed);
+		_mm_storeu_pd(p.chase_to + i, chase_to);
+	}
+}
+
+#else
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Plain version of the ball kernel for processors without
+ *		SSE2 or AVX. Left to the compiler to vectorize.
+*******************************************************************************/
+static void move_balls_plain(int lanes, const BallLanes& b, double now,
+	double top, double bottom, double radius, double left_edge,
+	double right_edge)
+{
+	for (int i = 0; i < lanes; i++)
+	{
+		double x = Ball::pathPosition(b.path_x[i], b.vx[i], b.s[i],
+			b.path_t[i], now);
+		double y = Ball::pathPosition(b.path_y[i], b.vy[i], b.s[i],
+			b.path_t[i], now);
+		b.x[i] = x;
+		b.y[i] = y;
+		b.contact[i] = y >= top || y <= bottom || (b.vx[i] > 0
+			? x + radius >= right_edge : x - radius <= left_edge);
+	}
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Plain version of the paddle kernel for processors without
+ *		SSE2 or AVX. Left to the compiler to vectorize.
+*******************************************************************************/
+static void move_paddles_plain(int lanes, const PaddleLanes& p,
+	const double* ball, double now, double maxy, double miny)
+{
+	for (int i = 0; i < lanes; i++)
+	{
+		double target = ball[i] - p.offset[i];
+		double v = p.speed[i];
+		double dir = 0;
+		if (target - p.y[i] > v) dir = 1;
+		else if (p.y[i] - target > v) dir = -1;
+
+		double y = target;
+		if (dir != 0)
+		{
+			if (dir != p.chase[i] || p.y[i] != p.chase_to[i]
+				|| v != p.chase_speed[i])
+			{
+				p.chase_y[i] = p.y[i];
+				p.chase_t[i] = now - 1;
+				p.chase_speed[i] = v;
+			}
+			y = p.chase_y[i] + dir * v * (now - p.chase_t[i]);
+			p.chase_to[i] = y;
+		}
+		p.chase[i] = dir;
+
+		if (y + p.half[i] > maxy) y = maxy - p.half[i];
+		if (y - p.half[i] < miny) y = miny + p.half[i];
+		p.y[i] = y;
+	}
+}
+
+#endif
+
+/*******************************************************************************
+ *                          FUNCTION DEFINITIONS
+*******************************************************************************/
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: The constructor. Sets aside room for every match. Matches
+ *		don't begin until start() is called.
+ *
+ * @param[in]	width - Width of the playing field.
+ * @param[in]	height - Height of the playing field.
+ * @param[in]	matches - Number of matches to play side by side.
+*******************************************************************************/
+BatchGame::BatchGame(int width, int height, int matches) :
+		matches(matches), lanes((matches + 3) / 4 * 4), width(width),
+		height(height), tick(0), running(0), use_avx(false),
+		ball_x(lanes), ball_y(lanes), ball_vx(lanes), ball_vy(lanes),
+		ball_s(lanes), path_x(lanes), path_y(lanes), path_t(lanes),
+		left_y(lanes), right_y(lanes), left_half(lanes),
+		right_half(lanes), left_speed(lanes), right_speed(lanes),
+		left_offset(lanes), right_offset(lanes), left_chase(lanes),
+		left_chase_y(lanes), left_chase_t(lanes), left_chase_speed(lanes),
+		left_chase_to(lanes), right_chase(lanes), right_chase_y(lanes),
+		right_chase_t(lanes), right_chase_speed(lanes), right_chase_to(lanes),
+		left_score(lanes), right_score(lanes), left_size(lanes),
+		right_size(lanes), hit_count(lanes), ball_timer(lanes),
+		end_tick(lanes, 0), random(matches), contact(lanes)
+{
+	int u = PongGame::unit;
+
+	// Same layout PongGame::reset() and PongGame::startGame() use
+	ball_width = 20;
+	ball_speed = 5;
+	paddle_width = u;
+	left_x = (int) (u * 2.5);
+	right_x = width - (int) (u * 2.5);
+	left_edge = left_x + paddle_width / 2;
+	right_edge = right_x - paddle_width / 2;
+	paddle_maxy = height;
+	paddle_miny = 0;
+
+#ifdef BATCH_X86
+	use_avx = __builtin_cpu_supports("avx");
+#endif
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Sets how hard the AIs of one side of every match are to
+ *		beat, from the next start() on, as PongGame::setDifficulty() does
+ *		for a game. Both sides play Difficulty::standard until this is
+ *		called. pong-tune gives the sides different ones to pit what it is
+ *		tuning against a fixed opponent.
+ *
+ * @param[in]	right - True for the right side, false for the left.
+ * @param[in]	difficulty - How hard that side is.
+*******************************************************************************/
+void BatchGame::setDifficulty(bool right, const Difficulty& difficulty)
+{
+	if (right)
+		right_difficulty = difficulty;
+	else
+		left_difficulty = difficulty;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Starts every match over from the beginning, the way
+ *		PongGame::startGame(true, true) does. Match i draws its random numbers
+ *		from stream first + i of the seed, as a PongGame would after
+ *		setSeed(seed, first + i).
+ *
+ * @param[in]	seed - Where to start the random numbers from.
+ * @param[in]	first - OPTIONAL. Stream of the first match.
+*******************************************************************************/
+void BatchGame::start(uint64_t seed, uint64_t first)
+{
+	tick = 0;
+	running = matches;
+
+	for (int i = 0; i < matches; i++)
+	{
+		left_score[i] = 0;
+		right_score[i] = 0;
+		left_size[i] = 8;
+		right_size[i] = 8;
+		left_half[i] = left_size[i] * PongGame::unit / 2;
+		right_half[i] = right_size[i] * PongGame::unit / 2;
+		left_y[i] = height / 2;
+		right_y[i] = height / 2;
+		hit_count[i] = 0;
+		end_tick[i] = -1;
+
+		ball_x[i] = width / 2;
+		ball_y[i] = height / 2;
+		ball_vx[i] = 0;
+		ball_vy[i] = 0;
+		ball_s[i] = 1.0;
+		path_x[i] = ball_x[i];
+		path_y[i] = ball_y[i];
+		path_t[i] = 0;
+		ball_timer[i] = 60;
+
+		left_chase[i] = 0;
+		left_chase_y[i] = 0;
+		left_chase_t[i] = 0;
+		left_chase_speed[i] = 0;
+		left_chase_to[i] = 0;
+		right_chase[i] = 0;
+		right_chase_y[i] = 0;
+		right_chase_t[i] = 0;
+		right_chase_speed[i] = 0;
+		right_chase_to[i] = 0;
+
+		random[i].seed(seed, first + i);
+		left_offset[i] = randomOffset(i, false);
+		right_offset[i] = randomOffset(i, true);
+		updateDifficulty(i);
+	}
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Moves every running match forward one step. Balls are
+ *		moved for all matches at once, then paddle hits, goals and serves are
+ *		handled for the matches that need it, then the AI paddles are moved
+ *		for all matches at once.
+*******************************************************************************/
+void BatchGame::step()
+{
+	if (running == 0) return;
+	tick++;
+
+	moveBalls();
+	for (int i = 0; i < matches; i++)
+	{
+		if (end_tick[i] < 0)
+		{
+			handleEvents(i);
+		}
+	}
+	movePaddles();
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Moves every ball according to its velocity, except those
+ *		that come within a unit of a wall or the paddle they're heading
+ *		toward. Those are left in place and flagged in contact[] to be swept
+ *		by handleEvents(). The extra unit makes sure no ball that Ball::sweep()
+ *		would stop or bounce slips through on account of rounding.
+*******************************************************************************/
+void BatchGame::moveBalls()
+{
+	double top = height - ball_width / 2 - 1;
+	double bottom = ball_width / 2 + 1;
+	double radius = ball_width / 2;
+	double left = left_edge + 1;
+	double right = right_edge - 1;
+
+	BallLanes b = { &ball_x[0], &ball_y[0], &path_x[0], &path_y[0],
+		&path_t[0], &ball_vx[0], &ball_vy[0], &ball_s[0], &contact[0] };
+
+#ifdef BATCH_X86
+	if (use_avx)
+	{
+		move_balls_avx(lanes, b, tick, top, bottom, radius, left, right);
+	}
+	else
+	{
+		move_balls_sse2(lanes, b, tick, top, bottom, radius, left, right);
+	}
+#else
+	move_balls_plain(lanes, b, tick, top, bottom, radius, left, right);
+#endif
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Moves every left and right AI paddle toward its ball.
+*******************************************************************************/
+void BatchGame::movePaddles()
+{
+	PaddleLanes left = { &left_y[0], &left_offset[0], &left_speed[0],
+		&left_half[0], &left_chase[0], &left_chase_y[0], &left_chase_t[0],
+		&left_chase_speed[0], &left_chase_to[0] };
+	PaddleLanes right = { &right_y[0], &right_offset[0], &right_speed[0],
+		&right_half[0], &right_chase[0], &right_chase_y[0], &right_chase_t[0],
+		&right_chase_speed[0], &right_chase_to[0] };
+
+#ifdef BATCH_X86
+	if (use_avx)
+	{
+		move_paddles_avx(lanes, left, &ball_y[0], tick, paddle_maxy,
+			paddle_miny);
+		move_paddles_avx(lanes, right, &ball_y[0], tick, paddle_maxy,
+			paddle_miny);
+	}
+	else
+	{
+		move_paddles_sse2(lanes, left, &ball_y[0], tick, paddle_maxy,
+			paddle_miny);
+		move_paddles_sse2(lanes, right, &ball_y[0], tick, paddle_maxy,
+			paddle_miny);
+	}
+#else
+	move_paddles_plain(lanes, left, &ball_y[0], tick, paddle_maxy,
+		paddle_miny);
+	move_paddles_plain(lanes, right, &ball_y[0], tick, paddle_maxy,
+		paddle_miny);
+#endif
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Handles everything in a match that isn't simple movement:
+ *		bouncing the ball off the walls and paddles, the ball going off the
+ *		board, and serving. Mirrors Ball::step(), PongGame::scoreLeft() and
+ *		PongGame::scoreRight(), and the serve timer in PongGame::step().
+ *
+ * @param[in]	i - The match to handle.
+*******************************************************************************/
+void BatchGame::handleEvents(int i)
+{
+	while (contact[i])
+	{
+		BallArena arena;
+		getArena(i, arena);
+
+		BallPath path = { path_x[i], path_y[i], path_t[i] };
+		int result = Ball::sweep(path, ball_vx[i], ball_vy[i], ball_s[i],
+			ball_width, tick, arena);
+		path_x[i] = path.x;
+		path_y[i] = path.y;
+		path_t[i] = path.t;
+		if (result == BOUNCE_PADDLE)
+		{
+			hitPaddle(i, ball_vx[i] < 0);
+			continue;
+		}
+
+		ball_x[i] = Ball::pathPosition(path.x, ball_vx[i], ball_s[i],
+			path.t, tick);
+		ball_y[i] = Ball::pathPosition(path.y, ball_vy[i], ball_s[i],
+			path.t, tick);
+		if (result == BOUNCE_GOAL)
+		{
+			score(i, ball_vx[i] > 0);
+			if (end_tick[i] >= 0) return;
+		}
+		break;
+	}
+
+	// Serve the ball if a serving timer is counting down
+	if (ball_timer[i] == 0 && ball_vx[i] == 0 && ball_vy[i] == 0)
+	{
+		if ((left_score[i] + right_score[i]) % 2)
+		{
+			ball_vx[i] = -ball_speed;
+		}
+		else
+		{
+			ball_vx[i] = ball_speed;
+		}
+		ball_vy[i] = (random[i].nextInt(11) - 5) / 2.0;
+		path_x[i] = ball_x[i];
+		path_y[i] = ball_y[i];
+		path_t[i] = tick;
+	}
+	if (ball_timer[i] > -1)
+	{
+		ball_timer[i]--;
+	}
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Handles a ball bouncing off a paddle in a match. Mirrors
+ *		PongGame::ballHit() and AIController::ballHit().
+ *
+ * @param[in]	i - The match the ball is in.
+ * @param[in]	right - True if the right paddle was hit, false for the left.
+*******************************************************************************/
+void BatchGame::hitPaddle(int i, bool right)
+{
+	// Possibly shrink paddle sizes
+	hit_count[i]++;
+	if (hit_count[i] > 16 - (left_score[i] + right_score[i]) / 2)
+	{
+		if (right)
+		{
+			right_size[i]--;
+		}
+		else
+		{
+			left_size[i]--;
+		}
+	}
+	if (right_size[i] < 3) right_size[i] = 3;
+	if (left_size[i] < 3) left_size[i] = 3;
+	left_half[i] = left_size[i] * PongGame::unit / 2;
+	right_half[i] = right_size[i] * PongGame::unit / 2;
+
+	// The AI that hit the ball picks a new offset
+	if (right)
+	{
+		right_offset[i] = randomOffset(i, true);
+	}
+	else
+	{
+		left_offset[i] = randomOffset(i, false);
+	}
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Fills in the walls, paddles, and goals of a match, the
+ *		same way Ball::getArena() does for a PongGame.
+ *
+ * @param[in]	i - The match to describe.
+ * @param[out]	arena - Where to put them.
+*******************************************************************************/
+void BatchGame::getArena(int i, BallArena& arena)
+{
+	arena.top = height;
+	arena.bottom = 0;
+	arena.left_goal = 0;
+	arena.right_goal = width;
+	arena.left_x = left_x;
+	arena.left_y = left_y[i];
+	arena.left_width = paddle_width;
+	arena.left_height = left_size[i] * PongGame::unit;
+	arena.right_x = right_x;
+	arena.right_y = right_y[i];
+	arena.right_width = paddle_width;
+	arena.right_height = right_size[i] * PongGame::unit;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Scores a point for one side of a match. Resets the
+ *		paddles, and either ends the match or puts the ball back in the
+ *		middle to be served.
+ *
+ * @param[in]	i - The match to score in.
+ * @param[in]	left - True to score for the left side, false for the right.
+*******************************************************************************/
+void BatchGame::score(int i, bool left)
+{
+	int points = left ? ++left_score[i] : ++right_score[i];
+
+	// Reset variables and paddle status
+	hit_count[i] = 0;
+	left_size[i] = 8;
+	right_size[i] = 8;
+	left_half[i] = left_size[i] * PongGame::unit / 2;
+	right_half[i] = right_size[i] * PongGame::unit / 2;
+	clampPaddle(right_y[i], right_half[i]);
+	clampPaddle(left_y[i], left_half[i]);
+
+	// Check if we have a winner
+	if (points == 10)
+	{
+		end_tick[i] = tick;
+		running--;
+	}
+	else
+	{
+		updateDifficulty(i);
+		ball_x[i] = width / 2;
+		ball_y[i] = height / 2;
+		ball_vx[i] = 0;
+		ball_vy[i] = 0;
+		path_x[i] = ball_x[i];
+		path_y[i] = ball_y[i];
+		path_t[i] = tick;
+		ball_timer[i] = 60;
+	}
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Keeps a paddle inside its area, the same way
+ *		Paddle::verticalMotion() does.
+ *
+ * @param[in,out]	y - y coordinate of the center of the paddle.
+ * @param[in]	half - Half the height of the paddle.
+*******************************************************************************/
+void BatchGame::clampPaddle(double& y, double half)
+{
+	if (y + half > paddle_maxy)
+	{
+		y = paddle_maxy - half;
+	}
+	if (y - half < paddle_miny)
+	{
+		y = paddle_miny + half;
+	}
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Speeds up the AI paddle of the side that is losing and
+ *		slows down the one that is winning, as PongGame::updateDifficulty()
+ *		does.
+ *
+ * @param[in]	i - The match to update.
+*******************************************************************************/
+void BatchGame::updateDifficulty(int i)
+{
+	left_speed[i] = fabs(left_difficulty.paddleSpeed(right_score[i]
+		- left_score[i]));
+	right_speed[i] = fabs(right_difficulty.paddleSpeed(left_score[i]
+		- right_score[i]));
+	if (left_speed[i] < 1) left_speed[i] = 1;
+	if (right_speed[i] < 1) right_speed[i] = 1;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Picks a new random offset for an AI paddle, the same way
+ *		AIController::ballHit() does.
+ *
+ * @param[in]	i - The match the paddle is in.
+ * @param[in]	right - True for the right paddle, false for the left.
+ *
+ * @returns The new offset.
+*******************************************************************************/
+double BatchGame::randomOffset(int i, bool right)
+{
+	return (right ? right_difficulty : left_difficulty).randomOffset(random[i]);
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Gets the number of matches being played.
+ *
+ * @returns The number of matches.
+*******************************************************************************/
+int BatchGame::getMatches()
+{
+	return matches;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Gets the number of matches still being played.
+ *
+ * @returns The number of unfinished matches.
+*******************************************************************************/
+int BatchGame::getRunning()
+{
+	return running;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Gets the number of steps taken since start().
+ *
+ * @returns The number of steps.
+*******************************************************************************/
+long BatchGame::getTick()
+{
+	return tick;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Checks whether a match is still being played.
+ *
+ * @param[in]	i - The match to check.
+ *
+ * @returns True if the match hasn't ended yet, false if it has.
+*******************************************************************************/
+bool BatchGame::isRunning(int i)
+{
+	return end_tick[i] < 0;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Gets the step a match ended on, counting the first step
+ *		after start() as 1.
+ *
+ * @param[in]	i - The match to check.
+ *
+ * @returns The step the match ended on, or -1 if it is still running.
+*******************************************************************************/
+long BatchGame::getEndTick(int i)
+{
+	return end_tick[i];
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Gets the number of points scored by the left side of a
+ *		match.
+ *
+ * @param[in]	i - The match to check.
+ *
+ * @returns The left side's score.
+*******************************************************************************/
+int BatchGame::getLeftScore(int i)
+{
+	return left_score[i];
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Gets the number of points scored by the right side of a
+ *		match.
+ *
+ * @param[in]	i - The match to check.
+ *
+ * @returns The right side's score.
+*******************************************************************************/
+int BatchGame::getRightScore(int i)
+{
+	return right_score[i];
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Checks whether a match is in exactly the same state as a
+ *		PongGame playing the same match. Positions and speeds must be equal
+ *		to the bit, not just close.
+ *
+ * @param[in]	i - The match to check.
+ * @param[in]	game - The game to compare against.
+ *
+ * @returns True if they match, false if anything differs.
+*******************************************************************************/
+bool BatchGame::matchesGame(int i, PongGame* game)
+{
+	if (isRunning(i) != game->isRunning()
+		|| left_score[i] != game->getLeftScore()
+		|| right_score[i] != game->getRightScore())
+	{
+		return false;
+	}
+	if (!isRunning(i))
+	{
+		return true;
+	}
+
+	Ball* ball = game->getBall();
+	Paddle* left = game->getLeftPaddle();
+	Paddle* right = game->getRightPaddle();
+	return ball_x[i] == ball->center_x
+		&& ball_y[i] == ball->center_y
+		&& ball_vx[i] == ball->x_velocity
+		&& ball_vy[i] == ball->y_velocity
+		&& left_y[i] == left->getY()
+		&& right_y[i] == right->getY()
+		&& left_size[i] * PongGame::unit == left->getHeight()
+		&& right_size[i] * PongGame::unit == right->getHeight();
+}
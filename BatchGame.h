@@ -0,0 +1,212 @@
+/***************************************************************************//**
+ * @file File containing the declaration for the BatchGame class.
+ *
+ * @brief Contains the declaration for the BatchGame class, which runs many AI
+ *		vs AI matches side by side.
+*******************************************************************************/
+#ifndef _BATCHGAME_H_
+#define _BATCHGAME_H_
+
+/*******************************************************************************
+ *                 DECLARATIONS, INCLUDES, AND NAMESPACES
+*******************************************************************************/
+class BatchGame;
+
+#include <vector>
+#include <cstdlib>
+#include "PongGame.h"
+
+using namespace std;
+
+/***************************************************************************//**
+ * @brief The BatchGame class plays many independent AI vs AI matches at once.
+ *
+ * @details Where PongGame keeps one Ball and two Paddles on the heap, BatchGame
+ *		keeps the ball and paddle state of every match in its own contiguous
+ *		array, one entry per match, and steps all matches together. The
+ *		movement of balls and paddles is done several matches at a time with
+ *		SSE2 or AVX instructions. Anything that needs a decision, a bounce, a
+ *		goal, or a serve, is handed to the same rules PongGame uses
+ *		(Ball::sweep and friends), one match at a time.
+ *
+ *		Matches play exactly as a PongGame with setScoreDemo(true) would after
+ *		startGame(true, true). Each match has its own PongRandom, seeded the
+ *		way PongGame::setSeed() seeds a game's, so both give bit-for-bit the
+ *		same matches from the same seed and stream; "pong-sim --verify-batch"
+ *		checks this.
+*******************************************************************************/
+class BatchGame
+{
+	private:
+		int matches;	/*!< Number of matches being played */
+		int lanes;		/*!< matches rounded up to a whole number of vectors */
+		int width;		/*!< Width of the playing field */
+		int height;		/*!< Height of the playing field */
+		long tick;		/*!< Number of steps taken since start() */
+		int running;	/*!< Number of matches still being played */
+		bool use_avx;	/*!< True if the processor supports AVX */
+
+		vector<double> ball_x;		/*!< x coordinate of each ball */
+		vector<double> ball_y;		/*!< y coordinate of each ball */
+		vector<double> ball_vx;		/*!< x speed of each ball */
+		vector<double> ball_vy;		/*!< y speed of each ball */
+		vector<double> ball_s;		/*!< speed modifier of each ball */
+		vector<double> path_x;		/*!< x coordinate each ball's path starts
+										at */
+		vector<double> path_y;		/*!< y coordinate each ball's path starts
+										at */
+		vector<double> path_t;		/*!< step each ball's path starts at */
+		vector<double> left_y;		/*!< y coordinate of each left paddle */
+		vector<double> right_y;		/*!< y coordinate of each right paddle */
+		vector<double> left_half;	/*!< half height of each left paddle */
+		vector<double> right_half;	/*!< half height of each right paddle */
+		vector<double> left_speed;	/*!< max speed of each left paddle */
+		vector<double> right_speed;	/*!< max speed of each right paddle */
+		vector<double> left_offset;	/*!< AI offset of each left paddle */
+		vector<double> right_offset;	/*!< AI offset of each right paddle */
+
+		// Runs at full speed by each AI paddle, as kept by AIController
+		vector<double> left_chase;			/*!< direction of each run */
+		vector<double> left_chase_y;		/*!< where each run started */
+		vector<double> left_chase_t;		/*!< step each run started on */
+		vector<double> left_chase_speed;	/*!< speed of each run */
+		vector<double> left_chase_to;		/*!< where each run last went */
+		vector<double> right_chase;			/*!< direction of each run */
+		vector<double> right_chase_y;		/*!< where each run started */
+		vector<double> right_chase_t;		/*!< step each run started on */
+		vector<double> right_chase_speed;	/*!< speed of each run */
+		vector<double> right_chase_to;		/*!< where each run last went */
+
+		vector<int> left_score;		/*!< Points made by each left side */
+		vector<int> right_score;	/*!< Points made by each right side */
+		vector<int> left_size;		/*!< height of each left paddle in units*/
+		vector<int> right_size;		/*!< height of each right paddle in units*/
+		vector<int> hit_count;		/*!< paddle hits since the last point */
+		vector<int> ball_timer;		/*!< timer before each ball is served */
+		vector<long> end_tick;		/*!< step each match ended on, or -1 */
+		vector<PongRandom> random;	/*!< random numbers of each match */
+		vector<unsigned char> contact;	/*!< set by moveBalls() for matches
+											whose ball may touch a wall,
+											paddle, or goal this step */
+
+		int ball_width;		/*!< diameter of the balls */
+		double ball_speed;	/*!< x speed balls are served at */
+		int paddle_width;	/*!< width of the paddles */
+		double left_x;		/*!< x coordinate of the left paddles */
+		double right_x;		/*!< x coordinate of the right paddles */
+		double left_edge;	/*!< right edge of the left paddles */
+		double right_edge;	/*!< left edge of the right paddles */
+		int paddle_maxy;	/*!< highest a paddle may reach */
+		int paddle_miny;	/*!< lowest a paddle may reach */
+		Difficulty left_difficulty;		/*!< how hard the left AIs are */
+		Difficulty right_difficulty;	/*!< how hard the right AIs are */
+
+		/*!
+		 * @brief Moves every ball and flags those that may touch something
+		 */
+		void moveBalls();
+
+		/*!
+		 * @brief Moves every AI paddle toward its ball
+		 */
+		void movePaddles();
+
+		/*!
+		 * @brief Handles paddle hits, goals and serves for one match
+		 */
+		void handleEvents(int i);
+
+		/*!
+		 * @brief Handles a ball bouncing off a paddle in one match
+		 */
+		void hitPaddle(int i, bool right);
+
+		/*!
+		 * @brief Gets the walls, paddles, and goals of one match
+		 */
+		void getArena(int i, BallArena& arena);
+
+		/*!
+		 * @brief Scores a point for one side of a match
+		 */
+		void score(int i, bool left);
+
+		/*!
+		 * @brief Keeps a paddle inside its area
+		 */
+		void clampPaddle(double& y, double half);
+
+		/*!
+		 * @brief Updates the AI paddle speeds of a match based on score
+		 */
+		void updateDifficulty(int i);
+
+		/*!
+		 * @brief Picks a new AI offset for one side of a match
+		 */
+		double randomOffset(int i, bool right);
+
+	public:
+		/*!
+		 * @brief The constructor. Sets up room for the given number of matches
+		 */
+		BatchGame(int width, int height, int matches);
+
+		/*!
+		 * @brief Sets how hard the AIs of one side of every match are
+		 */
+		void setDifficulty(bool right, const Difficulty& difficulty);
+
+		/*!
+		 * @brief Starts every match over from the beginning
+		 */
+		void start(uint64_t seed, uint64_t first = 0);
+
+		/*!
+		 * @brief Moves every running match forward one step
+		 */
+		void step();
+
+		/*!
+		 * @brief Gets the number of matches
+		 */
+		int getMatches();
+
+		/*!
+		 * @brief Gets the number of matches still being played
+		 */
+		int getRunning();
+
+		/*!
+		 * @brief Gets the number of steps taken since start()
+		 */
+		long getTick();
+
+		/*!
+		 * @brief Determines if a match is still being played
+		 */
+		bool isRunning(int i);
+
+		/*!
+		 * @brief Gets the step a match ended on
+		 */
+		long getEndTick(int i);
+
+		/*!
+		 * @brief Gets the score of the left side of a match
+		 */
+		int getLeftScore(int i);
+
+		/*!
+		 * @brief Gets the score of the right side of a match
+		 */
+		int getRightScore(int i);
+
+		/*!
+		 * @brief Checks whether a match is in exactly the same state as a
+		 *		PongGame
+		 */
+		bool matchesGame(int i, PongGame* game);
+};
+
+#endif
@@ -20,8 +20,11 @@
 *******************************************************************************/
 Board::Board(int x, int y, int width, int height, int border) :
 		x(x), y(y), width(width), height(height), border(border),
-		left_text(NULL), right_text(NULL)
+		left_text(NULL), right_text(NULL), left_room(0), right_room(0),
+		center_room(0), text_lists(0)
 {
+	text_changed[0] = text_changed[1] = text_changed[2] = true;
+
 	//creates unsigned charactor arraws for scoring later
 	left_text = new (nothrow) unsigned char[1];
 	right_text = new (nothrow) unsigned char[1];
@@ -38,11 +41,46 @@ Board::Board(int x, int y, int width, int height, int border) :
 *******************************************************************************/
 Board::~Board()
 {
+	releaseText();
 	delete[] left_text;
 	delete[] right_text;
 	delete[] center_text;
 }
 
+/***************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: Copies a string into a text array. Scores change often,
+ *		and games copied over one another set the text over and over, so an
+ *		array is only made anew if the string doesn't fit in the one there,
+ *		and a string that is the text already is left alone so the text
+ *		isn't drawn anew.
+ *
+ * @param[in,out]	text - The text array.
+ * @param[in,out]	room - Characters the text array has room for.
+ * @param[in]	source - The string to copy.
+ *
+ * @returns True if the text is different from before, false if the string
+ *		was the text already.
+*******************************************************************************/
+bool Board::copyText(unsigned char*& text, size_t& room, const string& source)
+{
+	if (text != NULL && source.compare((const char*) text) == 0) return false;
+	if (text == NULL || source.size() > room)
+	{
+		delete[] text;
+		text = new (nothrow) unsigned char[source.size() + 1];
+		room = text == NULL ? 0 : source.size();
+		if (text == NULL) return true;
+	}
+	for (unsigned int i = 0; i < source.size(); i++)
+	{
+		text[i] = (unsigned char) source[i];	//converts to unsigned char
+	};
+	text[source.size()] = '\0';
+	return true;
+}
+
 /***************************************************************************//**
  * @author Daniel Andrus
  * 
@@ -52,14 +90,7 @@ Board::~Board()
 *******************************************************************************/
 void Board::setLeftText(string text)
 {
-	delete[] left_text;//clears current score
-	left_text = new (nothrow) unsigned char[text.size() + 1]; //creates 
-											//unsigned array
-	for (unsigned int i = 0; i < text.size(); i++)
-	{
-		left_text[i] = (unsigned char) text[i]; //fills array from string
-	};
-	left_text[text.size()] = '\0';
+	if (copyText(left_text, left_room, text)) text_changed[0] = true;
 }
 
 /***************************************************************************//**
@@ -71,13 +102,7 @@ void Board::setLeftText(string text)
 *******************************************************************************/
 void Board::setRightText(string text)
 {
-	delete[] right_text; //clears current score
-	right_text = new (nothrow) unsigned char[text.size() + 1];
-	for (unsigned int i = 0; i < text.size(); i++)
-	{     //converts string to unsigned char
-		right_text[i] = (unsigned char) text[i]; 
-	};
-	right_text[text.size()] = '\0';
+	if (copyText(right_text, right_room, text)) text_changed[1] = true;
 }
 
 /***************************************************************************//**
@@ -89,13 +114,7 @@ void Board::setRightText(string text)
 *******************************************************************************/
 void Board::setCenterText(string text)
 {
-	delete[] center_text; //deletes current string
-	center_text = new (nothrow) unsigned char[text.size() + 1];
-	for (unsigned int i = 0; i < text.size(); i++)
-	{  //converts string to unsigned char array
-		center_text[i] = (unsigned char) text[i];
-	};
-	center_text[text.size()] = '\0';
+	if (copyText(center_text, center_room, text)) text_changed[2] = true;
 }
 
 /***************************************************************************//**
@@ -145,55 +164,3 @@ int Board::getHeight()
 {
 	return height;
 }
-
-/***************************************************************************//**
- * @author Daniel Andrus
- * 
- * @par Description: Draws the net, the border, and the scores for the bored
- *		as well as the end game text for the winner
-*******************************************************************************/
-void Board::draw()
-{
-	glColor3d( 1.0, 0.8, 0.8 );
-	//creates a border that is visable if any part of it is on screen
-    glRecti( x - border, y - border, x + border + width, y );
-    glRecti( x - border, y - border, x, y + height + border );
-	glRecti( x + width + border, y + height + border, x + width, y-border);
-	glRecti( x + width + border, y + height + border, x -border, y+height);
-
-	//creates the net
-	glLineStipple(3, 0xAAAA );
-	glEnable( GL_LINE_STIPPLE );
-	glColor3d( 0.8, 1.0, 0.8 );
-	glBegin( GL_LINES );
-		glVertex2i( width/2, 0 );
-		glVertex2i( width/2, height );
-	glEnd();
-	glDisable( GL_LINE_STIPPLE );
-
-	glColor3d( 0.8, 0.8, 1.0 );
-	glLineWidth( 2.5 );
-
-	//creates left score
-	glPushMatrix();
-	glScalef( 0.25, 0.25, 1.0 );
-    glTranslated( (width / 2 - 64) * 4.0, (height - 32) * 4.0, 0);
-    glutStrokeString(GLUT_STROKE_ROMAN, left_text);
-    glPopMatrix();
-
-	//creates right score
-	glPushMatrix();
-	glScalef( 0.25, 0.25, 1.0 );
-    glTranslated( (width / 2 + 64) * 4.0, (height - 32) * 4.0, 0);
-    glutStrokeString(GLUT_STROKE_ROMAN, right_text);
-    glPopMatrix();
-
-	//creates end game text
-	glColor3d( 1.0, 5.0, 0.0 );
-	glPushMatrix();
-	glScalef( 0.25, 0.25, 1.0 );
-    glTranslated( (width / 2 - 120) * 4.0, (height / 2 - 16) * 4.0, 0);
-    glutStrokeString(GLUT_STROKE_ROMAN, center_text);
-    glPopMatrix();
-
-}
@@ -32,6 +32,27 @@ class Board : public Drawable
 		unsigned char* left_text;	/*!< The left score */
 		unsigned char* right_text;	/*!< The right score */
 		unsigned char* center_text;	/*!< The end game text after a game */
+		size_t left_room;	/*!< Characters left_text has room for */
+		size_t right_room;	/*!< Characters right_text has room for */
+		size_t center_room;	/*!< Characters center_text has room for */
+		unsigned int text_lists;	/*!< First of three display lists holding
+										the left, right, and center text as
+										last drawn, 0 until first drawn */
+		bool text_changed[3];	/*!< True for each of the left, right, and
+									center text if it has changed since it
+									was last drawn */
+
+		/*!
+		 *  @brief Copies a string into a text array, making the array bigger
+		 *		only if it has to
+		 */
+		static bool copyText(unsigned char*& text, size_t& room,
+			const string& source);
+
+		/*!
+		 *  @brief Frees the display lists the text is drawn with
+		 */
+		void releaseText();
 
 	public:
 
@@ -0,0 +1,111 @@
+/***************************************************************************//**
+ * @file File containing the drawing implementation for the Board class.
+ *
+ * @brief Contains the drawing implementation for the Board class. Kept apart
+ *		from Board.cpp so the game logic can be built without OpenGL.
+*******************************************************************************/
+
+/*******************************************************************************
+ *                 DECLARATIONS, INCLUDES, AND NAMESPACES
+*******************************************************************************/
+#include <GL/freeglut.h>
+#include "Board.h"
+#include "Pong.h"
+
+/*******************************************************************************
+ *                          FUNCTION DEFINITIONS
+*******************************************************************************/
+/***************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: Draws a line of text in GLUT's stroke font at a quarter
+ *		size. The first time, and whenever the text has changed, the lines it
+ *		is made of are drawn into a display list as well, and every other
+ *		time the display list is drawn instead of walking the font again.
+ *
+ * @param[in]	list - Display list to keep the text in, 0 if there is none.
+ * @param[in,out]	changed - True if the text has changed since the display
+ *				list was made; set to false once it has been made again.
+ * @param[in]	text - The text.
+ * @param[in]	x - Where the text starts, in quarter units.
+ * @param[in]	y - Where the text's baseline is, in quarter units.
+*******************************************************************************/
+static void draw_text(GLuint list, bool& changed, const unsigned char* text,
+	double x, double y)
+{
+	if (list != 0 && !changed)
+	{
+		glCallList(list);
+		return;
+	}
+
+	if (list != 0) glNewList(list, GL_COMPILE_AND_EXECUTE);
+	glPushMatrix();
+	glScalef( 0.25, 0.25, 1.0 );
+    glTranslated( x, y, 0);
+    glutStrokeString(GLUT_STROKE_ROMAN, text);
+    glPopMatrix();
+	if (list != 0) glEndList();
+	changed = false;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: Draws the net, the border, and the scores for the bored
+ *		as well as the end game text for the winner
+*******************************************************************************/
+void Board::draw()
+{
+	Renderer* out = Pong::getInstance()->getRenderer();
+	out->color( 1.0, 0.8, 0.8 );
+	//creates a border that is visable if any part of it is on screen
+    out->rect( x - border, y - border, x + border + width, y );
+    out->rect( x - border, y - border, x, y + height + border );
+	out->rect( x + width + border, y + height + border, x + width, y-border);
+	out->rect( x + width + border, y + height + border, x -border, y+height);
+
+	//creates the net
+	glLineStipple(3, 0xAAAA );
+	glEnable( GL_LINE_STIPPLE );
+	glColor3d( 0.8, 1.0, 0.8 );
+	glBegin( GL_LINES );
+		glVertex2i( width/2, 0 );
+		glVertex2i( width/2, height );
+	glEnd();
+	glDisable( GL_LINE_STIPPLE );
+
+	glColor3d( 0.8, 0.8, 1.0 );
+	glLineWidth( 2.5 );
+
+	// Text only changes when a side scores or wins, so keep it in display
+	// lists, made the first time the board is drawn
+	if (text_lists == 0) text_lists = glGenLists(3);
+	GLuint list = text_lists;
+
+	//creates left score
+	draw_text( list, text_changed[0], left_text,
+		(width / 2 - 64) * 4.0, (height - 32) * 4.0 );
+
+	//creates right score
+	draw_text( list == 0 ? 0 : list + 1, text_changed[1], right_text,
+		(width / 2 + 64) * 4.0, (height - 32) * 4.0 );
+
+	//creates end game text
+	glColor3d( 1.0, 5.0, 0.0 );
+	draw_text( list == 0 ? 0 : list + 2, text_changed[2], center_text,
+		(width / 2 - 120) * 4.0, (height / 2 - 16) * 4.0 );
+
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: Frees the display lists the text is drawn with, if the
+ *		board has been drawn.
+*******************************************************************************/
+void Board::releaseText()
+{
+	if (text_lists != 0) glDeleteLists(text_lists, 3);
+	text_lists = 0;
+}
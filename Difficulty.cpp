@@ -0,0 +1,134 @@
+/***************************************************************************//**
+ * @file File containing the implementation of the Difficulty class.
+ *
+ * @brief Contains the implementation for the Difficulty class.
+*******************************************************************************/
+
+/*******************************************************************************
+ *                 DECLARATIONS, INCLUDES, AND NAMESPACES
+*******************************************************************************/
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include "Difficulty.h"
+#include "PongGame.h"
+
+const Difficulty Difficulty::standard;
+
+/*!
+ * @brief First line of a difficulty file
+ */
+static const char* difficulty_magic = "pong-difficulty 1";
+
+/*******************************************************************************
+ *                          FUNCTION DEFINITIONS
+*******************************************************************************/
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: The constructor. Sets the values the game has always
+ *		played with: a top speed of 3, an eighth more for each point behind,
+ *		and three spots to aim with, four fifths of a unit apart.
+*******************************************************************************/
+Difficulty::Difficulty() :
+base_speed(3), speed_per_point(0.125), offset_count(3), offset_spread(0.8)
+{ }
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Works out the top speed of an AI paddle from the score.
+ *		Paddle::change_max_paddle_speed() keeps it at 1 or more.
+ *
+ * @param[in]	behind - Points the AI's side is behind; negative if it is
+ *				ahead.
+ *
+ * @returns The top speed.
+*******************************************************************************/
+double Difficulty::paddleSpeed(int behind) const
+{
+	return base_speed + behind * speed_per_point;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Picks a new spot along the paddle for an AI to line the
+ *		ball up with, drawing one number from the game's random numbers.
+ *
+ * @param[in,out]	random - The game's random numbers.
+ *
+ * @returns How far below the ball to put the middle of the paddle.
+*******************************************************************************/
+double Difficulty::randomOffset(PongRandom& random) const
+{
+	return (random.nextInt(offset_count) * PongGame::unit
+		- (offset_count * PongGame::unit / 2)) * offset_spread;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Reads a difficulty written by save(). Leaves the
+ *		difficulty as it was if the file can't be read, any number is
+ *		missing, or any is out of range.
+ *
+ * @param[in]	path - File to read.
+ *
+ * @returns True if the difficulty was read, false if not.
+*******************************************************************************/
+bool Difficulty::load(const string& path)
+{
+	ifstream file(path.c_str());
+	string line;
+	if (!getline(file, line) || line != difficulty_magic) return false;
+
+	Difficulty read;
+	bool found[4] = { false, false, false, false };
+	string name;
+	while (file >> name)
+	{
+		if (name == "base_speed" && file >> read.base_speed)
+			found[0] = true;
+		else if (name == "speed_per_point" && file >> read.speed_per_point)
+			found[1] = true;
+		else if (name == "offset_count" && file >> read.offset_count)
+			found[2] = true;
+		else if (name == "offset_spread" && file >> read.offset_spread)
+			found[3] = true;
+		else
+			return false;
+	}
+
+	if (!found[0] || !found[1] || !found[2] || !found[3]
+		|| !(read.base_speed > 0 && read.base_speed < 100)
+		|| !(fabs(read.speed_per_point) < 100)
+		|| read.offset_count < 1 || read.offset_count > 64
+		|| !(fabs(read.offset_spread) < 100))
+	{
+		return false;
+	}
+	*this = read;
+	return true;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Writes the difficulty to a file for load() to read.
+ *
+ * @param[in]	path - File to write.
+ *
+ * @returns True if the difficulty was written, false if not.
+*******************************************************************************/
+bool Difficulty::save(const string& path) const
+{
+	ofstream file(path.c_str(), ios::trunc);
+	file << difficulty_magic << endl << setprecision(17)
+		<< "base_speed " << base_speed << endl
+		<< "speed_per_point " << speed_per_point << endl
+		<< "offset_count " << offset_count << endl
+		<< "offset_spread " << offset_spread << endl;
+	file.close();
+	return !file.fail();
+}
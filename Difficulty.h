@@ -0,0 +1,76 @@
+/***************************************************************************//**
+ * @file File containing the declaration for the Difficulty class.
+ *
+ * @brief Contains the declaration for the Difficulty class, the numbers that
+ *		decide how hard the AIs are to beat.
+*******************************************************************************/
+#ifndef _DIFFICULTY_H_
+#define _DIFFICULTY_H_
+
+/*******************************************************************************
+ *                 DECLARATIONS, INCLUDES, AND NAMESPACES
+*******************************************************************************/
+class Difficulty;
+
+#include <string>
+#include "PongRandom.h"
+
+using namespace std;
+
+/***************************************************************************//**
+ * @brief The Difficulty class holds the numbers that decide how well the
+ *		"follow" and "predict" AIs play, as tuned by pong-tune.
+ *
+ * @details An AI paddle's top speed goes up by speed_per_point for every
+ *		point its side is behind, and down as far for every point it is
+ *		ahead, from base_speed when the score is level, so a game stays
+ *		close. Every time an AI hits the ball it picks one of offset_count
+ *		evenly spaced spots along its paddle, offset_spread units apart, to
+ *		line the ball up with, so that it doesn't hit every ball the same
+ *		way. The values a Difficulty starts with are the ones the game has
+ *		always played with.
+ *
+ *		A difficulty is saved as a small text file, a line for each number
+ *		after a first line naming the format, so it can be read and edited
+ *		by hand. Numbers are written with all of their digits, so a
+ *		difficulty read back plays exactly the same.
+*******************************************************************************/
+class Difficulty
+{
+	public:
+		static const Difficulty standard;	/*!< The values the game has
+												always played with */
+
+		double base_speed;		/*!< Top speed of an AI paddle when the
+									score is level */
+		double speed_per_point;	/*!< Top speed gained for each point behind */
+		int offset_count;		/*!< Spots along the paddle an AI aims with */
+		double offset_spread;	/*!< Units between those spots */
+
+		/*!
+		 * @brief The constructor. Sets the values the game has always used.
+		 */
+		Difficulty();
+
+		/*!
+		 * @brief Works out the top speed of an AI paddle.
+		 */
+		double paddleSpeed(int behind) const;
+
+		/*!
+		 * @brief Picks a new spot for an AI to line the ball up with.
+		 */
+		double randomOffset(PongRandom& random) const;
+
+		/*!
+		 * @brief Reads a difficulty from a file.
+		 */
+		bool load(const string& path);
+
+		/*!
+		 * @brief Writes the difficulty to a file.
+		 */
+		bool save(const string& path) const;
+};
+
+#endif
@@ -0,0 +1,43 @@
+/***************************************************************************//**
+ * @file File containing the declaration for the DrawRegistry class.
+ *
+ * @brief Contains the declaration for the DrawRegistry class, an interface
+ *		for objects that keep track of what needs to be drawn.
+*******************************************************************************/
+#ifndef _DRAWREGISTRY_H_
+#define _DRAWREGISTRY_H_
+
+/*******************************************************************************
+ *                 DECLARATIONS, INCLUDES, AND NAMESPACES
+*******************************************************************************/
+class DrawRegistry;
+
+#include "Drawable.h"
+
+/*******************************************************************************
+ *                              CLASS INTERFACE
+ ******************************************************************************/
+/*!
+ * @brief Interface for the DrawRegistry class. Declares the functions used to
+ *		register and unregister Drawable objects.
+ *
+ * @details The game logic hands its Drawable objects to a DrawRegistry rather
+ *		than to the window directly, so that it can run without a window at
+ *		all when no registry is given.
+ */
+class DrawRegistry
+{
+	public:
+		/*!
+		 * @brief Registers a Drawable object to be drawn on demand.
+		 */
+		virtual void drawObject(Drawable* obj, int layer = 0) = 0;
+
+		/*!
+		 * @brief Removes an object from the drawing list and no longer draws
+		 *		it. Must be done before the object becomes deallocated.
+		 */
+		virtual void stopDrawingObject(Drawable* obj) = 0;
+};
+
+#endif
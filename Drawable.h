@@ -6,11 +6,6 @@
 #ifndef _DRAWABLE_H_
 #define _DRAWABLE_H_
 
-/*******************************************************************************
- *                 DECLARATIONS, INCLUDES, AND NAMESPACES
-*******************************************************************************/
-#include <GL/freeglut.h>
-
 /*******************************************************************************
  *                              CLASS INTERFACE
  ******************************************************************************/
@@ -19,7 +14,9 @@
  * draw().
  *
  * @details Declares a single virtual function draw() that defines how an object
- * is drawn using GLUT.
+ * is drawn using GLUT. The interface itself does not depend on GLUT, so game
+ * objects can be built without it; their draw() bodies live in separate
+ * *Draw.cpp files.
  */
 class Drawable
 {
@@ -0,0 +1,51 @@
+/***************************************************************************//**
+ * @file File containing empty drawing implementations for the game objects.
+ *
+ * @brief Contains do-nothing draw() functions for the Ball, Paddle, and Board
+ *		classes, and the Board's releaseText(). Linked in place of
+ *		BallDraw.cpp, PaddleDraw.cpp, and BoardDraw.cpp by programs that run
+ *		the game without a window.
+*******************************************************************************/
+
+/*******************************************************************************
+ *                 DECLARATIONS, INCLUDES, AND NAMESPACES
+*******************************************************************************/
+#include "Ball.h"
+#include "Board.h"
+#include "Paddle.h"
+
+/*******************************************************************************
+ *                          FUNCTION DEFINITIONS
+*******************************************************************************/
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Does nothing. There is nothing to draw to.
+*******************************************************************************/
+void Ball::draw()
+{ }
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Does nothing. There is nothing to draw to.
+*******************************************************************************/
+void Paddle::draw()
+{ }
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Does nothing. There is nothing to draw to.
+*******************************************************************************/
+void Board::draw()
+{ }
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Does nothing. Nothing was drawn, so there is nothing to
+ *		free.
+*******************************************************************************/
+void Board::releaseText()
+{ }
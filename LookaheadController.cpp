@@ -0,0 +1,429 @@
+/***************************************************************************//**
+ * @file File containing the implementation of the LookaheadController class.
+ *
+ * @brief Contains the implementation for the LookaheadController class.
+*******************************************************************************/
+
+/*******************************************************************************
+ *                 DECLARATIONS, INCLUDES, AND NAMESPACES
+*******************************************************************************/
+#include <cmath>
+#include "LookaheadController.h"
+#include "PongGame.h"
+
+const int LookaheadController::sample_count;
+const long LookaheadController::step_budget;
+
+/*!
+ * @brief A move tried each step
+ */
+struct LookaheadMove
+{
+	int direction;	/*!< 1 up, -1 down, 0 not at all */
+	long hold;		/*!< Steps to keep moving that way before following the
+						ball home, 0 to follow it from the start */
+};
+
+/*!
+ * @brief Moves tried each step. Following the ball comes first so that it
+ *		wins a tie; put off until later, it would always seem as good.
+ */
+static const LookaheadMove lookahead_moves[] = { { 0, 0 }, { 0, 4 },
+	{ 1, 4 }, { -1, 4 }, { 0, 16 }, { 1, 16 }, { -1, 16 } };
+
+/*!
+ * @brief Number of moves tried each step
+ */
+static const int lookahead_move_count = sizeof(lookahead_moves)
+	/ sizeof(lookahead_moves[0]);
+
+/*******************************************************************************
+ *                          FUNCTION DEFINITIONS
+*******************************************************************************/
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: The constructor. Makes the game that moves are played
+ *		out in, and sets it up once with a ball and controllers like the
+ *		ones it will be copied into, so that copying into it later never has
+ *		to make them again. In it this paddle is played by keys, and the
+ *		other side as it is here, or as standIn() has it, with the same
+ *		difficulty.
+ *
+ * @param[in]	game - Game the paddle is in.
+ * @param[in]	paddle - Pointer to paddle that this controller controls.
+ * @param[in]	ball - Pointer to the ball object to track.
+ * @param[in]	other_ai - True if the AI has the other paddle.
+ * @param[in]	other_kind - AIKind of the other paddle's AI.
+*******************************************************************************/
+LookaheadController::LookaheadController(PongGame* game, Paddle* paddle,
+	Ball* ball, bool other_ai, int other_kind) :
+game(game), paddle(paddle), ball(ball), steps(0)
+{
+	right = paddle == game->getRightPaddle();
+	other_kind = standIn(other_kind);
+
+	Board* board = game->getBoard();
+	sim.reset(new (nothrow) PongGame(board->getWidth(), board->getHeight()));
+	if (!sim) return;
+	sim->setDifficulty(game->getDifficulty());
+
+	PongState& state = samples[0];
+	sim->saveState(state);
+	state.game_active = 1;
+	state.left_ai = right ? other_ai : 0;
+	state.right_ai = right ? 0 : other_ai;
+	state.left_ai_kind = right ? other_kind : 0;
+	state.right_ai_kind = right ? 0 : other_kind;
+	sim->restoreState(state);
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: The destructor. Defined here, where PongGame is
+ *		complete, so that sim can free the game moves are played out in.
+*******************************************************************************/
+LookaheadController::~LookaheadController()
+{ }
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Does nothing. Fulfills superclass requirements.
+*******************************************************************************/
+void LookaheadController::keyDown(unsigned char key)
+{ }
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Does nothing. Fulfills superclass requirements.
+*******************************************************************************/
+void LookaheadController::keyUp(unsigned char key)
+{ }
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Does nothing. Fulfills superclass requirements.
+*******************************************************************************/
+void LookaheadController::keySpecialDown(int key)
+{ }
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Does nothing. Fulfills superclass requirements.
+*******************************************************************************/
+void LookaheadController::keySpecialUp(int key)
+{ }
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Does nothing. Fulfills superclass requirements. Draws no
+ *		random numbers, since the moves played out already try the ball
+ *		coming off the paddle at every height.
+*******************************************************************************/
+void LookaheadController::ballHit()
+{ }
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Determines if the ball is heading toward the paddle.
+ *
+ * @returns True if it is, false if it is heading the other way or waiting
+ *		to be served.
+*******************************************************************************/
+bool LookaheadController::coming()
+{
+	double dx = ball->x_velocity * ball->s_velocity;
+	return right ? dx > 0 : dx < 0;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Gets where the paddle would go without looking ahead:
+ *		where the ball will cross it, or the middle while the ball heads the
+ *		other way, kept in bounds.
+ *
+ * @returns Height to move the center of the paddle to.
+*******************************************************************************/
+double LookaheadController::target()
+{
+	double y = PredictiveController::crossingHeight(ball, paddle);
+	double highest = paddle->getHighestY();
+	double lowest = paddle->getLowestY();
+	if (y > highest) y = highest;
+	if (y < lowest) y = lowest;
+	return y;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Works out which way to move a paddle, a whole step at a
+ *		time, to follow the ball home: toward where the ball will cross it,
+ *		unless it is already within a step of there.
+ *
+ * @param[in]	ball - The ball.
+ * @param[in]	paddle - The paddle.
+ *
+ * @returns Direction to move: 1 up, -1 down, 0 not at all.
+*******************************************************************************/
+int LookaheadController::follow(Ball* ball, Paddle* paddle)
+{
+	double gap = PredictiveController::crossingHeight(ball, paddle)
+		- paddle->getY();
+	double speed = paddle->getVerticalSpeed();
+	return gap > speed ? 1 : (gap < -speed ? -1 : 0);
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Gets the AIKind that plays the other side in play-outs.
+ *		Another LookaheadController is played by a PredictiveController so
+ *		that play-outs never nest, and so are the AIs that play a policy or
+ *		network, since the game played out in has none loaded.
+ *
+ * @param[in]	kind - AIKind of the other side.
+ *
+ * @returns The AIKind to play it with.
+*******************************************************************************/
+int LookaheadController::standIn(int kind)
+{
+	return kind == AI_FOLLOW ? AI_FOLLOW : AI_PREDICT;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Copies the game into the states to play out from, one
+ *		for each sample with its own random numbers, then plays every move
+ *		out from each and adds up how they went. The step budget is split
+ *		evenly between the play-outs.
+ *
+ *		The states are set up the way the constructor set up the game they
+ *		are played in, so copying them in never makes a new controller. A
+ *		play-out that ended the match would free that game's ball, so the
+ *		scores copied are also kept short of winning; a play-out stops at
+ *		the first point, so the only other thing that can change is when
+ *		paddles start to shrink, a hit or so sooner.
+ *
+ * @returns Direction to move the paddle this step: 1 up, -1 down, 0 not at
+ *		all.
+*******************************************************************************/
+int LookaheadController::plan()
+{
+	PongState& first = samples[0];
+	game->saveState(first);
+	if (right)
+	{
+		first.right_ai = 0;
+		first.right_ai_kind = 0;
+		first.left_ai_kind = standIn(first.left_ai_kind);
+	}
+	else
+	{
+		first.left_ai = 0;
+		first.left_ai_kind = 0;
+		first.right_ai_kind = standIn(first.right_ai_kind);
+	}
+	if (first.left_score > 8) first.left_score = 8;
+	if (first.right_score > 8) first.right_score = 8;
+
+	for (int s = 1; s < sample_count; s++)
+	{
+		samples[s] = first;
+		samples[s].random_state += 0x9e3779b97f4a7c15ULL * (uint64_t) s;
+	}
+	first.random_state ^= 0xbf58476d1ce4e5b9ULL;
+
+	long limit = step_budget / (lookahead_move_count * sample_count);
+	double best = 0;
+	int best_move = 0;
+	for (int i = 0; i < lookahead_move_count; i++)
+	{
+		int direction = lookahead_moves[i].direction;
+		long hold = lookahead_moves[i].hold;
+		if (hold == 0)
+		{
+			direction = follow(ball, paddle);
+			hold = 1;
+		}
+
+		double total = 0;
+		for (int s = 0; s < sample_count; s++)
+		{
+			total += rollout(samples[s], direction, hold, limit);
+		}
+		if (i == 0 || total > best)
+		{
+			best = total;
+			best_move = direction;
+		}
+	}
+	return best_move;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Plays one move out from one state: makes the move right
+ *		away, as the paddle would this step, holds it, then follows where
+ *		the ball will cross. Stops at a point, at the paddle hitting the
+ *		ball, or after the given number of steps, and scores how it went.
+ *
+ *		A point is worth the most, the sooner the better for and the later
+ *		the better against. A hit is worth less, plus how far short the
+ *		other paddle would fall of where the ball will reach it, moving at
+ *		full speed the whole way. Running out of steps loses how far the
+ *		paddle still is from where the ball will cross it.
+ *
+ * @param[in]	start - State to play out from.
+ * @param[in]	move - Direction to move: 1 up, -1 down, 0 not at all.
+ * @param[in]	hold - Steps to keep moving that way for.
+ * @param[in]	limit - Most steps to play out.
+ *
+ * @returns How well the move went; higher is better.
+*******************************************************************************/
+double LookaheadController::rollout(const PongState& start, int move,
+	long hold, long limit)
+{
+	sim->restoreState(start);
+	Paddle* mine = right ? sim->getRightPaddle() : sim->getLeftPaddle();
+	Paddle* theirs = right ? sim->getLeftPaddle() : sim->getRightPaddle();
+	Ball* sim_ball = sim->getBall();
+	int shift = right ? 4 : 0;
+	unsigned char held = sim->getInput() & ~(15 << shift);
+	double unit = PongGame::unit;
+
+	mine->verticalMotion(move * mine->getVerticalSpeed());
+
+	for (long t = 1; t <= limit; t++)
+	{
+		int keys = t < hold ? move : follow(sim_ball, mine);
+		unsigned char input = keys > 0 ? 1 : (keys < 0 ? 2 : 0);
+		sim->setInput(held | input << shift);
+		sim->step();
+
+		if (sim->getLeftScore() != start.left_score
+			|| sim->getRightScore() != start.right_score)
+		{
+			bool ours = (right ? sim->getRightScore() : sim->getLeftScore())
+				!= (right ? start.right_score : start.left_score);
+			return ours ? 1000.0 - t : -1000.0 + t;
+		}
+
+		double dx = sim_ball->x_velocity * sim_ball->s_velocity;
+		if (right ? dx < 0 : dx > 0)
+		{
+			// Hit; how far the other side has to go and how far it can
+			double cross = PredictiveController::crossingHeight(sim_ball, theirs);
+			double time = fabs(theirs->getX() - sim_ball->center_x) / fabs(dx);
+			double reach = time * theirs->getVerticalSpeed()
+				+ theirs->getHeight() / 2.0;
+			double need = fabs(cross - theirs->getY());
+			return 500.0 + (need - reach) / unit;
+		}
+	}
+
+	return -fabs(PredictiveController::crossingHeight(sim_ball, mine)
+		- mine->getY()) / unit;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Moves the paddle. While the ball is coming, makes the
+ *		move that plays out best; otherwise goes to where it would without
+ *		looking ahead, straight there if it can get there this step and at
+ *		full speed if not.
+*******************************************************************************/
+void LookaheadController::step()
+{
+	steps++;
+
+	if (ball == NULL) return;		// This is entirely a possibility
+
+	double speed = paddle->getVerticalSpeed();
+	int move = 0;
+	if (sim && coming())
+	{
+		move = plan();
+	}
+	else
+	{
+		double to = target();
+		double y = paddle->getY();
+		if (fabs(to - y) <= speed)
+		{
+			paddle->verticalPosition(to);
+			return;
+		}
+		move = to > y ? 1 : -1;
+	}
+	paddle->verticalMotion(move * speed);
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Counts how many of the coming steps the paddle surely
+ *		waits where it is: while the ball isn't coming and the paddle is
+ *		already where it would go. Any step the ball is coming is planned.
+ *
+ * @param[in]	limit - Most steps to count.
+ *
+ * @returns Number of steps, up to limit, that skip() may be given.
+*******************************************************************************/
+long LookaheadController::quietSteps(long limit)
+{
+	if (ball == NULL) return limit;
+	if (sim && coming()) return 0;
+	return paddle->getY() == target() ? limit : 0;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Does what the given number of steps would. Only valid
+ *		for as many steps as quietSteps() allows, in which the paddle waits.
+ *
+ * @param[in]	steps - Number of steps to skip.
+*******************************************************************************/
+void LookaheadController::skip(long steps)
+{
+	if (steps <= 0) return;
+	this -> steps += steps;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Copies everything the AI remembers from step to step
+ *		into a ControllerState, which is only the number of steps taken;
+ *		every move is worked out afresh from the game.
+ *
+ * @param[out]	state - Where to copy it.
+*******************************************************************************/
+void LookaheadController::getState(ControllerState& state)
+{
+	state.steps = steps;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Puts back what getState() copied.
+ *
+ * @param[in]	state - What to put back.
+*******************************************************************************/
+void LookaheadController::setState(const ControllerState& state)
+{
+	steps = (long) state.steps;
+}
@@ -0,0 +1,161 @@
+/***************************************************************************//**
+ * @file File containing the declaration for the LookaheadController class.
+ *
+ * @brief Contains the declaration for the LookaheadController class.
+*******************************************************************************/
+#ifndef _LOOKAHEADCONTROLLER_H_
+#define _LOOKAHEADCONTROLLER_H_
+
+/*******************************************************************************
+ *                 DECLARATIONS, INCLUDES, AND NAMESPACES
+*******************************************************************************/
+class LookaheadController;
+class PongGame;
+
+#include <memory>
+#include "PaddleController.h"
+#include "PongState.h"
+#include "Paddle.h"
+#include "Ball.h"
+
+using namespace std;
+
+/***************************************************************************//**
+ * @brief The LookaheadController class moves a pong paddle by trying out
+ *		moves on a copy of the game and keeping the one that plays out best.
+ *
+ * @details The hardest AI. While the ball heads toward its paddle it copies
+ *		the whole game into a game of its own every step and plays a few
+ *		moves forward from it: up, down, or staying put, held for a few
+ *		steps before following the ball home. Each move is played out from
+ *		a couple of copies whose random numbers differ, so that serves and
+ *		the other side's offsets that haven't been drawn yet don't decide it.
+ *		A play-out ends when a point is scored, when the paddle hits the
+ *		ball, where it counts for more the less chance the other side has of
+ *		getting there, or when it runs out of steps. The paddle then makes
+ *		the first move of the best.
+ *
+ *		Every step plays out the same number of steps in all, about 200
+ *		microseconds' worth, rather than stopping at a time limit, so that
+ *		a game plays out the same however fast the machine is and can be
+ *		replayed, rolled back and checked like any other. The copy of the
+ *		game and the states played out from are made once, with the
+ *		controller, so stepping it never touches the heap. While the ball
+ *		heads the other way the paddle waits in the middle.
+*******************************************************************************/
+class LookaheadController : public PaddleController
+{
+	public:
+		static const int sample_count = 2;		/*!< Copies each move is
+													played out from */
+		static const long step_budget = 2048;	/*!< Steps played out each
+													step, in all */
+
+	private:
+		PongGame* game;		/*!< Game the paddle is in */
+		Paddle* paddle;		/*!< Pointer to paddle under AI control */
+		Ball* ball;			/*!< Pointer to ball to watch */
+		bool right;			/*!< True if the paddle is the right one */
+		long steps;			/*!< Number of steps taken */
+		unique_ptr<PongGame> sim;	/*!< Game moves are played out in, empty
+										if it couldn't be made */
+		PongState samples[sample_count];	/*!< States moves are played out
+												from this step */
+
+		/*!
+		 * @brief Determines if the ball is heading toward the paddle.
+		 */
+		bool coming();
+
+		/*!
+		 * @brief Gets where the paddle would go without looking ahead.
+		 */
+		double target();
+
+		/*!
+		 * @brief Gets the AIKind that plays the other side in play-outs.
+		 */
+		static int standIn(int kind);
+
+		/*!
+		 * @brief Works out which way to move a paddle to follow the ball
+		 *		home.
+		 */
+		static int follow(Ball* ball, Paddle* paddle);
+
+		/*!
+		 * @brief Plays every move out and picks the best.
+		 */
+		int plan();
+
+		/*!
+		 * @brief Plays one move out from one state.
+		 */
+		double rollout(const PongState& start, int move, long hold,
+			long limit);
+
+	public:
+		/*!
+		 * @brief The constructor. Makes the game moves are played out in.
+		 */
+		LookaheadController(PongGame* game, Paddle* paddle, Ball* ball,
+			bool other_ai, int other_kind);
+
+		/*!
+		 * @brief The destructor. Frees the game moves are played out in.
+		 */
+		~LookaheadController();
+
+		/*!
+		 * @brief Does nothing; fulfulls superclass requirements
+		 */
+		void keyDown(unsigned char key);
+
+		/*!
+		 * @brief Does nothing; fulfulls superclass requirements
+		 */
+		void keyUp(unsigned char key);
+
+		/*!
+		 * @brief Does nothing; fulfulls superclass requirements
+		 */
+		void keySpecialDown(int key);
+
+		/*!
+		 * @brief Does nothing; fulfulls superclass requirements
+		 */
+		void keySpecialUp(int key);
+
+		/*!
+		 * @brief Does nothing; fulfulls superclass requirements
+		 */
+		void ballHit();
+
+		/*!
+		 * @brief Makes the move that plays out best.
+		 */
+		void step();
+
+		/*!
+		 * @brief Counts the steps ahead in which the paddle surely keeps
+		 *		waiting.
+		 */
+		long quietSteps(long limit);
+
+		/*!
+		 * @brief Moves the paddle to where a number of steps would.
+		 */
+		void skip(long steps);
+
+		/*!
+		 * @brief Copies the step count into a ControllerState.
+		 */
+		void getState(ControllerState& state);
+
+		/*!
+		 * @brief Puts back what getState() copied.
+		 */
+		void setState(const ControllerState& state);
+};
+
+#endif
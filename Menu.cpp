@@ -154,20 +154,22 @@ void Menu::click( int button, int state, int x, int y )
  *****************************************************************************/
 void Menu::draw()
 {
+	Renderer* out = Pong::getInstance()->getRenderer();
+
 	// Draw transparent overlay
 	//glColor4d( 0.0, 0.0, 0.0, 0.5 );
 	//glRectd( 0, 0, Pong::getInstance()->getViewWidth(), Pong::getInstance()->getViewHeight() );
 	
 	// Draw border
-	glColor3d( 1.0, 1.0, 1.0 );
-	glRectd( x, y, x + width, y + height );
+	out->color( 1.0, 1.0, 1.0 );
+	out->rect( x, y, x + width, y + height );
 	
 	// Draw black background
-	glColor3d( 0.0, 0.0, 0.0 );
-    glRectd( x + border, y + border, x + width - border, y + height - border);
+	out->color( 0.0, 0.0, 0.0 );
+    out->rect( x + border, y + border, x + width - border, y + height - border);
     
     // Draw title and menu items
-	glColor3d( 1.0, 1.0, 1.0 );
+	out->color( 1.0, 1.0, 1.0 );
     title.draw();
     for (MenuItem* item : items)
     {
@@ -142,15 +142,17 @@ bool MenuItem::click( int button, int state, int x, int y )
  *****************************************************************************/
 void MenuItem::draw()
 {
+	Renderer* out = Pong::getInstance()->getRenderer();
+
 	// Draw the border
-	glColor3d( 1.0, 1.0, 1.0 );
-	glRectd( x, y, x + (width), y + ( height ) );
+	out->color( 1.0, 1.0, 1.0 );
+	out->rect( x, y, x + (width), y + ( height ) );
 	
 	// Draw black background
-	glColor3d( 0.0, 0.0, 0.0 );
-    glRectd( x + border, y + border, x + width - border, y + height - border );
+	out->color( 0.0, 0.0, 0.0 );
+    out->rect( x + border, y + border, x + width - border, y + height - border );
     
     // Draw the text
-	glColor3d( 1.0, 1.0, 1.0 );
+	out->color( 1.0, 1.0, 1.0 );
 	text.draw();
 }
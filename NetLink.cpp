@@ -0,0 +1,305 @@
+/***************************************************************************//**
+ * @file File containing the implementation of the NetLink class.
+ *
+ * @brief Contains the implementation for the NetLink class.
+*******************************************************************************/
+
+/*******************************************************************************
+ *                 DECLARATIONS, INCLUDES, AND NAMESPACES
+*******************************************************************************/
+#include <cstring>
+#include <utility>
+#include <fcntl.h>
+#include <netdb.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include "NetLink.h"
+
+/*******************************************************************************
+ *                          FUNCTION DEFINITIONS
+*******************************************************************************/
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: The constructor. Makes a link that isn't open yet, with
+ *		perfect conditions.
+*******************************************************************************/
+NetLink::NetLink() :
+socket_fd(-1), have_peer(false), latency(0), jitter(0), loss(0),
+packets_sent(0), packets_dropped(0)
+{
+	memset(&peer, 0, sizeof(peer));
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: The destructor. Closes the socket. Packets still being
+ *		held back are never sent.
+*******************************************************************************/
+NetLink::~NetLink()
+{
+	if (socket_fd >= 0) close(socket_fd);
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Opens a non-blocking UDP socket bound to a port on every
+ *		address of this machine.
+ *
+ * @param[in]	port - Port to bind to, 0 for any free one.
+ *
+ * @returns True if the socket was opened, false if not.
+*******************************************************************************/
+bool NetLink::open(int port)
+{
+	if (socket_fd >= 0) close(socket_fd);
+
+	socket_fd = socket(AF_INET, SOCK_DGRAM, 0);
+	if (socket_fd < 0) return false;
+
+	sockaddr_in address;
+	memset(&address, 0, sizeof(address));
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_ANY);
+	address.sin_port = htons((uint16_t) port);
+	if (bind(socket_fd, (sockaddr*) &address, sizeof(address)) != 0
+		|| fcntl(socket_fd, F_SETFL, O_NONBLOCK) != 0)
+	{
+		close(socket_fd);
+		socket_fd = -1;
+		return false;
+	}
+	return true;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Opens the link on a port and waits for a peer. Whoever
+ *		sends the first packet received becomes the peer.
+ *
+ * @param[in]	port - Port to listen on.
+ *
+ * @returns True if the port could be opened, false if not.
+*******************************************************************************/
+bool NetLink::listen(int port)
+{
+	have_peer = false;
+	return open(port);
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Opens the link on any free port and sends everything to
+ *		a peer listening on a host and port.
+ *
+ * @param[in]	host - Name or address of the peer's machine.
+ * @param[in]	port - Port the peer is listening on.
+ *
+ * @returns True if the host was found and the link opened, false if not.
+*******************************************************************************/
+bool NetLink::connect(const char* host, int port)
+{
+	addrinfo hints;
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_INET;
+	hints.ai_socktype = SOCK_DGRAM;
+
+	addrinfo* found = NULL;
+	if (getaddrinfo(host, NULL, &hints, &found) != 0 || found == NULL)
+	{
+		return false;
+	}
+	memcpy(&peer, found->ai_addr, sizeof(peer));
+	peer.sin_port = htons((uint16_t) port);
+	freeaddrinfo(found);
+
+	have_peer = open(0);
+	return have_peer;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Makes the link behave like a worse network. Every packet
+ *		sent afterwards is dropped with probability loss, or else held back
+ *		for latency_ms plus a random amount up to jitter_ms.
+ *
+ * @param[in]	latency_ms - Milliseconds every packet is held back.
+ * @param[in]	jitter_ms - Most extra milliseconds a packet is held back.
+ * @param[in]	loss - Fraction of packets dropped, 0 to 1.
+ * @param[in]	seed - OPTIONAL. Seed for which packets are dropped and how
+ *				late each is.
+*******************************************************************************/
+void NetLink::setConditions(double latency_ms, double jitter_ms, double loss,
+	uint64_t seed)
+{
+	latency = latency_ms > 0 ? latency_ms / 1000 : 0;
+	jitter = jitter_ms > 0 ? jitter_ms / 1000 : 0;
+	this -> loss = loss > 0 ? loss : 0;
+	random.seed(seed);
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Sends a packet to the peer, or drops or holds it back
+ *		if the link has been given conditions. Does nothing until there is
+ *		a peer.
+ *
+ * @param[in]	data - The packet.
+ * @param[in]	size - Size of the packet in bytes.
+*******************************************************************************/
+void NetLink::send(const unsigned char* data, size_t size)
+{
+	if (!have_peer) return;
+	packets_sent++;
+
+	if (loss > 0 && random.next() < loss * 4294967296.0)
+	{
+		packets_dropped++;
+		return;
+	}
+	if (latency <= 0 && jitter <= 0)
+	{
+		sendNow(data, size);
+		return;
+	}
+
+	double delay = latency + jitter * (random.next() / 4294967296.0);
+	NetDelayed packet;
+	packet.due = chrono::steady_clock::now()
+		+ chrono::duration_cast<chrono::steady_clock::duration>(
+			chrono::duration<double>(delay));
+	packet.data.assign(data, data + size);
+	delayed.push_back(packet);
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Sends a packet to the peer right away. A packet the
+ *		socket has no room for is lost, as it would be on a network.
+ *
+ * @param[in]	data - The packet.
+ * @param[in]	size - Size of the packet in bytes.
+*******************************************************************************/
+void NetLink::sendNow(const unsigned char* data, size_t size)
+{
+	sendto(socket_fd, data, size, 0, (const sockaddr*) &peer, sizeof(peer));
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Sends every packet being held back whose time has come.
+*******************************************************************************/
+void NetLink::sendDue()
+{
+	if (delayed.empty()) return;
+
+	chrono::steady_clock::time_point now = chrono::steady_clock::now();
+	size_t kept = 0;
+	for (size_t i = 0; i < delayed.size(); i++)
+	{
+		if (delayed[i].due <= now)
+		{
+			sendNow(&delayed[i].data[0], delayed[i].data.size());
+		}
+		else
+		{
+			if (kept != i) swap(delayed[kept], delayed[i]);
+			kept++;
+		}
+	}
+	delayed.resize(kept);
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Gets the next packet that has arrived from the peer, if
+ *		there is one, without waiting. Packets from anywhere else are thrown
+ *		away. Also sends any packets being held back that are due.
+ *
+ * @param[out]	buffer - Where to put the packet.
+ * @param[in]	size - Room in the buffer. Longer packets are cut short.
+ *
+ * @returns Size of the packet, or -1 if nothing has arrived.
+*******************************************************************************/
+long NetLink::receive(unsigned char* buffer, size_t size)
+{
+	if (socket_fd < 0) return -1;
+	sendDue();
+
+	while (true)
+	{
+		sockaddr_in from;
+		socklen_t from_size = sizeof(from);
+		ssize_t got = recvfrom(socket_fd, buffer, size, 0, (sockaddr*) &from,
+			&from_size);
+		if (got < 0) return -1;
+
+		// The first to reach a listening link becomes its peer
+		if (!have_peer)
+		{
+			peer = from;
+			have_peer = true;
+		}
+		if (from.sin_addr.s_addr == peer.sin_addr.s_addr
+			&& from.sin_port == peer.sin_port)
+		{
+			return (long) got;
+		}
+	}
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Gets the port the link is bound to, which is worth
+ *		knowing when it was opened on any free one.
+ *
+ * @returns The port, or 0 if the link isn't open.
+*******************************************************************************/
+int NetLink::getPort()
+{
+	sockaddr_in address;
+	socklen_t address_size = sizeof(address);
+	if (socket_fd < 0 || getsockname(socket_fd, (sockaddr*) &address,
+		&address_size) != 0)
+	{
+		return 0;
+	}
+	return ntohs(address.sin_port);
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Gets the number of packets handed to send() since the
+ *		link was made, including any dropped.
+ *
+ * @returns Number of packets.
+*******************************************************************************/
+long NetLink::getPacketsSent()
+{
+	return packets_sent;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Gets the number of packets dropped by the conditions
+ *		given to setConditions().
+ *
+ * @returns Number of packets.
+*******************************************************************************/
+long NetLink::getPacketsDropped()
+{
+	return packets_dropped;
+}
@@ -0,0 +1,129 @@
+/***************************************************************************//**
+ * @file File containing the declaration for the NetLink class.
+ *
+ * @brief Contains the declaration for the NetLink class, a UDP connection to
+ *		one other game that can pretend to be a worse network than it is.
+*******************************************************************************/
+#ifndef _NETLINK_H_
+#define _NETLINK_H_
+
+/*******************************************************************************
+ *                 DECLARATIONS, INCLUDES, AND NAMESPACES
+*******************************************************************************/
+class NetLink;
+
+#include <vector>
+#include <chrono>
+#include <stddef.h>
+#include <netinet/in.h>
+#include "PongRandom.h"
+
+using namespace std;
+
+/*!
+ * @brief A packet held back by NetLink to make it arrive late
+ */
+struct NetDelayed
+{
+	chrono::steady_clock::time_point due;	/*!< When to really send it */
+	vector<unsigned char> data;		/*!< What to send */
+};
+
+/***************************************************************************//**
+ * @brief The NetLink class sends and receives packets to and from one other
+ *		game over UDP.
+ *
+ * @details One side listens on a port and takes whoever sends to it first
+ *		as its peer; the other connects to it. The socket never blocks:
+ *		receive() returns at once whether or not anything has arrived.
+ *
+ *		For testing on one machine, a link can be given a latency, a jitter,
+ *		and a loss rate. Each packet sent is then dropped with the loss rate
+ *		or held back for the latency plus up to the jitter, so packets also
+ *		arrive out of order. Only packets sent are affected, so to make both
+ *		directions bad, give both sides the same conditions.
+*******************************************************************************/
+class NetLink
+{
+	private:
+		int socket_fd;		/*!< The UDP socket, -1 if not open */
+		sockaddr_in peer;	/*!< Where packets are sent */
+		bool have_peer;		/*!< True once there is somewhere to send */
+		double latency;		/*!< Seconds every packet is held back */
+		double jitter;		/*!< Most extra seconds a packet is held back */
+		double loss;		/*!< Fraction of packets dropped */
+		PongRandom random;	/*!< Decides which packets are dropped and how
+								late they are */
+		vector<NetDelayed> delayed;	/*!< Packets being held back */
+		long packets_sent;	/*!< Packets handed to send() */
+		long packets_dropped;	/*!< Packets dropped on purpose */
+
+		/*!
+		 * @brief Opens the socket, bound to a port
+		 */
+		bool open(int port);
+
+		/*!
+		 * @brief Sends a packet right away
+		 */
+		void sendNow(const unsigned char* data, size_t size);
+
+		/*!
+		 * @brief Sends the packets held back that are due
+		 */
+		void sendDue();
+
+	public:
+		/*!
+		 * @brief The constructor. Makes a link that isn't open
+		 */
+		NetLink();
+
+		/*!
+		 * @brief The destructor. Closes the socket
+		 */
+		~NetLink();
+
+		/*!
+		 * @brief Waits for a peer on a port
+		 */
+		bool listen(int port);
+
+		/*!
+		 * @brief Connects to a peer listening on a host and port
+		 */
+		bool connect(const char* host, int port);
+
+		/*!
+		 * @brief Makes the link drop and delay packets sent
+		 */
+		void setConditions(double latency_ms, double jitter_ms, double loss,
+			uint64_t seed = 0);
+
+		/*!
+		 * @brief Sends a packet to the peer
+		 */
+		void send(const unsigned char* data, size_t size);
+
+		/*!
+		 * @brief Gets the next packet from the peer, if any has arrived
+		 */
+		long receive(unsigned char* buffer, size_t size);
+
+		/*!
+		 * @brief Gets the port the link is bound to
+		 */
+		int getPort();
+
+		/*!
+		 * @brief Gets the number of packets sent
+		 */
+		long getPacketsSent();
+
+		/*!
+		 * @brief Gets the number of packets dropped on purpose
+		 */
+		long getPacketsDropped();
+};
+
+#endif
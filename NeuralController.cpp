@@ -0,0 +1,143 @@
+/***************************************************************************//**
+ * @file File containing the implementation of the NeuralController class.
+ *
+ * @brief Contains the implementation for the NeuralController class.
+*******************************************************************************/
+
+/*******************************************************************************
+ *                 DECLARATIONS, INCLUDES, AND NAMESPACES
+*******************************************************************************/
+#include "NeuralController.h"
+
+/*******************************************************************************
+ *                          FUNCTION DEFINITIONS
+*******************************************************************************/
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: The constructor. Initializes variables.
+ *
+ * @param[in]	paddle - Pointer to paddle that this controller controls.
+ * @param[in]	ball - Pointer to the ball object to track.
+ * @param[in]	net - Network that works out moves; must outlast the
+ *				controller.
+*******************************************************************************/
+NeuralController::NeuralController(Paddle* paddle, Ball* ball,
+	const PaddleNet* net) :
+paddle(paddle), ball(ball), net(net), steps(0)
+{ }
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Does nothing. Fulfills superclass requirements.
+*******************************************************************************/
+void NeuralController::keyDown(unsigned char key)
+{ }
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Does nothing. Fulfills superclass requirements.
+*******************************************************************************/
+void NeuralController::keyUp(unsigned char key)
+{ }
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Does nothing. Fulfills superclass requirements.
+*******************************************************************************/
+void NeuralController::keySpecialDown(int key)
+{ }
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Does nothing. Fulfills superclass requirements.
+*******************************************************************************/
+void NeuralController::keySpecialUp(int key)
+{ }
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Does nothing. Fulfills superclass requirements.
+*******************************************************************************/
+void NeuralController::ballHit()
+{ }
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Moves the paddle as far as the network says to. The
+ *		move is made after the ball has moved, as a player's key would be
+ *		before the ball's next move, which is how pong-train trained it.
+*******************************************************************************/
+void NeuralController::step()
+{
+	steps++;
+
+	if (ball == NULL || net == NULL || !net->isLoaded()) return;
+
+	float input[PaddleNet::input_count];
+	PaddleNet::features(ball, paddle, input);
+	float move = net->evaluate(input);
+	if (move != 0)
+		paddle->verticalMotion(move * paddle->getVerticalSpeed());
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Counts how many of the coming steps the controller can
+ *		be skipped over. The network may move on any step, so none can while
+ *		there is a ball.
+ *
+ * @param[in]	limit - Most steps to count.
+ *
+ * @returns Number of steps, up to limit, that skip() may be given.
+*******************************************************************************/
+long NeuralController::quietSteps(long limit)
+{
+	if (ball == NULL || net == NULL || !net->isLoaded()) return limit;
+	return 0;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Does what the given number of steps would while
+ *		quietSteps() allows them, which is only count them.
+ *
+ * @param[in]	steps - Number of steps to skip.
+*******************************************************************************/
+void NeuralController::skip(long steps)
+{
+	if (steps > 0) this -> steps += steps;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Copies everything the AI remembers from step to step
+ *		into a ControllerState, which is only the number of steps taken.
+ *
+ * @param[out]	state - Where to copy it.
+*******************************************************************************/
+void NeuralController::getState(ControllerState& state)
+{
+	state.steps = steps;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Puts back what getState() copied.
+ *
+ * @param[in]	state - What to put back.
+*******************************************************************************/
+void NeuralController::setState(const ControllerState& state)
+{
+	steps = (long) state.steps;
+}
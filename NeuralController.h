@@ -0,0 +1,93 @@
+/***************************************************************************//**
+ * @file File containing the declaration for the NeuralController class.
+ *
+ * @brief Contains the declaration for the NeuralController class.
+*******************************************************************************/
+#ifndef _NEURALCONTROLLER_H_
+#define _NEURALCONTROLLER_H_
+
+/*******************************************************************************
+ *                 DECLARATIONS, INCLUDES, AND NAMESPACES
+*******************************************************************************/
+class NeuralController;
+
+#include "PaddleController.h"
+#include "Paddle.h"
+#include "Ball.h"
+#include "PaddleNet.h"
+
+/***************************************************************************//**
+ * @brief The NeuralController class moves a pong paddle the way a PaddleNet
+ *		trained by pong-train says to.
+ *
+ * @details Every step it gives the network the ball and paddle and moves
+ *		the paddle by the network's answer, a fraction of its full speed up
+ *		or down. Since the move can change on any step, none are skipped.
+*******************************************************************************/
+class NeuralController : public PaddleController
+{
+	private:
+		Paddle* paddle;			/*!< Pointer to paddle under AI control */
+		Ball* ball;				/*!< Pointer to ball to watch */
+		const PaddleNet* net;	/*!< Network that works out moves */
+		long steps;				/*!< Number of steps taken */
+
+	public:
+		/*!
+		 * @brief The constructor. Initializes variables.
+		 */
+		NeuralController(Paddle* paddle, Ball* ball, const PaddleNet* net);
+
+		/*!
+		 * @brief Does nothing; fulfulls superclass requirements
+		 */
+		void keyDown(unsigned char key);
+
+		/*!
+		 * @brief Does nothing; fulfulls superclass requirements
+		 */
+		void keyUp(unsigned char key);
+
+		/*!
+		 * @brief Does nothing; fulfulls superclass requirements
+		 */
+		void keySpecialDown(int key);
+
+		/*!
+		 * @brief Does nothing; fulfulls superclass requirements
+		 */
+		void keySpecialUp(int key);
+
+		/*!
+		 * @brief Does nothing; fulfulls superclass requirements
+		 */
+		void ballHit();
+
+		/*!
+		 * @brief Makes the network's move.
+		 */
+		void step();
+
+		/*!
+		 * @brief Counts the steps ahead that could be skipped; none while
+		 *		there is a ball.
+		 */
+		long quietSteps(long limit);
+
+		/*!
+		 * @brief Does what a number of steps without a ball would.
+		 */
+		void skip(long steps);
+
+		/*!
+		 * @brief Copies the step count into a ControllerState.
+		 */
+		void getState(ControllerState& state);
+
+		/*!
+		 * @brief Puts back what getState() copied.
+		 */
+		void setState(const ControllerState& state);
+};
+
+#endif
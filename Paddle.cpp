@@ -33,26 +33,13 @@
  * @param[in]      int miny - the minimum y coordinate for the paddle
  *****************************************************************************/
 Paddle::Paddle(PongGame* game, double x, double y, int width, int height, int maxx, int minx, int maxy, int miny) :
-		game(game), center_x(x), center_y(y), width(width), height(height),
-		up(false), down(false), left(false), right(false), maxx(maxx), minx(minx), maxy(maxy), miny(miny),
-		horizontal_paddle_speed(4), vertical_paddle_speed(4)
+		height(height), width(width),
+		center_x(x), center_y(y), prev_x(x), prev_y(y),
+		maxx(maxx), minx(minx), maxy(maxy), miny(miny),
+		vertical_paddle_speed(4), horizontal_paddle_speed(4), game(game),
+		up(false), down(false), left(false), right(false)
 { }
 
-/**************************************************************************//**
- * @author Daniel Andrus, Johnathan Ackerman
- * 
- * @par Description: 
- * Draws the paddle with the help of the drawable class
- * 
- *****************************************************************************/
-void Paddle::draw()
-{
-	glColor3f( 1.0, 1.0, 1.0 ); // sets color to white
-	//draws paddle
-	glRectd( center_x - (width / 2), center_y -(height / 2), center_x
-		+ (width / 2), center_y + (height / 2 ) );
-}
-
 /**************************************************************************//**
  * @author Daniel Andrus, Johnny Acekerman
  * 
@@ -61,6 +48,10 @@ void Paddle::draw()
  *****************************************************************************/
 void Paddle::step( )
 {
+	// Remember where we were for drawing between steps
+	prev_x = center_x;
+	prev_y = center_y;
+
 	//uses booliens set by keyboard input
 	if( up )
 	{
@@ -80,6 +71,23 @@ void Paddle::step( )
 	}
 };
 
+/**************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: 
+ * Does what the given number of calls to step() would while no keys are
+ * held: the paddle doesn't move by itself, but remembers where it is as
+ * where it was on the previous step.
+ * 
+ * @param[in]      steps - Number of steps to skip
+ *****************************************************************************/
+void Paddle::skip( long steps )
+{
+	if (steps <= 0) return;
+	prev_x = center_x;
+	prev_y = center_y;
+}
+
 /**************************************************************************//**
  * @author Daniel Andrus, Johnny Ackerman
  * 
@@ -106,6 +114,32 @@ double Paddle::getY()
 	return center_y;
 }
 
+/**************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: 
+ * retrieves the x coordinate the paddle had on the previous step
+ * 
+ * @returns x - the horizontal location of the paddle a step ago
+ *****************************************************************************/
+double Paddle::getPrevX()
+{
+	return prev_x;
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: 
+ * retrieves the y coordinate the paddle had on the previous step
+ * 
+ * @returns y - the vertical location of the paddle a step ago
+ *****************************************************************************/
+double Paddle::getPrevY()
+{
+	return prev_y;
+}
+
 /**************************************************************************//**
  * @author Daniel Andrus, Johnny Ackerman
  * 
@@ -136,6 +170,90 @@ int Paddle::getHeight()
 	return height;
 }
 
+/**************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: 
+ * retrieves the max vertical speed of the paddle
+ * 
+ * @returns the most the paddle can move vertically in one step
+ *****************************************************************************/
+double Paddle::getVerticalSpeed()
+{
+	return vertical_paddle_speed;
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: 
+ * retrieves the highest y coordinate the center of the paddle can be at
+ * 
+ * @returns the highest the paddle can go at its current height
+ *****************************************************************************/
+double Paddle::getHighestY()
+{
+	return maxy - height / 2;
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: 
+ * retrieves the lowest y coordinate the center of the paddle can be at
+ * 
+ * @returns the lowest the paddle can go at its current height
+ *****************************************************************************/
+double Paddle::getLowestY()
+{
+	return miny + height / 2;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: Copies everything about the paddle that changes during
+ *		a game into a PaddleState.
+ *
+ * @param[out]	state - Where to copy it.
+*******************************************************************************/
+void Paddle::getState(PaddleState& state)
+{
+	state.center_x = center_x;
+	state.center_y = center_y;
+	state.prev_x = prev_x;
+	state.prev_y = prev_y;
+	state.vertical_speed = vertical_paddle_speed;
+	state.horizontal_speed = horizontal_paddle_speed;
+	state.height = height;
+	state.up = up;
+	state.down = down;
+	state.left = left;
+	state.right = right;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: Puts the paddle back the way getState() found it.
+ *
+ * @param[in]	state - What to put back.
+*******************************************************************************/
+void Paddle::setState(const PaddleState& state)
+{
+	center_x = state.center_x;
+	center_y = state.center_y;
+	prev_x = state.prev_x;
+	prev_y = state.prev_y;
+	vertical_paddle_speed = state.vertical_speed;
+	horizontal_paddle_speed = state.horizontal_speed;
+	height = state.height;
+	up = state.up != 0;
+	down = state.down != 0;
+	left = state.left != 0;
+	right = state.right != 0;
+}
+
 /**************************************************************************//**
  * @author Daniel Andrus, Johnny Ackerman
  * 
@@ -158,7 +276,22 @@ void Paddle::verticalMotion( double speed )
 	}
 
 	//moves paddle
-	center_y += speed;
+	verticalPosition( center_y + speed );
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: 
+ * moves the paddle vertically to the given y coordinate, regardless of its
+ * max speed, as far as it can go without leaving its area
+ * 
+ * 
+ * @param[in]      double y - where to put the center of the paddle
+ *****************************************************************************/
+void Paddle::verticalPosition( double y )
+{
+	center_y = y;
 
 	//makes sure paddle is in bounds of height
 	if (center_y + height / 2 > maxy)
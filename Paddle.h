@@ -13,6 +13,7 @@ class Paddle;
 
 #include "Drawable.h"
 #include "Steppable.h"
+#include "PongState.h"
 #include "PongGame.h"
 
 /****************************************************************************//* 
@@ -28,6 +29,8 @@ class Paddle : public Drawable, public Steppable
 		int width;	/*!< eidth of paddle */
 		double center_x;	/*!< Center x coordinate of paddle */
 		double center_y;	/*!< y coordinate for center of paddle */
+		double prev_x;	/*!< center_x as of the previous step */
+		double prev_y;	/*!< center_y as of the previous step */
 		int maxx;	/*!< Max x possition */
 		int minx;	/*!< min x possition */
 		int maxy;	/*!< max y possition */
@@ -54,11 +57,21 @@ class Paddle : public Drawable, public Steppable
 		 */
 		void step();
 
+		/*!
+		 *  @brief Does what steps with no keys held would
+		 */
+		void skip(long steps);
+
 		/*!
 		 *  @brief handle vertical movement with a set speed
 		 */
 		void verticalMotion( double speed );
 
+		/*!
+		 *  @brief moves the paddle straight to a y coordinate
+		 */
+		void verticalPosition( double y );
+
 		/*!
 		 *  @brief handles horizontal motion with a set speed
 		 */
@@ -85,6 +98,16 @@ class Paddle : public Drawable, public Steppable
 		 */
 		double getY();
 
+		/*!
+		 *  @brief returns the x cordinate the paddle had a step ago
+		 */
+		double getPrevX();
+
+		/*!
+		 *  @brief returns the y cordinate the paddle had a step ago
+		 */
+		double getPrevY();
+
 		/*!
 		 *  @brief returns the width of the paddles
 		 */
@@ -95,6 +118,32 @@ class Paddle : public Drawable, public Steppable
 		 */
 		int getHeight();
 
+		/*!
+		 *  @brief returns the max vertical speed of the paddle
+		 */
+		double getVerticalSpeed();
+
+		/*!
+		 *  @brief returns the highest the center of the paddle can go
+		 */
+		double getHighestY();
+
+		/*!
+		 *  @brief returns the lowest the center of the paddle can go
+		 */
+		double getLowestY();
+
+		/*!
+		 * @brief Copies everything about the paddle that changes into a
+		 *		PaddleState
+		 */
+		void getState(PaddleState& state);
+
+		/*!
+		 * @brief Puts the paddle back the way getState() found it
+		 */
+		void setState(const PaddleState& state);
+
 
 
 		/*!
@@ -13,6 +13,7 @@
 class PaddleController;
 
 #include "Steppable.h"
+#include "PongState.h"
 
 /***************************************************************************//**
  * @brief The PaddleController class is really an interface for objects designed
@@ -25,6 +26,11 @@ class PaddleController : public Steppable
 {
 	public:
 
+		/*!
+		 * @brief The destructor. Lets controllers free what they hold.
+		 */
+		virtual ~PaddleController() { }
+		
 		/*!
 		 * @brief Handles key press events.
 		 */
@@ -54,6 +60,28 @@ class PaddleController : public Steppable
 		 * @brief Executes every game step.
 		 */
 		virtual void step() = 0;
+
+		/*!
+		 * @brief Counts how many steps, up to limit, the controller could be
+		 *		skipped ahead by with skip().
+		 */
+		virtual long quietSteps(long limit) = 0;
+
+		/*!
+		 * @brief Does what a number of calls to step() would.
+		 */
+		virtual void skip(long steps) = 0;
+
+		/*!
+		 * @brief Copies whatever the controller remembers into a
+		 *		ControllerState.
+		 */
+		virtual void getState(ControllerState& state) = 0;
+
+		/*!
+		 * @brief Puts back what getState() copied.
+		 */
+		virtual void setState(const ControllerState& state) = 0;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,36 @@
+/***************************************************************************//**
+ * @file File containing the drawing implementation for the Paddle class.
+ *
+ * @brief Contains the drawing implementation for the Paddle class. Kept apart
+ *		from Paddle.cpp so the game logic can be built without OpenGL.
+*******************************************************************************/
+
+/*******************************************************************************
+ *                 DECLARATIONS, INCLUDES, AND NAMESPACES
+*******************************************************************************/
+#include "Paddle.h"
+#include "Pong.h"
+
+/*******************************************************************************
+ *                          FUNCTION DEFINITIONS
+*******************************************************************************/
+/**************************************************************************//**
+ * @author Daniel Andrus, Johnathan Ackerman
+ * 
+ * @par Description: 
+ * Draws the paddle with the help of the drawable class, interpolated
+ * between its last two positions
+ *****************************************************************************/
+void Paddle::draw()
+{
+	// Draw between the last two steps so motion is smooth at any frame rate
+	double a = Pong::getInstance()->getInterpolation();
+	double x = prev_x + (center_x - prev_x) * a;
+	double y = prev_y + (center_y - prev_y) * a;
+
+	Renderer* out = Pong::getInstance()->getRenderer();
+	out->color( 1.0, 1.0, 1.0 ); // sets color to white
+	//draws paddle
+	out->rect( x - (width / 2), y -(height / 2), x
+		+ (width / 2), y + (height / 2 ) );
+}
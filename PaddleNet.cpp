@@ -0,0 +1,493 @@
+/***************************************************************************//**
+ * @file File containing the implementation of the PaddleNet class.
+ *
+ * @brief Contains the implementation for the PaddleNet class.
+*******************************************************************************/
+
+/*******************************************************************************
+ *                 DECLARATIONS, INCLUDES, AND NAMESPACES
+*******************************************************************************/
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "PaddleNet.h"
+#include "PongGame.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define PADDLENET_AVX2 1
+#endif
+
+const int PaddleNet::input_count;
+const int PaddleNet::hidden_count;
+const int PaddleNet::weight_count;
+const size_t PaddleNet::header_size;
+
+/*!
+ * @brief Marks a network file
+ */
+static const char paddlenet_magic[8] = { 'P', 'O', 'N', 'G', 'M', 'L', 'P',
+	'1' };
+
+/*!
+ * @brief Where each part of the weights starts
+ */
+enum PaddleNetOffset
+{
+	NET_W1 = 0,
+	NET_B1 = NET_W1 + PaddleNet::input_count * PaddleNet::hidden_count,
+	NET_W2 = NET_B1 + PaddleNet::hidden_count,
+	NET_B2 = NET_W2 + PaddleNet::hidden_count * PaddleNet::hidden_count,
+	NET_W3 = NET_B2 + PaddleNet::hidden_count,
+	NET_B3 = NET_W3 + PaddleNet::hidden_count
+};
+
+/*******************************************************************************
+ *                          FUNCTION DEFINITIONS
+*******************************************************************************/
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Works out one hidden layer a unit at a time: each unit
+ *		starts at its bias and adds each input times its weight, first
+ *		input first, then goes through ReLU.
+ *
+ * @param[in]	weights - The layer's weights, input by input.
+ * @param[in]	biases - The layer's biases.
+ * @param[in]	input - The layer's inputs.
+ * @param[in]	count - Number of inputs.
+ * @param[out]	output - The layer's hidden_count outputs.
+*******************************************************************************/
+static void layerScalar(const float* weights, const float* biases,
+	const float* input, int count, float* output)
+{
+	const int n = PaddleNet::hidden_count;
+	float sums[n];
+	for (int j = 0; j < n; j++)
+	{
+		sums[j] = biases[j];
+	}
+	for (int i = 0; i < count; i++)
+	{
+		for (int j = 0; j < n; j++)
+		{
+			sums[j] += weights[i * n + j] * input[i];
+		}
+	}
+	for (int j = 0; j < n; j++)
+	{
+		output[j] = sums[j] > 0 ? sums[j] : 0.0f;
+	}
+}
+
+#ifdef PADDLENET_AVX2
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Works out one hidden layer eight units at a time with
+ *		AVX2, adding up in the same order as layerScalar() and multiplying
+ *		and adding separately, so that the outputs are the same to the bit.
+ *		Only called if the processor has AVX2.
+ *
+ * @param[in]	weights - The layer's weights, input by input.
+ * @param[in]	biases - The layer's biases.
+ * @param[in]	input - The layer's inputs.
+ * @param[in]	count - Number of inputs.
+ * @param[out]	output - The layer's hidden_count outputs.
+*******************************************************************************/
+__attribute__((target("avx2")))
+static void layerAVX2(const float* weights, const float* biases,
+	const float* input, int count, float* output)
+{
+	const int n = PaddleNet::hidden_count;
+	__m256 sums[n / 8];
+	for (int k = 0; k < n / 8; k++)
+	{
+		sums[k] = _mm256_loadu_ps(biases + 8 * k);
+	}
+	for (int i = 0; i < count; i++)
+	{
+		__m256 x = _mm256_set1_ps(input[i]);
+		const float* row = weights + i * n;
+		for (int k = 0; k < n / 8; k++)
+		{
+			sums[k] = _mm256_add_ps(sums[k],
+				_mm256_mul_ps(_mm256_loadu_ps(row + 8 * k), x));
+		}
+	}
+	__m256 zero = _mm256_setzero_ps();
+	for (int k = 0; k < n / 8; k++)
+	{
+		_mm256_storeu_ps(output + 8 * k, _mm256_max_ps(sums[k], zero));
+	}
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Works out the moves for eight sets of numbers at once
+ *		with AVX2, one set in each lane, so that every unit of every layer,
+ *		the output too, is worked out for all eight together. Each lane adds
+ *		up in the same order as PaddleNet::forward(), so the moves are the
+ *		same to the bit. Only called if the processor has AVX2.
+ *
+ * @param[in]	weights - weight_count weights, laid out as in a file.
+ * @param[in]	inputs - Eight sets of input_count numbers.
+ * @param[out]	outputs - Where to put the eight moves.
+*******************************************************************************/
+__attribute__((target("avx2")))
+static void forwardEightAVX2(const float* weights, const float* inputs,
+	float* outputs)
+{
+	const int k = PaddleNet::input_count;
+	const int n = PaddleNet::hidden_count;
+	__m256 input[k], first[n], second[n];
+	__m256 zero = _mm256_setzero_ps();
+
+	for (int i = 0; i < k; i++)
+	{
+		input[i] = _mm256_setr_ps(inputs[i], inputs[k + i],
+			inputs[2 * k + i], inputs[3 * k + i], inputs[4 * k + i],
+			inputs[5 * k + i], inputs[6 * k + i], inputs[7 * k + i]);
+	}
+	for (int j = 0; j < n; j++)
+	{
+		__m256 sum = _mm256_set1_ps(weights[NET_B1 + j]);
+		for (int i = 0; i < k; i++)
+		{
+			sum = _mm256_add_ps(sum, _mm256_mul_ps(
+				_mm256_set1_ps(weights[NET_W1 + i * n + j]), input[i]));
+		}
+		first[j] = _mm256_max_ps(sum, zero);
+	}
+	for (int j = 0; j < n; j++)
+	{
+		__m256 sum = _mm256_set1_ps(weights[NET_B2 + j]);
+		for (int i = 0; i < n; i++)
+		{
+			sum = _mm256_add_ps(sum, _mm256_mul_ps(
+				_mm256_set1_ps(weights[NET_W2 + i * n + j]), first[i]));
+		}
+		second[j] = _mm256_max_ps(sum, zero);
+	}
+	__m256 sum = _mm256_set1_ps(weights[NET_B3]);
+	for (int j = 0; j < n; j++)
+	{
+		sum = _mm256_add_ps(sum, _mm256_mul_ps(
+			_mm256_set1_ps(weights[NET_W3 + j]), second[j]));
+	}
+
+	float sums[8];
+	_mm256_storeu_ps(sums, sum);
+	for (int lane = 0; lane < 8; lane++)
+	{
+		outputs[lane] = (float) tanh((double) sums[lane]);
+	}
+}
+#endif
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: The constructor. Makes a network with no weights, using
+ *		the AVX2 kernel if the processor has it.
+*******************************************************************************/
+PaddleNet::PaddleNet() :
+mapping(NULL), mapped_size(0), weights(NULL), vectorized(hasAVX2())
+{ }
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: The destructor. Unmaps the weights.
+*******************************************************************************/
+PaddleNet::~PaddleNet()
+{
+	close();
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Maps weights in from a file written by save(). The file
+ *		is mapped read only and shared, so every game and process using the
+ *		same file shares one copy.
+ *
+ * @param[in]	path - The file.
+ *
+ * @returns True if the weights were mapped, false if the file couldn't be
+ *		read or was made for a network of another size.
+*******************************************************************************/
+bool PaddleNet::load(const string& path)
+{
+	close();
+
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0) return false;
+
+	struct stat info;
+	size_t size = header_size + weight_count * sizeof(float);
+	if (fstat(fd, &info) != 0 || (size_t) info.st_size != size)
+	{
+		::close(fd);
+		return false;
+	}
+	void* map = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+	::close(fd);
+	if (map == MAP_FAILED) return false;
+
+	const unsigned char* bytes = (const unsigned char*) map;
+	uint32_t inputs = 0, hidden = 0;
+	for (int i = 3; i >= 0; i--)
+	{
+		inputs = inputs << 8 | bytes[8 + i];
+		hidden = hidden << 8 | bytes[12 + i];
+	}
+	if (memcmp(bytes, paddlenet_magic, sizeof(paddlenet_magic)) != 0
+		|| inputs != (uint32_t) input_count
+		|| hidden != (uint32_t) hidden_count)
+	{
+		munmap(map, size);
+		return false;
+	}
+
+	mapping = map;
+	mapped_size = size;
+	weights = (const float*) (bytes + header_size);
+	return true;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Unmaps the weights, if any are loaded.
+*******************************************************************************/
+void PaddleNet::close()
+{
+	if (mapping != NULL)
+	{
+		munmap(mapping, mapped_size);
+		mapping = NULL;
+	}
+	mapped_size = 0;
+	weights = NULL;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Determines if weights are loaded.
+ *
+ * @returns True if they are.
+*******************************************************************************/
+bool PaddleNet::isLoaded() const
+{
+	return weights != NULL;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Determines if the processor can use the AVX2 kernel.
+ *
+ * @returns True if it has AVX2 and this was built for it.
+*******************************************************************************/
+bool PaddleNet::hasAVX2()
+{
+#ifdef PADDLENET_AVX2
+	return __builtin_cpu_supports("avx2");
+#else
+	return false;
+#endif
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Picks the AVX2 kernel, if the processor has it, or the
+ *		one that works a unit at a time. Both give the same answers; this is
+ *		for checking that and timing them.
+ *
+ * @param[in]	vectorized - True for AVX2.
+*******************************************************************************/
+void PaddleNet::setVectorized(bool vectorized)
+{
+	this -> vectorized = vectorized && hasAVX2();
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Determines if the AVX2 kernel is being used.
+ *
+ * @returns True if it is.
+*******************************************************************************/
+bool PaddleNet::isVectorized() const
+{
+	return vectorized;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Works out the numbers a network takes for a paddle,
+ *		seen from the paddle's side of the board so that they mean the same
+ *		for either paddle, and scaled to about -1 to 1: how far the ball is
+ *		from the paddle, the ball's height, how fast the ball comes toward
+ *		the paddle and goes up, the paddle's height above the middle, its
+ *		size, how far above it the ball is, and a constant 1.
+ *
+ * @param[in]	ball - The ball.
+ * @param[in]	paddle - The paddle, either one of the ball's game.
+ * @param[out]	input - Where to put the input_count numbers.
+*******************************************************************************/
+void PaddleNet::features(Ball* ball, Paddle* paddle, float* input)
+{
+	Board* board = ball->game->getBoard();
+	double width = board->getWidth();
+	double half = board->getHeight() / 2.0;
+	double middle = board->getY() + half;
+	bool right = paddle == ball->game->getRightPaddle();
+	double toward = ball->x_velocity * ball->s_velocity * (right ? 1 : -1);
+
+	input[0] = (float) (fabs(paddle->getX() - ball->center_x) / width);
+	input[1] = (float) ((ball->center_y - middle) / half);
+	input[2] = (float) (toward / 8.0);
+	input[3] = (float) (ball->y_velocity * ball->s_velocity / 8.0);
+	input[4] = (float) ((paddle->getY() - middle) / half);
+	input[5] = (float) (paddle->getHeight() / half);
+	input[6] = (float) ((ball->center_y - paddle->getY()) / half);
+	input[7] = 1.0f;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Works out the move with a given set of weights: both
+ *		hidden layers with the chosen kernel, then the output unit, added up
+ *		a weight at a time whichever kernel is used, through tanh.
+ *
+ * @param[in]	weights - weight_count weights, laid out as in a file.
+ * @param[in]	input - input_count numbers from features().
+ * @param[in]	vectorized - True to use the AVX2 kernel. The processor
+ *				must have AVX2.
+ *
+ * @returns The move as a fraction of full speed, -1 to 1.
+*******************************************************************************/
+float PaddleNet::forward(const float* weights, const float* input,
+	bool vectorized)
+{
+	float first[hidden_count], second[hidden_count];
+
+#ifdef PADDLENET_AVX2
+	if (vectorized)
+	{
+		layerAVX2(weights + NET_W1, weights + NET_B1, input, input_count,
+			first);
+		layerAVX2(weights + NET_W2, weights + NET_B2, first, hidden_count,
+			second);
+	}
+	else
+#endif
+	{
+		layerScalar(weights + NET_W1, weights + NET_B1, input, input_count,
+			first);
+		layerScalar(weights + NET_W2, weights + NET_B2, first, hidden_count,
+			second);
+	}
+
+	float sum = weights[NET_B3];
+	for (int j = 0; j < hidden_count; j++)
+	{
+		sum += weights[NET_W3 + j] * second[j];
+	}
+	return (float) tanh((double) sum);
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Works out the move for one set of numbers.
+ *
+ * @param[in]	input - input_count numbers from features().
+ *
+ * @returns The move as a fraction of full speed, -1 to 1, or 0 if no
+ *		weights are loaded.
+*******************************************************************************/
+float PaddleNet::evaluate(const float* input) const
+{
+	if (weights == NULL) return 0;
+	return forward(weights, input, vectorized);
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Works out the moves for many sets of numbers at once,
+ *		say one for each of thousands of matches stepped together. With
+ *		AVX2, eight sets go through the network together, one in each lane;
+ *		the moves are the same to the bit as evaluate() gives one at a time.
+ *
+ * @param[in]	inputs - count sets of input_count numbers, one after the
+ *				other.
+ * @param[out]	outputs - Where to put the count moves.
+ * @param[in]	count - Number of sets.
+*******************************************************************************/
+void PaddleNet::evaluateBatch(const float* inputs, float* outputs,
+	long count) const
+{
+	long i = 0;
+	if (weights == NULL)
+	{
+		for (; i < count; i++) outputs[i] = 0;
+		return;
+	}
+
+#ifdef PADDLENET_AVX2
+	if (vectorized)
+	{
+		for (; i + 8 <= count; i += 8)
+		{
+			forwardEightAVX2(weights, inputs + i * input_count, outputs + i);
+		}
+	}
+#endif
+	for (; i < count; i++)
+	{
+		outputs[i] = forward(weights, inputs + i * input_count, vectorized);
+	}
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Writes a set of weights to a file for load() to map.
+ *		Floats are written as they are in memory, which is little-endian on
+ *		the processors this runs on.
+ *
+ * @param[in]	path - The file.
+ * @param[in]	weights - weight_count weights.
+ *
+ * @returns True if the file was written, false if not.
+*******************************************************************************/
+bool PaddleNet::save(const string& path, const float* weights)
+{
+	ofstream file(path.c_str(), ios::binary | ios::trunc);
+	unsigned char header[header_size];
+	memset(header, 0, sizeof(header));
+	memcpy(header, paddlenet_magic, sizeof(paddlenet_magic));
+	for (int i = 0; i < 4; i++)
+	{
+		header[8 + i] = (unsigned char) ((uint32_t) input_count >> (8 * i));
+		header[12 + i] = (unsigned char) ((uint32_t) hidden_count >> (8 * i));
+	}
+	file.write((const char*) header, sizeof(header));
+	file.write((const char*) weights, weight_count * sizeof(float));
+	file.close();
+	return !file.fail();
+}
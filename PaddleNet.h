@@ -0,0 +1,141 @@
+/***************************************************************************//**
+ * @file File containing the declaration for the PaddleNet class.
+ *
+ * @brief Contains the declaration for the PaddleNet class, a small neural
+ *		network that plays a paddle.
+*******************************************************************************/
+#ifndef _PADDLENET_H_
+#define _PADDLENET_H_
+
+/*******************************************************************************
+ *                 DECLARATIONS, INCLUDES, AND NAMESPACES
+*******************************************************************************/
+class PaddleNet;
+class Ball;
+class Paddle;
+
+#include <string>
+#include <cstddef>
+
+using namespace std;
+
+/***************************************************************************//**
+ * @brief The PaddleNet class is a small fixed-size multi-layer perceptron
+ *		that works out how far a paddle should move on a step.
+ *
+ * @details Takes input_count numbers about the ball and the paddle, seen
+ *		from the paddle's side so one network plays both, through two
+ *		layers of hidden_count units with ReLU and one output unit with
+ *		tanh: the move, as a fraction of the paddle's full speed.
+ *
+ *		The weights are mapped from a file rather than read, so any number
+ *		of games can share them without copying. The file is 64 bytes of
+ *		header, eight bytes of magic, then the input and hidden counts as
+ *		32-bit little-endian numbers and zeros, followed by weight_count
+ *		little-endian floats: the first layer's weights input by input,
+ *		each input's hidden_count weights together, then its biases, the
+ *		second layer the same way, then the output's weights and bias.
+ *
+ *		The hidden layers are worked out eight units at a time with AVX2 if
+ *		the processor has it, and one at a time if not. Both add up in the
+ *		same order without fused multiply-adds, so they give the same answer
+ *		to the bit, and games with the network play out the same on any
+ *		machine.
+*******************************************************************************/
+class PaddleNet
+{
+	public:
+		static const int input_count = 8;	/*!< Numbers in */
+		static const int hidden_count = 32;	/*!< Units in each hidden layer */
+		static const int weight_count = input_count * hidden_count
+			+ hidden_count + hidden_count * hidden_count + hidden_count
+			+ hidden_count + 1;				/*!< Weights and biases in all */
+		static const size_t header_size = 64;	/*!< Bytes before the weights
+													in a file */
+
+	private:
+		void* mapping;			/*!< Where the file is mapped, NULL if not */
+		size_t mapped_size;		/*!< Size of the mapping */
+		const float* weights;	/*!< The weights, NULL if none are loaded */
+		bool vectorized;		/*!< True to use the AVX2 kernel */
+
+		/*!
+		 * @brief Not copyable; the mapping belongs to one network.
+		 */
+		PaddleNet(const PaddleNet&);
+
+		/*!
+		 * @brief Not copyable; the mapping belongs to one network.
+		 */
+		PaddleNet& operator=(const PaddleNet&);
+
+	public:
+		/*!
+		 * @brief The constructor. Makes a network with no weights.
+		 */
+		PaddleNet();
+
+		/*!
+		 * @brief The destructor. Unmaps the weights.
+		 */
+		~PaddleNet();
+
+		/*!
+		 * @brief Maps weights in from a file.
+		 */
+		bool load(const string& path);
+
+		/*!
+		 * @brief Unmaps the weights.
+		 */
+		void close();
+
+		/*!
+		 * @brief Determines if weights are loaded.
+		 */
+		bool isLoaded() const;
+
+		/*!
+		 * @brief Determines if the processor can use the AVX2 kernel.
+		 */
+		static bool hasAVX2();
+
+		/*!
+		 * @brief Picks the AVX2 kernel, if the processor has it, or not.
+		 */
+		void setVectorized(bool vectorized);
+
+		/*!
+		 * @brief Determines if the AVX2 kernel is being used.
+		 */
+		bool isVectorized() const;
+
+		/*!
+		 * @brief Works out the numbers a network takes for a paddle.
+		 */
+		static void features(Ball* ball, Paddle* paddle, float* input);
+
+		/*!
+		 * @brief Works out the move for one set of numbers.
+		 */
+		float evaluate(const float* input) const;
+
+		/*!
+		 * @brief Works out the moves for many sets of numbers at once.
+		 */
+		void evaluateBatch(const float* inputs, float* outputs,
+			long count) const;
+
+		/*!
+		 * @brief Works out the move with a given set of weights.
+		 */
+		static float forward(const float* weights, const float* input,
+			bool vectorized);
+
+		/*!
+		 * @brief Writes a set of weights to a file for load() to map.
+		 */
+		static bool save(const string& path, const float* weights);
+};
+
+#endif
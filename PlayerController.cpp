@@ -22,7 +22,7 @@
  *				should be listening for arrows (true) or WASD (false) controls.
 *******************************************************************************/
 PlayerController::PlayerController(Paddle* paddle, bool arrows) :
-		paddle(paddle), arrows(arrows)
+		arrows(arrows), paddle(paddle)
 { }
 
 /***************************************************************************//**
@@ -172,3 +172,47 @@ void PlayerController::ballHit()
 *******************************************************************************/
 void PlayerController::step()
 { }
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: Player paddles are moved by Paddle::step() rather than
+ *		by the controller, so the controller never needs a step.
+ *
+ * @param[in]	limit - Most steps to count.
+ *
+ * @returns limit
+*******************************************************************************/
+long PlayerController::quietSteps(long limit)
+{
+	return limit;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: Does nothing. Fulfills superclass requirements.
+*******************************************************************************/
+void PlayerController::skip(long steps)
+{ }
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: Does nothing. A player's keys are kept by the paddle, so
+ *		the controller has nothing of its own to remember.
+ *
+ * @param[out]	state - Left as it is.
+*******************************************************************************/
+void PlayerController::getState(ControllerState& state)
+{ }
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: Does nothing. Fulfills superclass requirements.
+ *
+ * @param[in]	state - Ignored.
+*******************************************************************************/
+void PlayerController::setState(const ControllerState& state)
+{ }
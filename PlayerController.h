@@ -12,10 +12,18 @@
 *******************************************************************************/
 class PlayerController;
 
-#include <GL/freeglut.h>
+#include <cctype>
 #include "PaddleController.h"
 #include "Paddle.h"
 
+// GLUT's codes for the arrow keys, so this class builds without GLUT
+#ifndef GLUT_KEY_LEFT
+#define GLUT_KEY_LEFT	0x0064
+#define GLUT_KEY_UP		0x0065
+#define GLUT_KEY_RIGHT	0x0066
+#define GLUT_KEY_DOWN	0x0067
+#endif
+
 /***************************************************************************//**
  * @brief The PlayerController class is designed to allow a user to control
  *		a Pong paddle through 
@@ -64,6 +72,26 @@ class PlayerController : public PaddleController
 		 * @brief Does nothing; fulfills superclass requirements.
 		 */
 		void step();
+
+		/*!
+		 * @brief Returns limit; the player does nothing on a step.
+		 */
+		long quietSteps(long limit);
+
+		/*!
+		 * @brief Does nothing; fulfills superclass requirements.
+		 */
+		void skip(long steps);
+
+		/*!
+		 * @brief Does nothing; fulfills superclass requirements.
+		 */
+		void getState(ControllerState& state);
+
+		/*!
+		 * @brief Does nothing; fulfills superclass requirements.
+		 */
+		void setState(const ControllerState& state);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,216 @@
+/***************************************************************************//**
+ * @file File containing the implementation of the Policy class.
+ *
+ * @brief Contains the implementation for the Policy class.
+*******************************************************************************/
+
+/*******************************************************************************
+ *                 DECLARATIONS, INCLUDES, AND NAMESPACES
+*******************************************************************************/
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include "Policy.h"
+#include "PongGame.h"
+
+const int Policy::distance_bins;
+const int Policy::time_bins;
+const int Policy::cell_count;
+
+/*!
+ * @brief Marks a policy file
+ */
+static const char policy_magic[8] = { 'P', 'O', 'N', 'G', 'P', 'O', 'L',
+	'1' };
+
+/*!
+ * @brief Upper ends of the bins of how far off a paddle is, in pixels. The
+ *		first is a paddle's speed, within which it can get there in a step.
+ */
+static const double policy_distances[] = { 3, 8, 16, 32, 64, 128 };
+
+/*!
+ * @brief Upper ends of the bins of how many steps until the ball arrives
+ */
+static const double policy_times[] = { 8, 24, 60 };
+
+/*******************************************************************************
+ *                          FUNCTION DEFINITIONS
+*******************************************************************************/
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Finds the bin a value falls in, given the upper ends of
+ *		every bin but the last.
+ *
+ * @param[in]	value - The value.
+ * @param[in]	ends - Upper ends of the bins.
+ * @param[in]	count - Number of upper ends.
+ *
+ * @returns The bin, from 0 to count.
+*******************************************************************************/
+static int policyBin(double value, const double* ends, int count)
+{
+	int bin = 0;
+	while (bin < count && value >= ends[bin]) bin++;
+	return bin;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: The constructor. Makes a policy that never moves, until
+ *		one is loaded or learned.
+*******************************************************************************/
+Policy::Policy()
+{
+	memset(actions, POLICY_STAY, sizeof(actions));
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Works out which cell a paddle is in. While the ball is
+ *		coming, from how many steps until it reaches the paddle and how far
+ *		the paddle is from where it will cross; otherwise from how far the
+ *		paddle is from the middle.
+ *
+ * @param[in]	ball - The ball.
+ * @param[in]	paddle - The paddle, either one of the ball's game.
+ *
+ * @returns The cell, from 0 to cell_count - 1.
+*******************************************************************************/
+int Policy::cell(Ball* ball, Paddle* paddle)
+{
+	bool right = paddle == ball->game->getRightPaddle();
+	double dx = ball->x_velocity * ball->s_velocity;
+	bool coming = right ? dx > 0 : dx < 0;
+
+	// Where the ball will cross, or the middle if it isn't coming
+	double gap = PredictiveController::crossingHeight(ball, paddle)
+		- paddle->getY();
+	int distance = policyBin(fabs(gap), policy_distances,
+		distance_bins / 2);
+	distance = distance_bins / 2 + (gap < 0 ? -distance : distance);
+
+	int time = 0;
+	if (coming)
+	{
+		double steps = fabs(paddle->getX() - ball->center_x) / fabs(dx);
+		time = policyBin(steps, policy_times, time_bins - 1);
+	}
+	return ((coming ? 1 : 0) * time_bins + time) * distance_bins + distance;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Gets the direction a move goes in.
+ *
+ * @param[in]	action - The move, a PolicyAction.
+ *
+ * @returns 1 for up, -1 for down, 0 for staying put.
+*******************************************************************************/
+int Policy::direction(int action)
+{
+	return action == POLICY_UP ? 1 : (action == POLICY_DOWN ? -1 : 0);
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Gets the move for a cell.
+ *
+ * @param[in]	cell - The cell, from cell().
+ *
+ * @returns The move, a PolicyAction.
+*******************************************************************************/
+int Policy::getAction(int cell) const
+{
+	if (cell < 0 || cell >= cell_count) return POLICY_STAY;
+	return actions[cell];
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Sets the move for a cell. Moves that don't exist are
+ *		taken as staying put.
+ *
+ * @param[in]	cell - The cell, from cell().
+ * @param[in]	action - The move, a PolicyAction.
+*******************************************************************************/
+void Policy::setAction(int cell, int action)
+{
+	if (cell < 0 || cell >= cell_count) return;
+	if (action < 0 || action >= POLICY_ACTION_COUNT) action = POLICY_STAY;
+	actions[cell] = (uint8_t) action;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Reads a policy written by save(). Leaves the policy as
+ *		it was if the file can't be read or was made for other cells.
+ *
+ * @param[in]	path - File to read.
+ *
+ * @returns True if the policy was read, false if not.
+*******************************************************************************/
+bool Policy::load(const string& path)
+{
+	ifstream file(path.c_str(), ios::binary);
+	unsigned char header[16];
+	uint8_t read[cell_count];
+	if (!file.read((char*) header, sizeof(header))
+		|| !file.read((char*) read, sizeof(read)))
+	{
+		return false;
+	}
+
+	uint32_t cells = 0, moves = 0;
+	for (int i = 3; i >= 0; i--)
+	{
+		cells = cells << 8 | header[8 + i];
+		moves = moves << 8 | header[12 + i];
+	}
+	if (memcmp(header, policy_magic, sizeof(policy_magic)) != 0
+		|| cells != (uint32_t) cell_count
+		|| moves != (uint32_t) POLICY_ACTION_COUNT)
+	{
+		return false;
+	}
+
+	for (int i = 0; i < cell_count; i++)
+	{
+		if (read[i] >= POLICY_ACTION_COUNT) return false;
+	}
+	memcpy(actions, read, sizeof(actions));
+	return true;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Writes the policy to a file for load() to read.
+ *
+ * @param[in]	path - File to write.
+ *
+ * @returns True if the policy was written, false if not.
+*******************************************************************************/
+bool Policy::save(const string& path) const
+{
+	ofstream file(path.c_str(), ios::binary | ios::trunc);
+	unsigned char header[16];
+	memcpy(header, policy_magic, sizeof(policy_magic));
+	for (int i = 0; i < 4; i++)
+	{
+		header[8 + i] = (unsigned char) ((uint32_t) cell_count >> (8 * i));
+		header[12 + i] = (unsigned char)
+			((uint32_t) POLICY_ACTION_COUNT >> (8 * i));
+	}
+	file.write((const char*) header, sizeof(header));
+	file.write((const char*) actions, sizeof(actions));
+	file.close();
+	return !file.fail();
+}
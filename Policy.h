@@ -0,0 +1,100 @@
+/***************************************************************************//**
+ * @file File containing the declaration for the Policy class.
+ *
+ * @brief Contains the declaration for the Policy class, a learned way of
+ *		playing a paddle.
+*******************************************************************************/
+#ifndef _POLICY_H_
+#define _POLICY_H_
+
+/*******************************************************************************
+ *                 DECLARATIONS, INCLUDES, AND NAMESPACES
+*******************************************************************************/
+class Policy;
+class Ball;
+class Paddle;
+
+#include <string>
+#include <stdint.h>
+
+using namespace std;
+
+/*!
+ * @brief Moves a Policy can make on a step
+ */
+enum PolicyAction
+{
+	POLICY_STAY = 0,	/*!< Don't move */
+	POLICY_UP = 1,		/*!< Move up at full speed */
+	POLICY_DOWN = 2,	/*!< Move down at full speed */
+	POLICY_ACTION_COUNT	/*!< Number of moves */
+};
+
+/***************************************************************************//**
+ * @brief The Policy class holds a move for every situation a paddle can be
+ *		in, as learned by pong-train.
+ *
+ * @details A paddle's situation is boiled down to one of a small number of
+ *		cells: whether the ball is coming its way, how many steps until it
+ *		arrives, and how far and which way the paddle is from where the ball
+ *		will cross it, or from the middle if the ball isn't coming. Distances
+ *		and times are binned more finely the smaller they are. The same
+ *		cells work for either paddle, so one policy plays both sides.
+ *
+ *		A policy is saved as a small file: eight bytes of magic, the number
+ *		of cells and moves as 32-bit little-endian numbers, then a move a
+ *		byte for each cell. A file made for a different set of cells won't
+ *		load.
+*******************************************************************************/
+class Policy
+{
+	public:
+		static const int distance_bins = 13;	/*!< Bins of how far off the
+													paddle is */
+		static const int time_bins = 4;			/*!< Bins of how soon the
+													ball arrives */
+		static const int cell_count = 2 * time_bins * distance_bins;	/*!<
+													Number of cells */
+
+	private:
+		uint8_t actions[cell_count];	/*!< Move for each cell, a
+											PolicyAction */
+
+	public:
+		/*!
+		 * @brief The constructor. Makes a policy that never moves.
+		 */
+		Policy();
+
+		/*!
+		 * @brief Works out which cell a paddle is in.
+		 */
+		static int cell(Ball* ball, Paddle* paddle);
+
+		/*!
+		 * @brief Gets the direction a move goes in.
+		 */
+		static int direction(int action);
+
+		/*!
+		 * @brief Gets the move for a cell.
+		 */
+		int getAction(int cell) const;
+
+		/*!
+		 * @brief Sets the move for a cell.
+		 */
+		void setAction(int cell, int action);
+
+		/*!
+		 * @brief Reads a policy from a file.
+		 */
+		bool load(const string& path);
+
+		/*!
+		 * @brief Writes the policy to a file.
+		 */
+		bool save(const string& path) const;
+};
+
+#endif
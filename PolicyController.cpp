@@ -0,0 +1,142 @@
+/***************************************************************************//**
+ * @file File containing the implementation of the PolicyController class.
+ *
+ * @brief Contains the implementation for the PolicyController class.
+*******************************************************************************/
+
+/*******************************************************************************
+ *                 DECLARATIONS, INCLUDES, AND NAMESPACES
+*******************************************************************************/
+#include "PolicyController.h"
+
+/*******************************************************************************
+ *                          FUNCTION DEFINITIONS
+*******************************************************************************/
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: The constructor. Initializes variables.
+ *
+ * @param[in]	paddle - Pointer to paddle that this controller controls.
+ * @param[in]	ball - Pointer to the ball object to track.
+ * @param[in]	policy - Moves to make; must outlast the controller.
+*******************************************************************************/
+PolicyController::PolicyController(Paddle* paddle, Ball* ball,
+	const Policy* policy) :
+paddle(paddle), ball(ball), policy(policy), steps(0)
+{ }
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Does nothing. Fulfills superclass requirements.
+*******************************************************************************/
+void PolicyController::keyDown(unsigned char key)
+{ }
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Does nothing. Fulfills superclass requirements.
+*******************************************************************************/
+void PolicyController::keyUp(unsigned char key)
+{ }
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Does nothing. Fulfills superclass requirements.
+*******************************************************************************/
+void PolicyController::keySpecialDown(int key)
+{ }
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Does nothing. Fulfills superclass requirements.
+*******************************************************************************/
+void PolicyController::keySpecialUp(int key)
+{ }
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Does nothing. Fulfills superclass requirements.
+*******************************************************************************/
+void PolicyController::ballHit()
+{ }
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Makes the move the policy has for the cell the paddle is
+ *		in. The move is made after the ball has moved, as a player's key
+ *		would be before the ball's next move, which is how pong-train
+ *		learned it.
+*******************************************************************************/
+void PolicyController::step()
+{
+	steps++;
+
+	if (ball == NULL || policy == NULL) return;
+
+	int action = policy->getAction(Policy::cell(ball, paddle));
+	int direction = Policy::direction(action);
+	if (direction != 0)
+		paddle->verticalMotion(direction * paddle->getVerticalSpeed());
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Counts how many of the coming steps the controller can
+ *		be skipped over. The policy may move on any step, so none can while
+ *		there is a ball.
+ *
+ * @param[in]	limit - Most steps to count.
+ *
+ * @returns Number of steps, up to limit, that skip() may be given.
+*******************************************************************************/
+long PolicyController::quietSteps(long limit)
+{
+	if (ball == NULL || policy == NULL) return limit;
+	return 0;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Does what the given number of steps would while
+ *		quietSteps() allows them, which is only count them.
+ *
+ * @param[in]	steps - Number of steps to skip.
+*******************************************************************************/
+void PolicyController::skip(long steps)
+{
+	if (steps > 0) this -> steps += steps;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Copies everything the AI remembers from step to step
+ *		into a ControllerState, which is only the number of steps taken.
+ *
+ * @param[out]	state - Where to copy it.
+*******************************************************************************/
+void PolicyController::getState(ControllerState& state)
+{
+	state.steps = steps;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Puts back what getState() copied.
+ *
+ * @param[in]	state - What to put back.
+*******************************************************************************/
+void PolicyController::setState(const ControllerState& state)
+{
+	steps = (long) state.steps;
+}
@@ -0,0 +1,94 @@
+/***************************************************************************//**
+ * @file File containing the declaration for the PolicyController class.
+ *
+ * @brief Contains the declaration for the PolicyController class.
+*******************************************************************************/
+#ifndef _POLICYCONTROLLER_H_
+#define _POLICYCONTROLLER_H_
+
+/*******************************************************************************
+ *                 DECLARATIONS, INCLUDES, AND NAMESPACES
+*******************************************************************************/
+class PolicyController;
+
+#include "PaddleController.h"
+#include "Paddle.h"
+#include "Ball.h"
+#include "Policy.h"
+
+/***************************************************************************//**
+ * @brief The PolicyController class moves a pong paddle the way a Policy
+ *		learned by pong-train says to.
+ *
+ * @details Every step it works out which of the policy's cells the paddle
+ *		is in and makes the move the policy has for it: up or down at full
+ *		speed, or staying put. Since the move can change on any step, none
+ *		are skipped.
+*******************************************************************************/
+class PolicyController : public PaddleController
+{
+	private:
+		Paddle* paddle;			/*!< Pointer to paddle under AI control */
+		Ball* ball;				/*!< Pointer to ball to watch */
+		const Policy* policy;	/*!< Moves to make */
+		long steps;				/*!< Number of steps taken */
+
+	public:
+		/*!
+		 * @brief The constructor. Initializes variables.
+		 */
+		PolicyController(Paddle* paddle, Ball* ball, const Policy* policy);
+
+		/*!
+		 * @brief Does nothing; fulfulls superclass requirements
+		 */
+		void keyDown(unsigned char key);
+
+		/*!
+		 * @brief Does nothing; fulfulls superclass requirements
+		 */
+		void keyUp(unsigned char key);
+
+		/*!
+		 * @brief Does nothing; fulfulls superclass requirements
+		 */
+		void keySpecialDown(int key);
+
+		/*!
+		 * @brief Does nothing; fulfulls superclass requirements
+		 */
+		void keySpecialUp(int key);
+
+		/*!
+		 * @brief Does nothing; fulfulls superclass requirements
+		 */
+		void ballHit();
+
+		/*!
+		 * @brief Makes the policy's move.
+		 */
+		void step();
+
+		/*!
+		 * @brief Counts the steps ahead that could be skipped; none while
+		 *		there is a ball.
+		 */
+		long quietSteps(long limit);
+
+		/*!
+		 * @brief Does what a number of steps without a ball would.
+		 */
+		void skip(long steps);
+
+		/*!
+		 * @brief Copies the step count into a ControllerState.
+		 */
+		void getState(ControllerState& state);
+
+		/*!
+		 * @brief Puts back what getState() copied.
+		 */
+		void setState(const ControllerState& state);
+};
+
+#endif
@@ -10,7 +10,7 @@
 #include "Pong.h"
 
 Pong* Pong::instance;
-const int Pong::unit = 16;
+const int Pong::unit;
 
 /*******************************************************************************
  *                          FUNCTION DEFINITIONS
@@ -22,14 +22,16 @@ const int Pong::unit = 16;
 *******************************************************************************/
 Pong::Pong() :
 	view_width(32*unit), view_height(24*unit), window_width(view_width),
-	window_height(view_height), window_name("Pong"), menu(NULL), view_x(0),
-	view_y(0)
+	window_height(view_height), view_x(0), view_y(0), window_name("Pong"),
+	menu(NULL), link(NULL), session(NULL), spectators(NULL), watching(false),
+	tick_rate(60), frame_rate(120), max_substeps(5), accumulator(0),
+	interpolation(1)
 {
 	if (instance == NULL)
 		instance = this;
 
 	// Instanciate game manager
-	game = new (nothrow) PongGame;
+	game = new (nothrow) PongGame(view_width, view_height, this);
 }
 
 /***************************************************************************//**
@@ -40,6 +42,9 @@ Pong::Pong() :
 Pong::~Pong()
 {
 	// Be sure to deallocate everything!
+	delete spectators;
+	delete session;
+	delete link;
 	delete game;
 	if (menu != NULL)
 		delete menu;
@@ -69,6 +74,19 @@ PongGame* Pong::getGame()
 	return game;
 }
 
+/***************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: Gets the renderer that Drawable objects draw their
+ *		rectangles and disks with, so that each layer is drawn all at once.
+ *
+ * @returns Pointer to the renderer.
+*******************************************************************************/
+Renderer* Pong::getRenderer()
+{
+	return &renderer;
+}
+
 /***************************************************************************//**
  * @author Daniel Andrus, Johnny Ackerman
  * 
@@ -81,15 +99,211 @@ PongGame* Pong::getGame()
 *******************************************************************************/
 int Pong::run( int argc, char *argv[] )
 {
-	srand((unsigned int) time(NULL));
-
-	// Start the game
-	game->startGame(true, true);
-	displayMenu();
+	uint64_t seed = (uint64_t) time(NULL);
+	const char* record = NULL;
+	const char* replay = NULL;
+	const char* publish = NULL;
+	const char* watch = NULL;
+	const char* policy = NULL;
+	const char* net = NULL;
+	const char* difficulty = NULL;
+	int host_port = 0;
+	int ai_kind = AI_FOLLOW;
+	string join;
+	double latency = 0, jitter = 0, loss = 0;
 
 	// perform various OpenGL initializations
     glutInit( &argc, argv );
 
+	// Read our own options from whatever GLUT left behind
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--tick-rate") == 0 && i + 1 < argc)
+		{
+			tick_rate = atof(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--frame-rate") == 0 && i + 1 < argc)
+		{
+			frame_rate = atof(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+		{
+			seed = (uint64_t) strtoull(argv[++i], NULL, 10);
+		}
+		else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+		{
+			record = argv[++i];
+		}
+		else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc)
+		{
+			replay = argv[++i];
+		}
+		else if (strcmp(argv[i], "--ai") == 0 && i + 1 < argc)
+		{
+			ai_kind = PongGame::findAIKind(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--policy") == 0 && i + 1 < argc)
+		{
+			policy = argv[++i];
+		}
+		else if (strcmp(argv[i], "--net") == 0 && i + 1 < argc)
+		{
+			net = argv[++i];
+		}
+		else if (strcmp(argv[i], "--difficulty") == 0 && i + 1 < argc)
+		{
+			difficulty = argv[++i];
+		}
+		else if (strcmp(argv[i], "--immediate") == 0)
+		{
+			renderer.setImmediate(true);
+		}
+		else if (strcmp(argv[i], "--gl-stats") == 0)
+		{
+			renderer.setStats(true);
+		}
+		else if (strcmp(argv[i], "--publish") == 0 && i + 1 < argc)
+		{
+			publish = argv[++i];
+		}
+		else if (strcmp(argv[i], "--watch") == 0 && i + 1 < argc)
+		{
+			watch = argv[++i];
+		}
+		else if (strcmp(argv[i], "--host") == 0 && i + 1 < argc)
+		{
+			host_port = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--join") == 0 && i + 1 < argc)
+		{
+			join = argv[++i];
+		}
+		else if (strcmp(argv[i], "--latency") == 0 && i + 1 < argc)
+		{
+			latency = atof(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--jitter") == 0 && i + 1 < argc)
+		{
+			jitter = atof(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--loss") == 0 && i + 1 < argc)
+		{
+			loss = atof(argv[++i]);
+		}
+		else
+		{
+			host_port = -1;
+			break;
+		}
+	}
+
+	// Networked games can't be recorded or mixed with replays, and a
+	// watched game is only watched
+	bool networked = host_port != 0 || !join.empty();
+	size_t colon = join.rfind(':');
+	if (host_port < 0 || ai_kind < 0 || (host_port != 0 && !join.empty())
+		|| (!join.empty() && colon == string::npos)
+		|| (networked && (record != NULL || replay != NULL))
+		|| (watch != NULL && (networked || record != NULL
+			|| replay != NULL || publish != NULL)))
+	{
+		cerr << "Usage: " << argv[0]
+			<< " [--tick-rate N] [--frame-rate N] [--seed N]"
+			<< " [--ai KIND] [--policy FILE]" << endl
+			<< "       [--net FILE] [--difficulty FILE]" << endl
+			<< "       [--record FILE | --replay FILE |"
+			<< " --host PORT | --join HOST:PORT]" << endl
+			<< "       [--latency MS] [--jitter MS] [--loss FRACTION]"
+			<< endl
+			<< "       [--publish NAME | --watch NAME]"
+			<< " [--immediate] [--gl-stats]" << endl;
+		return 1;
+	}
+	if (tick_rate <= 0) tick_rate = 60;
+	if (frame_rate <= 0) frame_rate = 120;
+
+	if (policy != NULL && !game->loadPolicy(policy))
+	{
+		cerr << "Unable to load a policy from " << policy << endl;
+		return 1;
+	}
+	if (net != NULL && !game->loadNet(net))
+	{
+		cerr << "Unable to load a network from " << net << endl;
+		return 1;
+	}
+
+	// A tuned difficulty is used if there is one, unless another is given
+	if (difficulty == NULL)
+	{
+		game->loadDifficulty("pong.difficulty");
+	}
+	else if (!game->loadDifficulty(difficulty))
+	{
+		cerr << "Unable to load a difficulty from " << difficulty << endl;
+		return 1;
+	}
+
+	if (record != NULL && !game->startRecording(record))
+	{
+		cerr << "Unable to record to " << record << endl;
+		return 1;
+	}
+
+	// Share every step with viewers, or be one
+	if (publish != NULL || watch != NULL)
+	{
+		spectators = new (nothrow) SpectatorChannel();
+		watching = watch != NULL;
+		bool opened = (spectators != NULL) && (watching
+			? spectators->watch(watch)
+			: spectators->publish(publish));
+		if (!opened)
+		{
+			cerr << "Unable to open channel "
+				<< (watching ? watch : publish) << endl;
+			return 1;
+		}
+	}
+
+	// Start the game, or play back the replay instead
+	game->setSeed(seed);
+	game->setAIKind(false, ai_kind);
+	game->setAIKind(true, ai_kind);
+	if (watching)
+	{
+		// The publisher's game arrives on the first step
+	}
+	else if (networked)
+	{
+		link = new (nothrow) NetLink();
+		bool opened = (link != NULL) && (host_port != 0
+			? link->listen(host_port)
+			: link->connect(join.substr(0, colon).c_str(),
+				atoi(join.c_str() + colon + 1)));
+		if (!opened)
+		{
+			cerr << "Unable to open the connection" << endl;
+			return 1;
+		}
+		link->setConditions(latency, jitter, loss, seed);
+		session = new (nothrow) RollbackSession(game, link, host_port != 0,
+			seed);
+	}
+	else if (replay != NULL)
+	{
+		if (!game->startPlayback(replay))
+		{
+			cerr << "Unable to read replay " << replay << endl;
+			return 1;
+		}
+	}
+	else
+	{
+		game->startGame(true, true);
+		displayMenu();
+	}
+
 	// Put window in center of screen
 	int w = glutGet(GLUT_SCREEN_WIDTH);
 	int h = glutGet(GLUT_SCREEN_HEIGHT);
@@ -108,6 +322,7 @@ int Pong::run( int argc, char *argv[] )
     glutInitWindowSize( view_width, view_height);    // initial window size
     glutInitWindowPosition( w, h );                  // initial window position
     glutCreateWindow( window_name.c_str() );         // window title
+	renderer.init();
 
 	// Always clear screen to black
 	glClearColor( 0, 0, 0, 1.0 );
@@ -122,6 +337,7 @@ int Pong::run( int argc, char *argv[] )
 	glutSpecialFunc( *::keySpecialDown );
 	glutSpecialUpFunc( *::keySpecialUp );
     glutMouseFunc( *::mouseclick );
+	last_step = chrono::steady_clock::now();
 	glutTimerFunc(0, *::step, 0);
 
     // Go into OpenGL/GLUT main loop
@@ -262,6 +478,34 @@ int Pong::getViewHeight()
 	return view_height;
 }
 
+/***************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: Gets the number of game steps run per second. This is
+ *		fixed, no matter how fast or slow frames are drawn.
+ *
+ * @returns Game steps per second.
+*******************************************************************************/
+double Pong::getTickRate()
+{
+	return tick_rate;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: Gets how far between the last two game steps the frame
+ *		being drawn is. Moving objects draw themselves this far between their
+ *		previous and current positions, so motion stays smooth when the frame
+ *		rate and tick rate differ.
+ *
+ * @returns 0 for the previous step's positions up to 1 for the current ones.
+*******************************************************************************/
+double Pong::getInterpolation()
+{
+	return interpolation;
+}
+
 /***************************************************************************//**
  * @author Johnny Ackerman
  * 
@@ -361,6 +605,7 @@ void Pong::displayMenu()
 	// Quit Pong
 	item = new (nothrow) MenuItem(menu, item_x, item_y, item_w, item_h, item_b, "Quit Pong");
 	item -> setAction([](){
+		Pong::getInstance() -> getGame() -> stopRecording();
 		exit(0);
 	});
 	menu -> addItem(item);
@@ -398,8 +643,10 @@ void Pong::display()
 	//clear the display and set backround to black
 	glClear( GL_COLOR_BUFFER_BIT );
 	glColor3f( 1.0, 1.0, 1.0 );
+	renderer.beginFrame();
     
-	// Draw all registered drawables
+	// Draw all registered drawables, a layer at a time so each layer covers
+	// the ones under it
 	typedef map<int, list<Drawable*>>::iterator it_type;
 	for (it_type iterator = drawables.begin();
 		iterator != drawables.end();
@@ -409,7 +656,9 @@ void Pong::display()
 		{
 			d->draw();
 		}
+		renderer.flush();
 	}
+	renderer.endFrame();
 
 	// Flush graphical output
     glutSwapBuffers();
@@ -480,15 +729,23 @@ void Pong::reshape(int w, int h)
 *******************************************************************************/
 void Pong::keyDown(unsigned char key, int x, int y)
 {
+	// Viewers can only leave
+	if ( watching && key != 27 ) return;
+
     switch ( key )
     {
         case 27:		// Escape
 			game -> quitGame();
+			game -> stopRecording();
+			if ( spectators != NULL ) spectators -> close();
 			closeMenu();
             exit( 0 );
             break;
 
 		case 32:		// Space
+			// Networked games can't be paused or restarted
+			if ( session != NULL ) break;
+
 			if ( game -> isRunning() && !game -> isDemo() )
 			{
 				if ( game -> isPaused() )
@@ -509,6 +766,10 @@ void Pong::keyDown(unsigned char key, int x, int y)
 			break;
 
         default:		// Everything else, forward to game manager
+			// Only the paddle keys are shared in a networked game
+			if ( session != NULL && (key == '-' || key == '_' || key == '='
+				|| key == '+') ) break;
+
 			game -> keyDownEvent(key);
             break;
     }
@@ -528,6 +789,7 @@ void Pong::keyDown(unsigned char key, int x, int y)
 *******************************************************************************/
 void Pong::keyUp(unsigned char key, int x, int y)
 {
+	if (watching) return;
 	game->keyUpEvent(key);
 }
 
@@ -535,7 +797,9 @@ void Pong::keyUp(unsigned char key, int x, int y)
  * @author Daniel Andrus, Johnny Ackerman
  * 
  * @par Description: Special key down callback. Executes whenever a "special"
- *		key such as an arrow key is pressed.
+ *		key such as an arrow key is pressed. While a replay is being played
+ *		back, the left and right arrows seek five seconds back and forward,
+ *		page up and page down a minute, and home and end to either end.
  *  
  * @param[in]	key - Special GLUT enumerator of the key.
  * @param[in]	x - The x coordinate of the mouse at the time the key
@@ -545,7 +809,36 @@ void Pong::keyUp(unsigned char key, int x, int y)
 *******************************************************************************/
 void Pong::keySpecialDown(int key, int x, int y)
 {
-	game->keySpecialDownEvent(key);
+	if (watching) return;
+	if (!game->isPlayingBack())
+	{
+		game->keySpecialDownEvent(key);
+		return;
+	}
+
+	long tick = game->getReplayTick();
+	long seconds = (long) tick_rate;
+	switch (key)
+	{
+		case GLUT_KEY_LEFT:
+			game->seekPlayback(tick - 5 * seconds);
+			break;
+		case GLUT_KEY_RIGHT:
+			game->seekPlayback(tick + 5 * seconds);
+			break;
+		case GLUT_KEY_PAGE_UP:
+			game->seekPlayback(tick - 60 * seconds);
+			break;
+		case GLUT_KEY_PAGE_DOWN:
+			game->seekPlayback(tick + 60 * seconds);
+			break;
+		case GLUT_KEY_HOME:
+			game->seekPlayback(0);
+			break;
+		case GLUT_KEY_END:
+			game->seekPlayback(game->getReplayLength());
+			break;
+	}
 }
 
 /***************************************************************************//**
@@ -562,6 +855,7 @@ void Pong::keySpecialDown(int key, int x, int y)
 *******************************************************************************/
 void Pong::keySpecialUp(int key, int x, int y)
 {
+	if (watching) return;
 	game->keySpecialUpEvent(key);
 }
 
@@ -606,13 +900,87 @@ void Pong::mouseclick(int button, int state, int x, int y)
 /***************************************************************************//**
  * @author Daniel Andrus
  * 
- * @par Description: Step callback. Called every frame of the game. Calls step
- *		function of other classes necessary for the game. Necessary
- *		for game elemnts that are not dependent on user interaction.
+ * @par Description: Step callback. Called every frame of the game. Measures
+ *		the time since the last call on a monotonic clock and runs that many
+ *		game steps at the fixed tick rate, carrying leftover time over to the
+ *		next call. If the game falls too far behind, only max_substeps steps
+ *		are run and the rest of the backlog is dropped, so a long frame
+ *		can't snowball into longer and longer frames. A networked game is
+ *		stepped through its RollbackSession. A published game is sent to its
+ *		viewers after every step; a watched one is not stepped at all, but
+ *		put into the next state the publisher sent instead.
 *******************************************************************************/
 void Pong::step()
 {
-	game->step();
+	chrono::steady_clock::time_point now = chrono::steady_clock::now();
+	double tick_length = 1.0 / tick_rate;
+	int ticks = 0;
+	PongState state;
+
+	accumulator += chrono::duration<double>(now - last_step).count();
+	last_step = now;
+
+	while (accumulator >= tick_length && ticks < max_substeps)
+	{
+		if (watching)
+		{
+			if (spectators->receive(state))
+				game->restoreState(state);
+		}
+		else
+		{
+			if (session != NULL)
+				session->advance();
+			else
+				game->step();
+			if (spectators != NULL)
+			{
+				game->saveState(state);
+				spectators->send(state);
+			}
+		}
+		accumulator -= tick_length;
+		ticks++;
+	}
+
+	// Give up on a networked game once the other side goes quiet
+	if (session != NULL && session->isStarted() && session->hasTimedOut())
+	{
+		cerr << "The other player stopped answering" << endl;
+		game->quitGame();
+		delete session;
+		session = NULL;
+		displayMenu();
+	}
+
+	// Too far behind to catch up, drop the backlog
+	if (accumulator >= tick_length)
+	{
+		accumulator = fmod(accumulator, tick_length);
+	}
+
+	// Nothing moves while paused, so draw things where they are
+	if (game -> isRunning() && game -> isPaused())
+	{
+		interpolation = 1.0;
+	}
+	else
+	{
+		interpolation = accumulator / tick_length;
+	}
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: Gets the number of milliseconds to wait between frames.
+ *
+ * @returns Delay between frames in milliseconds, at least 1.
+*******************************************************************************/
+unsigned int Pong::getFrameDelay()
+{
+	unsigned int delay = (unsigned int) (1000.0 / frame_rate);
+	return delay > 0 ? delay : 1;
 }
 
 /*******************************************************************************
@@ -745,11 +1113,9 @@ void mouseclick(int button, int state, int x, int y)
 *******************************************************************************/
 void step(int i)
 {
-	// FPS, or technically "milliseconds per frame"
-	static unsigned int fps_delay = 1000 / 60;
-	
-	// Reset the timer
-	glutTimerFunc(fps_delay, *::step, 0);
+	// Reset the timer. This only sets how often frames are drawn, the game
+	// itself steps at a fixed rate no matter how late this fires.
+	glutTimerFunc(Pong::getInstance()->getFrameDelay(), *::step, 0);
 	
 	// Call step function
 	Pong::getInstance()->step();
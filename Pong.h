@@ -14,12 +14,21 @@ class Pong;
 
 #include <iostream>
 #include <string>
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
 #include <map>
 #include <list>
+#include <chrono>
 #include <GL/freeglut.h>
 #include <time.h>
 #include "PongGame.h"
+#include "NetLink.h"
+#include "RollbackSession.h"
+#include "SpectatorChannel.h"
 #include "Drawable.h"
+#include "DrawRegistry.h"
+#include "Renderer.h"
 #include "Menu.h"
 
 using namespace std;
@@ -34,7 +43,7 @@ using namespace std;
  *		It handles drawing functions, forwards OpenGL events, generates a
  *		framerate, and standardizes various aspects of the game.
 *******************************************************************************/
-class Pong
+class Pong : public DrawRegistry
 {
 	private:
 		static Pong* instance;	/*!< reference to main instance of this class */
@@ -49,10 +58,31 @@ class Pong
 		Menu* menu;				/*!< Menu object */
 		
 		PongGame* game;			/*!< Pointer to instance of the game manager */
+		NetLink* link;			/*!< Connection to the other player in a
+									networked game, NULL if none */
+		RollbackSession* session;	/*!< Plays the networked game, NULL if
+										none */
+		SpectatorChannel* spectators;	/*!< Channel the game is published
+											on or watched from, NULL if
+											none */
+		bool watching;			/*!< True if only watching another
+									process's game */
 		map<int, list<Drawable*>> drawables;	/*!< list of objects to draw*/
+		Renderer renderer;		/*!< Batches up the shapes of each frame */
+
+		double tick_rate;		/*!< Game steps per second */
+		double frame_rate;		/*!< Redraws per second */
+		int max_substeps;		/*!< Most game steps run to catch up per
+									callback before time is dropped */
+		double accumulator;		/*!< Seconds of game time not yet stepped */
+		double interpolation;	/*!< How far between the last two game steps
+									the current frame is, 0 to 1 */
+		chrono::steady_clock::time_point last_step;	/*!< When step() last ran
+														*/
 		
 	public:
-		static const int unit;	/*!< Unit of measurement used in calculations */
+		static const int unit = PongGame::unit;	/*!< Unit of measurement used
+													in calculations */
 
 		/*!
 		 * @brief The constructor. Initializes variables and classes.
@@ -82,6 +112,12 @@ class Pong
 		 */
 		int run ( int argc, char *argv[] );
 
+		/*!
+		 * @brief Gets the renderer that Drawable objects draw their shapes
+		 *		with.
+		 */
+		Renderer* getRenderer();
+
 		/*!
 		 * @brief Registers a Drawable object to be drawn on demand.
 		 */
@@ -123,6 +159,17 @@ class Pong
 		 */
 		int getViewHeight();
 		
+		/*!
+		 * @brief Gets the number of game steps run per second.
+		 */
+		double getTickRate();
+
+		/*!
+		 * @brief Gets how far between the last two game steps the frame
+		 *		being drawn is. Used to smooth out movement.
+		 */
+		double getInterpolation();
+		
 		/*!
 		 *  @brief accesses the menu entity
 		 */
@@ -178,11 +225,16 @@ class Pong
 		void mouseclick( int button, int state, int x, int y );
 
 		/*!
-		 * @brief Step callback. Called every frame of the game. Calls step
-		 *		function of other classes necessary for the game. Necessary
+		 * @brief Step callback. Called every frame of the game. Runs as many
+		 *		game steps as the time since the last call is worth. Necessary
 		 *		for game elemnts that are not dependent on user interaction.
 		 */
 		void step();
+
+		/*!
+		 * @brief Gets the number of milliseconds to wait between frames.
+		 */
+		unsigned int getFrameDelay();
 };
 
 /*******************************************************************************
@@ -0,0 +1,276 @@
+/***************************************************************************//**
+ * @file File containing the blocky font PongText draws with.
+ *
+ * @brief Contains the rectangles every character of the blocky font is made
+ *		of, and a table to look characters up in, all worked out by the
+ *		compiler.
+*******************************************************************************/
+#ifndef _PONGFONT_H_
+#define _PONGFONT_H_
+
+/*******************************************************************************
+ *                 DECLARATIONS, INCLUDES, AND NAMESPACES
+*******************************************************************************/
+
+/*!
+ * @brief One rectangle of a character, in eighths of the text size, across
+ *		from the left of the character and down from its top
+ */
+struct FontRect
+{
+	signed char x1;		/*!< Left edge */
+	signed char y1;		/*!< Top edge */
+	signed char x2;		/*!< Right edge */
+	signed char y2;		/*!< Bottom edge */
+};
+
+/*!
+ * @brief Where a character's rectangles are in font_rects, and how wide it is
+ */
+struct FontGlyph
+{
+	char c;					/*!< The character, in upper case */
+	unsigned char first;	/*!< Its first rectangle in font_rects */
+	unsigned char count;	/*!< How many rectangles it has */
+	unsigned char width;	/*!< Its width in eighths of the text size */
+};
+
+/*!
+ * @brief Every rectangle of every character, a character's all together in
+ *		the order they are drawn: vertical lines first from left to right
+ *		then top to bottom, horizontal lines next from top to bottom then
+ *		left to right, and single points in whatever order suits
+ */
+constexpr FontRect font_rects[] =
+{
+	// '0' and 'O'
+	{ 0, 0, 1, 8 }, { 3, 0, 4, 8 }, { 1, 0, 3, 1 }, { 1, 7, 3, 8 },
+	// '1'
+	{ 0, 0, 1, 8 },
+	// '2'
+	{ 0, 3, 1, 8 }, { 3, 0, 4, 4 }, { 0, 0, 3, 1 }, { 1, 3, 3, 4 },
+	{ 1, 7, 4, 8 },
+	// '3'
+	{ 3, 0, 4, 8 }, { 0, 0, 3, 1 }, { 0, 3, 3, 4 }, { 0, 7, 3, 8 },
+	// '4'
+	{ 0, 0, 1, 4 }, { 3, 0, 4, 8 }, { 1, 3, 3, 4 },
+	// '5'
+	{ 0, 0, 1, 4 }, { 3, 3, 4, 8 }, { 1, 0, 4, 1 }, { 1, 3, 3, 4 },
+	{ 0, 7, 3, 8 },
+	// '6'
+	{ 0, 0, 1, 8 }, { 3, 3, 4, 8 }, { 1, 0, 4, 1 }, { 1, 3, 3, 4 },
+	{ 1, 7, 3, 8 },
+	// '7'
+	{ 0, 0, 4, 1 }, { 3, 1, 4, 8 },
+	// '8'
+	{ 0, 0, 1, 8 }, { 3, 0, 4, 8 }, { 1, 0, 3, 1 }, { 1, 3, 3, 4 },
+	{ 1, 7, 3, 8 },
+	// '9'
+	{ 0, 0, 1, 4 }, { 3, 0, 4, 8 }, { 1, 0, 3, 1 }, { 1, 3, 3, 4 },
+	// 'A'
+	{ 0, 0, 1, 8 }, { 3, 0, 4, 8 }, { 1, 0, 3, 1 }, { 1, 3, 3, 4 },
+	// 'B'
+	{ 0, 0, 1, 8 }, { 3, 0, 4, 3 }, { 3, 4, 4, 8 }, { 1, 0, 3, 1 },
+	{ 1, 3, 3, 4 }, { 1, 7, 3, 8 },
+	// 'C'
+	{ 0, 0, 1, 8 }, { 1, 0, 4, 1 }, { 1, 7, 4, 8 },
+	// 'D'
+	{ 0, 0, 1, 8 }, { 3, 1, 4, 7 }, { 1, 0, 3, 1 }, { 1, 7, 3, 8 },
+	// 'E'
+	{ 0, 0, 1, 8 }, { 1, 0, 4, 1 }, { 1, 3, 4, 4 }, { 1, 7, 4, 8 },
+	// 'F'
+	{ 0, 0, 1, 8 }, { 1, 0, 4, 1 }, { 1, 3, 4, 4 },
+	// 'G'
+	{ 0, 0, 1, 8 }, { 3, 3, 4, 8 }, { 1, 0, 4, 1 }, { 2, 3, 3, 4 },
+	{ 1, 7, 3, 8 },
+	// 'H'
+	{ 0, 0, 1, 8 }, { 3, 0, 4, 8 }, { 1, 3, 3, 4 },
+	// 'I'
+	{ 1, 1, 2, 7 }, { 0, 0, 3, 1 }, { 0, 7, 3, 8 },
+	// 'J'
+	{ 0, 6, 1, 7 }, { 2, 1, 3, 7 }, { 1, 0, 4, 1 }, { 0, 7, 3, 8 },
+	// 'K'
+	{ 0, 0, 1, 8 }, { 3, 0, 4, 3 }, { 3, 4, 4, 8 }, { 1, 3, 3, 4 },
+	// 'L'
+	{ 0, 0, 1, 8 }, { 1, 7, 4, 8 },
+	// 'M'
+	{ 0, 0, 1, 8 }, { 4, 0, 5, 8 }, { 1, 1, 2, 2 }, { 2, 2, 3, 3 },
+	{ 3, 1, 4, 2 },
+	// 'N'
+	{ 0, 0, 1, 8 }, { 4, 0, 5, 8 }, { 1, 1, 2, 3 }, { 2, 3, 3, 5 },
+	{ 3, 5, 4, 7 },
+	// 'P'
+	{ 0, 0, 1, 8 }, { 3, 0, 4, 4 }, { 1, 0, 3, 1 }, { 1, 3, 3, 4 },
+	// 'Q'
+	{ 0, 0, 1, 8 }, { 3, 0, 4, 8 }, { 1, 0, 3, 1 }, { 1, 7, 3, 8 },
+	{ 2, 6, 3, 7 },
+	// 'R'
+	{ 0, 0, 1, 8 }, { 3, 0, 4, 3 }, { 3, 4, 4, 8 }, { 1, 0, 3, 1 },
+	{ 1, 3, 3, 4 },
+	// 'S'
+	{ 0, 0, 4, 1 }, { 0, 1, 1, 3 }, { 0, 3, 4, 4 }, { 3, 4, 4, 7 },
+	{ 0, 7, 4, 8 },
+	// 'T'
+	{ 2, 1, 3, 8 }, { 0, 0, 5, 1 },
+	// 'U'
+	{ 0, 0, 1, 8 }, { 3, 0, 4, 8 }, { 1, 7, 3, 8 },
+	// 'V'
+	{ 0, 0, 1, 6 }, { 3, 0, 4, 7 }, { 1, 6, 2, 7 }, { 2, 7, 3, 8 },
+	// 'W'
+	{ 0, 0, 1, 8 }, { 2, 3, 3, 7 }, { 4, 0, 5, 8 }, { 1, 7, 4, 8 },
+	// 'X'
+	{ 0, 0, 1, 4 }, { 0, 5, 1, 8 }, { 3, 0, 4, 3 }, { 3, 4, 4, 8 },
+	{ 1, 4, 2, 5 }, { 2, 3, 3, 4 },
+	// 'Y'
+	{ 0, 0, 1, 4 }, { 3, 0, 4, 8 }, { 1, 3, 3, 4 }, { 0, 7, 3, 8 },
+	// 'Z'
+	{ 0, 6, 1, 7 }, { 1, 4, 2, 6 }, { 2, 2, 3, 4 }, { 3, 1, 4, 2 },
+	{ 0, 0, 4, 1 }, { 0, 7, 4, 8 },
+	// '.'
+	{ 0, 7, 1, 8 },
+	// ','
+	{ 0, 7, 1, 9 },
+	// '!'
+	{ 0, 0, 1, 6 }, { 0, 7, 1, 8 },
+	// ':'
+	{ 0, 2, 1, 3 }, { 0, 7, 1, 8 },
+	// ';'
+	{ 0, 2, 1, 3 }, { 0, 7, 1, 9 },
+	// '|'
+	{ 0, -1, 1, 9 },
+	// '\''
+	{ 0, 0, 1, 2 },
+	// '?'
+	{ 0, 0, 1, 1 }, { 0, 3, 1, 6 }, { 0, 7, 1, 8 }, { 1, 0, 2, 4 },
+	// '('
+	{ 0, 1, 1, 7 }, { 1, 0, 2, 1 }, { 1, 7, 2, 8 },
+	// ')'
+	{ 0, 0, 1, 1 }, { 0, 7, 1, 8 }, { 1, 1, 2, 7 },
+	// '['
+	{ 0, 0, 1, 8 }, { 1, 0, 2, 1 }, { 1, 7, 2, 8 },
+	// ']'
+	{ 0, 0, 1, 1 }, { 0, 7, 1, 8 }, { 1, 0, 2, 8 },
+	// '"'
+	{ 0, 0, 1, 2 }, { 2, 0, 3, 2 },
+	// '-'
+	{ 0, 4, 3, 5 },
+	// '+'
+	{ 1, 3, 2, 4 }, { 1, 5, 2, 6 }, { 0, 4, 3, 5 },
+	// '='
+	{ 0, 3, 3, 4 }, { 0, 5, 3, 6 },
+	// '_'
+	{ 0, 7, 4, 8 },
+	// '/'
+	{ 0, 6, 1, 8 }, { 1, 4, 2, 6 }, { 2, 2, 3, 4 }, { 3, 0, 4, 2 },
+	// '\\'
+	{ 0, 0, 1, 2 }, { 1, 2, 2, 4 }, { 2, 4, 3, 6 }, { 3, 6, 4, 8 },
+};
+
+/*!
+ * @brief Every character the font has. A space has no rectangles but takes
+ *		up room.
+ */
+constexpr FontGlyph font_glyphs[] =
+{
+	{ '0', 0, 4, 4 },
+	{ 'O', 0, 4, 4 },
+	{ '1', 4, 1, 1 },
+	{ '2', 5, 5, 4 },
+	{ '3', 10, 4, 4 },
+	{ '4', 14, 3, 4 },
+	{ '5', 17, 5, 4 },
+	{ '6', 22, 5, 4 },
+	{ '7', 27, 2, 4 },
+	{ '8', 29, 5, 4 },
+	{ '9', 34, 4, 4 },
+	{ 'A', 38, 4, 4 },
+	{ 'B', 42, 6, 4 },
+	{ 'C', 48, 3, 4 },
+	{ 'D', 51, 4, 4 },
+	{ 'E', 55, 4, 4 },
+	{ 'F', 59, 3, 4 },
+	{ 'G', 62, 5, 4 },
+	{ 'H', 67, 3, 4 },
+	{ 'I', 70, 3, 3 },
+	{ 'J', 73, 4, 4 },
+	{ 'K', 77, 4, 4 },
+	{ 'L', 81, 2, 4 },
+	{ 'M', 83, 5, 5 },
+	{ 'N', 88, 5, 5 },
+	{ 'P', 93, 4, 4 },
+	{ 'Q', 97, 5, 4 },
+	{ 'R', 102, 5, 4 },
+	{ 'S', 107, 5, 4 },
+	{ 'T', 112, 2, 5 },
+	{ 'U', 114, 3, 4 },
+	{ 'V', 117, 4, 4 },
+	{ 'W', 121, 4, 5 },
+	{ 'X', 125, 6, 4 },
+	{ 'Y', 131, 4, 4 },
+	{ 'Z', 135, 6, 4 },
+	{ '.', 141, 1, 1 },
+	{ ',', 142, 1, 1 },
+	{ '!', 143, 2, 1 },
+	{ ':', 145, 2, 1 },
+	{ ';', 147, 2, 1 },
+	{ '|', 149, 1, 1 },
+	{ '\'', 150, 1, 1 },
+	{ '?', 151, 4, 2 },
+	{ '(', 155, 3, 2 },
+	{ ')', 158, 3, 2 },
+	{ '[', 161, 3, 2 },
+	{ ']', 164, 3, 2 },
+	{ '"', 167, 2, 3 },
+	{ '-', 169, 1, 3 },
+	{ '+', 170, 3, 3 },
+	{ '=', 173, 2, 3 },
+	{ '_', 175, 1, 4 },
+	{ '/', 176, 4, 4 },
+	{ '\\', 180, 4, 4 },
+	{ ' ', 0, 0, 1 },
+};
+
+/*!
+ * @brief Number of characters in font_glyphs
+ */
+constexpr int font_glyph_count = sizeof(font_glyphs) / sizeof(font_glyphs[0]);
+
+/*!
+ * @brief Finds a character in font_glyphs, as upper case, for building
+ *		font_table. Characters the font doesn't have get no rectangles and
+ *		no width.
+ *
+ * @param[in]	c - The character, 0 to 255.
+ * @param[in]	i - Where in font_glyphs to start looking.
+ *
+ * @returns The character's entry.
+ */
+constexpr FontGlyph font_find(int c, int i = 0)
+{
+	return i == font_glyph_count ? FontGlyph { (char) c, 0, 0, 0 }
+		: font_glyphs[i].c == (char) (c >= 'a' && c <= 'z' ? c - 'a' + 'A' : c)
+		? font_glyphs[i] : font_find(c, i + 1);
+}
+
+#define FONT_ROW(c) font_find(c), font_find(c + 1), font_find(c + 2), \
+	font_find(c + 3), font_find(c + 4), font_find(c + 5), font_find(c + 6), \
+	font_find(c + 7), font_find(c + 8), font_find(c + 9), font_find(c + 10), \
+	font_find(c + 11), font_find(c + 12), font_find(c + 13), \
+	font_find(c + 14), font_find(c + 15)
+
+/*!
+ * @brief Every character from 0 to 255, looked up ahead of time, so drawing
+ *		or measuring a character is one look into an array. Index it with the
+ *		character as an unsigned char.
+ */
+constexpr FontGlyph font_table[256] =
+{
+	FONT_ROW(0), FONT_ROW(16), FONT_ROW(32), FONT_ROW(48),
+	FONT_ROW(64), FONT_ROW(80), FONT_ROW(96), FONT_ROW(112),
+	FONT_ROW(128), FONT_ROW(144), FONT_ROW(160), FONT_ROW(176),
+	FONT_ROW(192), FONT_ROW(208), FONT_ROW(224), FONT_ROW(240)
+};
+
+#undef FONT_ROW
+
+#endif
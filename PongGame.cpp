@@ -7,8 +7,11 @@
 /*******************************************************************************
  *                 DECLARATIONS, INCLUDES, AND NAMESPACES
 *******************************************************************************/
+#include <cstring>
 #include "PongGame.h"
 
+const int PongGame::unit;
+
 /*******************************************************************************
  *                          FUNCTION DEFINITIONS
 *******************************************************************************/
@@ -16,17 +19,22 @@
  * @author Daniel Andrus
  * 
  * @par Description: The constructor. Initializes variables and classes.
+ *
+ * @param[in]	width - Width of the playing field.
+ * @param[in]	height - Height of the playing field.
+ * @param[in]	registry - OPTIONAL. Where game elements are registered to be
+ *				drawn. Pass NULL (the default) to run without a window.
 *******************************************************************************/
-PongGame::PongGame() :
-		game_active(false), game_paused(false), board(NULL),
-		left_paddle(NULL), right_paddle(NULL), ball(NULL),
-		left_controller(NULL), right_controller(NULL),
-		ball_timer(-1)
+PongGame::PongGame(int width, int height, DrawRegistry* registry) :
+		game_active(false), game_paused(false), score_demo(false),
+		left_ai_kind(AI_FOLLOW), right_ai_kind(AI_FOLLOW), width(width),
+		height(height), ball_timer(-1), recording(NULL), playback(NULL),
+		match_tick(0), recorded_input(0), replay_mismatches(0),
+		keyframe_interval(600), next_keyframe(0), replay_base(0),
+		registry(registry), board(NULL), left_paddle(NULL),
+		right_paddle(NULL), ball(NULL), left_controller(NULL),
+		right_controller(NULL)
 {
-	Pong* pong = Pong::getInstance();
-	width = pong->getViewWidth();
-	height = pong->getViewHeight();
-	
 	reset();
 }
 
@@ -37,6 +45,8 @@ PongGame::PongGame() :
 *******************************************************************************/
 PongGame::~PongGame()
 {
+	stopRecording();
+	stopPlayback();
 	clear();
 }
 
@@ -45,13 +55,29 @@ PongGame::~PongGame()
  * 
  * @par Description: Handles each step of the game. Does nothing if game is
  *		paused. Calls step() functions of objects that perform actions on each
- *		step, such as paddles, paddle controllers, and the ball.
+ *		step, such as paddles, paddle controllers, and the ball. When a
+ *		replay is being played back, first does what it says happens before
+ *		this step; when recording, first records any change in the keys held
+ *		and, every so often, the whole state of the game.
 *******************************************************************************/
 void PongGame::step()
 {
 	// Don't do anything if the game is paused or if no game is running
 	if (game_active && game_paused) return;
 
+	if (playback != NULL)
+		playEvents();
+	if (game_active)
+	{
+		if (recording != NULL)
+		{
+			recordInput();
+			if (match_tick >= next_keyframe)
+				recordKeyframe();
+		}
+		match_tick++;
+	}
+
 	// Forward paddle events to relevent objects
 	if (left_paddle != NULL)
 		left_paddle -> step();
@@ -80,6 +106,97 @@ void PongGame::step()
 	}
 }
 
+/***************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: Counts how many of the coming steps can be jumped over
+ *		with skip(): steps in which the ball touches nothing, the ball isn't
+ *		served, nobody is holding a key down, and the paddle controllers
+ *		carry on doing what they're doing. Running games step by step and
+ *		skipping these in between give exactly the same games.
+ *
+ * @param[in]	limit - Most steps to count.
+ *
+ * @returns Number of steps, up to limit, that skip() may be given.
+*******************************************************************************/
+long PongGame::quietSteps(long limit)
+{
+	if (game_paused || ball == NULL) return 0;
+
+	Paddle* paddles[] = { left_paddle, right_paddle };
+	for (int i = 0; i < 2; i++)
+	{
+		if (paddles[i] == NULL) return 0;
+		if (paddles[i]->up || paddles[i]->down || paddles[i]->left
+			|| paddles[i]->right)
+		{
+			return 0;
+		}
+	}
+
+	// Keys that changed must be recorded on the step they changed
+	if (recording != NULL && getInput() != recorded_input) return 0;
+
+	long steps = ball->quietSteps(limit);
+	if (ball_timer >= 0 && ball_timer < steps)
+	{
+		steps = ball_timer;
+	}
+
+	// Stop in time for the next thing the replay says happens
+	ReplayEvent event;
+	if (playback != NULL && playback->peekEvent(event)
+		&& event.tick - match_tick < steps)
+	{
+		steps = event.tick - match_tick;
+		if (steps < 0) steps = 0;
+	}
+	if (left_controller != NULL)
+		steps = left_controller->quietSteps(steps);
+	if (right_controller != NULL)
+		steps = right_controller->quietSteps(steps);
+	return steps;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: Jumps the game ahead a number of steps without taking
+ *		them one at a time. Only valid for as many steps as quietSteps()
+ *		allows. All but the last step are jumped at once and the last one
+ *		in the order step() takes it, so that the paddles remember where
+ *		they were a step before the end, as they would have after stepping.
+ *
+ * @param[in]	steps - Number of steps to skip.
+*******************************************************************************/
+void PongGame::skip(long steps)
+{
+	if (steps <= 0 || ball == NULL) return;
+
+	if (steps > 1)
+	{
+		ball->skip(steps - 1);
+		if (left_controller != NULL)
+			left_controller->skip(steps - 1);
+		if (right_controller != NULL)
+			right_controller->skip(steps - 1);
+	}
+	left_paddle->skip(1);
+	right_paddle->skip(1);
+	ball->skip(1);
+	if (left_controller != NULL)
+		left_controller->skip(1);
+	if (right_controller != NULL)
+		right_controller->skip(1);
+	match_tick += steps;
+
+	ball_timer -= steps;
+	if (ball_timer < -1)
+	{
+		ball_timer = -1;
+	}
+}
+
 /***************************************************************************//**
  * @author Daniel Andrus
  * 
@@ -89,6 +206,9 @@ void PongGame::step()
 *******************************************************************************/
 void PongGame::keyDownEvent(unsigned char key)
 {
+	// A replay being played back does the pressing
+	if (playback != NULL) return;
+
 	// Forward event to paddle controllers (aka players)
 	if (left_controller != NULL)
 		left_controller->keyDown((char) key);
@@ -96,22 +216,13 @@ void PongGame::keyDownEvent(unsigned char key)
 		right_controller->keyDown((char) key);
 
 	// Adjust ball speed
-	if (ball != NULL && !game_paused)
+	if (key == '-' || key == '_')
 	{
-		if (key == '-' || key == '_')
-		{
-			ball->setSpeedModifier(ball->getSpeedModifier() - 0.25);
-		}
-		if (key == '=' || key == '+')
-		{
-			ball->setSpeedModifier(ball->getSpeedModifier() + 0.25);
-
-			// Apply governor to ball speed. Too much, and we may lose it.
-			if (ball->getSpeedModifier() > 2.0)
-			{
-				ball->setSpeedModifier(2.0);
-			}
-		}
+		changeSpeed(false);
+	}
+	if (key == '=' || key == '+')
+	{
+		changeSpeed(true);
 	}
 }
 
@@ -124,6 +235,7 @@ void PongGame::keyDownEvent(unsigned char key)
 *******************************************************************************/
 void PongGame::keyUpEvent(unsigned char key)
 {
+	if (playback != NULL) return;
 	if (left_controller != NULL)
 		left_controller->keyUp((char) key);
 	if (right_controller != NULL)
@@ -139,6 +251,7 @@ void PongGame::keyUpEvent(unsigned char key)
 *******************************************************************************/
 void PongGame::keySpecialDownEvent(int key)
 {
+	if (playback != NULL) return;
 	if (left_controller != NULL)
 		left_controller->keySpecialDown(key);
 	if (right_controller != NULL)
@@ -154,6 +267,7 @@ void PongGame::keySpecialDownEvent(int key)
 *******************************************************************************/
 void PongGame::keySpecialUpEvent(int key)
 {
+	if (playback != NULL) return;
 	if (left_controller != NULL)
 		left_controller->keySpecialUp(key);
 	if (right_controller != NULL)
@@ -175,6 +289,26 @@ void PongGame::startGame(bool left_ai, bool right_ai)
 	// If a game is already running, just do nothing.
 	if (game_active) return;
 
+	// A game asked for takes over from any replay being played back
+	stopPlayback();
+	beginGame(left_ai, right_ai);
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: Sets up and starts a new game. Records its start, and
+ *		the state it starts in, if games are being recorded.
+ *
+ * @param[in]	left_ai - True to make the left paddle AI-controlled.
+ * @param[in]	right_ai - True to make the right paddle AI-controlled.
+*******************************************************************************/
+void PongGame::beginGame(bool left_ai, bool right_ai)
+{
+	// Where the random numbers are before the game draws any
+	ReplayMatch match;
+	random.getState(match.random_state, match.random_increment);
+
 	this -> left_ai = left_ai;
 	this -> right_ai = right_ai;
 
@@ -190,17 +324,11 @@ void PongGame::startGame(bool left_ai, bool right_ai)
 	hit_count = 0;
 	ball = new (nothrow) Ball(this, 0, 0, 20, 0, 0);
 	resetBall();
-	Pong::getInstance() -> drawObject( ball, 1 );
+	if (registry != NULL) registry -> drawObject( ball, 1 );
 
 	// Set up paddle controllers
-	if (left_ai)
-		left_controller = new AIController(left_paddle, ball);
-	else
-		left_controller = new PlayerController(left_paddle, false);
-	if (right_ai)
-		right_controller = new AIController(right_paddle, ball);
-	else
-		right_controller = new PlayerController(right_paddle, true);
+	left_controller = makeController(false, left_ai);
+	right_controller = makeController(true, right_ai);
 	
 	// Don't display score if game is AI vs AI
 	if (left_ai && right_ai)
@@ -213,6 +341,56 @@ void PongGame::startGame(bool left_ai, bool right_ai)
 	getRightPaddle() -> change_max_paddle_speed( 2, 3 );
 
 	updateDifficulty();
+
+	match_tick = 0;
+	recorded_input = 0;
+	if (recording != NULL)
+	{
+		match.width = width;
+		match.height = height;
+		match.left_ai = left_ai;
+		match.right_ai = right_ai;
+		match.score_demo = score_demo;
+		match.left_ai_kind = left_ai_kind;
+		match.right_ai_kind = right_ai_kind;
+		match.difficulty = difficulty;
+		recording->beginMatch(match);
+		recordKeyframe();
+	}
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: Makes a controller for one of the paddles, an AI of the
+ *		kind set for that side or a player on the keyboard.
+ *
+ * @param[in]	right - True for the right paddle, false for the left.
+ * @param[in]	ai - True for an AI, false for a player.
+ *
+ * @returns The new controller.
+*******************************************************************************/
+PaddleController* PongGame::makeController(bool right, bool ai)
+{
+	Paddle* paddle = right ? right_paddle : left_paddle;
+	if (!ai)
+		return new PlayerController(paddle, right);
+
+	switch (right ? right_ai_kind : left_ai_kind)
+	{
+		case AI_PREDICT:
+			return new PredictiveController(paddle, ball, &random,
+				&difficulty);
+		case AI_POLICY:
+			return new PolicyController(paddle, ball, &policy);
+		case AI_NEURAL:
+			return new NeuralController(paddle, ball, &net);
+		case AI_LOOKAHEAD:
+			return new LookaheadController(this, paddle, ball,
+				right ? left_ai : right_ai, right ? left_ai_kind : right_ai_kind);
+		default:
+			return new AIController(paddle, ball, &random, &difficulty);
+	}
 }
 
 /***************************************************************************//**
@@ -224,7 +402,9 @@ void PongGame::quitGame()
 {
 	if (!game_active) return;
 	game_active = false;
-	Pong::getInstance() -> stopDrawingObject( ball );
+	if (recording != NULL)
+		recording->endMatch(match_tick, left_score, right_score);
+	if (registry != NULL) registry -> stopDrawingObject( ball );
 	if (right_controller != NULL) delete right_controller;
 	if (left_controller != NULL) delete left_controller;
 	if (ball != NULL) delete ball;
@@ -278,25 +458,25 @@ void PongGame::clear()
 {
 	if (board != NULL)
 	{
-		Pong::getInstance()->stopDrawingObject(board);
+		if (registry != NULL) registry->stopDrawingObject(board);
 		delete board;
 		board = NULL;
 	}
 	if (left_paddle != NULL)
 	{
-		Pong::getInstance()->stopDrawingObject(left_paddle);
+		if (registry != NULL) registry->stopDrawingObject(left_paddle);
 		delete left_paddle;
 		left_paddle = NULL;
 	}
 	if (right_paddle != NULL)
 	{
-		Pong::getInstance()->stopDrawingObject(right_paddle);
+		if (registry != NULL) registry->stopDrawingObject(right_paddle);
 		delete right_paddle;
 		right_paddle = NULL;
 	}
 	if (ball != NULL)
 	{
-		Pong::getInstance()->stopDrawingObject(ball);
+		if (registry != NULL) registry->stopDrawingObject(ball);
 		delete ball;
 		ball = NULL;
 	}
@@ -319,7 +499,7 @@ void PongGame::clear()
 *******************************************************************************/
 void PongGame::reset()
 {
-	int u = Pong::unit;
+	int u = unit;
 	clear();
 
 	// Reset game variables
@@ -353,9 +533,12 @@ void PongGame::reset()
 	board->setLeftText(to_string(left_score));
 
 	// Register game elements with drawing system
-	Pong::getInstance()->drawObject(board, 0);
-	Pong::getInstance()->drawObject(left_paddle, 2);
-	Pong::getInstance()->drawObject(right_paddle, 2);
+	if (registry != NULL)
+	{
+		registry->drawObject(board, 0);
+		registry->drawObject(left_paddle, 2);
+		registry->drawObject(right_paddle, 2);
+	}
 }
 
 /***************************************************************************//**
@@ -406,6 +589,30 @@ Ball* PongGame::getBall()
 	return ball;
 }
 
+/***************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: Gets the number of points scored by the left side.
+ *
+ * @returns The left side's score.
+*******************************************************************************/
+int PongGame::getLeftScore()
+{
+	return left_score;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: Gets the number of points scored by the right side.
+ *
+ * @returns The right side's score.
+*******************************************************************************/
+int PongGame::getRightScore()
+{
+	return right_score;
+}
+
 /***************************************************************************//**
  * @author Daniel Andrus
  * 
@@ -430,11 +637,199 @@ bool PongGame::isRunning()
 	return game_active;
 }
 
+/***************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: Checks whether the current game is just a demo, meaning
+ *		both paddles are AI-controlled.
+ *
+ * @returns True if a demo game is running, false if not.
+*******************************************************************************/
 bool PongGame::isDemo()
 {
 	return game_active && left_ai && right_ai;
 }
 
+/***************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: Sets whether AI vs AI games keep score. By default they
+ *		don't, so the demo behind the main menu plays forever. Headless
+ *		simulations turn scoring on so that matches end at 10 points.
+ *
+ * @param[in]	score_demo - True to keep score in AI vs AI games.
+*******************************************************************************/
+void PongGame::setScoreDemo(bool score_demo)
+{
+	this -> score_demo = score_demo;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: Sets the kind of AI that plays a side, AI_FOLLOW unless
+ *		set otherwise. Takes effect when the next game starts. The kinds are
+ *		recorded with each game and saved with its state, so replays and
+ *		rollbacks play with the same AI.
+ *
+ * @param[in]	right - True for the right side, false for the left.
+ * @param[in]	kind - An AIKind; anything else is taken as AI_FOLLOW.
+*******************************************************************************/
+void PongGame::setAIKind(bool right, int kind)
+{
+	if (kind < 0 || kind >= AI_KIND_COUNT) kind = AI_FOLLOW;
+	if (right)
+		right_ai_kind = kind;
+	else
+		left_ai_kind = kind;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: Gets the kind of AI that plays a side.
+ *
+ * @param[in]	right - True for the right side, false for the left.
+ *
+ * @returns The side's AIKind.
+*******************************************************************************/
+int PongGame::getAIKind(bool right)
+{
+	return right ? right_ai_kind : left_ai_kind;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: Looks up an AIKind by the name programs take on their
+ *		command lines: "follow", "predict", "lookahead", "policy", or
+ *		"neural".
+ *
+ * @param[in]	name - Name of the kind.
+ *
+ * @returns The AIKind, or -1 if there is none by that name.
+*******************************************************************************/
+int PongGame::findAIKind(const char* name)
+{
+	static const char* names[AI_KIND_COUNT] = { "follow", "predict",
+		"lookahead", "policy", "neural" };
+	for (int kind = 0; kind < AI_KIND_COUNT; kind++)
+	{
+		if (strcmp(name, names[kind]) == 0) return kind;
+	}
+	return -1;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: Loads the policy the AI_POLICY AI plays from a file
+ *		written by pong-train. The policy isn't part of a game's state or
+ *		replays, so a replay with that AI must be played back with the same
+ *		policy loaded. Until one is loaded, the AI never moves.
+ *
+ * @param[in]	path - The policy file.
+ *
+ * @returns True if it was loaded, false if not.
+*******************************************************************************/
+bool PongGame::loadPolicy(const string& path)
+{
+	return policy.load(path);
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: Maps in the network the AI_NEURAL AI plays from a file
+ *		written by pong-train. Like the policy, the network isn't part of a
+ *		game's state or replays. Until one is loaded, the AI never moves.
+ *
+ * @param[in]	path - The network file.
+ *
+ * @returns True if it was loaded, false if not.
+*******************************************************************************/
+bool PongGame::loadNet(const string& path)
+{
+	return net.load(path);
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: Loads how hard the AIs are to beat from a file written
+ *		by pong-tune, as setDifficulty() would. Leaves it as it was if the
+ *		file can't be read.
+ *
+ * @param[in]	path - The difficulty file.
+ *
+ * @returns True if it was loaded, false if not.
+*******************************************************************************/
+bool PongGame::loadDifficulty(const string& path)
+{
+	Difficulty read;
+	if (!read.load(path)) return false;
+	setDifficulty(read);
+	return true;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: Sets how hard the AIs are to beat. AI paddles take the
+ *		new top speeds at once, and new offsets from their next hit. The
+ *		difficulty is kept in a game's state and recorded with each game in
+ *		a replay, and playing one back plays it at the difficulty it was
+ *		recorded at.
+ *
+ * @param[in]	difficulty - The new difficulty.
+*******************************************************************************/
+void PongGame::setDifficulty(const Difficulty& difficulty)
+{
+	this -> difficulty = difficulty;
+	updateDifficulty();
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: Gets how hard the AIs are to beat.
+ *
+ * @returns The difficulty.
+*******************************************************************************/
+const Difficulty& PongGame::getDifficulty()
+{
+	return difficulty;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: Starts the game's random numbers over. Everything random
+ *		in a game, serves and AI offsets alike, comes from here, so two games
+ *		given the same seed and stream before startGame() play out the same.
+ *
+ * @param[in]	seed - Where to start the random numbers from.
+ * @param[in]	stream - OPTIONAL. Which stream of numbers to use; games with
+ *				the same seed and different streams play differently.
+*******************************************************************************/
+void PongGame::setSeed(uint64_t seed, uint64_t stream)
+{
+	random.seed(seed, stream);
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: Gets the random number generator of the game, for
+ *		anything else that needs to draw from it.
+ *
+ * @returns Pointer to the game's random number generator.
+*******************************************************************************/
+PongRandom* PongGame::getRandom()
+{
+	return &random;
+}
+
 /***************************************************************************//**
  * @author Daniel Andrus
  * 
@@ -443,18 +838,21 @@ bool PongGame::isDemo()
 void PongGame::scoreLeft()
 {
 	// If a player is playing, then keep track of score.
-	if (!left_ai || !right_ai)
+	if (!left_ai || !right_ai || score_demo)
 	{
 		left_score++;
-		board->setLeftText(to_string(left_score));
+		if (!left_ai || !right_ai)
+		{
+			board->setLeftText(to_string(left_score));
+		}
 	}
 
 	// Reset variables and paddle status
 	hit_count = 0;
 	right_paddle_size = 8;
 	left_paddle_size = 8;
-	right_paddle->setHeight(right_paddle_size * Pong::unit);
-	left_paddle->setHeight(left_paddle_size * Pong::unit);
+	right_paddle->setHeight(right_paddle_size * unit);
+	left_paddle->setHeight(left_paddle_size * unit);
 
 	// Since paddles could be outside border, move 0 px to fix position
 	right_paddle->verticalMotion(0);
@@ -481,18 +879,21 @@ void PongGame::scoreLeft()
 void PongGame::scoreRight()
 {
 	// If a player is playing, then keep track of score.
-	if (!left_ai || !right_ai)
+	if (!left_ai || !right_ai || score_demo)
 	{
 		right_score++;
-		board->setRightText(to_string(right_score));
+		if (!left_ai || !right_ai)
+		{
+			board->setRightText(to_string(right_score));
+		}
 	}
 
 	// Reset variables and paddle status
 	hit_count = 0;
 	right_paddle_size = 8;
 	left_paddle_size = 8;
-	right_paddle->setHeight(right_paddle_size * Pong::unit);
-	left_paddle->setHeight(left_paddle_size * Pong::unit);
+	right_paddle->setHeight(right_paddle_size * unit);
+	left_paddle->setHeight(left_paddle_size * unit);
 
 	// Since paddles could be outside border, move 0 px to fix position
 	right_paddle->verticalMotion(0);
@@ -565,8 +966,8 @@ void PongGame::ballHit(bool right)
 	{
 		left_paddle_size = 3;
 	}
-	right_paddle->setHeight(right_paddle_size * Pong::unit);
-	left_paddle->setHeight(left_paddle_size * Pong::unit);
+	right_paddle->setHeight(right_paddle_size * unit);
+	left_paddle->setHeight(left_paddle_size * unit);
 
 	// Let controllers know about the collision
 	if (right) {
@@ -587,11 +988,13 @@ void PongGame::updateDifficulty()
 {
 	if (left_ai)
 	{
-		left_paddle->change_max_paddle_speed(2, 3 + (right_score - left_score) * 0.125);
+		left_paddle->change_max_paddle_speed(2,
+			difficulty.paddleSpeed(right_score - left_score));
 	}
 	if (right_ai)
 	{
-		right_paddle->change_max_paddle_speed(2, 3 + (left_score - right_score) * 0.125);
+		right_paddle->change_max_paddle_speed(2,
+			difficulty.paddleSpeed(left_score - right_score));
 	}
 }
 
@@ -603,10 +1006,9 @@ void PongGame::updateDifficulty()
 *******************************************************************************/
 void PongGame::resetBall( )
 {
-	ball -> center_x = board -> getWidth() / 2;
-	ball -> center_y = board -> getHeight() / 2;
-	ball -> x_velocity = 0;
-	ball -> y_velocity = 0;
+	ball -> setMotion(board -> getWidth() / 2, board -> getHeight() / 2, 0, 0);
+	ball -> prev_x = ball -> center_x;
+	ball -> prev_y = ball -> center_y;
 	ball_timer = 60;
 }
 
@@ -618,13 +1020,539 @@ void PongGame::resetBall( )
 *******************************************************************************/
 void PongGame::serve()
 {
+	double x_velocity = ball_speed;
 	if( (left_score + right_score) % 2 )
 	{
-		ball -> x_velocity = -ball_speed;
+		x_velocity = -ball_speed;
+	}
+	ball -> setMotion(ball -> center_x, ball -> center_y, x_velocity,
+		(random.nextInt(11) - 5) / 2.0);
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: Speeds the ball up or slows it down by a quarter of its
+ *		normal speed, unless the game is paused. Recorded if games are being
+ *		recorded.
+ *
+ * @param[in]	faster - True to speed the ball up, false to slow it down.
+*******************************************************************************/
+void PongGame::changeSpeed(bool faster)
+{
+	if (ball == NULL || game_paused) return;
+
+	ball->setSpeedModifier(ball->getSpeedModifier() + (faster ? 0.25 : -0.25));
+	if (recording != NULL && game_active)
+	{
+		recording->addEvent(faster ? REPLAY_FASTER : REPLAY_SLOWER,
+			match_tick);
+	}
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: Packs the direction keys held for both paddles into a
+ *		byte: up, down, left and right of the left paddle in the low four
+ *		bits, the same of the right paddle in the high four.
+ *
+ * @returns The keys held.
+*******************************************************************************/
+unsigned char PongGame::getInput()
+{
+	unsigned char input = 0;
+	Paddle* paddles[] = { left_paddle, right_paddle };
+	for (int i = 0; i < 2; i++)
+	{
+		if (paddles[i] == NULL) continue;
+		input |= (paddles[i]->up ? 1 : 0) << (4 * i);
+		input |= (paddles[i]->down ? 2 : 0) << (4 * i);
+		input |= (paddles[i]->left ? 4 : 0) << (4 * i);
+		input |= (paddles[i]->right ? 8 : 0) << (4 * i);
+	}
+	return input;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: Holds down exactly the direction keys packed into a byte
+ *		by getInput().
+ *
+ * @param[in]	input - The keys to hold.
+*******************************************************************************/
+void PongGame::setInput(unsigned char input)
+{
+	Paddle* paddles[] = { left_paddle, right_paddle };
+	for (int i = 0; i < 2; i++)
+	{
+		if (paddles[i] == NULL) continue;
+		paddles[i]->up = (input >> (4 * i) & 1) != 0;
+		paddles[i]->down = (input >> (4 * i) & 2) != 0;
+		paddles[i]->left = (input >> (4 * i) & 4) != 0;
+		paddles[i]->right = (input >> (4 * i) & 8) != 0;
+	}
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: Records the direction keys held for the coming step if
+ *		they aren't the ones last recorded.
+*******************************************************************************/
+void PongGame::recordInput()
+{
+	unsigned char input = getInput();
+	if (input != recorded_input)
+	{
+		recording->addEvent(REPLAY_INPUT, match_tick, input);
+		recorded_input = input;
+	}
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: Records the whole state of the game as it is before the
+ *		coming step, so that playing back can start from here, and sets when
+ *		the next one is due.
+*******************************************************************************/
+void PongGame::recordKeyframe()
+{
+	PongState state;
+	saveState(state);
+	recording->addKeyframe(match_tick, &state, sizeof(state));
+	next_keyframe = match_tick + keyframe_interval;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: Does everything the replay being played back says
+ *		happens before the coming step: starting the next game, holding keys,
+ *		changing the ball's speed, and ending the game. A game that ends
+ *		differently than recorded, earlier, later, or with another score, is
+ *		counted as a mismatch, as is a replay that is damaged or cut off
+ *		before the end of its last game. Keyframes are only for seeking and
+ *		are passed over. Playback stops at the end of the replay.
+*******************************************************************************/
+void PongGame::playEvents()
+{
+	ReplayEvent event;
+	while (playback->peekEvent(event))
+	{
+		if (event.type == REPLAY_MATCH)
+		{
+			if (game_active) break;		// Last game never ended; damaged
+
+			playback->nextEvent(event);
+			if (event.match.width != width || event.match.height != height)
+			{
+				replay_mismatches++;
+				break;
+			}
+			random.setState(event.match.random_state,
+				event.match.random_increment);
+			score_demo = event.match.score_demo;
+			setAIKind(false, event.match.left_ai_kind);
+			setAIKind(true, event.match.right_ai_kind);
+			difficulty = event.match.difficulty;
+			beginGame(event.match.left_ai, event.match.right_ai);
+			continue;
+		}
+
+		// After a game is over the only thing left of it is its end
+		if (!game_active && event.type != REPLAY_END) break;
+		if (game_active && event.tick > match_tick) return;
+
+		playback->nextEvent(event);
+		switch (event.type)
+		{
+			case REPLAY_INPUT:
+				setInput(event.input);
+				break;
+
+			case REPLAY_SLOWER:
+				changeSpeed(false);
+				break;
+
+			case REPLAY_FASTER:
+				changeSpeed(true);
+				break;
+
+			case REPLAY_END:
+				quitGame();
+				replay_base += event.tick;
+				if (event.tick != match_tick
+					|| event.left_score != left_score
+					|| event.right_score != right_score)
+				{
+					replay_mismatches++;
+				}
+				break;
+		}
+	}
+
+	if (!playback->atEnd() || game_active)
+	{
+		replay_mismatches++;
+	}
+	stopPlayback();
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: Starts recording games to a file, beginning with the
+ *		next game started. Each game is written out as it ends. The state of
+ *		the game is recorded at its start and every interval steps after, so
+ *		playing back can jump around with seekPlayback().
+ *
+ * @param[in]	path - File to record to. Anything in it is lost.
+ * @param[in]	interval - OPTIONAL. Steps between keyframes, 600 (ten
+ *				seconds) by default.
+ *
+ * @returns True if recording started, false if the file couldn't be opened.
+*******************************************************************************/
+bool PongGame::startRecording(const string& path, long interval)
+{
+	stopRecording();
+
+	Replay* replay = new (nothrow) Replay();
+	if (replay == NULL) return false;
+	if (!replay->create(path))
+	{
+		delete replay;
+		return false;
+	}
+
+	recording = replay;
+	keyframe_interval = interval > 0 ? interval : 1;
+	next_keyframe = 0;
+	return true;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: Stops recording games. A game still going is recorded as
+ *		ending here, so it can still be played back.
+*******************************************************************************/
+void PongGame::stopRecording()
+{
+	if (recording == NULL) return;
+
+	if (game_active)
+	{
+		recording->endMatch(match_tick, left_score, right_score);
+	}
+	delete recording;
+	recording = NULL;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: Ends any game going and starts playing back the games
+ *		recorded in a file, one after another. While playing back, keys are
+ *		ignored; starting a game with startGame() stops the playback.
+ *
+ * @param[in]	path - Replay file to play.
+ *
+ * @returns True if playback started, false if the file couldn't be read.
+*******************************************************************************/
+bool PongGame::startPlayback(const string& path)
+{
+	Replay* replay = new (nothrow) Replay();
+	if (replay == NULL) return false;
+	if (!replay->load(path))
+	{
+		delete replay;
+		return false;
+	}
+
+	stopPlayback();
+	quitGame();
+	playback = replay;
+	replay_mismatches = 0;
+	replay_base = 0;
+
+	// Start the first game right away
+	playEvents();
+	return true;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: Stops playing back a replay. Any game going carries on
+ *		as an ordinary game.
+*******************************************************************************/
+void PongGame::stopPlayback()
+{
+	if (playback == NULL) return;
+
+	delete playback;
+	playback = NULL;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: Determines if a replay is being played back.
+ *
+ * @returns True if playing back, false if not.
+*******************************************************************************/
+bool PongGame::isPlayingBack()
+{
+	return playback != NULL;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: Jumps the replay being played back to a given step,
+ *		forwards or backwards, counting steps from the start of its first
+ *		game. The game is put back to the last keyframe at or before the
+ *		step and played forwards from there, skipping quiet steps, so no seek
+ *		plays more than a keyframe interval. Whether the game is paused is
+ *		kept. Seeking to the end of the replay plays it out and stops it.
+ *
+ * @param[in]	tick - Step to jump to.
+ *
+ * @returns True if the replay is now at that step, false if not playing
+ *		back or the replay has no keyframe to start from.
+*******************************************************************************/
+bool PongGame::seekPlayback(long tick)
+{
+	if (playback == NULL) return false;
+	if (tick < 0) tick = 0;
+
+	ReplayEvent keyframe;
+	long base;
+	if (!playback->seek(tick, keyframe, base)
+		|| keyframe.keyframe_size != sizeof(PongState))
+	{
+		return false;
+	}
+
+	PongState state;
+	memcpy(&state, keyframe.keyframe, sizeof(state));
+	restoreState(state);
+	replay_base = base;
+
+	bool paused = game_paused;
+	game_paused = false;
+	while (playback != NULL && replay_base + match_tick < tick)
+	{
+		long steps = quietSteps(tick - replay_base - match_tick);
+		if (steps > 0)
+			skip(steps);
+		else
+			step();
+	}
+	game_paused = paused;
+	return playback != NULL;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: Gets how far the replay being played back has got.
+ *
+ * @returns Steps played back since the start of the first game.
+*******************************************************************************/
+long PongGame::getReplayTick()
+{
+	return replay_base + match_tick;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: Gets how long the replay being played back is.
+ *
+ * @returns Steps in all its games together, 0 if not playing back.
+*******************************************************************************/
+long PongGame::getReplayLength()
+{
+	if (playback == NULL) return 0;
+	return playback->getLength();
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: Gets how many games of the last replay played back ended
+ *		differently than they did when they were recorded.
+ *
+ * @returns Number of games that didn't match.
+*******************************************************************************/
+long PongGame::getReplayMismatches()
+{
+	return replay_mismatches;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: Copies everything about the game that changes while it
+ *		is played into a PongState: scores, timers, the random numbers, the
+ *		ball, the paddles, and what the AI remembers, along with the
+ *		difficulty, so seeking a replay plays on at the one it was recorded
+ *		at. Whether the game is paused is left out. Parts of the state that
+ *		don't apply, like the ball when no game is going, are zeroed, so two
+ *		states of the same game compare equal with memcmp().
+ *
+ * @param[out]	state - Where to copy it.
+*******************************************************************************/
+void PongGame::saveState(PongState& state)
+{
+	memset(&state, 0, sizeof(state));
+
+	random.getState(state.random_state, state.random_increment);
+	state.match_tick = match_tick;
+	state.ball_speed = ball_speed;
+	state.base_speed = difficulty.base_speed;
+	state.speed_per_point = difficulty.speed_per_point;
+	state.offset_spread = difficulty.offset_spread;
+	state.offset_count = difficulty.offset_count;
+	state.left_score = left_score;
+	state.right_score = right_score;
+	state.ball_timer = ball_timer;
+	state.hit_count = hit_count;
+	state.left_paddle_size = left_paddle_size;
+	state.right_paddle_size = right_paddle_size;
+	state.game_active = game_active;
+	state.left_ai = left_ai;
+	state.right_ai = right_ai;
+	state.score_demo = score_demo;
+	state.left_ai_kind = (uint8_t) left_ai_kind;
+	state.right_ai_kind = (uint8_t) right_ai_kind;
+
+	if (ball != NULL)
+		ball->getState(state.ball);
+	if (left_paddle != NULL)
+		left_paddle->getState(state.left_paddle);
+	if (right_paddle != NULL)
+		right_paddle->getState(state.right_paddle);
+	if (left_controller != NULL)
+		left_controller->getState(state.left_controller);
+	if (right_controller != NULL)
+		right_controller->getState(state.right_controller);
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: Puts the game back the way saveState() found it. The
+ *		ball and controllers are made or done away with as needed, so a
+ *		state can be restored whether or not a game is going, or one of
+ *		another kind is. Nothing is recorded and playback isn't affected.
+ *		Rolling back within a game only copies numbers; nothing is made,
+ *		freed, or written to the board unless the score or the kind of game
+ *		changes, so it takes a small fraction of a microsecond.
+ *
+ * @param[in]	state - What to put back.
+*******************************************************************************/
+void PongGame::restoreState(const PongState& state)
+{
+	bool active = state.game_active != 0;
+	bool left = state.left_ai != 0;
+	bool right = state.right_ai != 0;
+	bool text_changed = active != game_active || left != left_ai
+		|| right != right_ai || state.left_score != left_score
+		|| state.right_score != right_score;
+
+	// Controllers watch the ball, so go whenever it does
+	bool kinds_changed = state.left_ai_kind != left_ai_kind
+		|| state.right_ai_kind != right_ai_kind;
+	if (ball == NULL || !active || left != left_ai || right != right_ai
+		|| kinds_changed)
+	{
+		if (left_controller != NULL) delete left_controller;
+		if (right_controller != NULL) delete right_controller;
+		left_controller = NULL;
+		right_controller = NULL;
+	}
+	if (active && ball == NULL)
+	{
+		ball = new (nothrow) Ball(this, 0, 0, 20, 0, 0);
+		if (registry != NULL) registry -> drawObject( ball, 1 );
+	}
+	else if (!active && ball != NULL)
+	{
+		if (registry != NULL) registry -> stopDrawingObject( ball );
+		delete ball;
+		ball = NULL;
+	}
+
+	game_active = active;
+	left_ai = left;
+	right_ai = right;
+	score_demo = state.score_demo != 0;
+	setAIKind(false, state.left_ai_kind);
+	setAIKind(true, state.right_ai_kind);
+	if (active && left_controller == NULL)
+	{
+		left_controller = makeController(false, left_ai);
+		right_controller = makeController(true, right_ai);
+	}
+
+	// After making controllers, which draw random numbers
+	random.setState(state.random_state, state.random_increment);
+	match_tick = (long) state.match_tick;
+	ball_speed = state.ball_speed;
+	difficulty.base_speed = state.base_speed;
+	difficulty.speed_per_point = state.speed_per_point;
+	difficulty.offset_spread = state.offset_spread;
+	difficulty.offset_count = state.offset_count;
+	left_score = state.left_score;
+	right_score = state.right_score;
+	ball_timer = state.ball_timer;
+	hit_count = state.hit_count;
+	left_paddle_size = state.left_paddle_size;
+	right_paddle_size = state.right_paddle_size;
+
+	if (ball != NULL)
+		ball->setState(state.ball);
+	left_paddle->setState(state.left_paddle);
+	right_paddle->setState(state.right_paddle);
+	if (left_controller != NULL)
+		left_controller->setState(state.left_controller);
+	if (right_controller != NULL)
+		right_controller->setState(state.right_controller);
+
+	if (text_changed)
+		updateBoardText();
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: Sets the text on the board the way playing up to the
+ *		current score would have: the score of each side unless the game is
+ *		AI vs AI, and the winner once a side has reached 10 and the game is
+ *		over.
+*******************************************************************************/
+void PongGame::updateBoardText()
+{
+	if (left_ai && right_ai)
+	{
+		board->setLeftText("");
+		board->setRightText("");
 	}
 	else
 	{
-		ball -> x_velocity = ball_speed;
+		board->setLeftText(to_string(left_score));
+		board->setRightText(to_string(right_score));
 	}
-	ball -> y_velocity = (rand() % 11 - 5) / 2.0;
+
+	if (!game_active && left_score == 10)
+		board->setCenterText("Left side wins!");
+	else if (!game_active && right_score == 10)
+		board->setCenterText("Right side wins!");
+	else
+		board->setCenterText("");
 }
@@ -14,17 +14,45 @@ class PongGame;
 
 #include <list>
 #include <string>
-#include "Pong.h"
+#include <cstdlib>
+#include "DrawRegistry.h"
 #include "Board.h"
 #include "Paddle.h"
 #include "Ball.h"
 #include "Steppable.h"
 #include "AIController.h"
+#include "PredictiveController.h"
+#include "LookaheadController.h"
+#include "PolicyController.h"
+#include "NeuralController.h"
 #include "PlayerController.h"
 #include "PaddleController.h"
+#include "PongRandom.h"
+#include "Policy.h"
+#include "PaddleNet.h"
+#include "Difficulty.h"
+#include "PongState.h"
+#include "Replay.h"
 
 using namespace std;
 
+/*!
+ * @brief Kinds of AI that can play a paddle
+ */
+enum AIKind
+{
+	AI_FOLLOW = 0,	/*!< Follows the ball, see AIController */
+	AI_PREDICT = 1,	/*!< Goes where the ball will cross, see
+						PredictiveController */
+	AI_LOOKAHEAD = 2,	/*!< Plays moves out on a copy of the game, see
+							LookaheadController */
+	AI_POLICY = 3,	/*!< Plays a policy learned by pong-train, see
+						PolicyController */
+	AI_NEURAL = 4,	/*!< Plays a network trained by pong-train, see
+						NeuralController */
+	AI_KIND_COUNT	/*!< Number of kinds */
+};
+
 /***************************************************************************//**
  * @brief The PongGame Class runs the entire game of pong, It is in charge
  *		of all parts of the game logic.
@@ -43,11 +71,36 @@ class PongGame : public Steppable
 		bool right_ai;	/*!< determines if right_ai is on */
 		int left_score;	/*!< Points made for left side */
 		int right_score;	/*!< The score of the right side */
-		int width;	/*!< View width from Pong.h */
-		int height;	/*!< View_hieght from Pong.h */
+		bool score_demo;	/*!< determines if AI vs AI games keep score */
+		int left_ai_kind;	/*!< AIKind that plays the left paddle */
+		int right_ai_kind;	/*!< AIKind that plays the right paddle */
+		int width;	/*!< Width of the playing field */
+		int height;	/*!< Height of the playing field */
 		double ball_speed;	/*!< The x velocity of the ball */
 		int ball_timer;	/*!< timer before ball is served */
 		int hit_count;	/*!< amount of times the ball has hit a paddle */
+		PongRandom random;	/*!< where the game's random numbers come from */
+		Policy policy;		/*!< what the AI_POLICY AI plays */
+		PaddleNet net;		/*!< what the AI_NEURAL AI plays */
+		Difficulty difficulty;	/*!< how hard the AIs are to beat */
+
+		Replay* recording;	/*!< where games are being recorded to, NULL if
+								they aren't */
+		Replay* playback;	/*!< replay being played back, NULL if none */
+		long match_tick;	/*!< steps taken in the current game */
+		unsigned char recorded_input;	/*!< keys held as of the last input
+											recorded */
+		long replay_mismatches;	/*!< games played back that didn't end the
+									way they were recorded */
+		long keyframe_interval;	/*!< steps between keyframes recorded */
+		long next_keyframe;	/*!< step of the current game the next keyframe
+								is due on */
+		long replay_base;	/*!< steps in the games played back before the
+								current one */
+
+		DrawRegistry* registry;	/*!< where game elements are registered to be
+									drawn, NULL when running without a
+									window */
 
 		Board* board;	/*!< instance of the board class */
 		Paddle* left_paddle;	/*!< instance of paddle on the left side */
@@ -82,13 +135,51 @@ class PongGame : public Steppable
 		 */
 		void reset();
 
+		/*!
+		 *  @brief Starts a game, whether asked for or played back
+		 */
+		void beginGame(bool left_ai, bool right_ai);
+
+		/*!
+		 *  @brief Makes a paddle controller of the given kind
+		 */
+		PaddleController* makeController(bool right, bool ai);
+
+		/*!
+		 *  @brief Sets the text on the board to go with the score
+		 */
+		void updateBoardText();
+
+		/*!
+		 *  @brief Changes the speed of the ball by a step
+		 */
+		void changeSpeed(bool faster);
+
+		/*!
+		 *  @brief Records the paddle keys held if they've changed
+		 */
+		void recordInput();
+
+		/*!
+		 *  @brief Records the whole state of the game as a keyframe
+		 */
+		void recordKeyframe();
+
+		/*!
+		 *  @brief Does whatever the replay being played back says happens
+		 *		before the next step
+		 */
+		void playEvents();
+
 	public:
+		static const int unit = 16;	/*!< Unit of measurement used in
+										calculations */
 
 		/*!
-		 *  @brief The constructor, initialize PongGame and gets a width and 
-		 *		height from the Pong class
+		 *  @brief The constructor, initialize PongGame with the size of the
+		 *		playing field and an optional drawing registry
 		 */
-		PongGame();
+		PongGame(int width, int height, DrawRegistry* registry = NULL);
 
 		/*!
 		 *  @brief The destructor, destroys subclasses and itself
@@ -100,6 +191,27 @@ class PongGame : public Steppable
 		 */
 		void step();
 
+		/*!
+		 *  @brief Counts the steps ahead in which nothing happens but movement
+		 */
+		long quietSteps(long limit);
+
+		/*!
+		 *  @brief Jumps the game ahead a number of steps in which nothing
+		 *		happens but movement
+		 */
+		void skip(long steps);
+
+		/*!
+		 *  @brief Packs the paddle keys being held into one byte
+		 */
+		unsigned char getInput();
+
+		/*!
+		 *  @brief Holds the paddle keys packed into a byte by getInput()
+		 */
+		void setInput(unsigned char input);
+
 		/*!
 		 *  @brief registers that a key was pressed
 		 */
@@ -191,6 +303,16 @@ class PongGame : public Steppable
 		 */
 		Ball* getBall();
 
+		/*!
+		 *  @brief gets the score of the left side
+		 */
+		int getLeftScore();
+
+		/*!
+		 *  @brief gets the score of the right side
+		 */
+		int getRightScore();
+
 		/*!
 		 *  @brief determines if the game is paused
 		 */
@@ -205,6 +327,118 @@ class PongGame : public Steppable
 		 * @brief Determins if current game is just a demo. (AI vs AI)
 		 */
 		bool isDemo();
+
+		/*!
+		 * @brief Sets whether AI vs AI games keep score and end at 10
+		 */
+		void setScoreDemo(bool score_demo);
+
+		/*!
+		 * @brief Sets the kind of AI that plays a side from the next game on
+		 */
+		void setAIKind(bool right, int kind);
+
+		/*!
+		 * @brief Gets the kind of AI that plays a side
+		 */
+		int getAIKind(bool right);
+
+		/*!
+		 * @brief Looks up an AIKind by name
+		 */
+		static int findAIKind(const char* name);
+
+		/*!
+		 * @brief Loads the policy the AI_POLICY AI plays from a file
+		 */
+		bool loadPolicy(const string& path);
+
+		/*!
+		 * @brief Maps in the network the AI_NEURAL AI plays from a file
+		 */
+		bool loadNet(const string& path);
+
+		/*!
+		 * @brief Loads how hard the AIs are to beat from a file
+		 */
+		bool loadDifficulty(const string& path);
+
+		/*!
+		 * @brief Sets how hard the AIs are to beat
+		 */
+		void setDifficulty(const Difficulty& difficulty);
+
+		/*!
+		 * @brief Gets how hard the AIs are to beat
+		 */
+		const Difficulty& getDifficulty();
+
+		/*!
+		 * @brief Starts the game's random numbers over from a seed
+		 */
+		void setSeed(uint64_t seed, uint64_t stream = 0);
+
+		/*!
+		 * @brief Gets the game's random number generator
+		 */
+		PongRandom* getRandom();
+
+		/*!
+		 * @brief Copies everything about the game that changes into a
+		 *		PongState
+		 */
+		void saveState(PongState& state);
+
+		/*!
+		 * @brief Puts the game back the way saveState() found it
+		 */
+		void restoreState(const PongState& state);
+
+		/*!
+		 * @brief Starts recording every game played to a file
+		 */
+		bool startRecording(const string& path, long interval = 600);
+
+		/*!
+		 * @brief Stops recording games
+		 */
+		void stopRecording();
+
+		/*!
+		 * @brief Starts playing back the games recorded in a file
+		 */
+		bool startPlayback(const string& path);
+
+		/*!
+		 * @brief Stops playing back a replay
+		 */
+		void stopPlayback();
+
+		/*!
+		 * @brief Determines if a replay is being played back
+		 */
+		bool isPlayingBack();
+
+		/*!
+		 * @brief Jumps the replay being played back to a given step
+		 */
+		bool seekPlayback(long tick);
+
+		/*!
+		 * @brief Gets the number of steps played back so far
+		 */
+		long getReplayTick();
+
+		/*!
+		 * @brief Gets the number of steps in the replay being played back
+		 */
+		long getReplayLength();
+
+		/*!
+		 * @brief Gets the number of games played back that came out
+		 *		differently than they were recorded
+		 */
+		long getReplayMismatches();
 };
 
 #endif
@@ -0,0 +1,898 @@
+/*************************************************************************//**
+ * @file
+ *
+ * @brief Load generator for pong-server. Plays thousands of bot clients
+ *		against a server at once and reports how well the server keeps up.
+ *
+ * @section compile_section Compiling and Usage
+ *
+ * @par Make:
+   @verbatim
+   > make pong-loadgen
+   @endverbatim
+ *
+ * @par Usage:
+   @verbatim
+   > ./pong-loadgen [--server HOST:PORT] [--clients N] [--ramp N]
+                    [--mode ai|player] [--threads N] [--tick-rate N]
+                    [--duration SECONDS] [--report SECONDS] [--seed N]
+   @endverbatim
+ *
+ * Opens --clients bot clients (default 1000) against the server at --server
+ * (default 127.0.0.1:7000), --ramp of them a second (default 200) so the
+ * server can be watched as load grows. Each client has its own socket, so
+ * the server spreads them over its workers as it would real players. Each
+ * asks for a match against the AI, or with --mode player against another
+ * bot, and asks for another whenever one ends.
+ *
+ * A bot plays with the same logic as the game's AI: it keeps a paddle and
+ * ball of its own where the server last said they were, lets an
+ * AIController move its paddle, and holds up or down to follow it. Keys are
+ * sent --tick-rate times a second (default 60), from --threads threads
+ * (default 2).
+ *
+ * Every --report seconds (default 5), and once more at the end, prints:
+ *   - the time between state updates a client gets, which is how long the
+ *     server's steps take to come round, as percentiles;
+ *   - the time from sending keys to getting back the state they were played
+ *     in, as percentiles;
+ *   - steps of a match a client never heard about, updates that arrived
+ *     out of order, and updates packed against a snapshot the client no
+ *     longer had;
+ *   - bytes a second each match costs each way, counting every client in
+ *     it, with and without the 28 bytes of UDP and IP header on every
+ *     packet.
+ *
+ * Runs for --duration seconds (default 30) after the last client opens,
+ * then has every client leave.
+ *
+ *****************************************************************************/
+
+/*******************************************************************************
+ *                 DECLARATIONS, INCLUDES, AND NAMESPACES
+*******************************************************************************/
+#include <iostream>
+#include <iomanip>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include <ctime>
+#include <stdint.h>
+#include <unistd.h>
+#include <netdb.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include "AIController.h"
+#include "AlignedAllocator.h"
+#include "Ball.h"
+#include "Paddle.h"
+#include "PongGame.h"
+#include "PongRandom.h"
+#include "ServerProtocol.h"
+
+using namespace std;
+
+/*!
+ * @brief Bytes of UDP and IPv4 header on every packet
+ */
+static const long header_bytes = 28;
+
+/*!
+ * @brief Buckets a histogram has: 10 microseconds wide up to a millisecond,
+ *		then 100 microseconds wide up to a second, then one for the rest
+ */
+static const int histogram_size = 100 + 9990 + 1;
+
+/*!
+ * @brief Keys sent, remembered by number for timing how long they take
+ */
+static const int sent_window = 256;
+
+/*!
+ * @brief Snapshots each client keeps for the server to pack new ones
+ *		against. As many as the server keeps is enough.
+ */
+static const uint32_t snapshot_history = 32;
+
+typedef chrono::steady_clock::time_point LoadTime;
+
+/*!
+ * @brief Room for the receive time the kernel puts on a packet
+ */
+static const size_t control_size = CMSG_SPACE(sizeof(timespec));
+
+/*!
+ * @brief Counts of times, to find percentiles in. Written by one thread and
+ *		emptied by another.
+ */
+struct LoadHistogram
+{
+	vector< atomic<long> > buckets;	/*!< Times in each bucket */
+
+	LoadHistogram() : buckets(histogram_size) { }
+};
+
+/*!
+ * @brief One bot client
+ */
+struct LoadClient
+{
+	int fd;					/*!< The client's socket */
+	bool open;				/*!< True once the socket is open */
+	bool playing;			/*!< True while the client has a match */
+	int side;				/*!< 0 if playing left, 1 if right */
+	uint32_t seq;			/*!< Number of the last keys sent */
+	uint32_t last_tick;		/*!< Step of the last state heard */
+	bool heard;				/*!< True once a state has been heard this match */
+	unsigned char keys;		/*!< Keys being held */
+	int64_t last_state;		/*!< When the last state arrived */
+	LoadTime last_join;		/*!< When a match was last asked for */
+	Snapshot snapshots[snapshot_history];	/*!< The newest snapshots, by
+												step */
+	uint32_t ack;			/*!< Step of the newest snapshot */
+	int64_t sent[sent_window];	/*!< When each recent set of keys was sent,
+									0 once timed */
+	PongRandom random;		/*!< Where the AI's offsets are drawn from */
+	Paddle* paddle;			/*!< The client's paddle, where the server put it */
+	Ball* ball;				/*!< The ball, where the server put it */
+	AIController* ai;		/*!< Moves the paddle */
+};
+
+/*!
+ * @brief Everything one thread of clients counts. Aligned to a cache line so
+ *		different threads' counters don't share one; kept in a LoadStatsList
+ *		so that holds on the heap too.
+ */
+struct alignas(64) LoadStats
+{
+	atomic<long> open;			/*!< Clients open */
+	atomic<long> playing;		/*!< Clients with a match */
+	atomic<long> bytes_in;		/*!< Bytes received */
+	atomic<long> bytes_out;		/*!< Bytes sent */
+	atomic<long> packets_in;	/*!< Packets received */
+	atomic<long> packets_out;	/*!< Packets sent */
+	atomic<long> missed;		/*!< Steps never heard about */
+	atomic<long> reordered;		/*!< States that came after a later one */
+	atomic<long> undecodable;	/*!< States that couldn't be unpacked */
+	atomic<long> finished;		/*!< Matches that ended */
+	atomic<long> full;			/*!< Times the server had no room */
+	LoadHistogram intervals;	/*!< Times between states */
+	LoadHistogram latencies;	/*!< Times from keys sent to state played */
+};
+
+/*!
+ * @brief The counts of every thread of clients, each on its own cache lines
+ */
+typedef vector<LoadStats, AlignedAllocator<LoadStats> > LoadStatsList;
+
+/*!
+ * @brief Settings every thread shares
+ */
+struct LoadSettings
+{
+	addrinfo* server;		/*!< Address of the server */
+	long clients;			/*!< Clients to open in all */
+	double ramp;			/*!< Clients to open a second */
+	int mode;				/*!< Kind of match to ask for */
+	int threads;			/*!< Threads the clients are split over */
+	double tick_rate;		/*!< Keys sent a second */
+	uint64_t seed;			/*!< Seed of the bots' random numbers */
+	LoadTime start;			/*!< When the first client opens */
+};
+
+/*!
+ * @brief Set when every client should leave
+ */
+static atomic<bool> stopping(false);
+
+/*******************************************************************************
+ *                          FUNCTION DEFINITIONS
+*******************************************************************************/
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Prints the command line usage of the load generator.
+ *
+ * @param[in]      name - Name the program was invoked with
+ *****************************************************************************/
+static void usage( const char* name )
+{
+	cerr << "Usage: " << name << " [--server HOST:PORT] [--clients N]"
+		<< " [--ramp N]" << endl
+		<< "       [--mode ai|player] [--threads N] [--tick-rate N]" << endl
+		<< "       [--duration SECONDS] [--report SECONDS] [--seed N]"
+		<< endl;
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Counts a time in a histogram.
+ *
+ * @param[in,out]  histogram - The histogram
+ * @param[in]      micros - The time, in microseconds
+ *****************************************************************************/
+static void add_time( LoadHistogram& histogram, long micros )
+{
+	int bucket;
+	if (micros < 0) micros = 0;
+	if (micros < 1000) bucket = (int) (micros / 10);
+	else if (micros < 1000000) bucket = 100 + (int) ((micros - 1000) / 100);
+	else bucket = histogram_size - 1;
+	histogram.buckets[bucket].fetch_add(1, memory_order_relaxed);
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Gets the time at the top of a histogram bucket.
+ *
+ * @param[in]      bucket - The bucket
+ *
+ * @returns The time, in microseconds.
+ *****************************************************************************/
+static long bucket_time( int bucket )
+{
+	if (bucket < 100) return (bucket + 1) * 10;
+	return 1000 + (bucket - 99) * 100;
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Adds up the histograms of every thread, emptying them, and prints the
+ * percentiles of the times counted.
+ *
+ * @param[in]      name - What the times are
+ * @param[in,out]  stats - Every thread's counters
+ * @param[in]      latency - True for the key latency, false for the
+ *		intervals between states
+ *****************************************************************************/
+static void print_percentiles( const char* name, LoadStatsList& stats,
+	bool latency )
+{
+	vector<long> counts(histogram_size, 0);
+	long total = 0;
+	for (size_t t = 0; t < stats.size(); t++)
+	{
+		LoadHistogram& histogram = latency ? stats[t].latencies
+			: stats[t].intervals;
+		for (int b = 0; b < histogram_size; b++)
+		{
+			long count = histogram.buckets[b].exchange(0);
+			counts[b] += count;
+			total += count;
+		}
+	}
+
+	cout << "  " << left << setw(16) << name << right;
+	if (total == 0)
+	{
+		cout << "none" << endl;
+		return;
+	}
+
+	const double points[] = { 0.5, 0.9, 0.99, 0.999, 1 };
+	const char* labels[] = { "p50", "p90", "p99", "p99.9", "max" };
+	int point = 0;
+	long seen = 0;
+	for (int b = 0; b < histogram_size && point < 5; b++)
+	{
+		seen += counts[b];
+		while (point < 5 && seen >= (long) (points[point] * total + 0.5)
+			&& seen > 0)
+		{
+			cout << labels[point] << " ";
+			if (b == histogram_size - 1) cout << ">1s";
+			else cout << fixed << setprecision(2) << bucket_time(b) / 1000.0
+				<< "ms";
+			cout << "  ";
+			point++;
+		}
+	}
+	cout << "(" << total << ")" << endl;
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Gets the time of day in nanoseconds, the clock the kernel stamps packets
+ * with as they arrive.
+ *
+ * @returns The time.
+ *****************************************************************************/
+static int64_t wall_time( )
+{
+	timespec now;
+	clock_gettime(CLOCK_REALTIME, &now);
+	return (int64_t) now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Reads a packet from a client's socket along with when it arrived. The
+ * kernel's stamp is used so that the time this thread takes to get round to
+ * reading it doesn't count against the server.
+ *
+ * @param[in]      client - The client
+ * @param[out]     packet - Where to read it to, server_packet_size bytes
+ * @param[out]     arrived - When it arrived, in nanoseconds
+ *
+ * @returns Size of the packet, or -1 if there were none.
+ *****************************************************************************/
+static long receive_packet( LoadClient& client, unsigned char* packet,
+	int64_t& arrived )
+{
+	char control[control_size];
+	iovec vector;
+	vector.iov_base = packet;
+	vector.iov_len = server_packet_size;
+	msghdr header;
+	memset(&header, 0, sizeof(header));
+	header.msg_iov = &vector;
+	header.msg_iovlen = 1;
+	header.msg_control = control;
+	header.msg_controllen = sizeof(control);
+
+	long size = recvmsg(client.fd, &header, MSG_DONTWAIT);
+	if (size < 0) return -1;
+
+	arrived = 0;
+	for (cmsghdr* message = CMSG_FIRSTHDR(&header); message != NULL;
+		message = CMSG_NXTHDR(&header, message))
+	{
+		if (message->cmsg_level == SOL_SOCKET
+			&& message->cmsg_type == SCM_TIMESTAMPNS)
+		{
+			timespec stamp;
+			memcpy(&stamp, CMSG_DATA(message), sizeof(stamp));
+			arrived = (int64_t) stamp.tv_sec * 1000000000 + stamp.tv_nsec;
+		}
+	}
+	if (arrived == 0) arrived = wall_time();
+	return size;
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Sends a message from a client.
+ *
+ * @param[in,out]  client - The client
+ * @param[in]      message - The message
+ * @param[in,out]  stats - Counters of the client's thread
+ *****************************************************************************/
+static void send_message( LoadClient& client, const ServerMessage& message,
+	LoadStats& stats )
+{
+	unsigned char packet[server_packet_size];
+	size_t size = encodeMessage(message, packet);
+	if (send(client.fd, packet, size, MSG_DONTWAIT) == (long) size)
+	{
+		stats.packets_out++;
+		stats.bytes_out += size;
+	}
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Opens a client's socket to the server and asks for a match.
+ *
+ * @param[in,out]  client - The client
+ * @param[in]      settings - Settings of the run
+ * @param[in]      epoll_fd - Where the thread waits for packets
+ * @param[in]      number - Number of the client
+ * @param[in,out]  stats - Counters of the client's thread
+ *
+ * @returns True if the socket opened, false if not.
+ *****************************************************************************/
+static bool open_client( LoadClient& client, const LoadSettings& settings,
+	int epoll_fd, long number, LoadStats& stats )
+{
+	client.fd = socket(settings.server->ai_family, SOCK_DGRAM | SOCK_NONBLOCK,
+		0);
+	if (client.fd < 0) return false;
+	if (connect(client.fd, settings.server->ai_addr,
+		settings.server->ai_addrlen) != 0)
+	{
+		close(client.fd);
+		return false;
+	}
+
+	int on = 1;
+	setsockopt(client.fd, SOL_SOCKET, SO_TIMESTAMPNS, &on, sizeof(on));
+
+	epoll_event event;
+	event.events = EPOLLIN;
+	event.data.u64 = (uint64_t) number;
+	epoll_ctl(epoll_fd, EPOLL_CTL_ADD, client.fd, &event);
+
+	// The bot's own paddle and ball, moved to wherever the server says
+	int u = PongGame::unit;
+	client.random.seed(settings.seed, (uint64_t) number);
+	client.paddle = new (nothrow) Paddle(NULL, 2.5 * u, 12 * u, u, 8 * u,
+		32 * u, 0, 24 * u, 0);
+	client.ball = new (nothrow) Ball(NULL, 0, 0, 20, 0, 0);
+	if (client.paddle == NULL || client.ball == NULL) return false;
+	client.paddle->change_max_paddle_speed(2, 3);
+	client.ai = new (nothrow) AIController(client.paddle, client.ball,
+		&client.random, &Difficulty::standard);
+	if (client.ai == NULL) return false;
+
+	client.open = true;
+	client.playing = false;
+	client.last_join = chrono::steady_clock::now();
+	stats.open++;
+
+	ServerMessage message;
+	message.type = CLIENT_JOIN;
+	message.mode = (uint8_t) settings.mode;
+	send_message(client, message, stats);
+	return true;
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Reads what a packet from the server says: starts or ends the client's
+ * match, or moves its paddle and ball to where the server has them and
+ * times how long the update and the keys it played took.
+ *
+ * @param[in,out]  client - The client the packet came to
+ * @param[in]      packet - The packet
+ * @param[in]      size - Size of the packet in bytes
+ * @param[in]      now - When it was read
+ * @param[in]      arrived - When it arrived, in nanoseconds
+ * @param[in]      mode - Kind of match to ask for next
+ * @param[in,out]  stats - Counters of the client's thread
+ *****************************************************************************/
+static void handle_packet( LoadClient& client, const unsigned char* packet,
+	size_t size, LoadTime now, int64_t arrived, int mode,
+	LoadStats& stats )
+{
+	ServerMessage message;
+	if (!decodeMessage(packet, size, message)) return;
+
+	if (message.type == SERVER_WELCOME && !client.playing)
+	{
+		client.playing = true;
+		client.side = message.side;
+		client.heard = false;
+		client.keys = 0;
+		client.ack = 0;
+		memset(client.snapshots, 0, sizeof(client.snapshots));
+		stats.playing++;
+	}
+	else if (message.type == SERVER_FULL)
+	{
+		stats.full++;
+	}
+	else if (message.type == SERVER_END && client.playing)
+	{
+		client.playing = false;
+		stats.playing--;
+		stats.finished++;
+
+		// Ask for another right away
+		client.last_join = now;
+		ServerMessage join;
+		join.type = CLIENT_JOIN;
+		join.mode = (uint8_t) mode;
+		send_message(client, join, stats);
+	}
+	else if (message.type == SERVER_STATE && client.playing)
+	{
+		// Unpack against the snapshot the server packed it against
+		static const Snapshot none = Snapshot();
+		const Snapshot& base = message.base == 0 ? none
+			: client.snapshots[message.base % snapshot_history];
+		Snapshot state;
+		if ((message.base != 0 && base.tick != message.base)
+			|| !decodeSnapshot(base, message.snapshot, message.snapshot_size,
+				state))
+		{
+			stats.undecodable++;
+			return;
+		}
+		if (client.heard && state.tick <= client.last_tick)
+		{
+			stats.reordered++;
+			return;
+		}
+		client.snapshots[state.tick % snapshot_history] = state;
+		client.ack = state.tick;
+
+		if (client.heard)
+		{
+			stats.missed += state.tick - client.last_tick - 1;
+			add_time(stats.intervals, (long) ((arrived - client.last_state)
+				/ 1000));
+		}
+		client.heard = true;
+		client.last_tick = state.tick;
+		client.last_state = arrived;
+
+		// Time the keys this state was the first to play
+		uint32_t seq = message.seq;
+		if (seq != 0 && seq + sent_window > client.seq)
+		{
+			int64_t& sent = client.sent[seq % sent_window];
+			if (sent != 0)
+			{
+				add_time(stats.latencies, (long) ((arrived - sent) / 1000));
+				sent = 0;
+			}
+		}
+
+		// Let the AI move the paddle from where the server has it, and
+		// hold whichever key follows it
+		double y = snapshotPixels(client.side == 0 ? state.left_y
+			: state.right_y);
+		client.paddle->verticalPosition(y);
+		client.ball->center_y = snapshotPixels(state.ball_y);
+		client.ball->center_x = snapshotPixels(state.ball_x);
+		client.ai->step();
+		double move = client.paddle->getY() - y;
+		client.keys = move > 0.5 ? 1 : (move < -0.5 ? 2 : 0);
+	}
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Runs one thread's share of the clients: opens them as the ramp allows,
+ * reads what the server sends, and sends every client's keys on each tick
+ * until the run stops. Then every client leaves.
+ *
+ * @param[in]      settings - Settings of the run
+ * @param[in]      index - Number of the thread
+ * @param[in,out]  stats - Counters of the thread
+ *****************************************************************************/
+static void run_clients( const LoadSettings* settings, int index,
+	LoadStats* stats )
+{
+	int epoll_fd = epoll_create1(0);
+	if (epoll_fd < 0) return;
+
+	// This thread plays every threads'th client
+	long count = (settings->clients - index + settings->threads - 1)
+		/ settings->threads;
+	if (count < 0) count = 0;
+	vector<LoadClient> clients(count);
+	for (long i = 0; i < count; i++)
+	{
+		clients[i].open = false;
+		clients[i].playing = false;
+		clients[i].seq = 0;
+		clients[i].paddle = NULL;
+		clients[i].ball = NULL;
+		clients[i].ai = NULL;
+		memset(clients[i].sent, 0, sizeof(clients[i].sent));
+	}
+
+	chrono::duration<double> tick_length(1.0 / settings->tick_rate);
+	LoadTime next_tick = settings->start;
+	long opened = 0;
+	epoll_event events[256];
+	unsigned char packet[server_packet_size];
+
+	while (!stopping)
+	{
+		LoadTime now = chrono::steady_clock::now();
+
+		// Open the clients whose turn has come
+		double elapsed = chrono::duration<double>(now - settings->start)
+			.count();
+		long due = (long) (elapsed * settings->ramp);
+		while (opened < count && opened * settings->threads + index <= due)
+		{
+			long number = opened * settings->threads + index;
+			if (!open_client(clients[opened], *settings, epoll_fd, opened,
+				*stats))
+			{
+				cerr << "Unable to open client " << number << endl;
+				stopping = true;
+				break;
+			}
+			opened++;
+		}
+
+		if (now >= next_tick)
+		{
+			for (long i = 0; i < opened; i++)
+			{
+				LoadClient& client = clients[i];
+				if (client.playing)
+				{
+					ServerMessage message;
+					message.type = CLIENT_INPUT;
+					message.seq = ++client.seq;
+					message.keys = client.keys;
+					message.ack = client.ack;
+					client.sent[client.seq % sent_window] = wall_time();
+					send_message(client, message, *stats);
+				}
+				else if (now - client.last_join > chrono::seconds(1))
+				{
+					// The welcome or the join was lost, or the server was
+					// full
+					client.last_join = now;
+					ServerMessage message;
+					message.type = CLIENT_JOIN;
+					message.mode = (uint8_t) settings->mode;
+					send_message(client, message, *stats);
+				}
+			}
+			next_tick += chrono::duration_cast<chrono::steady_clock::duration>(
+				tick_length);
+			if (next_tick < now) next_tick = now;
+		}
+
+		long wait = (long) chrono::duration_cast<chrono::milliseconds>(
+			next_tick - chrono::steady_clock::now()).count();
+		int ready = epoll_wait(epoll_fd, events, 256, wait > 0 ? wait : 0);
+		now = chrono::steady_clock::now();
+		for (int e = 0; e < ready; e++)
+		{
+			LoadClient& client = clients[events[e].data.u64];
+			while (true)
+			{
+				int64_t arrived;
+				long size = receive_packet(client, packet, arrived);
+				if (size < 0) break;
+				stats->packets_in++;
+				stats->bytes_in += size;
+				handle_packet(client, packet, size, now, arrived,
+					settings->mode, *stats);
+			}
+		}
+	}
+
+	ServerMessage leave;
+	leave.type = CLIENT_LEAVE;
+	for (long i = 0; i < opened; i++)
+	{
+		send_message(clients[i], leave, *stats);
+		close(clients[i].fd);
+		delete clients[i].ai;
+		delete clients[i].paddle;
+		delete clients[i].ball;
+	}
+	close(epoll_fd);
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Prints what the clients saw since the last report.
+ *
+ * @param[in,out]  stats - Every thread's counters
+ * @param[in]      seconds - Seconds since the last report
+ * @param[in]      sides - Clients in each match, 1 against the AI and 2
+ *		against another bot
+ * @param[in,out]  last - Counters as of the last report
+ *****************************************************************************/
+static void report( LoadStatsList& stats, double seconds, int sides,
+	vector<long>& last )
+{
+	vector<long> now(11, 0);
+	for (size_t t = 0; t < stats.size(); t++)
+	{
+		now[0] += stats[t].open;
+		now[1] += stats[t].playing;
+		now[2] += stats[t].bytes_in;
+		now[3] += stats[t].bytes_out;
+		now[4] += stats[t].packets_in;
+		now[5] += stats[t].packets_out;
+		now[6] += stats[t].missed;
+		now[7] += stats[t].reordered;
+		now[8] += stats[t].finished;
+		now[9] += stats[t].full;
+		now[10] += stats[t].undecodable;
+	}
+
+	double matches = (double) now[1] / sides;
+	double in = (now[2] - last[2]) / seconds;
+	double out = (now[3] - last[3]) / seconds;
+	double packets_in = (now[4] - last[4]) / seconds;
+	double packets_out = (now[5] - last[5]) / seconds;
+
+	cout << "clients " << now[0] << "  playing " << now[1]
+		<< "  matches finished " << now[8] / sides << "  server full "
+		<< now[9]
+		<< endl;
+	print_percentiles("state interval", stats, false);
+	print_percentiles("key latency", stats, true);
+	cout << "  missed steps    " << now[6] - last[6] << "  out of order "
+		<< now[7] - last[7] << "  couldn't unpack " << now[10] - last[10]
+		<< endl;
+	if (matches > 0)
+	{
+		cout << fixed << setprecision(0)
+			<< "  per match       down " << in / matches << " B/s ("
+			<< (in + packets_in * header_bytes) / matches << " on the wire)"
+			<< "  up " << out / matches << " B/s ("
+			<< (out + packets_out * header_bytes) / matches
+			<< " on the wire)" << endl;
+	}
+	last = now;
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Reads the command line, starts the client threads, and reports on them
+ * until the run is over.
+ *
+ * @param[in]      argc - Number of aurments from the command line
+ * @param[out]     argv - An array of command line aurgments
+ *
+ * @returns 0 if the run finished, 1 on bad arguments or if the server
+ *		couldn't be found.
+ *****************************************************************************/
+int main( int argc, char *argv[] )
+{
+	string server = "127.0.0.1:7000";
+	LoadSettings settings;
+	settings.clients = 1000;
+	settings.ramp = 200;
+	settings.mode = MATCH_VS_AI;
+	settings.threads = 2;
+	settings.tick_rate = 60;
+	settings.seed = (uint64_t) time(NULL);
+	double duration = 30;
+	double interval = 5;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--server") == 0 && i + 1 < argc)
+		{
+			server = argv[++i];
+		}
+		else if (strcmp(argv[i], "--clients") == 0 && i + 1 < argc)
+		{
+			settings.clients = atol(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--ramp") == 0 && i + 1 < argc)
+		{
+			settings.ramp = atof(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--mode") == 0 && i + 1 < argc)
+		{
+			i++;
+			if (strcmp(argv[i], "ai") == 0) settings.mode = MATCH_VS_AI;
+			else if (strcmp(argv[i], "player") == 0)
+				settings.mode = MATCH_VS_PLAYER;
+			else
+			{
+				usage(argv[0]);
+				return 1;
+			}
+		}
+		else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+		{
+			settings.threads = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--tick-rate") == 0 && i + 1 < argc)
+		{
+			settings.tick_rate = atof(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--duration") == 0 && i + 1 < argc)
+		{
+			duration = atof(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--report") == 0 && i + 1 < argc)
+		{
+			interval = atof(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+		{
+			settings.seed = (uint64_t) strtoull(argv[++i], NULL, 10);
+		}
+		else
+		{
+			usage(argv[0]);
+			return 1;
+		}
+	}
+
+	size_t colon = server.rfind(':');
+	if (colon == string::npos || settings.clients < 1 || settings.ramp <= 0
+		|| settings.threads < 1 || settings.tick_rate <= 0 || interval <= 0)
+	{
+		usage(argv[0]);
+		return 1;
+	}
+
+	addrinfo hints;
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_INET;
+	hints.ai_socktype = SOCK_DGRAM;
+	if (getaddrinfo(server.substr(0, colon).c_str(),
+		server.substr(colon + 1).c_str(), &hints, &settings.server) != 0)
+	{
+		cerr << "Unable to find " << server << endl;
+		return 1;
+	}
+
+	// Every client needs a socket
+	rlimit files;
+	if (getrlimit(RLIMIT_NOFILE, &files) == 0
+		&& files.rlim_cur < (rlim_t) settings.clients + 64)
+	{
+		files.rlim_cur = min(files.rlim_max,
+			(rlim_t) settings.clients + 64);
+		setrlimit(RLIMIT_NOFILE, &files);
+	}
+
+	LoadStatsList stats(settings.threads);
+	for (int t = 0; t < settings.threads; t++)
+	{
+		stats[t].open = 0;
+		stats[t].playing = 0;
+		stats[t].bytes_in = 0;
+		stats[t].bytes_out = 0;
+		stats[t].packets_in = 0;
+		stats[t].packets_out = 0;
+		stats[t].missed = 0;
+		stats[t].reordered = 0;
+		stats[t].undecodable = 0;
+		stats[t].finished = 0;
+		stats[t].full = 0;
+	}
+
+	settings.start = chrono::steady_clock::now();
+	vector<thread> pool;
+	for (int t = 0; t < settings.threads; t++)
+	{
+		pool.push_back(thread(run_clients, &settings, t, &stats[t]));
+	}
+
+	double ramp_time = settings.clients / settings.ramp;
+	LoadTime last_report = settings.start;
+	vector<long> last(11, 0);
+	while (!stopping)
+	{
+		this_thread::sleep_for(chrono::milliseconds(100));
+		LoadTime now = chrono::steady_clock::now();
+		if (chrono::duration<double>(now - settings.start).count()
+			>= ramp_time + duration)
+		{
+			stopping = true;
+		}
+
+		double seconds = chrono::duration<double>(now - last_report).count();
+		if (seconds >= interval || stopping)
+		{
+			report(stats, seconds,
+				settings.mode == MATCH_VS_PLAYER ? 2 : 1, last);
+			last_report = now;
+		}
+	}
+
+	for (int t = 0; t < settings.threads; t++)
+	{
+		pool[t].join();
+	}
+	freeaddrinfo(settings.server);
+	return 0;
+}
@@ -0,0 +1,439 @@
+/*************************************************************************//**
+ * @file
+ *
+ * @brief Headless netplay tester. Plays a versus game against another
+ *		process over UDP with rollback, with a bot holding random keys in
+ *		place of each player, and checks that both sides end up with the same
+ *		game.
+ *
+ * @section compile_section Compiling and Usage
+ *
+ * @par Make:
+   @verbatim
+   > make pong-net
+   @endverbatim
+ *
+ * @par Usage:
+   @verbatim
+   > ./pong-net --host PORT [options]
+   > ./pong-net --join HOST:PORT [options]
+   > ./pong-net --verify [options]
+   options: [--ticks N] [--tick-rate N] [--seed N] [--window N]
+            [--latency MS] [--jitter MS] [--loss FRACTION]
+   @endverbatim
+ *
+ * Start one process with --host and another with --join, on the same machine
+ * (127.0.0.1) or another. Each plays --ticks steps (default 1800, half a
+ * minute) at --tick-rate steps a second (default 60), then waits until both
+ * sides have all of each other's keys and prints a checksum of its game.
+ * The checksums printed by the two processes must match.
+ *
+ * --verify plays both sides in one process over 127.0.0.1, then checks that
+ * both games are the same to the bit as a game played straight through with
+ * the keys as they finally arrived, with no guessing or rolling back.
+ *
+ * --latency, --jitter, and --loss make each side's packets late, out of order
+ * and lost (see NetLink). Give both processes the same conditions for a
+ * symmetric network.
+ *
+ *****************************************************************************/
+
+/*******************************************************************************
+ *                 DECLARATIONS, INCLUDES, AND NAMESPACES
+*******************************************************************************/
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <cstring>
+#include <cstdlib>
+#include <ctime>
+#include <stdint.h>
+#include "PongGame.h"
+#include "NetLink.h"
+#include "RollbackSession.h"
+
+using namespace std;
+
+/*!
+ * @brief How a netplay test is run
+ */
+struct NetOptions
+{
+	long ticks;			/*!< Steps each side plays */
+	double tick_rate;	/*!< Steps a second */
+	uint64_t seed;		/*!< Seed of the game, and of the bots */
+	long window;		/*!< Most steps to guess ahead */
+	double latency;		/*!< Milliseconds every packet is held back */
+	double jitter;		/*!< Most extra milliseconds a packet is held back */
+	double loss;		/*!< Fraction of packets dropped */
+};
+
+/*******************************************************************************
+ *                          FUNCTION DEFINITIONS
+*******************************************************************************/
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Prints the command line usage of the tester.
+ *
+ * @param[in]      name - Name the program was invoked with
+ *****************************************************************************/
+static void usage( const char* name )
+{
+	cerr << "Usage: " << name << " --host PORT | --join HOST:PORT | --verify"
+		<< endl << "       [--ticks N] [--tick-rate N] [--seed N] [--window N]"
+		<< endl << "       [--latency MS] [--jitter MS] [--loss FRACTION]"
+		<< endl;
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Boils the state of a game down to one number, so that two games can be
+ * compared by printing it.
+ *
+ * @param[in]      game - The game
+ *
+ * @returns FNV-1a hash of the game's PongState.
+ *****************************************************************************/
+static uint64_t checksum( PongGame& game )
+{
+	PongState state;
+	game.saveState(state);
+
+	const unsigned char* bytes = (const unsigned char*) &state;
+	uint64_t hash = 14695981039346656037ULL;
+	for (size_t i = 0; i < sizeof(state); i++)
+	{
+		hash = (hash ^ bytes[i]) * 1099511628211ULL;
+	}
+	return hash;
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Holds the keys a bot player picks for the coming step on the paddle of a
+ * session. The bot changes its mind about every ten steps.
+ *
+ * @param[in,out]  game - Game the session plays
+ * @param[in]      session - Session whose player the bot stands in for
+ * @param[in,out]  bot - The bot's random numbers
+ * @param[in,out]  keys - Keys the bot holds
+ *****************************************************************************/
+static void bot_step( PongGame& game, RollbackSession& session,
+	PongRandom& bot, unsigned char& keys )
+{
+	if (bot.nextInt(10) == 0) keys = (unsigned char) bot.nextInt(16);
+	game.setInput(session.isRight() ? keys << 4 : keys);
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Keeps one or two sessions reading and sending, without playing any more
+ * steps, until each has every step's keys from the other side, then a
+ * little longer so the other side hears that it does too.
+ *
+ * @param[in,out]  a - A session
+ * @param[in,out]  b - Another session, or NULL
+ *
+ * @returns True if the sessions synchronized, false if they gave up
+ *		waiting.
+ *****************************************************************************/
+static bool settle( RollbackSession& a, RollbackSession* b )
+{
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	chrono::steady_clock::time_point synced = start;
+	bool was_synced = false;
+	while (true)
+	{
+		a.poll();
+		if (b != NULL) b->poll();
+
+		chrono::steady_clock::time_point now = chrono::steady_clock::now();
+		bool is_synced = a.isSynchronized()
+			&& (b == NULL || b->isSynchronized());
+		if (is_synced && !was_synced) synced = now;
+		was_synced = is_synced;
+
+		if (is_synced && now - synced > chrono::milliseconds(500))
+			return true;
+		if (!is_synced && now - start > chrono::seconds(10))
+			return false;
+		this_thread::sleep_for(chrono::milliseconds(1));
+	}
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Prints how much rolling back a session did.
+ *
+ * @param[in]      name - What to call the session
+ * @param[in]      session - The session
+ * @param[in]      link - The session's link
+ *****************************************************************************/
+static void report( const char* name, RollbackSession& session,
+	NetLink& link )
+{
+	cout << name << " ticks:       " << session.getTick() << endl;
+	cout << name << " rollbacks:   " << session.getRollbacks() << endl;
+	cout << name << " resimulated: " << session.getResimulated() << endl;
+	cout << name << " longest:     " << session.getLongestRollback() << endl;
+	cout << name << " waits:       " << session.getWaits() << endl;
+	cout << name << " packets:     " << link.getPacketsSent() << " sent, "
+		<< link.getPacketsDropped() << " dropped" << endl;
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Plays one side of a versus game against another process in real time,
+ * then prints a checksum of the game once both sides agree on every step.
+ *
+ * @param[in]      host - True to host, false to join
+ * @param[in]      address - Host to join, if joining
+ * @param[in]      port - Port to host on or join
+ * @param[in]      options - How to run the test
+ *
+ * @returns 0 if the game finished synchronized, 1 if not.
+ *****************************************************************************/
+static int run_side( bool host, const char* address, int port,
+	const NetOptions& options )
+{
+	NetLink link;
+	if (host ? !link.listen(port) : !link.connect(address, port))
+	{
+		cerr << "Unable to open the connection" << endl;
+		return 1;
+	}
+	link.setConditions(options.latency, options.jitter, options.loss,
+		options.seed + (host ? 1 : 2));
+
+	PongGame game(32 * PongGame::unit, 24 * PongGame::unit);
+	RollbackSession session(&game, &link, host, options.seed, options.window);
+	PongRandom bot(options.seed, host ? 1 : 2);
+	unsigned char keys = 0;
+
+	chrono::duration<double> tick_length(1.0 / options.tick_rate);
+	chrono::steady_clock::time_point next = chrono::steady_clock::now();
+	while (session.getTick() < options.ticks)
+	{
+		if (session.hasTimedOut(host && !session.isStarted() ? 60 : 5))
+		{
+			cerr << "The other side stopped answering" << endl;
+			return 1;
+		}
+		if (session.isStarted()) bot_step(game, session, bot, keys);
+		session.advance();
+
+		next += chrono::duration_cast<chrono::steady_clock::duration>(
+			tick_length);
+		this_thread::sleep_until(next);
+	}
+
+	bool synced = settle(session, NULL);
+	report(host ? "host" : "join", session, link);
+	cout << "checksum:         " << hex << checksum(game) << dec << endl;
+	return synced ? 0 : 1;
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Plays both sides of a versus game in one process over 127.0.0.1 in real
+ * time, then checks that both games are the same to the bit as one played
+ * straight through with the keys both sides finally agreed on.
+ *
+ * @param[in]      options - How to run the test
+ *
+ * @returns 0 if all three games are the same, 1 if not.
+ *****************************************************************************/
+static int verify( const NetOptions& options )
+{
+	NetLink host_link, join_link;
+	if (!host_link.listen(0)
+		|| !join_link.connect("127.0.0.1", host_link.getPort()))
+	{
+		cerr << "Unable to open the connection" << endl;
+		return 1;
+	}
+	host_link.setConditions(options.latency, options.jitter, options.loss,
+		options.seed + 1);
+	join_link.setConditions(options.latency, options.jitter, options.loss,
+		options.seed + 2);
+
+	PongGame host_game(32 * PongGame::unit, 24 * PongGame::unit);
+	PongGame join_game(32 * PongGame::unit, 24 * PongGame::unit);
+	RollbackSession host(&host_game, &host_link, true, options.seed,
+		options.window);
+	RollbackSession join(&join_game, &join_link, false, 0, options.window);
+	PongRandom host_bot(options.seed, 1), join_bot(options.seed, 2);
+	unsigned char host_keys = 0, join_keys = 0;
+
+	chrono::duration<double> tick_length(1.0 / options.tick_rate);
+	chrono::steady_clock::time_point next = chrono::steady_clock::now();
+	while (host.getTick() < options.ticks || join.getTick() < options.ticks)
+	{
+		if (host.hasTimedOut() || join.hasTimedOut())
+		{
+			cerr << "A side stopped answering" << endl;
+			return 1;
+		}
+		if (host.getTick() < options.ticks)
+		{
+			if (host.isStarted())
+				bot_step(host_game, host, host_bot, host_keys);
+			host.advance();
+		}
+		else
+		{
+			host.poll();
+		}
+		if (join.getTick() < options.ticks)
+		{
+			if (join.isStarted())
+				bot_step(join_game, join, join_bot, join_keys);
+			join.advance();
+		}
+		else
+		{
+			join.poll();
+		}
+
+		next += chrono::duration_cast<chrono::steady_clock::duration>(
+			tick_length);
+		this_thread::sleep_until(next);
+	}
+	if (!settle(host, &join))
+	{
+		cerr << "The sides never agreed on every step" << endl;
+		return 1;
+	}
+
+	// The same game with no guessing
+	PongGame straight(32 * PongGame::unit, 24 * PongGame::unit);
+	straight.setSeed(options.seed);
+	straight.startGame(false, false);
+	for (long step = 0; step < options.ticks; step++)
+	{
+		straight.setInput(host.getInput(step));
+		straight.step();
+	}
+
+	report("host", host, host_link);
+	report("join", join, join_link);
+	uint64_t expected = checksum(straight);
+	bool same = checksum(host_game) == expected
+		&& checksum(join_game) == expected;
+	for (long step = 0; step < options.ticks && same; step++)
+	{
+		same = host.getInput(step) == join.getInput(step);
+	}
+	cout << "checksum:         " << hex << expected << dec << endl;
+	cout << "verified:         " << (same ? "both sides match" : "MISMATCH")
+		<< endl;
+	return same ? 0 : 1;
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Reads the command line and runs one side, or both, of a netplay test.
+ *
+ * @param[in]      argc - Number of aurments from the command line
+ * @param[out]     argv - An array of command line aurgments
+ *
+ * @returns 0 if the test passed, 1 bad arguments or failed.
+ *****************************************************************************/
+int main( int argc, char *argv[] )
+{
+	NetOptions options;
+	options.ticks = 1800;
+	options.tick_rate = 60;
+	options.seed = (uint64_t) time(NULL);
+	options.window = 30;
+	options.latency = 0;
+	options.jitter = 0;
+	options.loss = 0;
+	int mode = 0;	// 1 host, 2 join, 3 verify
+	string address;
+	int port = 0;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--host") == 0 && i + 1 < argc)
+		{
+			mode = 1;
+			port = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--join") == 0 && i + 1 < argc)
+		{
+			mode = 2;
+			address = argv[++i];
+			size_t colon = address.rfind(':');
+			if (colon == string::npos)
+			{
+				usage(argv[0]);
+				return 1;
+			}
+			port = atoi(address.c_str() + colon + 1);
+			address.erase(colon);
+		}
+		else if (strcmp(argv[i], "--verify") == 0)
+		{
+			mode = 3;
+		}
+		else if (strcmp(argv[i], "--ticks") == 0 && i + 1 < argc)
+		{
+			options.ticks = atol(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--tick-rate") == 0 && i + 1 < argc)
+		{
+			options.tick_rate = atof(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+		{
+			options.seed = (uint64_t) strtoull(argv[++i], NULL, 10);
+		}
+		else if (strcmp(argv[i], "--window") == 0 && i + 1 < argc)
+		{
+			options.window = atol(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--latency") == 0 && i + 1 < argc)
+		{
+			options.latency = atof(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--jitter") == 0 && i + 1 < argc)
+		{
+			options.jitter = atof(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--loss") == 0 && i + 1 < argc)
+		{
+			options.loss = atof(argv[++i]);
+		}
+		else
+		{
+			usage(argv[0]);
+			return 1;
+		}
+	}
+	if (mode == 0 || options.ticks < 1 || options.tick_rate <= 0
+		|| (mode != 3 && (port <= 0 || port > 65535)))
+	{
+		usage(argv[0]);
+		return 1;
+	}
+
+	if (mode == 3) return verify(options);
+	return run_side(mode == 1, address.c_str(), port, options);
+}
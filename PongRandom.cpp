@@ -0,0 +1,108 @@
+/***************************************************************************//**
+ * @file File containing the implementation of the PongRandom class.
+ *
+ * @brief Contains the implementation for the PongRandom class.
+*******************************************************************************/
+
+/*******************************************************************************
+ *                 DECLARATIONS, INCLUDES, AND NAMESPACES
+*******************************************************************************/
+#include "PongRandom.h"
+
+/*******************************************************************************
+ *                          FUNCTION DEFINITIONS
+*******************************************************************************/
+/***************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: The constructor. Seeds the generator.
+ *
+ * @param[in]	seed - OPTIONAL. Where to start the generator from.
+ * @param[in]	stream - OPTIONAL. Which stream of numbers to draw from.
+*******************************************************************************/
+PongRandom::PongRandom(uint64_t seed, uint64_t stream) :
+state(0), increment(1)
+{
+	this -> seed(seed, stream);
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: Starts the generator over. The same seed and stream
+ *		always give the same numbers.
+ *
+ * @param[in]	seed - Where to start the generator from.
+ * @param[in]	stream - OPTIONAL. Which stream of numbers to draw from.
+*******************************************************************************/
+void PongRandom::seed(uint64_t seed, uint64_t stream)
+{
+	state = 0;
+	increment = (stream << 1) | 1;
+	next();
+	state += seed;
+	next();
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: Gets the whole state of the generator. Handing it to
+ *		setState() later, on this generator or another, carries on with the
+ *		same numbers from here.
+ *
+ * @param[out]	state - Current state.
+ * @param[out]	increment - Current stream.
+*******************************************************************************/
+void PongRandom::getState(uint64_t& state, uint64_t& increment)
+{
+	state = this -> state;
+	increment = this -> increment;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: Puts the generator into a state got from getState().
+ *
+ * @param[in]	state - State to carry on from.
+ * @param[in]	increment - Stream to carry on with.
+*******************************************************************************/
+void PongRandom::setState(uint64_t state, uint64_t increment)
+{
+	this -> state = state;
+	this -> increment = increment | 1;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: Moves the generator on and gets the next 32 random bits.
+ *
+ * @returns The random bits.
+*******************************************************************************/
+uint32_t PongRandom::next()
+{
+	uint64_t old = state;
+	state = old * 6364136223846793005ULL + increment;
+
+	uint32_t shifted = (uint32_t) (((old >> 18) ^ old) >> 27);
+	uint32_t rotation = (uint32_t) (old >> 59);
+	return (shifted >> rotation) | (shifted << ((32 - rotation) & 31));
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: Gets a random number in a range, for use where rand() % n
+ *		would have been.
+ *
+ * @param[in]	bound - One more than the largest number wanted. Must be more
+ *				than 0.
+ *
+ * @returns A number from 0 to bound - 1.
+*******************************************************************************/
+int PongRandom::nextInt(int bound)
+{
+	return (int) (next() % (uint32_t) bound);
+}
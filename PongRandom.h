@@ -0,0 +1,67 @@
+/***************************************************************************//**
+ * @file File containing the declaration for the PongRandom class.
+ *
+ * @brief Contains the declaration for the PongRandom class, a small random
+ *		number generator that each game keeps for itself.
+*******************************************************************************/
+#ifndef _PONGRANDOM_H_
+#define _PONGRANDOM_H_
+
+/*******************************************************************************
+ *                 DECLARATIONS, INCLUDES, AND NAMESPACES
+*******************************************************************************/
+class PongRandom;
+
+#include <stdint.h>
+
+/***************************************************************************//**
+ * @brief The PongRandom class makes the random numbers for one game.
+ *
+ * @details A PCG32 generator (64 bits of state, 32 bit results). Unlike
+ *		rand(), every game has its own, so a match plays the same way every
+ *		time it is given the same seed no matter what else is running, and
+ *		games on different threads never wait on each other for a number.
+ *
+ *		Besides the seed, a generator is given a stream. Generators with the
+ *		same seed and different streams give unrelated numbers, so a run of
+ *		many matches can use one seed and number the matches as streams.
+*******************************************************************************/
+class PongRandom
+{
+	private:
+		uint64_t state;		/*!< Current state of the generator */
+		uint64_t increment;	/*!< Picks the stream; always odd */
+
+	public:
+		/*!
+		 * @brief The constructor. Seeds the generator
+		 */
+		PongRandom(uint64_t seed = 0, uint64_t stream = 0);
+
+		/*!
+		 * @brief Starts the generator over from a seed and stream
+		 */
+		void seed(uint64_t seed, uint64_t stream = 0);
+
+		/*!
+		 * @brief Gets where the generator is, so it can be put back later
+		 */
+		void getState(uint64_t& state, uint64_t& increment);
+
+		/*!
+		 * @brief Puts the generator back to where getState() found it
+		 */
+		void setState(uint64_t state, uint64_t increment);
+
+		/*!
+		 * @brief Gets the next 32 random bits
+		 */
+		uint32_t next();
+
+		/*!
+		 * @brief Gets a random number from 0 up to but not including bound
+		 */
+		int nextInt(int bound);
+};
+
+#endif
@@ -0,0 +1,916 @@
+/*************************************************************************//**
+ * @file
+ *
+ * @brief Game server. Runs thousands of matches of Pong at once on a fixed
+ *		tick for clients that send their keys over UDP and are sent back where
+ *		everything is after every step.
+ *
+ * @section compile_section Compiling and Usage
+ *
+ * @par Make:
+   @verbatim
+   > make pong-server
+   @endverbatim
+ *
+ * @par Usage:
+   @verbatim
+   > ./pong-server [--port N] [--threads N] [--tick-rate N] [--max-matches N]
+                   [--send-every N] [--seed N] [--duration SECONDS]
+                   [--stats SECONDS]
+   @endverbatim
+ *
+ * The server is authoritative: clients only send the keys their player holds
+ * (see ServerProtocol.h), and every match is played by the server alone with
+ * a headless PongGame. A client asks for a match against the AI, which starts
+ * at once, or against another player, which starts when the next client asks
+ * for one too. Every --send-every steps (default every one) each client is
+ * sent a snapshot of its match, along with the number of the last input
+ * played, so it can tell how long its keys take to count. Snapshots are
+ * packed against the newest one the client has acknowledged (see
+ * Snapshot.h), so a step usually costs a client only a few bytes.
+ *
+ * Matches are split between --threads workers (default one per core). Every
+ * worker has its own socket on the same --port (default 7000), opened with
+ * SO_REUSEPORT so the kernel always hands a client's packets to the same
+ * worker, which plays that client's matches. A worker waits on its socket
+ * and a timer with epoll, never blocks otherwise, and reads and sends its
+ * packets many at a time with recvmmsg() and sendmmsg(). Workers share
+ * nothing but their counters, so they never wait on each other.
+ *
+ * A client that sends nothing for ten seconds is dropped. Statistics are
+ * printed every --stats seconds (default 5); the server runs until
+ * interrupted or for --duration seconds.
+ *
+ *****************************************************************************/
+
+/*******************************************************************************
+ *                 DECLARATIONS, INCLUDES, AND NAMESPACES
+*******************************************************************************/
+#include <iostream>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <unordered_map>
+#include <cstring>
+#include <cstdlib>
+#include <ctime>
+#include <csignal>
+#include <stdint.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include "AlignedAllocator.h"
+#include "PongGame.h"
+#include "ServerProtocol.h"
+
+using namespace std;
+
+/*!
+ * @brief Most packets read or sent with one call
+ */
+static const int packet_batch = 256;
+
+/*!
+ * @brief Steps a client may stay quiet before it is dropped, in seconds
+ */
+static const double client_timeout = 10;
+
+/*!
+ * @brief Snapshots each match keeps to pack new ones against
+ */
+static const uint32_t snapshot_history = 32;
+
+/*!
+ * @brief Set when the server should stop
+ */
+static atomic<bool> stopping(false);
+
+struct ServerMatch;
+
+/*!
+ * @brief A client of the server
+ */
+struct ServerClient
+{
+	sockaddr_in address;	/*!< Where the client's packets come from */
+	ServerMatch* match;		/*!< The client's match, NULL if waiting */
+	int side;				/*!< 0 if playing left, 1 if right */
+	uint32_t seq;			/*!< Number of the last input taken */
+	unsigned char keys;		/*!< Keys the client's player is holding */
+	uint32_t ack;			/*!< Newest snapshot the client has, 0 if none */
+	long last_heard;		/*!< Step the client was last heard from on */
+};
+
+/*!
+ * @brief A match being played
+ */
+struct ServerMatch
+{
+	PongGame* game;			/*!< The match */
+	uint32_t id;			/*!< Number of the match */
+	uint32_t tick;			/*!< Steps the match has taken */
+	uint64_t clients[2];	/*!< Key of the client on each side, 0 for the
+								AI */
+	size_t index;			/*!< Where the match is in its worker's list */
+	Snapshot history[snapshot_history];	/*!< The last snapshots taken, by
+											step */
+};
+
+/*!
+ * @brief Everything one worker thread has. Aligned to a cache line so the
+ *		counters of different workers don't share one; kept in a
+ *		ServerWorkers so that holds on the heap too.
+ */
+struct alignas(64) ServerWorker
+{
+	int id;					/*!< Number of the worker */
+	int socket_fd;			/*!< The worker's socket */
+	int epoll_fd;			/*!< Waits on the socket and the timer */
+	int timer_fd;			/*!< Goes off every step */
+	long tick;				/*!< Steps taken */
+	long max_matches;		/*!< Most matches this worker plays at once */
+	uint32_t next_id;		/*!< Number of the next match made */
+	uint64_t waiting;		/*!< Client waiting for an opponent, 0 if none */
+
+	unordered_map<uint64_t, ServerClient> clients;	/*!< Clients by key */
+	vector<ServerMatch*> matches;	/*!< Matches being played */
+
+	vector<mmsghdr> out_headers;	/*!< Packets waiting to be sent */
+	vector<iovec> out_vectors;		/*!< What each packet waiting holds */
+	vector<sockaddr_in> out_addresses;	/*!< Where each is going */
+	vector<unsigned char> out_data;	/*!< The bytes of each */
+
+	atomic<long> match_count;	/*!< Matches being played */
+	atomic<long> client_count;	/*!< Clients */
+	atomic<long> packets_in;	/*!< Packets received */
+	atomic<long> packets_out;	/*!< Packets sent */
+	atomic<long> matches_played;	/*!< Matches finished */
+	atomic<long> late_steps;	/*!< Steps that ran late and were dropped */
+	atomic<long> slowest_step;	/*!< Longest time spent on one step, in
+									microseconds */
+};
+
+/*!
+ * @brief Every worker of the server, each on its own cache lines
+ */
+typedef vector<ServerWorker, AlignedAllocator<ServerWorker> > ServerWorkers;
+
+/*******************************************************************************
+ *                          FUNCTION DEFINITIONS
+*******************************************************************************/
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Prints the command line usage of the server.
+ *
+ * @param[in]      name - Name the program was invoked with
+ *****************************************************************************/
+static void usage( const char* name )
+{
+	cerr << "Usage: " << name << " [--port N] [--threads N] [--tick-rate N]"
+		<< " [--max-matches N]" << endl
+		<< "       [--send-every N] [--seed N] [--duration SECONDS]"
+		<< " [--stats SECONDS]" << endl;
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Signal handler for interrupts. Asks the server to stop.
+ *
+ * @param[in]      signal - The signal
+ *****************************************************************************/
+static void stop_server( int signal )
+{
+	stopping = true;
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Makes the key a client is filed under from where its packets come from.
+ *
+ * @param[in]      address - Address of the client
+ *
+ * @returns The key, never 0.
+ *****************************************************************************/
+static inline uint64_t client_key( const sockaddr_in& address )
+{
+	return ((uint64_t) address.sin_addr.s_addr << 16 | address.sin_port)
+		+ ((uint64_t) 1 << 48);
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Adds a message to the packets a worker sends at the end of the step.
+ *
+ * @param[in,out]  worker - The worker
+ * @param[in]      address - Where to send it
+ * @param[in]      message - The message
+ *****************************************************************************/
+static void queue_message( ServerWorker& worker, const sockaddr_in& address,
+	const ServerMessage& message )
+{
+	size_t n = worker.out_addresses.size();
+	worker.out_addresses.push_back(address);
+	worker.out_data.resize((n + 1) * server_packet_size);
+	size_t size = encodeMessage(message, &worker.out_data[n * server_packet_size]);
+
+	iovec vector;
+	vector.iov_base = NULL;	// Filled in when sent; out_data may move
+	vector.iov_len = size;
+	worker.out_vectors.push_back(vector);
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Sends every packet a worker has waiting, as many at a time as the kernel
+ * takes. Packets the socket has no room for are dropped, as any UDP packet
+ * may be.
+ *
+ * @param[in,out]  worker - The worker
+ *****************************************************************************/
+static void flush_messages( ServerWorker& worker )
+{
+	size_t count = worker.out_addresses.size();
+	if (count == 0) return;
+
+	worker.out_headers.resize(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		worker.out_vectors[i].iov_base = &worker.out_data[i * server_packet_size];
+		msghdr& header = worker.out_headers[i].msg_hdr;
+		memset(&header, 0, sizeof(header));
+		header.msg_name = &worker.out_addresses[i];
+		header.msg_namelen = sizeof(sockaddr_in);
+		header.msg_iov = &worker.out_vectors[i];
+		header.msg_iovlen = 1;
+	}
+
+	size_t sent = 0;
+	while (sent < count)
+	{
+		unsigned int batch = (unsigned int) min(count - sent, (size_t) 1024);
+		int done = sendmmsg(worker.socket_fd, &worker.out_headers[sent], batch,
+			0);
+		if (done <= 0)
+		{
+			// Skip a packet the kernel won't take rather than spin on it
+			sent++;
+			continue;
+		}
+		sent += done;
+		worker.packets_out += done;
+	}
+
+	worker.out_addresses.clear();
+	worker.out_vectors.clear();
+	worker.out_data.clear();
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Packs the newest snapshot of a match into a message for one of its
+ * clients, against the newest snapshot the client has said it has if the
+ * match still remembers it, or else against nothing.
+ *
+ * @param[in]      match - The match
+ * @param[in]      client - The client
+ * @param[in]      full - True to pack against nothing whatever the client
+ *		has
+ * @param[out]     message - The message
+ *****************************************************************************/
+static void pack_snapshot( ServerMatch* match, ServerClient& client,
+	bool full, ServerMessage& message )
+{
+	static const Snapshot none = Snapshot();
+	const Snapshot& snapshot = match->history[match->tick % snapshot_history];
+	const Snapshot& base = match->history[client.ack % snapshot_history];
+	bool known = !full && client.ack != 0
+		&& match->tick - client.ack < snapshot_history
+		&& base.tick == client.ack;
+
+	message.seq = client.seq;
+	message.base = known ? client.ack : 0;
+	message.snapshot_size = encodeSnapshot(known ? base : none, snapshot,
+		message.snapshot, sizeof(message.snapshot));
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Ends a match: tells its clients how it came out, frees them to ask for
+ * another, and throws the match away.
+ *
+ * @param[in,out]  worker - The worker playing the match
+ * @param[in]      match - The match
+ *****************************************************************************/
+static void end_match( ServerWorker& worker, ServerMatch* match )
+{
+	ServerMessage message;
+	message.type = SERVER_END;
+	for (int side = 0; side < 2; side++)
+	{
+		if (match->clients[side] == 0) continue;
+		unordered_map<uint64_t, ServerClient>::iterator client =
+			worker.clients.find(match->clients[side]);
+		if (client == worker.clients.end()) continue;
+
+		pack_snapshot(match, client->second, true, message);
+		queue_message(worker, client->second.address, message);
+		client->second.match = NULL;
+	}
+
+	// Swap the last match into the gap
+	ServerMatch* last = worker.matches.back();
+	worker.matches[match->index] = last;
+	last->index = match->index;
+	worker.matches.pop_back();
+
+	delete match->game;
+	delete match;
+	worker.match_count--;
+	worker.matches_played++;
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Starts a match for one client or two and welcomes them to it.
+ *
+ * @param[in,out]  worker - The worker to play the match
+ * @param[in]      left - Key of the client playing left
+ * @param[in]      right - Key of the client playing right, 0 for the AI
+ * @param[in]      seed - Seed of the server; the match plays a stream of it
+ *****************************************************************************/
+static void start_match( ServerWorker& worker, uint64_t left, uint64_t right,
+	uint64_t seed )
+{
+	ServerMatch* match = new (nothrow) ServerMatch;
+	if (match == NULL) return;
+	match->game = new (nothrow) PongGame(32 * PongGame::unit,
+		24 * PongGame::unit);
+	if (match->game == NULL)
+	{
+		delete match;
+		return;
+	}
+
+	match->id = (uint32_t) worker.id << 24 | (worker.next_id++ & 0xFFFFFF);
+	match->tick = 0;
+	captureSnapshot(match->game, 0, match->history[0]);
+	match->clients[0] = left;
+	match->clients[1] = right;
+	match->index = worker.matches.size();
+	match->game->setSeed(seed, match->id);
+	match->game->startGame(false, right == 0);
+	worker.matches.push_back(match);
+	worker.match_count++;
+
+	ServerMessage message;
+	message.type = SERVER_WELCOME;
+	message.match = match->id;
+	for (int side = 0; side < 2; side++)
+	{
+		if (match->clients[side] == 0) continue;
+		ServerClient& client = worker.clients[match->clients[side]];
+		client.match = match;
+		client.side = side;
+		client.ack = 0;
+		message.side = (uint8_t) side;
+		queue_message(worker, client.address, message);
+	}
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Drops a client. Its match ends if it had one, since the other side can't
+ * go on alone.
+ *
+ * @param[in,out]  worker - The worker the client belongs to
+ * @param[in]      key - Key of the client
+ *****************************************************************************/
+static void drop_client( ServerWorker& worker, uint64_t key )
+{
+	unordered_map<uint64_t, ServerClient>::iterator client =
+		worker.clients.find(key);
+	if (client == worker.clients.end()) return;
+
+	ServerMatch* match = client->second.match;
+	if (match != NULL)
+	{
+		match->clients[client->second.side] = 0;
+		end_match(worker, match);
+	}
+	if (worker.waiting == key) worker.waiting = 0;
+	worker.clients.erase(client);
+	worker.client_count--;
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Does what a packet from a client asks.
+ *
+ * @param[in,out]  worker - The worker the packet came to
+ * @param[in]      address - Where it came from
+ * @param[in]      packet - The packet
+ * @param[in]      size - Size of the packet in bytes
+ * @param[in]      seed - Seed of the server
+ *****************************************************************************/
+static void handle_packet( ServerWorker& worker, const sockaddr_in& address,
+	const unsigned char* packet, size_t size, uint64_t seed )
+{
+	ServerMessage message;
+	if (!decodeMessage(packet, size, message)) return;
+
+	uint64_t key = client_key(address);
+	unordered_map<uint64_t, ServerClient>::iterator found =
+		worker.clients.find(key);
+	if (found != worker.clients.end())
+	{
+		found->second.last_heard = worker.tick;
+	}
+
+	if (message.type == CLIENT_INPUT && found != worker.clients.end())
+	{
+		// Packets can arrive out of order; only newer keys count
+		ServerClient& client = found->second;
+		if (message.seq > client.seq)
+		{
+			client.seq = message.seq;
+			client.keys = message.keys & 15;
+		}
+		if (client.match != NULL && message.ack > client.ack
+			&& message.ack <= client.match->tick)
+		{
+			client.ack = message.ack;
+		}
+	}
+	else if (message.type == CLIENT_JOIN)
+	{
+		// Asking again just repeats the welcome, which may have been lost
+		if (found != worker.clients.end())
+		{
+			ServerMatch* match = found->second.match;
+			if (match != NULL)
+			{
+				ServerMessage welcome;
+				welcome.type = SERVER_WELCOME;
+				welcome.match = match->id;
+				welcome.side = (uint8_t) found->second.side;
+				queue_message(worker, address, welcome);
+			}
+			return;
+		}
+
+		if ((long) worker.matches.size() >= worker.max_matches)
+		{
+			ServerMessage full;
+			full.type = SERVER_FULL;
+			queue_message(worker, address, full);
+			return;
+		}
+
+		ServerClient client;
+		client.address = address;
+		client.match = NULL;
+		client.side = 0;
+		client.seq = 0;
+		client.keys = 0;
+		client.ack = 0;
+		client.last_heard = worker.tick;
+		worker.clients[key] = client;
+		worker.client_count++;
+
+		if (message.mode != MATCH_VS_PLAYER)
+		{
+			start_match(worker, key, 0, seed);
+		}
+		else if (worker.waiting != 0)
+		{
+			uint64_t opponent = worker.waiting;
+			worker.waiting = 0;
+			start_match(worker, opponent, key, seed);
+		}
+		else
+		{
+			worker.waiting = key;
+		}
+	}
+	else if (message.type == CLIENT_LEAVE && found != worker.clients.end())
+	{
+		drop_client(worker, key);
+	}
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Reads every packet waiting on a worker's socket, many at a time.
+ *
+ * @param[in,out]  worker - The worker
+ * @param[in]      seed - Seed of the server
+ *****************************************************************************/
+static void read_packets( ServerWorker& worker, uint64_t seed )
+{
+	static thread_local unsigned char data[packet_batch][server_packet_size];
+	static thread_local sockaddr_in addresses[packet_batch];
+	static thread_local iovec vectors[packet_batch];
+	static thread_local mmsghdr headers[packet_batch];
+
+	while (true)
+	{
+		for (int i = 0; i < packet_batch; i++)
+		{
+			vectors[i].iov_base = data[i];
+			vectors[i].iov_len = server_packet_size;
+			memset(&headers[i].msg_hdr, 0, sizeof(msghdr));
+			headers[i].msg_hdr.msg_name = &addresses[i];
+			headers[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+			headers[i].msg_hdr.msg_iov = &vectors[i];
+			headers[i].msg_hdr.msg_iovlen = 1;
+		}
+
+		int count = recvmmsg(worker.socket_fd, headers, packet_batch,
+			MSG_DONTWAIT, NULL);
+		if (count <= 0) return;
+
+		worker.packets_in += count;
+		for (int i = 0; i < count; i++)
+		{
+			handle_packet(worker, addresses[i], data[i], headers[i].msg_len,
+				seed);
+		}
+		if (count < packet_batch) return;
+	}
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Plays one step of every match a worker has, ends the matches that are
+ * over, sends clients where everything is, and drops clients gone quiet.
+ *
+ * @param[in,out]  worker - The worker
+ * @param[in]      send_every - Steps between state updates
+ * @param[in]      tick_rate - Steps a second
+ *****************************************************************************/
+static void run_step( ServerWorker& worker, long send_every,
+	double tick_rate )
+{
+	worker.tick++;
+
+	// Play the step with the keys each client last sent
+	for (size_t i = 0; i < worker.matches.size(); )
+	{
+		ServerMatch* match = worker.matches[i];
+		unsigned char keys[2] = { 0, 0 };
+		for (int side = 0; side < 2; side++)
+		{
+			if (match->clients[side] == 0) continue;
+			unordered_map<uint64_t, ServerClient>::iterator client =
+				worker.clients.find(match->clients[side]);
+			if (client != worker.clients.end())
+				keys[side] = client->second.keys;
+		}
+		match->game->setInput(keys[0] | keys[1] << 4);
+		match->game->step();
+		match->tick++;
+		captureSnapshot(match->game, match->tick,
+			match->history[match->tick % snapshot_history]);
+
+		if (match->game->isRunning())
+			i++;
+		else
+			end_match(worker, match);	// Moves the last match here
+	}
+
+	// Tell clients where everything is
+	if (worker.tick % send_every == 0)
+	{
+		ServerMessage message;
+		message.type = SERVER_STATE;
+		for (size_t i = 0; i < worker.matches.size(); i++)
+		{
+			ServerMatch* match = worker.matches[i];
+			for (int side = 0; side < 2; side++)
+			{
+				if (match->clients[side] == 0) continue;
+				ServerClient& client = worker.clients[match->clients[side]];
+				pack_snapshot(match, client, false, message);
+				queue_message(worker, client.address, message);
+			}
+		}
+	}
+
+	// Drop clients that have gone quiet, once a second
+	long ticks_per_second = (long) tick_rate > 0 ? (long) tick_rate : 1;
+	if (worker.tick % ticks_per_second == 0)
+	{
+		long quiet = (long) (client_timeout * tick_rate);
+		vector<uint64_t> gone;
+		for (unordered_map<uint64_t, ServerClient>::iterator client =
+			worker.clients.begin(); client != worker.clients.end(); client++)
+		{
+			if (worker.tick - client->second.last_heard > quiet)
+				gone.push_back(client->first);
+		}
+		for (size_t i = 0; i < gone.size(); i++)
+		{
+			drop_client(worker, gone[i]);
+		}
+	}
+
+	flush_messages(worker);
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Opens a worker's socket and timer and adds them to its epoll set.
+ *
+ * @param[in,out]  worker - The worker
+ * @param[in]      port - Port every worker shares
+ * @param[in]      tick_rate - Steps a second
+ *
+ * @returns True if everything opened, false if not.
+ *****************************************************************************/
+static bool open_worker( ServerWorker& worker, int port, double tick_rate )
+{
+	worker.socket_fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0);
+	if (worker.socket_fd < 0) return false;
+
+	int on = 1;
+	int buffer = 4 << 20;
+	setsockopt(worker.socket_fd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on));
+	setsockopt(worker.socket_fd, SOL_SOCKET, SO_RCVBUF, &buffer,
+		sizeof(buffer));
+	setsockopt(worker.socket_fd, SOL_SOCKET, SO_SNDBUF, &buffer,
+		sizeof(buffer));
+
+	sockaddr_in address;
+	memset(&address, 0, sizeof(address));
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_ANY);
+	address.sin_port = htons((uint16_t) port);
+	if (bind(worker.socket_fd, (sockaddr*) &address, sizeof(address)) != 0)
+	{
+		return false;
+	}
+
+	worker.timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK);
+	if (worker.timer_fd < 0) return false;
+	long period = (long) (1e9 / tick_rate);
+	itimerspec interval;
+	interval.it_interval.tv_sec = period / 1000000000;
+	interval.it_interval.tv_nsec = period % 1000000000;
+	interval.it_value = interval.it_interval;
+	if (timerfd_settime(worker.timer_fd, 0, &interval, NULL) != 0)
+	{
+		return false;
+	}
+
+	worker.epoll_fd = epoll_create1(0);
+	if (worker.epoll_fd < 0) return false;
+	epoll_event event;
+	event.events = EPOLLIN;
+	event.data.fd = worker.socket_fd;
+	epoll_ctl(worker.epoll_fd, EPOLL_CTL_ADD, worker.socket_fd, &event);
+	event.data.fd = worker.timer_fd;
+	epoll_ctl(worker.epoll_fd, EPOLL_CTL_ADD, worker.timer_fd, &event);
+	return true;
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Runs one worker until the server stops: waits for packets and the step
+ * timer, handles packets as they come, and plays a step each time the timer
+ * goes off. If steps fall behind, only one is played and the rest are
+ * counted as late, so a slow step can't snowball.
+ *
+ * @param[in,out]  worker - The worker
+ * @param[in]      tick_rate - Steps a second
+ * @param[in]      send_every - Steps between state updates
+ * @param[in]      seed - Seed of the server
+ *****************************************************************************/
+static void run_worker( ServerWorker* worker, double tick_rate,
+	long send_every, uint64_t seed )
+{
+	epoll_event events[2];
+	while (!stopping)
+	{
+		int count = epoll_wait(worker->epoll_fd, events, 2, 100);
+		for (int i = 0; i < count; i++)
+		{
+			if (events[i].data.fd == worker->socket_fd)
+			{
+				read_packets(*worker, seed);
+				flush_messages(*worker);
+			}
+			else if (events[i].data.fd == worker->timer_fd)
+			{
+				uint64_t expirations = 0;
+				if (read(worker->timer_fd, &expirations, sizeof(expirations))
+					!= sizeof(expirations))
+				{
+					continue;
+				}
+				if (expirations > 1) worker->late_steps += expirations - 1;
+
+				chrono::steady_clock::time_point start =
+					chrono::steady_clock::now();
+				run_step(*worker, send_every, tick_rate);
+				long micros = (long) chrono::duration_cast<
+					chrono::microseconds>(chrono::steady_clock::now()
+					- start).count();
+				if (micros > worker->slowest_step) worker->slowest_step = micros;
+			}
+		}
+	}
+
+	while (!worker->matches.empty())
+	{
+		end_match(*worker, worker->matches.back());
+	}
+	flush_messages(*worker);
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Reads the command line, starts the workers, and prints statistics until
+ * the server is stopped.
+ *
+ * @param[in]      argc - Number of aurments from the command line
+ * @param[out]     argv - An array of command line aurgments
+ *
+ * @returns 0 if the server ran, 1 bad arguments or the port couldn't be
+ *		opened.
+ *****************************************************************************/
+int main( int argc, char *argv[] )
+{
+	int port = 7000;
+	int threads = (int) thread::hardware_concurrency();
+	double tick_rate = 60;
+	long max_matches = 100000;
+	long send_every = 1;
+	uint64_t seed = (uint64_t) time(NULL);
+	double duration = 0;
+	double stats = 5;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--port") == 0 && i + 1 < argc)
+		{
+			port = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+		{
+			threads = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--tick-rate") == 0 && i + 1 < argc)
+		{
+			tick_rate = atof(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--max-matches") == 0 && i + 1 < argc)
+		{
+			max_matches = atol(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--send-every") == 0 && i + 1 < argc)
+		{
+			send_every = atol(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+		{
+			seed = (uint64_t) strtoull(argv[++i], NULL, 10);
+		}
+		else if (strcmp(argv[i], "--duration") == 0 && i + 1 < argc)
+		{
+			duration = atof(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--stats") == 0 && i + 1 < argc)
+		{
+			stats = atof(argv[++i]);
+		}
+		else
+		{
+			usage(argv[0]);
+			return 1;
+		}
+	}
+	if (threads < 1) threads = 1;
+	if (port <= 0 || port > 65535 || tick_rate <= 0 || max_matches < 1
+		|| send_every < 1 || stats <= 0)
+	{
+		usage(argv[0]);
+		return 1;
+	}
+
+	signal(SIGINT, stop_server);
+	signal(SIGTERM, stop_server);
+
+	ServerWorkers workers(threads);
+	for (int w = 0; w < threads; w++)
+	{
+		ServerWorker& worker = workers[w];
+		worker.id = w;
+		worker.tick = 0;
+		worker.max_matches = (max_matches + threads - 1) / threads;
+		worker.next_id = 0;
+		worker.waiting = 0;
+		worker.match_count = 0;
+		worker.client_count = 0;
+		worker.packets_in = 0;
+		worker.packets_out = 0;
+		worker.matches_played = 0;
+		worker.late_steps = 0;
+		worker.slowest_step = 0;
+		if (!open_worker(worker, port, tick_rate))
+		{
+			cerr << "Unable to open port " << port << endl;
+			return 1;
+		}
+	}
+
+	vector<thread> pool;
+	for (int w = 0; w < threads; w++)
+	{
+		pool.push_back(thread(run_worker, &workers[w], tick_rate, send_every,
+			seed));
+	}
+	cout << "serving on port " << port << " with " << threads
+		<< " workers" << endl;
+
+	// Print what the workers are doing now and then
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	chrono::steady_clock::time_point last = start;
+	long last_in = 0, last_out = 0;
+	while (!stopping)
+	{
+		this_thread::sleep_for(chrono::milliseconds(100));
+		chrono::steady_clock::time_point now = chrono::steady_clock::now();
+		if (duration > 0
+			&& chrono::duration<double>(now - start).count() >= duration)
+		{
+			stopping = true;
+		}
+
+		double seconds = chrono::duration<double>(now - last).count();
+		if (seconds < stats && !stopping) continue;
+
+		long matches = 0, clients = 0, in = 0, out = 0, played = 0,
+			late = 0, slowest = 0;
+		for (int w = 0; w < threads; w++)
+		{
+			matches += workers[w].match_count;
+			clients += workers[w].client_count;
+			in += workers[w].packets_in;
+			out += workers[w].packets_out;
+			played += workers[w].matches_played;
+			late += workers[w].late_steps;
+			slowest = max(slowest, workers[w].slowest_step.exchange(0));
+		}
+		cout << "matches " << matches << "  clients " << clients
+			<< "  finished " << played
+			<< "  in/s " << (long) ((in - last_in) / seconds)
+			<< "  out/s " << (long) ((out - last_out) / seconds)
+			<< "  late steps " << late
+			<< "  slowest step " << slowest << "us" << endl;
+		last = now;
+		last_in = in;
+		last_out = out;
+	}
+
+	for (int w = 0; w < threads; w++)
+	{
+		pool[w].join();
+		close(workers[w].socket_fd);
+		close(workers[w].timer_fd);
+		close(workers[w].epoll_fd);
+	}
+	return 0;
+}
@@ -0,0 +1,1364 @@
+/*************************************************************************//**
+ * @file
+ *
+ * @brief Headless match simulator. Plays AI vs AI matches of Pong as fast as
+ *		the processor allows, without opening a window or linking OpenGL.
+ *
+ * @section compile_section Compiling and Usage
+ *
+ * @par Make:
+   @verbatim
+   > make pong-sim
+   @endverbatim
+ *
+ * @par Usage:
+   @verbatim
+   > ./pong-sim [--matches N] [--max-ticks N] [--seed N]
+                [--batch [--batch-size N] | --verify-batch |
+                 --events | --verify-events | --verify-state |
+                 --snapshots [--ack-delay N] | --step-times | --net-bench]
+                [--record FILE] [--left-ai KIND] [--right-ai KIND]
+                [--policy FILE] [--net FILE]
+   > ./pong-sim --replay FILE [--seek N | --verify-seek] [--policy FILE]
+                [--net FILE]
+   @endverbatim
+ *
+ * By default matches are played one after another with PongGame. --batch
+ * plays them with BatchGame, --batch-size matches at a time. --verify-batch
+ * plays every match both ways side by side and checks that they agree to the
+ * bit on every step.
+ *
+ * --events plays matches with PongGame, but jumps straight over the steps in
+ * which nothing but movement happens (PongGame::quietSteps()), so that a
+ * match costs about as much as the number of bounces in it rather than the
+ * number of steps. --verify-events plays every match both ways and checks
+ * that they agree to the bit wherever the event-driven game stops.
+ *
+ * --verify-state checks that PongGame::restoreState() puts a match back
+ * exactly, by rolling matches back 60 steps over and over and playing the
+ * steps again, and reports how long saving and restoring a state take.
+ *
+ * --snapshots measures the snapshots pong-server sends (see Snapshot.h): it
+ * captures one on every step of every match, packs each against the one
+ * --ack-delay steps earlier (default 6, a tenth of a second of round trip),
+ * and reports the bytes a step takes, against nothing as well, and how long
+ * packing and unpacking take. Every snapshot must unpack to exactly what
+ * was packed.
+ *
+ * --step-times times every step of every match on its own and reports the
+ * average, the 99th percentile and the slowest, along with how many times
+ * the heap was used during steps, which should be none. It is meant for the
+ * AIs that work hardest on a step, "lookahead" above all.
+ *
+ * --net-bench plays matches of the network --net loads against itself,
+ * stepping them all together, and works out every paddle's move each step
+ * with one PaddleNet::evaluateBatch() over all of them. It reports how long
+ * a move takes worked out one at a time with each kernel and all together,
+ * and checks that the AVX2 kernel, the other one, and the batch agree to
+ * the bit on every move. Use a few thousand --matches.
+ *
+ * Match m of a run plays stream m of --seed (see PongRandom), so the same
+ * seed always gives the same matches whichever way they are played.
+ *
+ * --left-ai and --right-ai pick the AI that plays each side, "follow" (the
+ * default, see AIController), "predict" (see PredictiveController),
+ * "lookahead" (see LookaheadController), "policy" (see PolicyController),
+ * which plays the policy --policy loads from a file written by pong-train,
+ * or "neural" (see NeuralController), which plays the network --net loads
+ * from one. Replays of games the policy or network played need the same
+ * --policy or --net to play back.
+ * BatchGame only plays "follow", so --batch and --verify-batch can't be
+ * given either.
+ *
+ * --record saves the matches played one at a time (by default or with
+ * --events) to a replay file. --replay plays back a replay file, recorded
+ * here or by "pong --record", as fast as possible, and fails if any game in
+ * it doesn't come out exactly as it did when recorded. --seek starts playing
+ * at step N of the replay instead of the beginning. --verify-seek plays the
+ * replay through once, saving the game's state at a hundred points along
+ * the way, then seeks back to each of them, last first, and checks that the
+ * state found is the same to the bit.
+ *
+ *****************************************************************************/
+
+/*******************************************************************************
+ *                 DECLARATIONS, INCLUDES, AND NAMESPACES
+*******************************************************************************/
+#include <iostream>
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+#include <ctime>
+#include <vector>
+#include <new>
+#include <algorithm>
+#include "PongGame.h"
+#include "BatchGame.h"
+#include "Snapshot.h"
+
+using namespace std;
+
+/*!
+ * @brief Tally of a number of matches played
+ */
+struct SimResults
+{
+	long matches;			/*!< Number of matches played */
+	long left_wins;			/*!< Matches won by the left side */
+	long right_wins;		/*!< Matches won by the right side */
+	long unfinished;		/*!< Matches cut off by max_ticks */
+	long long ticks;		/*!< Steps taken by all matches together */
+	long long stepped;		/*!< Steps actually worked through one by one */
+};
+
+/*!
+ * @brief Number of times the heap has been used, counted by operator new
+ */
+static long heap_allocations = 0;
+
+/*******************************************************************************
+ *                          FUNCTION DEFINITIONS
+*******************************************************************************/
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Allocates memory from the heap like the library's operator new, counting
+ * each time, so that --step-times can tell whether a step used the heap.
+ *
+ * @param[in]      size - Bytes to allocate
+ *
+ * @returns The memory allocated.
+ *****************************************************************************/
+void* operator new( size_t size )
+{
+	heap_allocations++;
+	void* memory = malloc(size == 0 ? 1 : size);
+	if (memory == NULL) throw bad_alloc();
+	return memory;
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Allocates memory from the heap, counting each time, and returns NULL
+ * instead of throwing if there isn't any.
+ *
+ * @param[in]      size - Bytes to allocate
+ *
+ * @returns The memory allocated, or NULL.
+ *****************************************************************************/
+void* operator new( size_t size, const nothrow_t& ) noexcept
+{
+	heap_allocations++;
+	return malloc(size == 0 ? 1 : size);
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Frees memory from operator new.
+ *
+ * @param[in]      memory - Memory to free
+ *****************************************************************************/
+void operator delete( void* memory ) noexcept
+{
+	free(memory);
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Frees memory from operator new.
+ *
+ * @param[in]      memory - Memory to free
+ *****************************************************************************/
+void operator delete( void* memory, const nothrow_t& ) noexcept
+{
+	free(memory);
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Prints the command line usage of the simulator.
+ *
+ * @param[in]      name - Name the program was invoked with
+ *****************************************************************************/
+static void usage( const char* name )
+{
+	cerr << "Usage: " << name << " [--matches N] [--max-ticks N] [--seed N]"
+		<< endl << "       [--batch [--batch-size N] | --verify-batch |"
+		<< endl << "        --events | --verify-events | --verify-state |"
+		<< endl << "        --snapshots [--ack-delay N] | --step-times |"
+		<< " --net-bench]"
+		<< endl << "       [--record FILE] [--left-ai KIND] [--right-ai KIND]"
+		<< endl << "       [--policy FILE] [--net FILE]"
+		<< endl << "       " << name << " --replay FILE [--seek N | --verify-seek]"
+		<< " [--policy FILE]" << endl << "       [--net FILE]" << endl;
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Loads the policy and network the AI_POLICY and AI_NEURAL AIs play into a
+ * game.
+ *
+ * @param[in,out]  game - The game
+ * @param[in]      policy - File of the policy, NULL for none
+ * @param[in]      net - File of the network, NULL for none
+ *****************************************************************************/
+static void load_files( PongGame& game, const char* policy, const char* net )
+{
+	if (policy != NULL) game.loadPolicy(policy);
+	if (net != NULL) game.loadNet(net);
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Plays matches one at a time with PongGame.
+ *
+ * @param[in,out]  game - Game to play the matches with
+ * @param[in]      matches - Number of matches to play
+ * @param[in]      max_ticks - Steps after which a match is abandoned
+ * @param[in]      seed - Seed for the matches; match m plays stream m of it
+ *
+ * @returns The results of the matches.
+ *****************************************************************************/
+static SimResults run_scalar( PongGame& game, long matches, long max_ticks,
+	uint64_t seed )
+{
+	SimResults results = { matches, 0, 0, 0, 0, 0 };
+
+	for (long m = 0; m < matches; m++)
+	{
+		game.setSeed(seed, m);
+		game.startGame(true, true);
+
+		long ticks = 0;
+		while (game.isRunning() && ticks < max_ticks)
+		{
+			game.step();
+			ticks++;
+		}
+		results.ticks += ticks;
+		results.stepped += ticks;
+
+		if (game.isRunning())
+		{
+			results.unfinished++;
+			game.quitGame();
+		}
+		else if (game.getLeftScore() > game.getRightScore())
+		{
+			results.left_wins++;
+		}
+		else
+		{
+			results.right_wins++;
+		}
+	}
+
+	return results;
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Plays matches batch_size at a time with BatchGame.
+ *
+ * @param[in]      matches - Number of matches to play
+ * @param[in]      max_ticks - Steps after which a match is abandoned
+ * @param[in]      batch_size - Number of matches to play at once
+ * @param[in]      seed - Seed for the matches; match m plays stream m of it
+ *
+ * @returns The results of the matches.
+ *****************************************************************************/
+static SimResults run_batch( long matches, long max_ticks, int batch_size,
+	uint64_t seed )
+{
+	SimResults results = { matches, 0, 0, 0, 0, 0 };
+
+	for (long done = 0; done < matches; done += batch_size)
+	{
+		int n = (int) min((long) batch_size, matches - done);
+		BatchGame batch(32 * PongGame::unit, 24 * PongGame::unit, n);
+		batch.start(seed, done);
+
+		while (batch.getRunning() > 0 && batch.getTick() < max_ticks)
+		{
+			batch.step();
+		}
+
+		for (int i = 0; i < n; i++)
+		{
+			if (batch.isRunning(i))
+			{
+				results.unfinished++;
+				results.ticks += batch.getTick();
+			}
+			else
+			{
+				results.ticks += batch.getEndTick(i);
+				if (batch.getLeftScore(i) > batch.getRightScore(i))
+				{
+					results.left_wins++;
+				}
+				else
+				{
+					results.right_wins++;
+				}
+			}
+		}
+		results.stepped += batch.getTick();
+	}
+
+	return results;
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Plays matches one at a time with PongGame, skipping over the steps in
+ * which nothing happens.
+ *
+ * @param[in,out]  game - Game to play the matches with
+ * @param[in]      matches - Number of matches to play
+ * @param[in]      max_ticks - Steps after which a match is abandoned
+ * @param[in]      seed - Seed for the matches; match m plays stream m of it
+ *
+ * @returns The results of the matches.
+ *****************************************************************************/
+static SimResults run_events( PongGame& game, long matches, long max_ticks,
+	uint64_t seed )
+{
+	SimResults results = { matches, 0, 0, 0, 0, 0 };
+
+	for (long m = 0; m < matches; m++)
+	{
+		game.setSeed(seed, m);
+		game.startGame(true, true);
+
+		long ticks = 0;
+		while (game.isRunning() && ticks < max_ticks)
+		{
+			long quiet = game.quietSteps(max_ticks - ticks);
+			if (quiet > 0)
+			{
+				game.skip(quiet);
+				ticks += quiet;
+			}
+			else
+			{
+				game.step();
+				ticks++;
+				results.stepped++;
+			}
+		}
+		results.ticks += ticks;
+
+		if (game.isRunning())
+		{
+			results.unfinished++;
+			game.quitGame();
+		}
+		else if (game.getLeftScore() > game.getRightScore())
+		{
+			results.left_wins++;
+		}
+		else
+		{
+			results.right_wins++;
+		}
+	}
+
+	return results;
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Checks that seeking in a replay file finds the same game as playing it
+ * from the start. Plays the replay through once, saving the state of the
+ * game at a hundred evenly spaced steps, then seeks to each of those steps,
+ * from the last back to the first, and compares the states to the bit.
+ *
+ * @param[in]      path - Replay file to check
+ * @param[in]      policy - File of the policy AI_POLICY plays, NULL for none
+ * @param[in]      net - File of the network AI_NEURAL plays, NULL for none
+ *
+ * @returns Number of seeks that found a different state, or 1 if the file
+ *		couldn't be read.
+ *****************************************************************************/
+static long verify_seek( const char* path, const char* policy,
+	const char* net )
+{
+	PongGame game(32 * PongGame::unit, 24 * PongGame::unit);
+	load_files(game, policy, net);
+	if (!game.startPlayback(path))
+	{
+		cerr << "Unable to read replay " << path << endl;
+		return 1;
+	}
+
+	long length = game.getReplayLength();
+	const long samples = 100;
+	vector<long> ticks;
+	for (long i = 0; i < samples; i++)
+	{
+		long tick = length * i / samples;
+		if (ticks.empty() || tick != ticks.back()) ticks.push_back(tick);
+	}
+
+	// Play through once, stopping on every step to sample
+	vector<PongState> states(ticks.size());
+	size_t next = 0;
+	while (game.isPlayingBack() && next < ticks.size())
+	{
+		long tick = game.getReplayTick();
+		if (tick == ticks[next])
+		{
+			game.saveState(states[next++]);
+			continue;
+		}
+
+		long quiet = game.quietSteps(ticks[next] - tick);
+		if (quiet > 0)
+			game.skip(quiet);
+		else
+			game.step();
+	}
+	if (next < ticks.size())
+	{
+		cerr << "Replay ended at step " << game.getReplayTick()
+			<< " of " << length << endl;
+		return 1;
+	}
+
+	// Seek back to every sample, last first
+	long failures = 0;
+	double slowest = 0, total = 0;
+	for (long i = (long) ticks.size() - 1; i >= 0; i--)
+	{
+		if (!game.startPlayback(path))
+		{
+			cerr << "Unable to read replay " << path << endl;
+			return 1;
+		}
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		bool found = game.seekPlayback(ticks[i]);
+		double seconds = chrono::duration<double>(
+			chrono::steady_clock::now() - start).count();
+		total += seconds;
+		if (seconds > slowest) slowest = seconds;
+
+		PongState state;
+		game.saveState(state);
+		if (!found || game.getReplayTick() != ticks[i]
+			|| memcmp(&state, &states[i], sizeof(state)) != 0)
+		{
+			cerr << "Seek to step " << ticks[i] << " differs" << endl;
+			failures++;
+		}
+	}
+
+	cout << "length:       " << length << endl;
+	cout << "seeks:        " << ticks.size() << endl;
+	cout << "failures:     " << failures << endl;
+	cout << "mean seek us: " << total / ticks.size() * 1e6 << endl;
+	cout << "max seek us:  " << slowest * 1e6 << endl;
+	return failures;
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Plays back a replay file as fast as possible, skipping over the steps in
+ * which nothing happens, and reports whether every game in it came out the
+ * way it was recorded.
+ *
+ * @param[in]      path - Replay file to play
+ * @param[in]      seek - Step of the replay to start playing at
+ * @param[in]      policy - File of the policy AI_POLICY plays, NULL for none
+ * @param[in]      net - File of the network AI_NEURAL plays, NULL for none
+ *
+ * @returns 0 if every game matched, 1 if not or if the file couldn't be
+ *		read.
+ *****************************************************************************/
+static int run_replay( const char* path, long seek, const char* policy,
+	const char* net )
+{
+	PongGame game(32 * PongGame::unit, 24 * PongGame::unit);
+	load_files(game, policy, net);
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	if (!game.startPlayback(path))
+	{
+		cerr << "Unable to read replay " << path << endl;
+		return 1;
+	}
+
+	long long ticks = 0, stepped = 0;
+	if (seek > 0)
+	{
+		chrono::steady_clock::time_point seek_start =
+			chrono::steady_clock::now();
+		if (!game.seekPlayback(seek))
+		{
+			cerr << "Unable to seek to step " << seek << endl;
+			return 1;
+		}
+		ticks = game.getReplayTick();
+		cout << "seek seconds: " << chrono::duration<double>(
+			chrono::steady_clock::now() - seek_start).count() << endl;
+	}
+
+	while (game.isPlayingBack())
+	{
+		long quiet = game.quietSteps(60L * 60 * 60);
+		if (quiet > 0)
+		{
+			game.skip(quiet);
+			ticks += quiet;
+		}
+		else
+		{
+			game.step();
+			ticks++;
+			stepped++;
+		}
+	}
+	double seconds = chrono::duration<double>(
+		chrono::steady_clock::now() - start).count();
+
+	cout << "mismatches:   " << game.getReplayMismatches() << endl;
+	cout << "ticks:        " << ticks << endl;
+	cout << "stepped:      " << stepped << endl;
+	cout << "seconds:      " << seconds << endl;
+	if (seconds > 0)
+	{
+		cout << "ticks/sec:    " << ticks / seconds << endl;
+	}
+	return game.getReplayMismatches() == 0 ? 0 : 1;
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Checks whether two games are in exactly the same state: everything
+ * saveState() saves, down to where things were drawn from on the previous
+ * step.
+ *
+ * @param[in]      a - One game
+ * @param[in]      b - The other game
+ *
+ * @returns True if they agree to the bit, false if anything differs.
+ *****************************************************************************/
+static bool same_state( PongGame& a, PongGame& b )
+{
+	PongState state_a, state_b;
+	a.saveState(state_a);
+	b.saveState(state_b);
+	return memcmp(&state_a, &state_b, sizeof(state_a)) == 0;
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Plays each match twice, once step by step and once skipping quiet steps,
+ * and checks that the two are in exactly the same state every time the
+ * skipping game stops.
+ *
+ * @param[in]      matches - Number of matches to play
+ * @param[in]      max_ticks - Steps after which a match is abandoned
+ * @param[in]      seed - Seed for the matches; match m plays stream m of it
+ * @param[in]      left_ai - AIKind of the left side
+ * @param[in]      right_ai - AIKind of the right side
+ * @param[in]      policy - File of the policy AI_POLICY plays, NULL for none
+ * @param[in]      net - File of the network AI_NEURAL plays, NULL for none
+ *
+ * @returns Number of matches that didn't agree.
+ *****************************************************************************/
+static long verify_events( long matches, long max_ticks, uint64_t seed,
+	int left_ai, int right_ai, const char* policy, const char* net )
+{
+	PongGame ticked(32 * PongGame::unit, 24 * PongGame::unit);
+	PongGame skipped(32 * PongGame::unit, 24 * PongGame::unit);
+	ticked.setScoreDemo(true);
+	skipped.setScoreDemo(true);
+	ticked.setAIKind(false, left_ai);
+	ticked.setAIKind(true, right_ai);
+	load_files(ticked, policy, net);
+	skipped.setAIKind(false, left_ai);
+	skipped.setAIKind(true, right_ai);
+	load_files(skipped, policy, net);
+	long failures = 0;
+	long long ticks = 0, stepped = 0;
+
+	for (long m = 0; m < matches; m++)
+	{
+		ticked.setSeed(seed, m);
+		ticked.startGame(true, true);
+		skipped.setSeed(seed, m);
+		skipped.startGame(true, true);
+
+		long tick = 0;
+		bool failed = false;
+		while (skipped.isRunning() && tick < max_ticks && !failed)
+		{
+			long quiet = skipped.quietSteps(max_ticks - tick);
+			if (quiet > 0)
+			{
+				skipped.skip(quiet);
+				for (long i = 0; i < quiet; i++)
+				{
+					ticked.step();
+				}
+				tick += quiet;
+			}
+			else
+			{
+				tick++;
+				skipped.step();
+				ticked.step();
+				stepped++;
+			}
+
+			if (!same_state(ticked, skipped))
+			{
+				cerr << "match " << m << " differs at step " << tick << endl;
+				failed = true;
+				failures++;
+			}
+		}
+		ticks += tick;
+
+		ticked.quitGame();
+		skipped.quitGame();
+	}
+
+	cout << "verified:     " << matches - failures << " of " << matches
+		<< " matches identical" << endl;
+	cout << "ticks:        " << ticks << endl;
+	cout << "stepped:      " << stepped << endl;
+	return failures;
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Checks that PongGame::restoreState() really does put a game back. Every
+ * 97 steps of each match the state is saved, the match is played 60 steps
+ * on and saved again, then put back to the first state and played the same
+ * 60 steps, which must come out the same to the bit. Then times saving and
+ * restoring states, back and forth between two a second apart in the first
+ * match, as rolling back does.
+ *
+ * @param[in]      matches - Number of matches to play
+ * @param[in]      max_ticks - Steps after which a match is abandoned
+ * @param[in]      seed - Seed for the matches; match m plays stream m of it
+ * @param[in]      left_ai - AIKind of the left side
+ * @param[in]      right_ai - AIKind of the right side
+ * @param[in]      policy - File of the policy AI_POLICY plays, NULL for none
+ * @param[in]      net - File of the network AI_NEURAL plays, NULL for none
+ *
+ * @returns Number of matches that didn't come out the same.
+ *****************************************************************************/
+static long verify_state( long matches, long max_ticks, uint64_t seed,
+	int left_ai, int right_ai, const char* policy, const char* net )
+{
+	PongGame game(32 * PongGame::unit, 24 * PongGame::unit);
+	game.setScoreDemo(true);
+	game.setAIKind(false, left_ai);
+	game.setAIKind(true, right_ai);
+	load_files(game, policy, net);
+	long failures = 0, checks = 0;
+	PongState saved, ahead, again, samples[2];
+
+	for (long m = 0; m < matches; m++)
+	{
+		game.setSeed(seed, m);
+		game.startGame(true, true);
+
+		bool failed = false;
+		for (long tick = 0; game.isRunning() && tick < max_ticks && !failed;
+			tick++)
+		{
+			if (tick % 97 == 0)
+			{
+				game.saveState(saved);
+				for (int i = 0; i < 60; i++) game.step();
+				game.saveState(ahead);
+				game.restoreState(saved);
+				for (int i = 0; i < 60; i++) game.step();
+				game.saveState(again);
+				checks++;
+
+				if (memcmp(&ahead, &again, sizeof(ahead)) != 0)
+				{
+					cerr << "match " << m << " differs after restoring step "
+						<< tick << endl;
+					failed = true;
+					failures++;
+				}
+			}
+			if (m == 0 && (tick == 300 || tick == 360))
+				game.saveState(samples[tick == 360]);
+			game.step();
+		}
+		game.quitGame();
+	}
+
+	// Time saving and restoring on their own
+	const long rounds = 1000000;
+	game.restoreState(samples[0]);
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	for (long i = 0; i < rounds; i++)
+	{
+		game.saveState(saved);
+	}
+	double save_seconds = chrono::duration<double>(
+		chrono::steady_clock::now() - start).count();
+	start = chrono::steady_clock::now();
+	for (long i = 0; i < rounds; i++)
+	{
+		game.restoreState(samples[i & 1]);
+	}
+	double restore_seconds = chrono::duration<double>(
+		chrono::steady_clock::now() - start).count();
+
+	cout << "verified:     " << matches - failures << " of " << matches
+		<< " matches restored exactly over " << checks << " rollbacks" << endl;
+	cout << "state bytes:  " << sizeof(PongState) << endl;
+	cout << "save ns:      " << save_seconds / rounds * 1e9 << endl;
+	cout << "restore ns:   " << restore_seconds / rounds * 1e9 << endl;
+	return failures;
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Captures a snapshot on every step of a number of matches, then packs each
+ * against the one a number of steps before it, as a server would against
+ * the last one a client said it had, and unpacks it again. Reports the
+ * bytes a step takes that way and against nothing, and the time taken to
+ * pack and unpack one.
+ *
+ * @param[in]      matches - Number of matches to play
+ * @param[in]      max_ticks - Steps after which a match is abandoned
+ * @param[in]      seed - Seed for the matches; match m plays stream m of it
+ * @param[in]      ack_delay - Steps between a snapshot and the one it is
+ *		packed against
+ *
+ * @returns Number of snapshots that didn't unpack to what was packed.
+ *****************************************************************************/
+static long bench_snapshots( long matches, long max_ticks, uint64_t seed,
+	long ack_delay )
+{
+	PongGame game(32 * PongGame::unit, 24 * PongGame::unit);
+	game.setScoreDemo(true);
+	vector<Snapshot> snapshots;
+	vector<unsigned char> packed;
+	vector<unsigned char> sizes;
+	Snapshot none = Snapshot();
+	long failures = 0;
+	long long count = 0, delta_bytes = 0, full_bytes = 0;
+	double encode_seconds = 0, decode_seconds = 0;
+
+	for (long m = 0; m < matches; m++)
+	{
+		game.setSeed(seed, m);
+		game.startGame(true, true);
+		snapshots.clear();
+		for (long tick = 1; game.isRunning() && tick <= max_ticks; tick++)
+		{
+			game.step();
+			snapshots.push_back(Snapshot());
+			captureSnapshot(&game, (uint32_t) tick, snapshots.back());
+		}
+		game.quitGame();
+
+		size_t n = snapshots.size();
+		packed.resize(n * snapshot_max_size);
+		sizes.resize(n);
+
+		// Pack, timed on their own
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		for (size_t i = 0; i < n; i++)
+		{
+			const Snapshot& base = (long) i >= ack_delay
+				? snapshots[i - ack_delay] : none;
+			sizes[i] = (unsigned char) encodeSnapshot(base, snapshots[i],
+				&packed[i * snapshot_max_size], snapshot_max_size);
+		}
+		encode_seconds += chrono::duration<double>(
+			chrono::steady_clock::now() - start).count();
+
+		// Unpack and check
+		Snapshot unpacked;
+		long wrong = 0;
+		start = chrono::steady_clock::now();
+		for (size_t i = 0; i < n; i++)
+		{
+			const Snapshot& base = (long) i >= ack_delay
+				? snapshots[i - ack_delay] : none;
+			if (!decodeSnapshot(base, &packed[i * snapshot_max_size],
+				sizes[i], unpacked)
+				|| memcmp(&unpacked, &snapshots[i], sizeof(unpacked)) != 0)
+			{
+				wrong++;
+			}
+		}
+		decode_seconds += chrono::duration<double>(
+			chrono::steady_clock::now() - start).count();
+
+		if (wrong > 0)
+		{
+			cerr << "match " << m << ": " << wrong
+				<< " snapshots didn't unpack the same" << endl;
+			failures += wrong;
+		}
+
+		unsigned char scratch[snapshot_max_size];
+		for (size_t i = 0; i < n; i++)
+		{
+			delta_bytes += sizes[i];
+			full_bytes += encodeSnapshot(none, snapshots[i], scratch,
+				sizeof(scratch));
+		}
+		count += n;
+	}
+
+	cout << "snapshots:    " << count << endl;
+	cout << "failures:     " << failures << endl;
+	if (count > 0)
+	{
+		cout << "bytes/tick:   " << (double) delta_bytes / count
+			<< " against " << ack_delay << " steps back" << endl;
+		cout << "full bytes:   " << (double) full_bytes / count
+			<< " against nothing" << endl;
+		cout << "raw bytes:    " << sizeof(Snapshot) << " unpacked" << endl;
+		cout << "encode ns:    " << encode_seconds / count * 1e9 << endl;
+		cout << "decode ns:    " << decode_seconds / count * 1e9 << endl;
+	}
+	return failures;
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Plays a number of matches timing every step on its own, and reports how
+ * long steps take and how many times the heap was used during them.
+ *
+ * @param[in]      matches - Number of matches to play
+ * @param[in]      max_ticks - Steps after which a match is abandoned
+ * @param[in]      seed - Seed for the matches; match m plays stream m of it
+ * @param[in]      left_ai - AIKind of the left side
+ * @param[in]      right_ai - AIKind of the right side
+ * @param[in]      policy - File of the policy AI_POLICY plays, NULL for none
+ * @param[in]      net - File of the network AI_NEURAL plays, NULL for none
+ *
+ * @returns Number of times the heap was used during steps.
+ *****************************************************************************/
+static long bench_steps( long matches, long max_ticks, uint64_t seed,
+	int left_ai, int right_ai, const char* policy, const char* net )
+{
+	PongGame game(32 * PongGame::unit, 24 * PongGame::unit);
+	game.setScoreDemo(true);
+	game.setAIKind(false, left_ai);
+	game.setAIKind(true, right_ai);
+	load_files(game, policy, net);
+	vector<double> times;
+	long allocations = 0;
+	double total = 0;
+
+	for (long m = 0; m < matches; m++)
+	{
+		game.setSeed(seed, m);
+		game.startGame(true, true);
+		times.reserve(times.size() + max_ticks);
+
+		for (long tick = 0; game.isRunning() && tick < max_ticks; tick++)
+		{
+			long before = heap_allocations;
+			chrono::steady_clock::time_point start
+				= chrono::steady_clock::now();
+			game.step();
+			double seconds = chrono::duration<double>(
+				chrono::steady_clock::now() - start).count();
+			allocations += heap_allocations - before;
+			times.push_back(seconds);
+			total += seconds;
+		}
+		game.quitGame();
+	}
+
+	cout << "ticks:        " << times.size() << endl;
+	cout << "allocations:  " << allocations << " during steps" << endl;
+	if (!times.empty())
+	{
+		sort(times.begin(), times.end());
+		cout << "mean us:      " << total / times.size() * 1e6 << endl;
+		cout << "p99 us:       " << times[times.size() * 99 / 100] * 1e6
+			<< endl;
+		cout << "max us:       " << times.back() * 1e6 << endl;
+	}
+	return allocations;
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Plays matches of a network against itself, all stepped together, working
+ * out every paddle's move each step in one batch, and reports how long
+ * moves take one at a time with each kernel and in the batch. Checks that
+ * every move comes out the same to the bit all three ways.
+ *
+ * @param[in]      matches - Number of matches to play at once
+ * @param[in]      max_ticks - Steps after which matches are abandoned
+ * @param[in]      seed - Seed for the matches; match m plays stream m of it
+ * @param[in]      net - File of the network
+ *
+ * @returns Number of moves that didn't agree, or 1 if the network couldn't
+ *		be loaded.
+ *****************************************************************************/
+static long bench_net( long matches, long max_ticks, uint64_t seed,
+	const char* net )
+{
+	PaddleNet model;
+	if (net == NULL || !model.load(net))
+	{
+		cerr << "--net-bench needs a network from --net" << endl;
+		return 1;
+	}
+	bool avx2 = PaddleNet::hasAVX2();
+
+	const int k = PaddleNet::input_count;
+	long paddles = 2 * matches;
+	vector<PongGame*> games(matches);
+	vector<float> inputs(paddles * k), batched(paddles), single(paddles);
+	vector<float> scalar(paddles);
+	for (long m = 0; m < matches; m++)
+	{
+		games[m] = new PongGame(32 * PongGame::unit, 24 * PongGame::unit);
+		games[m]->setScoreDemo(true);
+		games[m]->setSeed(seed, m);
+		games[m]->startGame(false, false);
+	}
+
+	long failures = 0;
+	long long moves = 0;
+	double batch_seconds = 0, single_seconds = 0, scalar_seconds = 0;
+	long tick = 0;
+	for (long running = matches; running > 0 && tick < max_ticks; tick++)
+	{
+		long count = 0;
+		for (long m = 0; m < matches; m++)
+		{
+			if (!games[m]->isRunning()) continue;
+			Ball* ball = games[m]->getBall();
+			PaddleNet::features(ball, games[m]->getLeftPaddle(),
+				&inputs[count++ * k]);
+			PaddleNet::features(ball, games[m]->getRightPaddle(),
+				&inputs[count++ * k]);
+		}
+
+		model.setVectorized(avx2);
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		model.evaluateBatch(&inputs[0], &batched[0], count);
+		chrono::steady_clock::time_point done = chrono::steady_clock::now();
+		for (long i = 0; i < count; i++)
+		{
+			single[i] = model.evaluate(&inputs[i * k]);
+		}
+		chrono::steady_clock::time_point one = chrono::steady_clock::now();
+		model.setVectorized(false);
+		for (long i = 0; i < count; i++)
+		{
+			scalar[i] = model.evaluate(&inputs[i * k]);
+		}
+		chrono::steady_clock::time_point other = chrono::steady_clock::now();
+		batch_seconds += chrono::duration<double>(done - start).count();
+		single_seconds += chrono::duration<double>(one - done).count();
+		scalar_seconds += chrono::duration<double>(other - one).count();
+
+		// Move the paddles as NeuralController would, then step
+		count = 0;
+		running = 0;
+		for (long m = 0; m < matches; m++)
+		{
+			if (!games[m]->isRunning()) continue;
+			for (int side = 0; side < 2; side++, count++)
+			{
+				if (memcmp(&batched[count], &single[count], sizeof(float)) != 0
+					|| memcmp(&batched[count], &scalar[count],
+						sizeof(float)) != 0)
+				{
+					failures++;
+				}
+				Paddle* paddle = side == 0 ? games[m]->getLeftPaddle()
+					: games[m]->getRightPaddle();
+				if (batched[count] != 0)
+				{
+					paddle->verticalMotion(batched[count]
+						* paddle->getVerticalSpeed());
+				}
+			}
+			games[m]->step();
+			if (games[m]->isRunning()) running++;
+		}
+		moves += count;
+	}
+
+	for (long m = 0; m < matches; m++)
+	{
+		delete games[m];
+	}
+
+	cout << "matches:      " << matches << " at once, " << tick << " steps"
+		<< endl;
+	cout << "moves:        " << moves << endl;
+	cout << "kernel:       " << (avx2 ? "AVX2" : "scalar (no AVX2)") << endl;
+	if (moves > 0)
+	{
+		cout << "ns/move:      " << single_seconds / moves * 1e9
+			<< " one at a time" << endl;
+		cout << "ns/move:      " << scalar_seconds / moves * 1e9
+			<< " one at a time, scalar" << endl;
+		cout << "ns/move:      " << batch_seconds / moves * 1e9
+			<< " batched" << endl;
+		cout << "ns/step:      " << batch_seconds / tick * 1e9
+			<< " batched, all matches" << endl;
+	}
+	cout << "verified:     " << moves - failures << " of " << moves
+		<< " moves identical" << endl;
+	return failures;
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Plays the same matches with a BatchGame and with one PongGame per match,
+ * stepping them side by side, and checks after every step that each match is
+ * in exactly the same state both ways.
+ *
+ * @param[in]      matches - Number of matches to play
+ * @param[in]      max_ticks - Steps after which matches are abandoned
+ * @param[in]      seed - Seed for the matches; match m plays stream m of it
+ *
+ * @returns Number of matches that didn't agree.
+ *****************************************************************************/
+static long verify_batch( long matches, long max_ticks, uint64_t seed )
+{
+	int n = (int) matches;
+	vector<PongGame*> games(n);
+	BatchGame batch(32 * PongGame::unit, 24 * PongGame::unit, n);
+	vector<bool> failed(n, false);
+	long failures = 0;
+
+	for (int i = 0; i < n; i++)
+	{
+		games[i] = new PongGame(32 * PongGame::unit, 24 * PongGame::unit);
+		games[i]->setScoreDemo(true);
+		games[i]->setSeed(seed, i);
+		games[i]->startGame(true, true);
+	}
+
+	batch.start(seed);
+
+	for (long tick = 1; batch.getRunning() > 0 && tick <= max_ticks; tick++)
+	{
+		for (int i = 0; i < n; i++)
+		{
+			if (games[i]->isRunning())
+			{
+				games[i]->step();
+			}
+		}
+		batch.step();
+
+		for (int i = 0; i < n; i++)
+		{
+			if (!failed[i] && !batch.matchesGame(i, games[i]))
+			{
+				cerr << "match " << i << " differs at step " << tick << endl;
+				failed[i] = true;
+				failures++;
+			}
+		}
+	}
+
+	for (int i = 0; i < n; i++)
+	{
+		delete games[i];
+	}
+
+	cout << "verified:     " << matches - failures << " of " << matches
+		<< " matches identical over " << batch.getTick() << " steps" << endl;
+	return failures;
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Prints the results of a simulation and how fast it ran.
+ *
+ * @param[in]      results - The results to print
+ * @param[in]      seconds - How long the simulation took
+ *****************************************************************************/
+static void report( const SimResults& results, double seconds )
+{
+	cout << "matches:      " << results.matches << endl;
+	cout << "left wins:    " << results.left_wins << endl;
+	cout << "right wins:   " << results.right_wins << endl;
+	cout << "unfinished:   " << results.unfinished << endl;
+	cout << "ticks:        " << results.ticks << endl;
+	cout << "stepped:      " << results.stepped << endl;
+	cout << "seconds:      " << seconds << endl;
+	if (seconds > 0)
+	{
+		cout << "matches/sec:  " << results.matches / seconds << endl;
+		cout << "ticks/sec:    " << results.ticks / seconds << endl;
+		cout << "x real-time:  " << results.ticks / 60.0 / seconds << endl;
+	}
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Plays a number of AI vs AI matches to completion with no window and reports
+ * the results and the simulation throughput.
+ *
+ * @param[in]      argc - Number of aurments from the command line
+ * @param[out]     argv - An array of command line aurgments
+ *
+ * @returns 0 program ran successfully, 1 bad arguments or failed
+ *		verification.
+ *****************************************************************************/
+int main( int argc, char *argv[] )
+{
+	long matches = 1000;
+	long max_ticks = 60L * 60 * 60;	// An hour of game time per match
+	uint64_t seed = (uint64_t) time(NULL);
+	bool batch = false;
+	bool verify = false;
+	bool events = false;
+	bool verify_skip = false;
+	bool verify_states = false;
+	int batch_size = 4096;
+	const char* record = NULL;
+	const char* replay = NULL;
+	long seek = 0;
+	bool verify_seeks = false;
+	bool snapshots = false;
+	long ack_delay = 6;
+	bool step_times = false;
+	const char* policy = NULL;
+	const char* net = NULL;
+	bool net_bench = false;
+	int left_ai = AI_FOLLOW;
+	int right_ai = AI_FOLLOW;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--matches") == 0 && i + 1 < argc)
+		{
+			matches = atol(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--max-ticks") == 0 && i + 1 < argc)
+		{
+			max_ticks = atol(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+		{
+			seed = (uint64_t) strtoull(argv[++i], NULL, 10);
+		}
+		else if (strcmp(argv[i], "--batch") == 0)
+		{
+			batch = true;
+		}
+		else if (strcmp(argv[i], "--batch-size") == 0 && i + 1 < argc)
+		{
+			batch_size = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--verify-batch") == 0)
+		{
+			verify = true;
+		}
+		else if (strcmp(argv[i], "--events") == 0)
+		{
+			events = true;
+		}
+		else if (strcmp(argv[i], "--verify-events") == 0)
+		{
+			verify_skip = true;
+		}
+		else if (strcmp(argv[i], "--verify-state") == 0)
+		{
+			verify_states = true;
+		}
+		else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+		{
+			record = argv[++i];
+		}
+		else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc)
+		{
+			replay = argv[++i];
+		}
+		else if (strcmp(argv[i], "--seek") == 0 && i + 1 < argc)
+		{
+			seek = atol(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--verify-seek") == 0)
+		{
+			verify_seeks = true;
+		}
+		else if (strcmp(argv[i], "--snapshots") == 0)
+		{
+			snapshots = true;
+		}
+		else if (strcmp(argv[i], "--ack-delay") == 0 && i + 1 < argc)
+		{
+			ack_delay = atol(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--policy") == 0 && i + 1 < argc)
+		{
+			policy = argv[++i];
+		}
+		else if (strcmp(argv[i], "--net") == 0 && i + 1 < argc)
+		{
+			net = argv[++i];
+		}
+		else if (strcmp(argv[i], "--net-bench") == 0)
+		{
+			net_bench = true;
+		}
+		else if (strcmp(argv[i], "--step-times") == 0)
+		{
+			step_times = true;
+		}
+		else if (strcmp(argv[i], "--left-ai") == 0 && i + 1 < argc)
+		{
+			left_ai = PongGame::findAIKind(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--right-ai") == 0 && i + 1 < argc)
+		{
+			right_ai = PongGame::findAIKind(argv[++i]);
+		}
+		else
+		{
+			usage(argv[0]);
+			return 1;
+		}
+	}
+	if (matches < 1 || batch_size < 1 || ack_delay < 1 || left_ai < 0
+		|| right_ai < 0 || ((batch || verify)
+			&& (left_ai != AI_FOLLOW || right_ai != AI_FOLLOW)))
+	{
+		usage(argv[0]);
+		return 1;
+	}
+
+	Policy check;
+	if (policy != NULL && !check.load(policy))
+	{
+		cerr << "Unable to load a policy from " << policy << endl;
+		return 1;
+	}
+	PaddleNet check_net;
+	if (net != NULL && !check_net.load(net))
+	{
+		cerr << "Unable to load a network from " << net << endl;
+		return 1;
+	}
+
+	if (replay != NULL && verify_seeks)
+	{
+		return verify_seek(replay, policy, net) == 0 ? 0 : 1;
+	}
+	if (replay != NULL)
+	{
+		return run_replay(replay, seek, policy, net);
+	}
+	if (verify)
+	{
+		return verify_batch(matches, max_ticks, seed) == 0 ? 0 : 1;
+	}
+	if (verify_skip)
+	{
+		return verify_events(matches, max_ticks, seed, left_ai, right_ai,
+			policy, net) == 0 ? 0 : 1;
+	}
+	if (verify_states)
+	{
+		return verify_state(matches, max_ticks, seed, left_ai, right_ai,
+			policy, net) == 0 ? 0 : 1;
+	}
+	if (snapshots)
+	{
+		return bench_snapshots(matches, max_ticks, seed, ack_delay) == 0
+			? 0 : 1;
+	}
+
+	if (net_bench)
+	{
+		return bench_net(matches, max_ticks, seed, net) == 0 ? 0 : 1;
+	}
+
+	if (step_times)
+	{
+		return bench_steps(matches, max_ticks, seed, left_ai, right_ai,
+			policy, net) == 0 ? 0 : 1;
+	}
+
+	PongGame game(32 * PongGame::unit, 24 * PongGame::unit);
+	game.setScoreDemo(true);
+	game.setAIKind(false, left_ai);
+	game.setAIKind(true, right_ai);
+	load_files(game, policy, net);
+	if (record != NULL && (batch || !game.startRecording(record)))
+	{
+		cerr << "Unable to record to " << record << endl;
+		return 1;
+	}
+
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	SimResults results;
+	if (batch)
+	{
+		results = run_batch(matches, max_ticks, batch_size, seed);
+	}
+	else if (events)
+	{
+		results = run_events(game, matches, max_ticks, seed);
+	}
+	else
+	{
+		results = run_scalar(game, matches, max_ticks, seed);
+	}
+	game.stopRecording();
+	double seconds = chrono::duration<double>(
+		chrono::steady_clock::now() - start).count();
+
+	report(results, seconds);
+	return 0;
+}
@@ -0,0 +1,488 @@
+/*************************************************************************//**
+ * @file
+ *
+ * @brief Headless spectator tester. Publishes a demo match to a
+ *		SpectatorChannel, or watches one, or does both at once with a crowd of
+ *		viewer processes and checks that they all see the match as played.
+ *
+ * @section compile_section Compiling and Usage
+ *
+ * @par Make:
+   @verbatim
+   > make pong-spectate
+   @endverbatim
+ *
+ * @par Usage:
+   @verbatim
+   > ./pong-spectate --publish NAME [options]
+   > ./pong-spectate --watch NAME [options]
+   > ./pong-spectate --verify [--viewers N] [--slow-every N] [options]
+   options: [--ticks N] [--tick-rate N] [--seed N] [--slots N] [--lag N]
+            [--delay MS]
+   @endverbatim
+ *
+ * --publish plays AI vs AI matches at --tick-rate steps a second (default 60)
+ * and publishes every step on the channel NAME, for --ticks steps (default
+ * 0, until interrupted). The channel holds --slots steps (default 256).
+ * "pong --watch NAME" shows it in a window.
+ *
+ * --watch reads the channel NAME and puts a game of its own into each state
+ * read, as a window would before drawing it, until the publisher stops. A
+ * viewer lets at most --lag steps pile up (default 8) before skipping to
+ * the newest, and --delay makes it take that many milliseconds over each
+ * step, to play a slow viewer.
+ *
+ * --verify publishes --ticks steps (default 600) to --viewers viewer
+ * processes (default 100) at once, every --slow-every'th of which (default
+ * 10) is slow, taking 50 milliseconds over each step. Every state a viewer
+ * reads must be one the publisher published, to the bit. Reports how many
+ * steps viewers read and skipped, fast and slow, and how long publishing a
+ * step took, which must not depend on the viewers.
+ *
+ *****************************************************************************/
+
+/*******************************************************************************
+ *                 DECLARATIONS, INCLUDES, AND NAMESPACES
+*******************************************************************************/
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <csignal>
+#include <cstring>
+#include <cstdlib>
+#include <ctime>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "PongGame.h"
+#include "SpectatorChannel.h"
+
+using namespace std;
+
+/*!
+ * @brief How a spectator test is run
+ */
+struct SpectateOptions
+{
+	long ticks;			/*!< Steps to publish, 0 for no end */
+	double tick_rate;	/*!< Steps a second */
+	uint64_t seed;		/*!< Seed of the matches */
+	long slots;			/*!< Steps the channel holds */
+	long lag;			/*!< Most steps a viewer lets pile up */
+	double delay;		/*!< Milliseconds a viewer takes over each step */
+};
+
+/*!
+ * @brief What one viewer saw, sent back to the --verify process
+ */
+struct ViewerResult
+{
+	int32_t index;		/*!< Number of the viewer */
+	int32_t slow;		/*!< Nonzero if the viewer was slow */
+	int64_t received;	/*!< Steps read */
+	int64_t skipped;	/*!< Steps skipped */
+	int64_t wrong;		/*!< Steps that weren't as published */
+};
+
+/*!
+ * @brief Set when publishing should stop
+ */
+static volatile sig_atomic_t stopping = 0;
+
+/*******************************************************************************
+ *                          FUNCTION DEFINITIONS
+*******************************************************************************/
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Prints the command line usage of the tester.
+ *
+ * @param[in]      name - Name the program was invoked with
+ *****************************************************************************/
+static void usage( const char* name )
+{
+	cerr << "Usage: " << name << " --publish NAME | --watch NAME |"
+		<< " --verify [--viewers N] [--slow-every N]" << endl
+		<< "       [--ticks N] [--tick-rate N] [--seed N] [--slots N]"
+		<< " [--lag N]" << endl
+		<< "       [--delay MS]" << endl;
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Signal handler for interrupts. Asks the publisher to stop.
+ *
+ * @param[in]      signal - The signal
+ *****************************************************************************/
+static void stop_publishing( int signal )
+{
+	stopping = 1;
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Marks a published state so a viewer can check it arrived whole: every
+ * state published is made from its step number, so the viewer can make it
+ * again and compare.
+ *
+ * @param[in]      game - The game being published
+ * @param[in]      step - Number of the step
+ * @param[out]     state - The state to publish
+ *****************************************************************************/
+static void stamp_state( PongGame& game, long step, PongState& state )
+{
+	game.saveState(state);
+	state.left_controller.steps = step;
+	state.right_controller.steps = ~(int64_t) step;
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Plays AI vs AI matches in real time and publishes every step on a
+ * channel, starting another match whenever one ends.
+ *
+ * @param[in,out]  channel - The channel, open to publish
+ * @param[in]      options - How to run
+ * @param[out]     slowest - Longest time publishing one step took, in
+ *		nanoseconds
+ *
+ * @returns Average time publishing a step took, in nanoseconds.
+ *****************************************************************************/
+static double publish_matches( SpectatorChannel& channel,
+	const SpectateOptions& options, double& slowest )
+{
+	PongGame game(32 * PongGame::unit, 24 * PongGame::unit);
+	game.setScoreDemo(true);
+	long match = 0;
+	game.setSeed(options.seed, match);
+	game.startGame(true, true);
+
+	chrono::duration<double> tick_length(1.0 / options.tick_rate);
+	chrono::steady_clock::time_point next = chrono::steady_clock::now();
+	PongState state;
+	double total = 0;
+	slowest = 0;
+
+	long step;
+	for (step = 0; !stopping && (options.ticks == 0 || step < options.ticks);
+		step++)
+	{
+		if (!game.isRunning())
+		{
+			game.setSeed(options.seed, ++match);
+			game.startGame(true, true);
+		}
+		game.step();
+
+		stamp_state(game, step, state);
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		channel.send(state);
+		double nanos = chrono::duration<double, nano>(
+			chrono::steady_clock::now() - start).count();
+		total += nanos;
+		if (nanos > slowest) slowest = nanos;
+
+		next += chrono::duration_cast<chrono::steady_clock::duration>(
+			tick_length);
+		this_thread::sleep_until(next);
+	}
+	return step > 0 ? total / step : 0;
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Watches a channel until its publisher stops: every tick, reads what has
+ * arrived, puts a game into each state read, and checks that the game then
+ * saves the very same state.
+ *
+ * @param[in,out]  channel - The channel, open to watch
+ * @param[in]      options - How to run
+ * @param[out]     result - What the viewer saw
+ *****************************************************************************/
+static void watch_channel( SpectatorChannel& channel,
+	const SpectateOptions& options, ViewerResult& result )
+{
+	PongGame game(32 * PongGame::unit, 24 * PongGame::unit);
+	PongState state, shown;
+	chrono::duration<double> tick_length(1.0 / options.tick_rate);
+	chrono::steady_clock::time_point next = chrono::steady_clock::now();
+	result.wrong = 0;
+
+	while (true)
+	{
+		bool finished = channel.isFinished();
+		while (channel.receive(state))
+		{
+			game.restoreState(state);
+			game.saveState(shown);
+			if (memcmp(&state, &shown, sizeof(state)) != 0
+				|| state.right_controller.steps
+					!= ~state.left_controller.steps)
+			{
+				result.wrong++;
+			}
+			if (options.delay > 0)
+			{
+				this_thread::sleep_for(chrono::duration<double, milli>(
+					options.delay));
+			}
+		}
+		if (finished) break;
+
+		next += chrono::duration_cast<chrono::steady_clock::duration>(
+			tick_length);
+		this_thread::sleep_until(next);
+	}
+	result.received = channel.getReceived();
+	result.skipped = channel.getSkipped();
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Publishes a channel to a crowd of viewer processes, some of them slow,
+ * and checks that every viewer saw only whole, published states, and that
+ * publishing never waited on any of them.
+ *
+ * @param[in]      options - How to run
+ * @param[in]      viewers - Number of viewer processes
+ * @param[in]      slow_every - Every this many'th viewer is slow
+ *
+ * @returns True if every viewer saw the match as published.
+ *****************************************************************************/
+static bool verify_viewers( const SpectateOptions& options, int viewers,
+	int slow_every )
+{
+	string name = "verify-" + to_string((long) getpid());
+	SpectatorChannel channel;
+	if (!channel.publish(name.c_str(), options.slots))
+	{
+		cerr << "Unable to open channel " << name << endl;
+		return false;
+	}
+
+	int results[2];
+	if (pipe(results) != 0) return false;
+
+	vector<pid_t> children;
+	for (int v = 0; v < viewers; v++)
+	{
+		pid_t child = fork();
+		if (child == 0)
+		{
+			::close(results[0]);
+			SpectateOptions mine = options;
+			ViewerResult result;
+			memset(&result, 0, sizeof(result));
+			result.index = v;
+			result.slow = slow_every > 0 && v % slow_every == slow_every - 1;
+			if (result.slow) mine.delay = 50;
+
+			SpectatorChannel view;
+			if (view.watch(name.c_str(), mine.lag))
+			{
+				watch_channel(view, mine, result);
+			}
+			else
+			{
+				result.wrong = -1;
+			}
+			if (write(results[1], &result, sizeof(result)) < 0) _exit(1);
+			_exit(0);
+		}
+		if (child > 0) children.push_back(child);
+	}
+	::close(results[1]);
+
+	double slowest;
+	double average = publish_matches(channel, options, slowest);
+	long published = channel.getPublished();
+	channel.close();
+
+	// Gather what every viewer saw
+	long fast = 0, slow = 0, failed = 0;
+	long long fast_received = 0, fast_skipped = 0;
+	long long slow_received = 0, slow_skipped = 0;
+	ViewerResult result;
+	while (read(results[0], &result, sizeof(result)) == sizeof(result))
+	{
+		if (result.wrong != 0)
+		{
+			cerr << "viewer " << result.index << ": " << result.wrong
+				<< " steps not as published" << endl;
+			failed++;
+		}
+		if (result.slow)
+		{
+			slow++;
+			slow_received += result.received;
+			slow_skipped += result.skipped;
+		}
+		else
+		{
+			fast++;
+			fast_received += result.received;
+			fast_skipped += result.skipped;
+		}
+	}
+	::close(results[0]);
+	for (size_t i = 0; i < children.size(); i++)
+	{
+		waitpid(children[i], NULL, 0);
+	}
+	failed += viewers - (fast + slow);
+
+	cout << "published:    " << published << " steps" << endl;
+	cout << "viewers:      " << fast + slow << " of " << viewers
+		<< " reported, " << failed << " failed" << endl;
+	if (fast > 0)
+	{
+		cout << "fast viewers: " << fast << ", read " << fast_received / fast
+			<< " and skipped " << fast_skipped / fast << " steps each"
+			<< endl;
+	}
+	if (slow > 0)
+	{
+		cout << "slow viewers: " << slow << ", read " << slow_received / slow
+			<< " and skipped " << slow_skipped / slow << " steps each"
+			<< endl;
+	}
+	cout << "publish ns:   " << average << " average, " << slowest
+		<< " slowest" << endl;
+	return failed == 0;
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Reads the command line and publishes, watches, or verifies.
+ *
+ * @param[in]      argc - Number of aurments from the command line
+ * @param[out]     argv - An array of command line aurgments
+ *
+ * @returns 0 if everything went as it should, 1 if not or on bad arguments.
+ *****************************************************************************/
+int main( int argc, char *argv[] )
+{
+	const char* publish = NULL;
+	const char* watch = NULL;
+	bool verify = false;
+	int viewers = 100;
+	int slow_every = 10;
+	SpectateOptions options;
+	options.ticks = -1;
+	options.tick_rate = 60;
+	options.seed = (uint64_t) time(NULL);
+	options.slots = 256;
+	options.lag = 8;
+	options.delay = 0;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--publish") == 0 && i + 1 < argc)
+		{
+			publish = argv[++i];
+		}
+		else if (strcmp(argv[i], "--watch") == 0 && i + 1 < argc)
+		{
+			watch = argv[++i];
+		}
+		else if (strcmp(argv[i], "--verify") == 0)
+		{
+			verify = true;
+		}
+		else if (strcmp(argv[i], "--viewers") == 0 && i + 1 < argc)
+		{
+			viewers = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--slow-every") == 0 && i + 1 < argc)
+		{
+			slow_every = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--ticks") == 0 && i + 1 < argc)
+		{
+			options.ticks = atol(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--tick-rate") == 0 && i + 1 < argc)
+		{
+			options.tick_rate = atof(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+		{
+			options.seed = (uint64_t) strtoull(argv[++i], NULL, 10);
+		}
+		else if (strcmp(argv[i], "--slots") == 0 && i + 1 < argc)
+		{
+			options.slots = atol(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--lag") == 0 && i + 1 < argc)
+		{
+			options.lag = atol(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--delay") == 0 && i + 1 < argc)
+		{
+			options.delay = atof(argv[++i]);
+		}
+		else
+		{
+			usage(argv[0]);
+			return 1;
+		}
+	}
+	if ((publish != NULL) + (watch != NULL) + verify != 1
+		|| options.tick_rate <= 0 || options.slots < 2 || viewers < 0)
+	{
+		usage(argv[0]);
+		return 1;
+	}
+	if (options.ticks < 0) options.ticks = verify ? 600 : 0;
+
+	if (verify)
+	{
+		return verify_viewers(options, viewers, slow_every) ? 0 : 1;
+	}
+
+	SpectatorChannel channel;
+	if (publish != NULL)
+	{
+		if (!channel.publish(publish, options.slots))
+		{
+			cerr << "Unable to open channel " << publish << endl;
+			return 1;
+		}
+		signal(SIGINT, stop_publishing);
+		signal(SIGTERM, stop_publishing);
+
+		double slowest;
+		double average = publish_matches(channel, options, slowest);
+		cout << "published:    " << channel.getPublished() << " steps"
+			<< endl;
+		cout << "publish ns:   " << average << " average, " << slowest
+			<< " slowest" << endl;
+		return 0;
+	}
+
+	if (!channel.watch(watch, options.lag))
+	{
+		cerr << "Unable to watch channel " << watch << endl;
+		return 1;
+	}
+	ViewerResult result;
+	watch_channel(channel, options, result);
+	cout << "received:     " << result.received << " steps" << endl;
+	cout << "skipped:      " << result.skipped << " steps" << endl;
+	cout << "not as sent:  " << result.wrong << " steps" << endl;
+	return result.wrong == 0 ? 0 : 1;
+}
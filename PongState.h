@@ -0,0 +1,106 @@
+/***************************************************************************//**
+ * @file File containing the declarations of the game state structures.
+ *
+ * @brief Contains plain structures holding the state of a game and each of
+ *		its parts, as saved and restored by PongGame::saveState() and
+ *		PongGame::restoreState().
+*******************************************************************************/
+#ifndef _PONGSTATE_H_
+#define _PONGSTATE_H_
+
+/*******************************************************************************
+ *                 DECLARATIONS, INCLUDES, AND NAMESPACES
+*******************************************************************************/
+#include <stdint.h>
+#include <type_traits>
+
+/*!
+ * @brief Everything about a ball that changes during a game
+ */
+struct BallState
+{
+	double center_x;	/*!< x coordinate of the center of the ball */
+	double center_y;	/*!< y coordinate of the center of the ball */
+	double prev_x;		/*!< center_x as of the previous step */
+	double prev_y;		/*!< center_y as of the previous step */
+	double x_velocity;	/*!< x speed of the ball */
+	double y_velocity;	/*!< y speed of the ball */
+	double s_velocity;	/*!< Velocity scalar for varying speeds */
+	double path_x;		/*!< x coordinate the ball's path starts at */
+	double path_y;		/*!< y coordinate the ball's path starts at */
+	double path_t;		/*!< step count the ball's path starts at */
+	int64_t clock;		/*!< Number of steps taken */
+};
+
+/*!
+ * @brief Everything about a paddle that changes during a game
+ */
+struct PaddleState
+{
+	double center_x;			/*!< x coordinate of the center of the paddle */
+	double center_y;			/*!< y coordinate of the center of the paddle */
+	double prev_x;				/*!< center_x as of the previous step */
+	double prev_y;				/*!< center_y as of the previous step */
+	double vertical_speed;		/*!< speed the paddle moves up or down */
+	double horizontal_speed;	/*!< speed the paddle moves left or right */
+	int32_t height;				/*!< height of the paddle */
+	uint8_t up;					/*!< nonzero if moving up */
+	uint8_t down;				/*!< nonzero if moving down */
+	uint8_t left;				/*!< nonzero if moving left */
+	uint8_t right;				/*!< nonzero if moving right */
+};
+
+/*!
+ * @brief Everything a paddle controller remembers from step to step. The AI
+ *		controllers keep their chase here; for players it is left zeroed.
+ */
+struct ControllerState
+{
+	double offset;			/*!< Offset to align the ball with */
+	double chase_y;			/*!< Where the last run at full speed started */
+	double chase_speed;		/*!< Speed of the last run at full speed */
+	double chase_to;		/*!< Where the last run at full speed went */
+	int64_t steps;			/*!< Number of steps taken */
+	int64_t chase_step;		/*!< Step the last run at full speed started on */
+	int32_t chase;			/*!< Direction of the last run at full speed */
+};
+
+/*!
+ * @brief Everything about a game that changes while it is played. Holds no
+ *		pointers, so it can be copied with memcpy() and written to a file.
+ */
+struct PongState
+{
+	uint64_t random_state;		/*!< State of the game's random numbers */
+	uint64_t random_increment;	/*!< Stream of the game's random numbers */
+	int64_t match_tick;			/*!< Steps taken in the game */
+	double ball_speed;			/*!< x speed balls are served at */
+	double base_speed;			/*!< Difficulty: AI top speed, score level */
+	double speed_per_point;		/*!< Difficulty: top speed per point behind */
+	double offset_spread;		/*!< Difficulty: units between aiming spots */
+	int32_t offset_count;		/*!< Difficulty: spots an AI aims with */
+	int32_t left_score;			/*!< Points made by the left side */
+	int32_t right_score;		/*!< Points made by the right side */
+	int32_t ball_timer;			/*!< Timer before the ball is served */
+	int32_t hit_count;			/*!< Paddle hits since the last point */
+	int32_t left_paddle_size;	/*!< Height of the left paddle in units */
+	int32_t right_paddle_size;	/*!< Height of the right paddle in units */
+	uint8_t game_active;		/*!< nonzero if a game is being played */
+	uint8_t left_ai;			/*!< nonzero if the AI has the left paddle */
+	uint8_t right_ai;			/*!< nonzero if the AI has the right paddle */
+	uint8_t score_demo;			/*!< nonzero if AI vs AI games keep score */
+	uint8_t left_ai_kind;		/*!< AIKind of the left AI */
+	uint8_t right_ai_kind;		/*!< AIKind of the right AI */
+	BallState ball;					/*!< The ball, if a game is going */
+	PaddleState left_paddle;		/*!< The left paddle */
+	PaddleState right_paddle;		/*!< The right paddle */
+	ControllerState left_controller;	/*!< Controller of the left paddle */
+	ControllerState right_controller;	/*!< Controller of the right paddle */
+};
+
+static_assert(std::is_trivially_copyable<PongState>::value,
+	"PongState must be copyable with memcpy()");
+static_assert(std::is_standard_layout<PongState>::value,
+	"PongState must be laid out the same by every compiler");
+
+#endif
@@ -7,7 +7,9 @@
 /*******************************************************************************
  *                 DECLARATIONS, INCLUDES, AND NAMESPACES
 *******************************************************************************/
+#include <cctype>
 #include "PongText.h"
+#include "PongFont.h"
 
 /*******************************************************************************
  *                          FUNCTION DEFINITIONS
@@ -18,7 +20,7 @@
  * @par Description: The constructor. Initializes variables and classes.
 *******************************************************************************/
 PongText::PongText(double x, double y, double size, string text, int align) :
-		x(x), y(y), size(size), text(text), align(align)
+		text(text), align(align), x(x), y(y), size(size), dirty(true)
 {
 	if (align < -1) this -> align = -1;
 	if (align > 1) this -> align = 1;
@@ -43,6 +45,7 @@ PongText::~PongText()
 void PongText::setText(string text)
 {
 	this -> text = text;
+	dirty = true;
 	calc_size();
 }
 
@@ -58,6 +61,7 @@ void PongText::setPosition(double x, double y)
 {
 	this -> x = x;
 	this -> y = y;
+	dirty = true;
 }
 
 /***************************************************************************//**
@@ -70,6 +74,7 @@ void PongText::setPosition(double x, double y)
 void PongText::setSize(double size)
 {
 	this -> size = size;
+	dirty = true;
 }
 
 /***************************************************************************//**
@@ -83,6 +88,7 @@ void PongText::setSize(double size)
 void PongText::setAlignment(int align)
 {
 	this -> align = ( align < 0 ? -1 : align > 0 ? 1 : 0 );
+	dirty = true;
 }
 
 /***************************************************************************//**
@@ -112,15 +118,19 @@ double PongText::getHeight()
 /***************************************************************************//**
  * @author Daniel Andrus
  * 
- * @par Description: Draws the text
+ * @par Description: Works out where every rectangle of every letter goes,
+ *		so that drawing the text only has to hand them to the renderer. Only
+ *		done when the text, its position, its size, or its alignment has
+ *		changed since the last time.
 *******************************************************************************/
-void PongText::draw()
+void PongText::layout()
 {
 	double x;
 	double y = this -> y;
 	int x_off = 0;
 	int y_off = 0;
 
+	rects.clear();
 	for (unsigned int i = 0; i < text.size(); i++)
 	{
 		// If new line, calculate line starting point
@@ -162,92 +172,24 @@ void PongText::draw()
 		}
 		else
 		{
-			draw_char(text[i], x + x_off * size / 8.0, y + y_off * size * 10.0 / 8.0, size);
+			place_char(text[i], x + x_off * size / 8.0, y + y_off * size * 10.0 / 8.0, size, rects);
 			x_off += char_width(text[i]) + 1;
 		}
 	}
+	dirty = false;
 }
 
 /***************************************************************************//**
  * @author Daniel Andrus
  * 
- * @par Description: Gets the width of a single character
+ * @par Description: Gets the width of a single character, from the font
+ *		table
  *
  * @returns The width in units of the individual character
 *******************************************************************************/
 int PongText::char_width(char c)
 {
-	switch (toupper(c))
-	{
-		default:
-			return 0;
-
-		case '1':
-		case ' ':
-		case '.':
-		case ',':
-		case '!':
-		case ':':
-		case ';':
-		case '|':
-		case '\'':
-			return 1;
-
-		case '?':
-		case '(':
-		case ')':
-		case '[':
-		case ']':
-			return 2;
-
-		case 'I':
-		case '"':
-		case '-':
-		case '+':
-		case '=':
-			return 3;
-
-		case '0':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9':
-		case 'A':
-		case 'B':
-		case 'C':
-		case 'D':
-		case 'E':
-		case 'F':
-		case 'G':
-		case 'H':
-		case 'J':
-		case 'K':
-		case 'L':
-		case 'O':
-		case 'P':
-		case 'Q':
-		case 'R':
-		case 'S':
-		case 'U':
-		case 'V':
-		case 'X':
-		case 'Y':
-		case 'Z':
-		case '_':
-		case '/':
-		case '\\':
-			return 4;
-			
-		case 'M':
-		case 'N':
-		case 'T':
-		case 'W':
-			return 5;
-	}
+	return font_table[(unsigned char) c].width;
 }
 
 /***************************************************************************//**
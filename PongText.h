@@ -14,7 +14,9 @@ class PongText;
  *                 DECLARATIONS, INCLUDES, AND NAMESPACES
 *******************************************************************************/
 #include <string>
+#include <vector>
 #include "Drawable.h"
+#include "Renderer.h"
 
 using namespace std;
 
@@ -34,6 +36,10 @@ class PongText : public Drawable
 		double size;	/*!< size of text */
 		int width;		/*!< width of text */
 		int height;		/*!< height of text */
+		vector<RenderRect> rects;	/*!< Rectangles of every letter, as last
+										laid out */
+		bool dirty;		/*!< True if the text has changed since it was
+							last laid out */
 
 		/*!
 		 * @brief Gets the width of a specific character in 8ths of size. Used
@@ -48,9 +54,15 @@ class PongText : public Drawable
 		static int char_height(char c);
 
 		/*!
-		 * @brief Draws given char with width and height calculations
+		 * @brief Adds the rectangles of a given char to a list
 		 */
-		static void draw_char(char c, double x, double y, double size);
+		static void place_char(char c, double x, double y, double size,
+			vector<RenderRect>& rects);
+
+		/*!
+		 * @brief Works out where every rectangle of the text goes
+		 */
+		void layout();
 
 		/*!
 		 * @brief calculates the overal size of the text area
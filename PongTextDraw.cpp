@@ -8,381 +8,47 @@
  *                 DECLARATIONS, INCLUDES, AND NAMESPACES
 *******************************************************************************/
 #include "PongText.h"
+#include "PongFont.h"
+#include "Pong.h"
 
 /**************************************************************************//**
  * @author Daniel Andrus
  * 
  * @par Description: 
- * draws a single charactor in a blocky formate
+ * adds the rectangles of a single charactor in a blocky formate to a list,
+ * one at a time from the character's entry in the font table
  * 
  * 
- * @param[in]      char c - the charactor being drawn
+ * @param[in]      char c - the charactor being placed
  * @param[in]      double x - x coordinant of charactor
  * @param[in]      double y - y coordinant of charactor
  * @param[in]      double size - size of charactor
+ * @param[in,out]  vector<RenderRect>& rects - list to add the rectangles to
  *****************************************************************************/
-void PongText::draw_char(char c, double x, double y, double size)
+void PongText::place_char(char c, double x, double y, double size,
+	vector<RenderRect>& rects)
 {
 	const double u = size / 8;	// Unitary size
-	const double s = size;		// Sugar :P
+	const FontGlyph& glyph = font_table[(unsigned char) c];
+	const FontRect* rect = font_rects + glyph.first;
 
-	/* Note on drawing order for debugging purposes:
-	 * Vertical lines first from left to right then top to bottom
-	 * Horizontal lines next from top to bottom then left to right
-	 * Single point drawing order varies between characters
-	*/
-
-	switch (toupper(c))
+	for (int i = 0; i < glyph.count; i++, rect++)
 	{
-		default:
-			break;
-
-		case '0':
-		case 'O':
-			glRectd( x, y, x + u, y - s );
-			glRectd( x + u * 3, y, x + u * 4, y - s );
-			glRectd( x + u, y, x + u * 3, y - u );
-			glRectd( x + u, y - s + u, x + u * 3, y - s );
-			break;
-
-		case '1':
-			glRectd( x, y, x + u, y - s );
-			break;
-
-		case '2':
-			glRectd( x, y - u * 3, x + u, y - s );
-			glRectd( x + u * 3, y, x + u * 4, y - u * 4 );
-			glRectd( x, y, x + u * 3, y - u );
-			glRectd( x + u, y - u * 3, x + u * 3, y - u * 4 );
-			glRectd( x + u, y - s + u, x + u * 4, y - s );
-			break;
-
-		case '3':
-			glRectd( x + u * 3, y, x + u * 4, y - s );
-			glRectd( x, y, x + u * 3, y - u );
-			glRectd( x, y - u * 3, x + u * 3, y - u * 4 );
-			glRectd( x, y - s + u, x + u * 3, y - s );
-			break;
-
-		case '4':
-			glRectd( x, y, x + u, y - u * 4 );
-			glRectd( x + u * 3, y, x + u * 4, y - s );
-			glRectd( x + u, y - u * 3, x + u * 3, y - u * 4 );
-			break;
-
-		case '5':
-			glRectd( x, y, x + u, y - u * 4 );
-			glRectd( x + u * 3, y - u * 3, x + u * 4, y - s );
-			glRectd( x + u, y, x + u * 4, y - u );
-			glRectd( x + u, y - u * 3, x + u * 3, y - u * 4 );
-			glRectd( x, y - s + u, x + u * 3, y - s );
-			break;
-
-		case '6':
-			glRectd( x, y, x + u, y - s );
-			glRectd( x + u * 3, y - u * 3, x + u * 4, y - s );
-			glRectd( x + u, y, x + u * 4, y - u );
-			glRectd( x + u, y - u * 3, x + u * 3, y - u * 4 );
-			glRectd( x + u, y - s + u, x + u * 3, y - s );
-			break;
-
-		case '7':
-			glRectd( x, y, x + u * 4, y - u );
-			glRectd( x + u * 3, y - u, x + u * 4, y - s );
-			break;
-
-		case '8':
-			glRectd( x, y, x + u, y - s );
-			glRectd( x + u * 3, y, x + u * 4, y - s );
-			glRectd( x + u, y, x + u * 3, y - u );
-			glRectd( x + u, y - u * 3, x + u * 3, y - u * 4 );
-			glRectd( x + u, y - s + u, x + u * 3, y - s );
-			break;
-
-		case '9':
-			glRectd( x, y, x + u, y - u* 4 );
-			glRectd( x + u * 3, y, x + u * 4, y - s );
-			glRectd( x + u, y, x + u * 3, y - u );
-			glRectd( x + u, y - u * 3, x + u * 3, y - u * 4 );
-			break;
-
-		case 'A':
-			glRectd( x, y, x + u, y - s );
-			glRectd( x + u * 3, y, x + u * 4, y - s );
-			glRectd( x + u, y, x + u * 3, y - u );
-			glRectd( x + u, y - u * 3, x + u * 3, y - u * 4 );
-			break;
-
-		case 'B':
-			glRectd( x, y, x + u, y - s );
-			glRectd( x + u * 3, y, x + u * 4, y - u * 3 );
-			glRectd( x + u * 3, y - u * 4, x + u * 4, y - s );
-			glRectd( x + u, y, x + u * 3, y - u );
-			glRectd( x + u, y - u * 3, x + u * 3, y - u * 4 );
-			glRectd( x + u, y - s + u, x + u * 3, y - s );
-			break;
-
-		case 'C':
-			glRectd( x, y, x + u, y - s );
-			glRectd( x + u, y, x + u * 4, y - u );
-			glRectd( x + u, y - s + u, x + u * 4, y - s );
-			break;
-
-		case 'D':
-			glRectd( x, y, x + u, y - s );
-			glRectd( x + u * 3, y - u, x + u * 4, y - s + u );
-			glRectd( x + u, y, x + u * 3, y - u );
-			glRectd( x + u, y - s + u, x + u * 3, y - s );
-			break;
-
-		case 'E':
-			glRectd( x, y, x + u, y - s );
-			glRectd( x + u, y, x + u * 4, y - u );
-			glRectd( x + u, y - u * 3, x + u * 4, y - u * 4 );
-			glRectd( x + u, y - s + u, x + u * 4, y - s );
-			break;
-
-		case 'F':
-			glRectd( x, y, x + u, y - s );
-			glRectd( x + u, y, x + u * 4, y - u );
-			glRectd( x + u, y - u * 3, x + u * 4, y - u * 4 );
-			break;
-
-		case 'G':
-			glRectd( x, y, x + u, y - s );
-			glRectd( x + u * 3, y - u * 3, x + u * 4, y - s );
-			glRectd( x + u, y, x + u * 4, y - u );
-			glRectd( x + u * 2, y - u * 3, x + u * 3, y - u * 4 );
-			glRectd( x + u, y - s + u, x + u * 3, y - s );
-			break;
-
-		case 'H':
-			glRectd( x, y, x + u, y - s );
-			glRectd( x + u * 3, y, x + u * 4, y - s );
-			glRectd( x + u, y - u * 3, x + u * 3, y - u * 4 );
-			break;
-
-		case 'I':
-			glRectd( x + u, y - u, x + u * 2, y - s + u );
-			glRectd( x, y, x + u * 3, y - u );
-			glRectd( x, y - s + u, x + u * 3, y - s );
-			break;
-
-		case 'J':
-			glRectd( x, y - s + u * 2, x + u, y - s + u );
-			glRectd( x + u * 2, y - u, x + u * 3, y - s + u );
-			glRectd( x + u, y, x + u * 4, y - u );
-			glRectd( x, y - s + u, x + u * 3, y - s );
-			break;
-
-		case 'K':
-			glRectd( x, y, x + u, y - s );
-			glRectd( x + u * 3, y, x + u * 4, y - u * 3 );
-			glRectd( x + u * 3, y - u * 4, x + u * 4, y - s );
-			glRectd(x + u, y - u * 3, x + u * 3, y - u * 4 );
-			break;
-
-		case 'L':
-			glRectd( x, y, x + u, y - s );
-			glRectd( x + u, y - s + u, x + u * 4, y - s );
-			break;
-
-		case 'M':
-			glRectd( x, y, x + u, y - s );
-			glRectd( x + u * 4, y, x + u * 5, y - s );
-			glRectd( x + u, y - u, x + u * 2, y - u * 2 );
-			glRectd( x + u * 2, y - u * 2, x + u * 3, y - u * 3 );
-			glRectd( x + u * 3, y - u, x + u * 4, y - u * 2 );
-			break;
-
-		case 'N':
-			glRectd( x, y, x + u, y - s );
-			glRectd( x + u * 4, y, x + u * 5, y - s );
-			glRectd( x + u, y - u, x + u * 2, y - u * 3 );
-			glRectd( x + u * 2, y - u * 3, x + u * 3, y - s + u * 3 );
-			glRectd( x + u * 3, y - s + u * 3, x + u * 4, y - s + u );
-			break;
-
-		case 'P':
-			glRectd( x, y, x + u, y - s );
-			glRectd( x + u * 3, y, x + u * 4, y - u * 4 );
-			glRectd( x + u, y, x + u * 3, y - u );
-			glRectd( x + u, y - u * 3, x + u * 3, y - u * 4 );
-			break;
-
-		case 'Q':
-			glRectd( x, y, x + u, y - s );
-			glRectd( x + u * 3, y, x + u * 4, y - s );
-			glRectd( x + u, y, x + u * 3, y - u );
-			glRectd( x + u, y - s + u, x + u * 3, y - s );
-			glRectd( x + u * 2, y - s + u * 2, x + u * 3, y - s + u );
-			break;
-
-		case 'R':
-			glRectd( x, y, x + u, y - s );
-			glRectd( x + u * 3, y, x + u * 4, y - u * 3 );
-			glRectd( x + u * 3, y - u * 4, x + u * 4, y - s );
-			glRectd( x + u, y, x + u * 3, y - u );
-			glRectd( x + u, y - u * 3, x + u * 3, y - u * 4 );
-			break;
-
-		case 'S':
-			glRectd( x, y, x + u * 4, y - u );
-			glRectd( x, y - u, x + u, y - u * 3 );
-			glRectd( x, y - u * 3, x + u * 4, y - u * 4 );
-			glRectd( x + u * 3, y - u * 4, x + u * 4, y - s + u );
-			glRectd( x, y - s + u, x + u * 4, y - s );
-			break;
-
-		case 'T':
-			glRectd( x + u * 2, y - u, x + u * 3, y - s );
-			glRectd( x, y, x + u * 5, y - u );
-			break;
-
-		case 'U':
-			glRectd( x, y, x + u, y - s );
-			glRectd( x + u * 3, y, x + u * 4, y - s );
-			glRectd( x + u, y - s + u, x + u * 3, y - s );
-			break;
-			
-		case 'V':
-			glRectd( x, y, x + u, y - s + u * 2 );
-			glRectd( x + u * 3, y, x + u * 4, y - s + u );
-			glRectd( x + u, y - s + u * 2, x + u * 2, y - s + u );
-			glRectd( x + u * 2, y - s + u, x + u * 3, y - s );
-			break;
-
-		case 'W':
-			glRectd( x, y, x + u, y - s );
-			glRectd( x + u * 2, y - u * 3, x + u * 3, y - s + u );
-			glRectd( x + u * 4, y, x + u * 5, y - s );
-			glRectd( x + u, y - s + u, x + u * 4, y - s );
-			break;
-
-		case 'X':
-			glRectd( x, y, x + u, y - u * 4 );
-			glRectd( x, y - u * 5, x + u, y - s );
-			glRectd( x + u * 3, y, x + u * 4, y - u * 3 );
-			glRectd( x + u * 3, y - u * 4, x + u * 4, y - s );
-			glRectd( x + u, y - u * 4, x + u * 2, y - u * 5 );
-			glRectd( x + u * 2, y - u * 3, x + u * 3, y - u * 4 );
-			break;
-
-		case 'Y':
-			glRectd( x, y, x + u, y - u * 4 );
-			glRectd( x + u * 3, y, x + u * 4, y - s );
-			glRectd( x + u, y - u * 3, x + u * 3, y - u * 4 );
-			glRectd( x, y - s + u, x + u * 3, y - s );
-			break;
-
-		case 'Z':
-			glRectd( x, y - s + u * 2, x + u, y - s + u );
-			glRectd( x + u, y - s / 2, x + u * 2, y - s + u * 2 );
-			glRectd( x + u * 2, y - u * 2, x + u * 3, y - s / 2 );
-			glRectd( x + u * 3, y - u, x + u * 4, y - u * 2 );
-			glRectd( x, y, x + u * 4, y - u );
-			glRectd( x, y - s + u, x + u * 4, y - s );
-			break;
-
-		case '.':
-			glRectd( x, y - s + u, x + u, y - s );
-			break;
-
-		case ',':
-			glRectd( x, y - s + u, x + u, y - s - u );
-			break;
-
-		case '!':
-			glRectd( x, y, x + u, y - s + u * 2 );
-			glRectd( x, y - s + u, x + u, y - s );
-			break;
-
-		case ':':
-			glRectd( x, y - u * 2, x + u, y - u * 3 );
-			glRectd( x, y - s + u, x + u, y - s );
-			break;
-
-		case ';':
-			glRectd( x, y - u * 2, x + u, y - u * 3 );
-			glRectd( x, y - s + u, x + u, y - s - u );
-			break;
-
-		case '|':
-			glRectd( x, y + u, x + u, y - s - u );
-			break;
-
-		case '\'':
-			glRectd( x, y, x + u, y - u * 2 );
-			break;
-
-		case '?':
-			glRectd( x, y, x + u, y - u );
-			glRectd( x, y - u * 3, x + u, y - s + u * 2 );
-			glRectd( x, y - s + u, x + u, y - s );
-			glRectd( x + u, y, x + u * 2, y - u * 4 );
-			break;
-
-		case '(':
-			glRectd( x, y - u, x + u, y - s + u );
-			glRectd( x + u, y, x + u * 2, y - u );
-			glRectd( x + u, y - s + u, x + u * 2, y - s );
-			break;
-			
-		case ')':
-			glRectd( x, y, x + u, y - u );
-			glRectd( x, y - s + u, x + u, y - s );
-			glRectd( x + u, y - u, x + u * 2, y - s + u );
-			break;
-
-		case '[':
-			glRectd( x, y, x + u, y - s );
-			glRectd( x + u, y, x + u * 2, y - u );
-			glRectd( x + u, y - s + u, x + u * 2, y - s );
-			break;
-
-		case ']':
-			glRectd( x, y, x + u, y - u );
-			glRectd( x, y - s + u, x + u, y - s );
-			glRectd( x + u, y, x + u * 2, y - s );
-			break;
-
-		case '"':
-			glRectd( x, y, x + u, y - u * 2 );
-			glRectd( x + u * 2, y, x + u * 3, y - u * 2 );
-			break;
-
-		case '-':
-			glRectd( x, y - u * 4, x + u * 3, y - u * 5 );
-			break;
-
-		case '+':
-			glRectd( x + u, y - u * 3, x + u * 2, y - u * 4);
-			glRectd( x + u, y - u * 5, x + u * 2, y - u * 6);
-			glRectd( x, y - u * 4, x + u * 3, y - u * 5 );
-			break;
-
-		case '=':
-			glRectd( x, y - u * 3, x + u * 3, y - u * 4 );
-			glRectd( x, y - u * 5, x + u * 3, y - u * 6 );
-			break;
-
-		case '_':
-			glRectd( x, y - s + u, x + u * 4, y - s );
-			break;
-
-		case '/':
-			glRectd( x, y - s + u * 2, x + u, y - s );
-			glRectd( x + u, y - s / 2, x + u * 2, y - s + u * 2 );
-			glRectd( x + u * 2, y - u * 2, x + u  * 3, y - s / 2 );
-			glRectd( x + u * 3, y, x + u * 4, y - u * 2 );
-			break;
-
-		case '\\':
-			glRectd( x, y, x + u, y - u * 2 );
-			glRectd( x + u, y - u * 2, x + u  * 2, y - s / 2 );
-			glRectd( x + u * 2, y - s / 2, x + u * 3, y - s + u * 2 );
-			glRectd( x + u * 3, y - s + u * 2, x + u * 4, y - s );
-			break;
-
+		RenderRect r = { x + u * rect->x1, y - u * rect->y1,
+			x + u * rect->x2, y - u * rect->y2 };
+		rects.push_back(r);
 	}
 }
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ * 
+ * @par Description: Draws the text, laying it out first if it has changed.
+ *		Text that stays the same, such as the labels of an open menu, is
+ *		handed to the renderer as it was laid out last time.
+*******************************************************************************/
+void PongText::draw()
+{
+	if (dirty) layout();
+	Pong::getInstance()->getRenderer()->rects(rects);
+}
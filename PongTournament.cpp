@@ -0,0 +1,409 @@
+/*************************************************************************//**
+ * @file
+ *
+ * @brief AI vs AI tournament runner. Plays a large number of matches of Pong
+ *		across every processor core without opening a window.
+ *
+ * @section compile_section Compiling and Usage
+ *
+ * @par Make:
+   @verbatim
+   > make pong-tournament
+   @endverbatim
+ *
+ * @par Usage:
+   @verbatim
+   > ./pong-tournament [--matches N] [--threads N] [--chunk N] [--seed N]
+                       [--left-ai KIND] [--right-ai KIND] [--policy FILE]
+                       [--net FILE] [--difficulty FILE]
+   @endverbatim
+ *
+ * Every thread has its own PongGame and tally. The matches to be played are
+ * split evenly between the threads up front; a thread that runs out of matches
+ * steals half of the remaining matches of another thread. Taking and stealing
+ * matches is done with compare-and-swap, so no thread ever waits on a lock.
+ *
+ * Match m of the tournament plays stream m of --seed (see PongRandom), so the
+ * results depend only on the seed and not on which thread played what.
+ *
+ * --left-ai and --right-ai pick the AI that plays each side, "follow" (the
+ * default, see AIController), "predict" (see PredictiveController) or
+ * "lookahead" (see LookaheadController), to pit one against the other.
+ * "lookahead" plays moves out on a copy of the game every step the ball
+ * comes its way, so matches with it run a few thousand times slower.
+ * "policy" (see PolicyController) plays the policy --policy loads from a
+ * file written by pong-train, and "neural" (see NeuralController) the
+ * network --net loads from one. Every thread maps the same copy of the
+ * network. --difficulty plays the AIs with a difficulty pong-tune wrote
+ * rather than the standard one.
+ *
+ *****************************************************************************/
+
+/*******************************************************************************
+ *                 DECLARATIONS, INCLUDES, AND NAMESPACES
+*******************************************************************************/
+#include <iostream>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <cstring>
+#include <cstdlib>
+#include <ctime>
+#include <stdint.h>
+#include "AlignedAllocator.h"
+#include "PongGame.h"
+
+using namespace std;
+
+/*!
+ * @brief The matches a thread has left to play and its tally so far. Aligned
+ *		to a cache line so that threads don't slow each other down by writing
+ *		next to each other; kept in a Workers so that holds on the heap too.
+ */
+struct alignas(64) Worker
+{
+	atomic<uint64_t> range;	/*!< Matches left to play, first in the low 32
+								bits and one past the last in the high 32 */
+	long matches;			/*!< Matches played */
+	long left_wins;			/*!< Matches won by the left side */
+	long right_wins;		/*!< Matches won by the right side */
+	long stolen;			/*!< Times this thread stole matches */
+	long long ticks;		/*!< Steps taken by all matches played */
+};
+
+/*!
+ * @brief Every thread of a tournament, each on its own cache line
+ */
+typedef vector<Worker, AlignedAllocator<Worker> > Workers;
+
+/*******************************************************************************
+ *                          FUNCTION DEFINITIONS
+*******************************************************************************/
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Packs a range of matches into the form kept in Worker::range.
+ *
+ * @param[in]      first - First match of the range
+ * @param[in]      last - One past the last match of the range
+ *
+ * @returns The packed range.
+ *****************************************************************************/
+static inline uint64_t pack_range( uint32_t first, uint32_t last )
+{
+	return ((uint64_t) last << 32) | first;
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Takes up to chunk matches off the front of a thread's own range.
+ *
+ * @param[in,out]  worker - Thread taking the matches
+ * @param[in]      chunk - Most matches to take
+ * @param[out]     first - First match taken
+ * @param[out]     last - One past the last match taken
+ *
+ * @returns true if any matches were taken, false if the range was empty.
+ *****************************************************************************/
+static bool take( Worker& worker, uint32_t chunk, uint32_t& first,
+	uint32_t& last )
+{
+	uint64_t range = worker.range.load(memory_order_acquire);
+	while (true)
+	{
+		first = (uint32_t) range;
+		uint32_t end = (uint32_t) (range >> 32);
+		if (first >= end)
+		{
+			return false;
+		}
+
+		last = (end - first > chunk) ? first + chunk : end;
+		if (worker.range.compare_exchange_weak(range, pack_range(last, end),
+			memory_order_acq_rel))
+		{
+			return true;
+		}
+	}
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Steals the back half of the matches another thread has left and makes them
+ * the thief's own range.
+ *
+ * @param[in,out]  thief - Thread doing the stealing. Its range must be empty.
+ * @param[in,out]  victim - Thread being stolen from
+ *
+ * @returns true if any matches were stolen.
+ *****************************************************************************/
+static bool steal( Worker& thief, Worker& victim )
+{
+	uint64_t range = victim.range.load(memory_order_acquire);
+	while (true)
+	{
+		uint32_t first = (uint32_t) range;
+		uint32_t end = (uint32_t) (range >> 32);
+		if (first >= end)
+		{
+			return false;
+		}
+
+		uint32_t middle = first + (end - first) / 2;
+		if (victim.range.compare_exchange_weak(range,
+			pack_range(first, middle), memory_order_acq_rel))
+		{
+			thief.range.store(pack_range(middle, end), memory_order_release);
+			thief.stolen++;
+			return true;
+		}
+	}
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Body of each tournament thread. Plays matches from its own range chunk at a
+ * time, then steals from the other threads until there is nothing left.
+ *
+ * @param[in,out]  workers - Every thread of the tournament
+ * @param[in]      id - Index of this thread in workers
+ * @param[in]      chunk - Number of matches to take at once
+ * @param[in]      seed - Seed for the matches
+ * @param[in]      left_ai - AIKind of the left side
+ * @param[in]      right_ai - AIKind of the right side
+ * @param[in]      policy - File of the policy AI_POLICY plays, NULL for none
+ * @param[in]      net - File of the network AI_NEURAL plays, NULL for none
+ * @param[in]      difficulty - How hard the AIs are
+ *****************************************************************************/
+static void play( Workers* workers, int id, uint32_t chunk,
+	uint64_t seed, int left_ai, int right_ai, const char* policy,
+	const char* net, const Difficulty* difficulty )
+{
+	Worker& self = (*workers)[id];
+	int count = (int) workers -> size();
+	PongGame game(32 * PongGame::unit, 24 * PongGame::unit);
+	game.setScoreDemo(true);
+	game.setAIKind(false, left_ai);
+	game.setAIKind(true, right_ai);
+	if (policy != NULL) game.loadPolicy(policy);
+	if (net != NULL) game.loadNet(net);
+	game.setDifficulty(*difficulty);
+
+	while (true)
+	{
+		uint32_t first, last;
+		while (take(self, chunk, first, last))
+		{
+			for (uint32_t m = first; m < last; m++)
+			{
+				game.setSeed(seed, m);
+				game.startGame(true, true);
+				long ticks = 0;
+				while (game.isRunning())
+				{
+					game.step();
+					ticks++;
+				}
+
+				self.ticks += ticks;
+				self.matches++;
+				if (game.getLeftScore() > game.getRightScore())
+				{
+					self.left_wins++;
+				}
+				else
+				{
+					self.right_wins++;
+				}
+			}
+		}
+
+		// Out of work; look for someone to steal from, starting with the
+		// next thread over so thieves spread out
+		bool found = false;
+		for (int i = 1; i < count && !found; i++)
+		{
+			found = steal(self, (*workers)[(id + i) % count]);
+		}
+		if (!found)
+		{
+			return;
+		}
+	}
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Prints the command line usage of the tournament runner.
+ *
+ * @param[in]      name - Name the program was invoked with
+ *****************************************************************************/
+static void usage( const char* name )
+{
+	cerr << "Usage: " << name
+		<< " [--matches N] [--threads N] [--chunk N] [--seed N]" << endl
+		<< "       [--left-ai KIND] [--right-ai KIND] [--policy FILE]" << endl
+		<< "       [--net FILE] [--difficulty FILE]" << endl;
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Plays a tournament of AI vs AI matches to 10 points on every core and
+ * reports the results and the throughput.
+ *
+ * @param[in]      argc - Number of aurments from the command line
+ * @param[out]     argv - An array of command line aurgments
+ *
+ * @returns 0 program ran successfully, 1 bad arguments.
+ *****************************************************************************/
+int main( int argc, char *argv[] )
+{
+	long matches = 1000000;
+	int threads = (int) thread::hardware_concurrency();
+	long chunk = 16;
+	uint64_t seed = (uint64_t) time(NULL);
+	int left_ai = AI_FOLLOW;
+	int right_ai = AI_FOLLOW;
+	const char* policy = NULL;
+	const char* net = NULL;
+	const char* difficulty = NULL;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--matches") == 0 && i + 1 < argc)
+		{
+			matches = atol(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+		{
+			threads = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--chunk") == 0 && i + 1 < argc)
+		{
+			chunk = atol(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+		{
+			seed = (uint64_t) strtoull(argv[++i], NULL, 10);
+		}
+		else if (strcmp(argv[i], "--left-ai") == 0 && i + 1 < argc)
+		{
+			left_ai = PongGame::findAIKind(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--right-ai") == 0 && i + 1 < argc)
+		{
+			right_ai = PongGame::findAIKind(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--policy") == 0 && i + 1 < argc)
+		{
+			policy = argv[++i];
+		}
+		else if (strcmp(argv[i], "--net") == 0 && i + 1 < argc)
+		{
+			net = argv[++i];
+		}
+		else if (strcmp(argv[i], "--difficulty") == 0 && i + 1 < argc)
+		{
+			difficulty = argv[++i];
+		}
+		else
+		{
+			usage(argv[0]);
+			return 1;
+		}
+	}
+	if (threads < 1)
+	{
+		threads = 1;
+	}
+	if (matches < 1 || matches > 0xFFFFFFFFL || chunk < 1 || left_ai < 0
+		|| right_ai < 0)
+	{
+		usage(argv[0]);
+		return 1;
+	}
+
+	Policy check;
+	if (policy != NULL && !check.load(policy))
+	{
+		cerr << "Unable to load a policy from " << policy << endl;
+		return 1;
+	}
+	PaddleNet check_net;
+	if (net != NULL && !check_net.load(net))
+	{
+		cerr << "Unable to load a network from " << net << endl;
+		return 1;
+	}
+	Difficulty tuned;
+	if (difficulty != NULL && !tuned.load(difficulty))
+	{
+		cerr << "Unable to load a difficulty from " << difficulty << endl;
+		return 1;
+	}
+
+	// Hand every thread an even share to start with
+	Workers workers(threads);
+	for (int i = 0; i < threads; i++)
+	{
+		uint32_t first = (uint32_t) (matches * i / threads);
+		uint32_t last = (uint32_t) (matches * (i + 1) / threads);
+		workers[i].range.store(pack_range(first, last));
+		workers[i].matches = 0;
+		workers[i].left_wins = 0;
+		workers[i].right_wins = 0;
+		workers[i].stolen = 0;
+		workers[i].ticks = 0;
+	}
+
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	vector<thread> pool;
+	for (int i = 0; i < threads; i++)
+	{
+		pool.push_back(thread(play, &workers, i, (uint32_t) chunk, seed,
+			left_ai, right_ai, policy, net, &tuned));
+	}
+	for (int i = 0; i < threads; i++)
+	{
+		pool[i].join();
+	}
+	double seconds = chrono::duration<double>(
+		chrono::steady_clock::now() - start).count();
+
+	long played = 0, left_wins = 0, right_wins = 0, stolen = 0;
+	long long ticks = 0;
+	for (int i = 0; i < threads; i++)
+	{
+		played += workers[i].matches;
+		left_wins += workers[i].left_wins;
+		right_wins += workers[i].right_wins;
+		stolen += workers[i].stolen;
+		ticks += workers[i].ticks;
+	}
+
+	cout << "threads:      " << threads << endl;
+	cout << "matches:      " << played << endl;
+	cout << "left wins:    " << left_wins << endl;
+	cout << "right wins:   " << right_wins << endl;
+	cout << "steals:       " << stolen << endl;
+	cout << "ticks:        " << ticks << endl;
+	cout << "seconds:      " << seconds << endl;
+	if (seconds > 0)
+	{
+		cout << "matches/sec:  " << played / seconds << endl;
+		cout << "ticks/sec:    " << ticks / seconds << endl;
+	}
+	return 0;
+}
@@ -0,0 +1,828 @@
+/*************************************************************************//**
+ * @file
+ *
+ * @brief Self-play trainer. Learns a Policy for PolicyController by having
+ *		it play both sides of many headless games at once, on the CPU only,
+ *		or trains a PaddleNet for NeuralController.
+ *
+ * @section compile_section Compiling and Usage
+ *
+ * @par Make:
+   @verbatim
+   > make pong-train
+   @endverbatim
+ *
+ * @par Usage:
+   @verbatim
+   > ./pong-train [--steps N] [--envs N] [--threads N] [--unroll N]
+                  [--buffer N] [--seed N] [--out FILE] [--eval N]
+   > ./pong-train --mlp FILE [--steps N] [--envs N] [--seed N] [--eval N]
+   @endverbatim
+ *
+ * Learns by Q-learning over the cells of Policy. --envs games (default 256)
+ * are played at once, both paddles of each by keys, the policy being
+ * learned playing both. The games are stepped in lock-step, --unroll steps
+ * at a time (default 32), split between --threads threads (default one a
+ * core). Every step of every game adds two experiences, one for each
+ * paddle, to a ring of --buffer experiences (default 2^20) made up front,
+ * overwriting the oldest once it is full. Between rounds of stepping, the
+ * table of values is updated from as many experiences drawn at random from
+ * the ring as were just added.
+ *
+ * A paddle gets 1 for a point, -1 for a point against, and a little for
+ * hitting the ball. While learning, a paddle makes a random move some of
+ * the time, all of it to start with and a twentieth of it from halfway
+ * through on. The table is only read while games are stepped and only
+ * written between rounds, and each game draws its random numbers from its
+ * own stream of --seed, so the policy learned depends on --seed and not on
+ * --threads.
+ *
+ * After --steps game steps in all (default 20 million), the best move for
+ * each cell is written to --out (default pong.policy), where "--ai policy
+ * --policy FILE" plays it. The environment steps a second are reported,
+ * and the policy plays --eval matches (default 20) against each of the
+ * "follow" and "predict" AIs.
+ *
+ * With --mlp, a PaddleNet is trained instead and written to FILE, where
+ * "--ai neural --net FILE" plays it. The network is taught to play like
+ * "predict": to move toward where the ball will cross, at full speed until
+ * it is within a step of there. --envs games are played with both paddles
+ * by keys, mostly moving the way the network is being taught to and now and
+ * then at random so that it sees paddles in the wrong place too, for
+ * --steps steps in all (default 2 million here). The network learns from
+ * each paddle's step as it is played, a few dozen at a time, by stochastic
+ * gradient descent on the squared error. Its starting weights are drawn
+ * from --seed, so the same seed trains the same network.
+ *
+ *****************************************************************************/
+
+/*******************************************************************************
+ *                 DECLARATIONS, INCLUDES, AND NAMESPACES
+*******************************************************************************/
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <cstring>
+#include <cstdlib>
+#include <ctime>
+#include <cmath>
+#include <stdint.h>
+#include "PongGame.h"
+
+using namespace std;
+
+/*!
+ * @brief One step of one paddle, as learned from
+ */
+struct Experience
+{
+	uint16_t cell;		/*!< Cell the paddle was in */
+	uint16_t next;		/*!< Cell it ended up in */
+	uint8_t action;		/*!< Move it made, a PolicyAction */
+	uint8_t done;		/*!< nonzero if a point ended it */
+	float reward;		/*!< What it got for the move */
+};
+
+/*!
+ * @brief One of the games learned from
+ */
+struct Environment
+{
+	PongGame* game;		/*!< The game */
+	PongRandom explore;	/*!< Where random moves are drawn from */
+	long matches;		/*!< Matches started in it */
+	long points;		/*!< Points scored in it */
+};
+
+/*!
+ * @brief Everything the threads stepping the games share
+ */
+struct Trainer
+{
+	vector<Environment> envs;		/*!< The games */
+	vector<float> values;			/*!< Value of each move in each cell */
+	vector<Experience> ring;		/*!< Experiences learned from */
+	uint64_t seed;					/*!< Seed the games play */
+	uint64_t added;					/*!< Experiences added to the ring */
+	long unroll;					/*!< Steps a game takes in a round */
+	uint32_t explore_limit;			/*!< Chance out of 2^32 of a random
+										move this round */
+};
+
+/*!
+ * @brief What a paddle gets for hitting the ball
+ */
+static const float train_hit_reward = 0.1f;
+
+/*!
+ * @brief How much later rewards count for
+ */
+static const float train_discount = 0.99f;
+
+/*!
+ * @brief How far a value moves toward what it is learned to be
+ */
+static const float train_rate = 0.1f;
+
+/*!
+ * @brief Paddle steps a network learns from at a time
+ */
+static const int net_batch = 32;
+
+/*!
+ * @brief How far a network's weights move down the gradient each time
+ */
+static const float net_rate = 0.01f;
+
+/*!
+ * @brief How much of each move of a network's weights carries on to the next
+ */
+static const float net_momentum = 0.9f;
+
+/*!
+ * @brief Chance out of 2^32 that a paddle makes a random move while a
+ *		network is trained
+ */
+static const uint32_t net_explore = 1u << 30;
+
+/*!
+ * @brief Where each part of a network's weights starts; see PaddleNet
+ */
+enum NetOffset
+{
+	NET_W1 = 0,
+	NET_B1 = NET_W1 + PaddleNet::input_count * PaddleNet::hidden_count,
+	NET_W2 = NET_B1 + PaddleNet::hidden_count,
+	NET_B2 = NET_W2 + PaddleNet::hidden_count * PaddleNet::hidden_count,
+	NET_W3 = NET_B2 + PaddleNet::hidden_count,
+	NET_B3 = NET_W3 + PaddleNet::hidden_count
+};
+
+/*******************************************************************************
+ *                          FUNCTION DEFINITIONS
+*******************************************************************************/
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Picks the move with the highest value in a cell, staying put on a tie.
+ *
+ * @param[in]      values - Value of each move in each cell
+ * @param[in]      cell - The cell
+ *
+ * @returns The move, a PolicyAction.
+ *****************************************************************************/
+static int best_action( const float* values, int cell )
+{
+	const float* row = values + cell * POLICY_ACTION_COUNT;
+	int best = POLICY_STAY;
+	for (int a = 0; a < POLICY_ACTION_COUNT; a++)
+	{
+		if (row[a] > row[best]) best = a;
+	}
+	return best;
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Starts the next match of a game, on its own stream of the seed.
+ *
+ * @param[in,out]  trainer - The trainer
+ * @param[in]      id - Index of the game
+ *****************************************************************************/
+static void start_match( Trainer& trainer, long id )
+{
+	Environment& env = trainer.envs[id];
+	env.game->setSeed(trainer.seed,
+		(uint64_t) env.matches * trainer.envs.size() + id);
+	env.game->startGame(false, false);
+	env.matches++;
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Body of each stepping thread. Steps a share of the games unroll steps in
+ * lock-step, each paddle making the move the table says or now and then a
+ * random one, and writes what happened to the ring. Every step of every
+ * game has its own two places in the ring, so threads never write to the
+ * same one.
+ *
+ * @param[in,out]  trainer - The trainer
+ * @param[in]      first - First game to step
+ * @param[in]      last - One past the last game to step
+ *****************************************************************************/
+static void step_games( Trainer* trainer, long first, long last )
+{
+	const float* values = &trainer -> values[0];
+	long count = (long) trainer -> envs.size();
+	uint64_t size = trainer -> ring.size();
+
+	for (long k = 0; k < trainer -> unroll; k++)
+	{
+		for (long id = first; id < last; id++)
+		{
+			Environment& env = trainer -> envs[id];
+			PongGame* game = env.game;
+			if (!game->isRunning()) start_match(*trainer, id);
+
+			Ball* ball = game->getBall();
+			Paddle* paddles[2] = { game->getLeftPaddle(),
+				game->getRightPaddle() };
+			int cells[2], actions[2];
+			unsigned char input = 0;
+			for (int side = 0; side < 2; side++)
+			{
+				cells[side] = Policy::cell(ball, paddles[side]);
+				actions[side] = env.explore.next() < trainer -> explore_limit
+					? env.explore.nextInt(POLICY_ACTION_COUNT)
+					: best_action(values, cells[side]);
+				int direction = Policy::direction(actions[side]);
+				input |= (direction > 0 ? 1 : (direction < 0 ? 2 : 0))
+					<< (4 * side);
+			}
+
+			int left_score = game->getLeftScore();
+			int right_score = game->getRightScore();
+			double before = ball->x_velocity;
+			game->setInput(input);
+			game->step();
+
+			// A point for one is a point against the other
+			float rewards[2] = { 0, 0 };
+			bool done = game->getLeftScore() != left_score
+				|| game->getRightScore() != right_score;
+			if (done)
+			{
+				rewards[0] = game->getLeftScore() != left_score ? 1.0f : -1.0f;
+				rewards[1] = -rewards[0];
+				env.points++;
+			}
+			else if (before < 0 && ball->x_velocity > 0)
+			{
+				rewards[0] = train_hit_reward;
+			}
+			else if (before > 0 && ball->x_velocity < 0)
+			{
+				rewards[1] = train_hit_reward;
+			}
+
+			uint64_t slot = trainer -> added
+				+ 2 * ((uint64_t) k * count + id);
+			for (int side = 0; side < 2; side++)
+			{
+				Experience& e = trainer -> ring[(slot + side) % size];
+				e.cell = (uint16_t) cells[side];
+				e.next = (uint16_t) (done || game->getBall() == NULL ? 0
+					: Policy::cell(game->getBall(), paddles[side]));
+				e.action = (uint8_t) actions[side];
+				e.done = done ? 1 : 0;
+				e.reward = rewards[side];
+			}
+		}
+	}
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Learns from a number of experiences drawn at random from the ring, moving
+ * the value of each move made toward what it got plus the best it could
+ * get after.
+ *
+ * @param[in,out]  trainer - The trainer
+ * @param[in,out]  random - Where experiences are drawn from
+ * @param[in]      updates - Number of experiences to learn from
+ *****************************************************************************/
+static void learn( Trainer& trainer, PongRandom& random, long updates )
+{
+	float* values = &trainer.values[0];
+	uint64_t size = trainer.ring.size();
+	uint64_t filled = trainer.added < size ? trainer.added : size;
+	if (filled == 0) return;
+
+	for (long i = 0; i < updates; i++)
+	{
+		uint64_t pick = (((uint64_t) random.next() << 32) | random.next())
+			% filled;
+		const Experience& e = trainer.ring[pick];
+		float target = e.reward;
+		if (!e.done)
+		{
+			target += train_discount
+				* values[e.next * POLICY_ACTION_COUNT
+					+ best_action(values, e.next)];
+		}
+		float& value = values[e.cell * POLICY_ACTION_COUNT + e.action];
+		value += train_rate * (target - value);
+	}
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Gets the move a network is taught to make: toward where the ball will
+ * cross, or the middle if it isn't coming, as a fraction of the paddle's
+ * full speed.
+ *
+ * @param[in]      ball - The ball
+ * @param[in]      paddle - The paddle
+ *
+ * @returns The move, from -1 to 1.
+ *****************************************************************************/
+static float net_target( Ball* ball, Paddle* paddle )
+{
+	double gap = PredictiveController::crossingHeight(ball, paddle)
+		- paddle->getY();
+	double move = gap / paddle->getVerticalSpeed();
+	return (float) (move > 1 ? 1 : (move < -1 ? -1 : move));
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Adds the gradient of half the squared error of a network's move to a sum,
+ * working the layers out the same way PaddleNet does and then back.
+ *
+ * @param[in]      weights - The network's weights
+ * @param[in]      input - Numbers from PaddleNet::features()
+ * @param[in]      target - Move the network should have made
+ * @param[in,out]  gradient - Sum to add to
+ *
+ * @returns The squared error.
+ *****************************************************************************/
+static float net_gradient( const float* weights, const float* input,
+	float target, float* gradient )
+{
+	const int n = PaddleNet::hidden_count;
+	float first[n], second[n], back[n];
+
+	for (int j = 0; j < n; j++)
+	{
+		float sum = weights[NET_B1 + j];
+		for (int i = 0; i < PaddleNet::input_count; i++)
+		{
+			sum += weights[NET_W1 + i * n + j] * input[i];
+		}
+		first[j] = sum > 0 ? sum : 0.0f;
+	}
+	for (int j = 0; j < n; j++)
+	{
+		float sum = weights[NET_B2 + j];
+		for (int i = 0; i < n; i++)
+		{
+			sum += weights[NET_W2 + i * n + j] * first[i];
+		}
+		second[j] = sum > 0 ? sum : 0.0f;
+	}
+	float sum = weights[NET_B3];
+	for (int j = 0; j < n; j++)
+	{
+		sum += weights[NET_W3 + j] * second[j];
+	}
+	float output = tanhf(sum);
+	float error = output - target;
+
+	// Back through tanh, then each layer, where ReLU let anything through
+	float delta = error * (1 - output * output);
+	gradient[NET_B3] += delta;
+	for (int j = 0; j < n; j++)
+	{
+		gradient[NET_W3 + j] += delta * second[j];
+		back[j] = second[j] > 0 ? delta * weights[NET_W3 + j] : 0.0f;
+		gradient[NET_B2 + j] += back[j];
+	}
+	for (int i = 0; i < n; i++)
+	{
+		float sum = 0;
+		for (int j = 0; j < n; j++)
+		{
+			gradient[NET_W2 + i * n + j] += first[i] * back[j];
+			sum += weights[NET_W2 + i * n + j] * back[j];
+		}
+		first[i] = first[i] > 0 ? sum : 0.0f;
+	}
+	for (int j = 0; j < n; j++)
+	{
+		gradient[NET_B1 + j] += first[j];
+		for (int i = 0; i < PaddleNet::input_count; i++)
+		{
+			gradient[NET_W1 + i * n + j] += input[i] * first[j];
+		}
+	}
+	return error * error;
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Trains a network to play like the "predict" AI and writes it out. See the
+ * file's description.
+ *
+ * @param[in]      out - File to write the network to
+ * @param[in]      steps - Game steps to play in all
+ * @param[in]      envs - Games to play at once
+ * @param[in]      seed - Seed for the games and the starting weights
+ *
+ * @returns True if the network was written, false if not.
+ *****************************************************************************/
+static bool train_net( const char* out, long long steps, long envs,
+	uint64_t seed )
+{
+	vector<float> weights(PaddleNet::weight_count, 0.0f);
+	vector<float> gradient(PaddleNet::weight_count, 0.0f);
+	vector<float> velocity(PaddleNet::weight_count, 0.0f);
+
+	// He initialization: uniform, scaled to each layer's inputs
+	PongRandom random(seed, 0xbadc0de);
+	const int n = PaddleNet::hidden_count;
+	for (int w = 0; w < PaddleNet::weight_count; w++)
+	{
+		int fan_in = w < NET_B1 ? PaddleNet::input_count : n;
+		bool bias = (w >= NET_B1 && w < NET_W2) || (w >= NET_B2 && w < NET_W3)
+			|| w == NET_B3;
+		double limit = sqrt(6.0 / fan_in);
+		weights[w] = bias ? 0.0f : (float) (limit
+			* (random.next() / 2147483647.5 - 1.0));
+	}
+
+	vector<PongGame*> games(envs);
+	vector<PongRandom> explore(envs);
+	long matches = 0;
+	for (long i = 0; i < envs; i++)
+	{
+		games[i] = new (nothrow) PongGame(32 * PongGame::unit,
+			24 * PongGame::unit);
+		if (games[i] == NULL)
+		{
+			cerr << "Out of memory" << endl;
+			return false;
+		}
+		explore[i].seed(seed ^ 0x5bd1e995, (uint64_t) i);
+	}
+
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	float input[PaddleNet::input_count];
+	double error = 0;
+	long seen = 0, batched = 0;
+	for (long long taken = 0; taken < steps; taken += envs)
+	{
+		for (long id = 0; id < envs; id++)
+		{
+			PongGame* game = games[id];
+			if (!game->isRunning())
+			{
+				game->setSeed(seed, (uint64_t) matches++);
+				game->startGame(false, false);
+			}
+
+			Ball* ball = game->getBall();
+			Paddle* paddles[2] = { game->getLeftPaddle(),
+				game->getRightPaddle() };
+			unsigned char keys = 0;
+			for (int side = 0; side < 2; side++)
+			{
+				float target = net_target(ball, paddles[side]);
+				PaddleNet::features(ball, paddles[side], input);
+				error += net_gradient(&weights[0], input, target,
+					&gradient[0]);
+				seen++;
+
+				int direction = target > 0.5f ? 1 : (target < -0.5f ? -1 : 0);
+				if (explore[id].next() < net_explore)
+					direction = explore[id].nextInt(3) - 1;
+				keys |= (direction > 0 ? 1 : (direction < 0 ? 2 : 0))
+					<< (4 * side);
+
+				if (++batched == net_batch)
+				{
+					for (int w = 0; w < PaddleNet::weight_count; w++)
+					{
+						velocity[w] = net_momentum * velocity[w]
+							- net_rate / net_batch * gradient[w];
+						weights[w] += velocity[w];
+						gradient[w] = 0;
+					}
+					batched = 0;
+				}
+			}
+			game->setInput(keys);
+			game->step();
+		}
+
+		// Report how it is going every so often
+		if ((taken / envs + 1) % 1000 == 0)
+		{
+			cout << "steps " << taken + envs << ": mean squared error "
+				<< error / seen << endl;
+			error = 0;
+			seen = 0;
+		}
+	}
+	double seconds = chrono::duration<double>(chrono::steady_clock::now()
+		- start).count();
+
+	for (long i = 0; i < envs; i++)
+	{
+		delete games[i];
+	}
+
+	cout << "envs:         " << envs << endl;
+	cout << "env steps:    " << steps << endl;
+	cout << "matches:      " << matches << endl;
+	cout << "seconds:      " << seconds << endl;
+	if (!PaddleNet::save(out, &weights[0]))
+	{
+		cerr << "Unable to write " << out << endl;
+		return false;
+	}
+	cout << "network:      " << out << endl;
+	return true;
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Plays a number of matches of a policy or network against another AI and
+ * prints how many it won.
+ *
+ * @param[in]      file - File holding the policy or network
+ * @param[in]      kind - AI_POLICY or AI_NEURAL
+ * @param[in]      other - AIKind of the other AI
+ * @param[in]      matches - Number of matches
+ * @param[in]      seed - Seed for the matches; match m plays stream m of it
+ *****************************************************************************/
+static void evaluate( const char* file, int kind, int other, long matches,
+	uint64_t seed )
+{
+	static const char* names[AI_KIND_COUNT] = { "follow", "predict",
+		"lookahead", "policy", "neural" };
+	PongGame game(32 * PongGame::unit, 24 * PongGame::unit);
+	game.setScoreDemo(true);
+	if (kind == AI_NEURAL)
+		game.loadNet(file);
+	else
+		game.loadPolicy(file);
+	long wins = 0, unfinished = 0;
+
+	for (long m = 0; m < matches; m++)
+	{
+		// Take turns at which side the policy plays
+		bool right = m % 2 == 1;
+		game.setAIKind(right, kind);
+		game.setAIKind(!right, other);
+		game.setSeed(seed, m);
+		game.startGame(true, true);
+		for (long tick = 0; game.isRunning() && tick < 60L * 60 * 10; tick++)
+		{
+			game.step();
+		}
+		if (game.isRunning())
+		{
+			unfinished++;
+			game.quitGame();
+		}
+		else if ((game.getRightScore() > game.getLeftScore()) == right)
+		{
+			wins++;
+		}
+	}
+
+	cout << "vs " << names[other] << ":" << string(10 - strlen(names[other]),
+		' ') << wins << " of " << matches << " won, " << unfinished
+		<< " unfinished" << endl;
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Prints the command line usage of the trainer.
+ *
+ * @param[in]      name - Name the program was invoked with
+ *****************************************************************************/
+static void usage( const char* name )
+{
+	cerr << "Usage: " << name
+		<< " [--steps N] [--envs N] [--threads N] [--unroll N]" << endl
+		<< "       [--buffer N] [--seed N] [--out FILE] [--eval N]" << endl
+		<< "       " << name << " --mlp FILE [--steps N] [--envs N] [--seed N]"
+		<< " [--eval N]" << endl;
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Learns a policy by self-play, or trains a network, writes it out, and
+ * reports how fast the games were stepped and how well it plays.
+ *
+ * @param[in]      argc - Number of aurments from the command line
+ * @param[out]     argv - An array of command line aurgments
+ *
+ * @returns 0 program ran successfully, 1 bad arguments or the policy or
+ *		network couldn't be written.
+ *****************************************************************************/
+int main( int argc, char *argv[] )
+{
+	long long steps = 0;
+	long envs = 256;
+	int threads = (int) thread::hardware_concurrency();
+	long unroll = 32;
+	long buffer = 1L << 20;
+	uint64_t seed = (uint64_t) time(NULL);
+	const char* out = "pong.policy";
+	long eval = 20;
+	const char* mlp = NULL;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--steps") == 0 && i + 1 < argc)
+		{
+			steps = atoll(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--envs") == 0 && i + 1 < argc)
+		{
+			envs = atol(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+		{
+			threads = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--unroll") == 0 && i + 1 < argc)
+		{
+			unroll = atol(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--buffer") == 0 && i + 1 < argc)
+		{
+			buffer = atol(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+		{
+			seed = (uint64_t) strtoull(argv[++i], NULL, 10);
+		}
+		else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc)
+		{
+			out = argv[++i];
+		}
+		else if (strcmp(argv[i], "--eval") == 0 && i + 1 < argc)
+		{
+			eval = atol(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--mlp") == 0 && i + 1 < argc)
+		{
+			mlp = argv[++i];
+		}
+		else
+		{
+			usage(argv[0]);
+			return 1;
+		}
+	}
+	if (threads < 1)
+	{
+		threads = 1;
+	}
+	if (threads > envs)
+	{
+		threads = (int) envs;
+	}
+	if (steps == 0)
+	{
+		steps = mlp != NULL ? 2000000 : 20000000;
+	}
+	if (steps < 1 || envs < 1 || unroll < 1 || buffer < 2 || eval < 0)
+	{
+		usage(argv[0]);
+		return 1;
+	}
+
+	if (mlp != NULL)
+	{
+		if (!train_net(mlp, steps, envs, seed))
+		{
+			return 1;
+		}
+		if (eval > 0)
+		{
+			evaluate(mlp, AI_NEURAL, AI_FOLLOW, eval, seed);
+			evaluate(mlp, AI_NEURAL, AI_PREDICT, eval, seed);
+		}
+		return 0;
+	}
+
+	Trainer trainer;
+	trainer.envs.resize(envs);
+	for (long i = 0; i < envs; i++)
+	{
+		Environment& env = trainer.envs[i];
+		env.game = new (nothrow) PongGame(32 * PongGame::unit,
+			24 * PongGame::unit);
+		env.explore.seed(seed ^ 0x5bd1e995, (uint64_t) i);
+		env.matches = 0;
+		env.points = 0;
+		if (env.game == NULL)
+		{
+			cerr << "Out of memory" << endl;
+			return 1;
+		}
+		start_match(trainer, i);
+	}
+	trainer.values.assign(Policy::cell_count * POLICY_ACTION_COUNT, 0.0f);
+	trainer.ring.resize(buffer);
+	trainer.seed = seed;
+	trainer.added = 0;
+	trainer.unroll = unroll;
+	PongRandom random(seed, 0xdecade);
+
+	long long taken = 0;
+	double step_seconds = 0, learn_seconds = 0;
+	while (taken < steps)
+	{
+		// Random moves from all of the time down to a twentieth by halfway
+		double progress = (double) taken / steps;
+		double explore = progress >= 0.5 ? 0.05 : 1.0 - 0.95 * progress / 0.5;
+		trainer.explore_limit = (uint32_t) (explore * 4294967295.0);
+
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		if (threads == 1)
+		{
+			step_games(&trainer, 0, envs);
+		}
+		else
+		{
+			vector<thread> pool;
+			for (int i = 0; i < threads; i++)
+			{
+				pool.push_back(thread(step_games, &trainer,
+					envs * i / threads, envs * (i + 1) / threads));
+			}
+			for (int i = 0; i < threads; i++)
+			{
+				pool[i].join();
+			}
+		}
+		chrono::steady_clock::time_point stepped = chrono::steady_clock::now();
+
+		long added = 2 * unroll * envs;
+		trainer.added += added;
+		taken += unroll * envs;
+		learn(trainer, random, added);
+		step_seconds += chrono::duration<double>(stepped - start).count();
+		learn_seconds += chrono::duration<double>(
+			chrono::steady_clock::now() - stepped).count();
+	}
+
+	Policy policy;
+	for (int cell = 0; cell < Policy::cell_count; cell++)
+	{
+		policy.setAction(cell, best_action(&trainer.values[0], cell));
+	}
+	bool saved = policy.save(out);
+
+	long long matches = 0, points = 0;
+	for (long i = 0; i < envs; i++)
+	{
+		matches += trainer.envs[i].matches;
+		points += trainer.envs[i].points;
+		delete trainer.envs[i].game;
+	}
+
+	cout << "threads:      " << threads << endl;
+	cout << "envs:         " << envs << endl;
+	cout << "env steps:    " << taken << endl;
+	cout << "matches:      " << matches << endl;
+	cout << "points:       " << points << endl;
+	cout << "experiences:  " << trainer.added << " into a ring of "
+		<< buffer << endl;
+	cout << "seconds:      " << step_seconds + learn_seconds << endl;
+	if (step_seconds > 0)
+	{
+		cout << "steps/sec:    " << taken / step_seconds << " stepping"
+			<< endl;
+		cout << "overall:      " << taken / (step_seconds + learn_seconds)
+			<< " steps/sec with learning" << endl;
+	}
+	if (!saved)
+	{
+		cerr << "Unable to write " << out << endl;
+		return 1;
+	}
+	cout << "policy:       " << out << endl;
+
+	if (eval > 0)
+	{
+		evaluate(out, AI_POLICY, AI_FOLLOW, eval, seed);
+		evaluate(out, AI_POLICY, AI_PREDICT, eval, seed);
+	}
+	return 0;
+}
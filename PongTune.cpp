@@ -0,0 +1,471 @@
+/*************************************************************************//**
+ * @file
+ *
+ * @brief Difficulty tuner. Evolves the numbers in Difficulty so that the AI
+ *		wins points as often as a target curve says it should, playing large
+ *		batches of headless matches on every core.
+ *
+ * @section compile_section Compiling and Usage
+ *
+ * @par Make:
+   @verbatim
+   > make pong-tune
+   @endverbatim
+ *
+ * @par Usage:
+   @verbatim
+   > ./pong-tune [--generations N] [--population N] [--matches N]
+                 [--threads N] [--seed N] [--level P] [--slope S]
+                 [--out FILE]
+   @endverbatim
+ *
+ * Every difficulty tried plays --matches matches (default 512) with
+ * BatchGame, on the left, against a steady opponent on the right: the AI as
+ * it plays by default, but without speeding up or slowing down with the
+ * score, as a stand-in for a player. Every point played is tallied by how
+ * far ahead the tuned side was when it started. The target is for the
+ * tuned side to win --level of the points (default 0.5) when the score is
+ * level, and --slope (default 0.05) less for every point it is ahead, or
+ * more for every point behind, so that games stay close; a difficulty is
+ * scored by the squared difference between the two curves, weighted by how
+ * many points were played at each lead.
+ *
+ * A population of --population difficulties (default 16), starting from
+ * the standard one and random changes to it, is evolved for --generations
+ * generations (default 20). Each generation every difficulty plays the
+ * same matches, stream m of a seed drawn from --seed, so that they are
+ * compared on even terms; the best quarter are kept, and the rest replaced
+ * by random changes to them, smaller as the generations go by. The
+ * difficulties of a generation are shared out between --threads threads
+ * (default one a core), each with a BatchGame of its own. How a difficulty
+ * plays depends only on the seed, so the result depends on --seed and not
+ * on --threads.
+ *
+ * The best difficulty of the last generation is written to --out (default
+ * pong.difficulty), which pong loads when it starts, along with how its
+ * curve compares to the target.
+ *
+ *****************************************************************************/
+
+/*******************************************************************************
+ *                 DECLARATIONS, INCLUDES, AND NAMESPACES
+*******************************************************************************/
+#include <iostream>
+#include <iomanip>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <cstdlib>
+#include <ctime>
+#include <stdint.h>
+#include "BatchGame.h"
+
+using namespace std;
+
+/*!
+ * @brief Most points a side can be ahead by, in a match to 10
+ */
+static const int tune_max_lead = 9;
+
+/*!
+ * @brief Number of leads points are tallied by, from -9 to 9
+ */
+static const int tune_leads = 2 * tune_max_lead + 1;
+
+/*!
+ * @brief Steps after which a match is abandoned, ten minutes of game time
+ */
+static const long tune_max_ticks = 60L * 60 * 10;
+
+/*!
+ * @brief How a difficulty played against the steady opponent
+ */
+struct Trial
+{
+	Difficulty difficulty;		/*!< The difficulty tried */
+	long points[tune_leads];	/*!< Points played at each lead */
+	long won[tune_leads];		/*!< Points the tuned side won at each lead */
+	long matches;				/*!< Matches played */
+	long match_wins;			/*!< Matches the tuned side won */
+	double error;				/*!< Weighted squared difference from the
+									target curve */
+};
+
+/*!
+ * @brief Everything the tuning threads share
+ */
+struct Tuner
+{
+	vector<Trial> trials;		/*!< The difficulties of this generation */
+	atomic<int> next;			/*!< Next trial to take */
+	long matches;				/*!< Matches each trial plays */
+	uint64_t seed;				/*!< Seed this generation's matches play */
+	double level;				/*!< Points to win when level */
+	double slope;				/*!< Points fewer to win per point ahead */
+};
+
+/*******************************************************************************
+ *                          FUNCTION DEFINITIONS
+*******************************************************************************/
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Gets the share of points the tuned side should win at a lead.
+ *
+ * @param[in]      tuner - The tuner
+ * @param[in]      lead - Points the tuned side is ahead; negative if behind
+ *
+ * @returns The share, from 0.02 to 0.98.
+ *****************************************************************************/
+static double target( const Tuner& tuner, int lead )
+{
+	double share = tuner.level - tuner.slope * lead;
+	return share < 0.02 ? 0.02 : (share > 0.98 ? 0.98 : share);
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Plays a trial's matches against the steady opponent, tallying every point
+ * by the lead it started at, and scores the trial against the target curve.
+ *
+ * @param[in]      tuner - The tuner
+ * @param[in,out]  batch - Matches to play them with
+ * @param[in,out]  trial - The trial
+ *****************************************************************************/
+static void play_trial( const Tuner& tuner, BatchGame& batch, Trial& trial )
+{
+	Difficulty steady;
+	steady.speed_per_point = 0;
+	batch.setDifficulty(false, trial.difficulty);
+	batch.setDifficulty(true, steady);
+	batch.start(tuner.seed);
+
+	int n = batch.getMatches();
+	vector<int> left(n, 0), right(n, 0);
+	memset(trial.points, 0, sizeof(trial.points));
+	memset(trial.won, 0, sizeof(trial.won));
+	while (batch.getRunning() > 0 && batch.getTick() < tune_max_ticks)
+	{
+		batch.step();
+		for (int i = 0; i < n; i++)
+		{
+			int l = batch.getLeftScore(i), r = batch.getRightScore(i);
+			if (l == left[i] && r == right[i]) continue;
+
+			int lead = left[i] - right[i] + tune_max_lead;
+			trial.points[lead]++;
+			if (l != left[i]) trial.won[lead]++;
+			left[i] = l;
+			right[i] = r;
+		}
+	}
+
+	trial.matches = n;
+	trial.match_wins = 0;
+	for (int i = 0; i < n; i++)
+	{
+		if (!batch.isRunning(i) && left[i] > right[i]) trial.match_wins++;
+	}
+
+	long points = 0;
+	double error = 0;
+	for (int lead = 0; lead < tune_leads; lead++)
+	{
+		if (trial.points[lead] == 0) continue;
+		double gap = (double) trial.won[lead] / trial.points[lead]
+			- target(tuner, lead - tune_max_lead);
+		error += trial.points[lead] * gap * gap;
+		points += trial.points[lead];
+	}
+	trial.error = points > 0 ? error / points : 1.0;
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Body of each tuning thread. Takes trials one at a time until there are
+ * none left, playing each with the thread's own BatchGame.
+ *
+ * @param[in,out]  tuner - The tuner
+ *****************************************************************************/
+static void tune_trials( Tuner* tuner )
+{
+	BatchGame batch(32 * PongGame::unit, 24 * PongGame::unit,
+		(int) tuner -> matches);
+	int count = (int) tuner -> trials.size();
+	for (int t = tuner -> next++; t < count; t = tuner -> next++)
+	{
+		play_trial(*tuner, batch, tuner -> trials[t]);
+	}
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Draws a number from the standard normal distribution.
+ *
+ * @param[in,out]  random - Where to draw it from
+ *
+ * @returns The number.
+ *****************************************************************************/
+static double normal( PongRandom& random )
+{
+	double u = (random.next() + 1.0) / 4294967297.0;
+	double v = random.next() / 4294967296.0;
+	return sqrt(-2 * log(u)) * cos(2 * M_PI * v);
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Makes a random change to a difficulty, keeping it within sensible bounds.
+ * The number of spots aimed with is left alone.
+ *
+ * @param[in]      parent - Difficulty to change
+ * @param[in]      scale - Size of the change, 1 to start with
+ * @param[in,out]  random - Where the change is drawn from
+ *
+ * @returns The changed difficulty.
+ *****************************************************************************/
+static Difficulty mutate( const Difficulty& parent, double scale,
+	PongRandom& random )
+{
+	Difficulty child = parent;
+	child.base_speed += 0.25 * scale * normal(random);
+	child.speed_per_point += 0.05 * scale * normal(random);
+	child.offset_spread += 0.15 * scale * normal(random);
+	child.base_speed = max(1.0, min(8.0, child.base_speed));
+	child.speed_per_point = max(0.0, min(1.0, child.speed_per_point));
+	child.offset_spread = max(0.0, min(3.0, child.offset_spread));
+	return child;
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Orders trials from best to worst.
+ *
+ * @param[in]      a - One trial
+ * @param[in]      b - Another
+ *
+ * @returns True if a is better than b.
+ *****************************************************************************/
+static bool better( const Trial& a, const Trial& b )
+{
+	return a.error < b.error;
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Prints a difficulty on one line.
+ *
+ * @param[in]      difficulty - The difficulty
+ *****************************************************************************/
+static void print_difficulty( const Difficulty& difficulty )
+{
+	cout << "speed " << difficulty.base_speed << " + "
+		<< difficulty.speed_per_point << "/point behind, spread "
+		<< difficulty.offset_spread;
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Prints the command line usage of the tuner.
+ *
+ * @param[in]      name - Name the program was invoked with
+ *****************************************************************************/
+static void usage( const char* name )
+{
+	cerr << "Usage: " << name
+		<< " [--generations N] [--population N] [--matches N]" << endl
+		<< "       [--threads N] [--seed N] [--level P] [--slope S]" << endl
+		<< "       [--out FILE]" << endl;
+}
+
+/**************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description:
+ * Evolves a difficulty toward the target curve, writes it out, and reports
+ * how its curve compares to the target.
+ *
+ * @param[in]      argc - Number of aurments from the command line
+ * @param[out]     argv - An array of command line aurgments
+ *
+ * @returns 0 program ran successfully, 1 bad arguments or the difficulty
+ *		couldn't be written.
+ *****************************************************************************/
+int main( int argc, char *argv[] )
+{
+	long generations = 20;
+	long population = 16;
+	long matches = 512;
+	int threads = (int) thread::hardware_concurrency();
+	uint64_t seed = (uint64_t) time(NULL);
+	double level = 0.5;
+	double slope = 0.05;
+	const char* out = "pong.difficulty";
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--generations") == 0 && i + 1 < argc)
+		{
+			generations = atol(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--population") == 0 && i + 1 < argc)
+		{
+			population = atol(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--matches") == 0 && i + 1 < argc)
+		{
+			matches = atol(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+		{
+			threads = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+		{
+			seed = (uint64_t) strtoull(argv[++i], NULL, 10);
+		}
+		else if (strcmp(argv[i], "--level") == 0 && i + 1 < argc)
+		{
+			level = atof(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--slope") == 0 && i + 1 < argc)
+		{
+			slope = atof(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc)
+		{
+			out = argv[++i];
+		}
+		else
+		{
+			usage(argv[0]);
+			return 1;
+		}
+	}
+	if (threads < 1)
+	{
+		threads = 1;
+	}
+	if (threads > population)
+	{
+		threads = (int) population;
+	}
+	if (generations < 1 || population < 2 || matches < 1
+		|| matches > 1000000 || !(level > 0 && level < 1))
+	{
+		usage(argv[0]);
+		return 1;
+	}
+
+	Tuner tuner;
+	tuner.trials.resize(population);
+	tuner.matches = matches;
+	tuner.level = level;
+	tuner.slope = slope;
+	PongRandom random(seed, 0x7e57);
+	for (long i = 0; i < population; i++)
+	{
+		tuner.trials[i].difficulty = i == 0 ? Difficulty::standard
+			: mutate(Difficulty::standard, 1.0, random);
+	}
+
+	long keep = population / 4 > 0 ? population / 4 : 1;
+	double seconds = 0;
+	long long played = 0;
+	for (long g = 0; g < generations; g++)
+	{
+		tuner.seed = ((uint64_t) random.next() << 32) | random.next();
+		tuner.next = 0;
+
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		if (threads == 1)
+		{
+			tune_trials(&tuner);
+		}
+		else
+		{
+			vector<thread> pool;
+			for (int i = 0; i < threads; i++)
+			{
+				pool.push_back(thread(tune_trials, &tuner));
+			}
+			for (int i = 0; i < threads; i++)
+			{
+				pool[i].join();
+			}
+		}
+		seconds += chrono::duration<double>(
+			chrono::steady_clock::now() - start).count();
+		played += population * matches;
+
+		stable_sort(tuner.trials.begin(), tuner.trials.end(), better);
+		const Trial& best = tuner.trials[0];
+		cout << "generation " << setw(3) << g + 1 << ": error "
+			<< setw(10) << best.error << ", ";
+		print_difficulty(best.difficulty);
+		cout << endl;
+
+		// Keep the best quarter and replace the rest with changes to them
+		if (g + 1 < generations)
+		{
+			double scale = 1.0 - 0.8 * (g + 1) / generations;
+			for (long i = keep; i < population; i++)
+			{
+				tuner.trials[i].difficulty = mutate(
+					tuner.trials[i % keep].difficulty, scale, random);
+			}
+		}
+	}
+
+	const Trial& best = tuner.trials[0];
+	cout << "threads:      " << threads << endl;
+	cout << "matches:      " << played << endl;
+	cout << "seconds:      " << seconds << endl;
+	if (seconds > 0)
+	{
+		cout << "matches/sec:  " << played / seconds << endl;
+	}
+	cout << "best:         ";
+	print_difficulty(best.difficulty);
+	cout << endl;
+	cout << "match wins:   " << best.match_wins << " of " << best.matches
+		<< endl;
+	cout << "lead  target  actual  points" << endl;
+	for (int lead = 0; lead < tune_leads; lead++)
+	{
+		if (best.points[lead] == 0) continue;
+		cout << setw(4) << lead - tune_max_lead << fixed << setprecision(3)
+			<< setw(8) << target(tuner, lead - tune_max_lead) << setw(8)
+			<< (double) best.won[lead] / best.points[lead] << setw(8)
+			<< best.points[lead] << endl;
+		cout.unsetf(ios::fixed);
+		cout << setprecision(6);
+	}
+
+	if (!best.difficulty.save(out))
+	{
+		cerr << "Unable to write " << out << endl;
+		return 1;
+	}
+	cout << "difficulty:   " << out << endl;
+	return 0;
+}
@@ -0,0 +1,313 @@
+/***************************************************************************//**
+ * @file File containing the implementation of the PredictiveController class.
+ *
+ * @brief Contains the implementation for the PredictiveController class.
+*******************************************************************************/
+
+/*******************************************************************************
+ *                 DECLARATIONS, INCLUDES, AND NAMESPACES
+*******************************************************************************/
+#include <cmath>
+#include "PredictiveController.h"
+
+/*******************************************************************************
+ *                          FUNCTION DEFINITIONS
+*******************************************************************************/
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: The constructor. Initializes variables and classes.
+ *		Triggers the ballHit() function to randomize offset.
+ *
+ * @param[in]	paddle - Pointer to paddle that this controller controls.
+ * @param[in]	ball - Pointer to the ball object to track.
+ * @param[in]	random - The game's random number generator.
+ * @param[in]	difficulty - How offsets are picked; must outlast the
+ *				controller.
+*******************************************************************************/
+PredictiveController::PredictiveController(Paddle* paddle, Ball* ball,
+	PongRandom* random, const Difficulty* difficulty) :
+paddle(paddle), ball(ball), random(random), difficulty(difficulty), offset(0),
+steps(0), chase(0), chase_y(0), chase_step(0), chase_speed(0), chase_to(0),
+aimed(false), aim_path_x(0), aim_path_y(0), aim_path_t(0), aim_x_velocity(0),
+aim_y_velocity(0), aim_s_velocity(0), aim_y(0)
+{
+	ballHit();
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Does nothing. Fulfills superclass requirements.
+*******************************************************************************/
+void PredictiveController::keyDown(unsigned char key)
+{ }
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Does nothing. Fulfills superclass requirements.
+*******************************************************************************/
+void PredictiveController::keyUp(unsigned char key)
+{ }
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Does nothing. Fulfills superclass requirements.
+*******************************************************************************/
+void PredictiveController::keySpecialDown(int key)
+{ }
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Does nothing. Fulfills superclass requirements.
+*******************************************************************************/
+void PredictiveController::keySpecialUp(int key)
+{ }
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Triggers when ball bounces off paddle that this controller
+ *		controls. Randomizes the AI's offset, drawing the same random numbers
+ *		AIController does.
+*******************************************************************************/
+void PredictiveController::ballHit()
+{
+	if (random == NULL) return;
+	offset = difficulty->randomOffset(*random);
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Works out the height at which a ball will reach the
+ *		face of a paddle, from the ball's path alone. The ball's center runs
+ *		between two lines a half ball inside the walls, so its height is
+ *		found as if there were no walls and then folded back into that band:
+ *		a span of twice the band's height repeats, and the second half of
+ *		each span runs back down. A ball that isn't coming toward the paddle
+ *		is met in the middle.
+ *
+ * @param[in]	ball - The ball.
+ * @param[in]	paddle - The paddle, either one of the ball's game.
+ *
+ * @returns Height of the ball's center as it reaches the paddle.
+*******************************************************************************/
+double PredictiveController::crossingHeight(Ball* ball, Paddle* paddle)
+{
+	BallArena arena;
+	ball->getArena(arena);
+
+	double bottom = arena.bottom + ball->width / 2;
+	double top = arena.top - ball->width / 2;
+	double dx = ball->x_velocity * ball->s_velocity;
+	double dy = ball->y_velocity * ball->s_velocity;
+	bool right = paddle == ball->game->getRightPaddle();
+
+	if (top <= bottom) return bottom;
+	if ((right && dx <= 0) || (!right && dx >= 0)) return (top + bottom) / 2;
+
+	// Where the ball's center is when its leading edge touches the face
+	double x = right ? arena.right_x - arena.right_width / 2 - ball->width / 2
+		: arena.left_x + arena.left_width / 2 + ball->width / 2;
+	double y = ball->path.y + dy * ((x - ball->path.x) / dx);
+
+	double span = top - bottom;
+	double folded = fmod(y - bottom, 2 * span);
+	if (folded < 0) folded += 2 * span;
+	return folded <= span ? bottom + folded : bottom + 2 * span - folded;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Gets where the paddle is headed. Where the ball will
+ *		reach the paddle only changes when the ball's path does, so it is
+ *		kept along with the path it was worked out from and only worked out
+ *		again on a serve, a bounce off a wall or paddle, or a change of speed.
+ *		Since it depends on nothing but the path, working it out again after
+ *		setState() gives the same answer to the last bit.
+ *
+ * @returns Height to move the center of the paddle to.
+*******************************************************************************/
+double PredictiveController::target()
+{
+	if (!aimed || ball->path.x != aim_path_x || ball->path.y != aim_path_y
+		|| ball->path.t != aim_path_t || ball->x_velocity != aim_x_velocity
+		|| ball->y_velocity != aim_y_velocity
+		|| ball->s_velocity != aim_s_velocity)
+	{
+		aim_y = crossingHeight(ball, paddle);
+		aim_path_x = ball->path.x;
+		aim_path_y = ball->path.y;
+		aim_path_t = ball->path.t;
+		aim_x_velocity = ball->x_velocity;
+		aim_y_velocity = ball->y_velocity;
+		aim_s_velocity = ball->s_velocity;
+		aimed = true;
+	}
+
+	// Paddles change size, so keep the paddle in bounds as of now
+	double y = aim_y - offset;
+	double highest = paddle->getHighestY();
+	double lowest = paddle->getLowestY();
+	if (y > highest) y = highest;
+	if (y < lowest) y = lowest;
+	return y;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Moves the paddle toward where the ball will cross it.
+ *		If the paddle can get there this step it goes straight there,
+ *		otherwise it moves toward it at full speed. A run at full speed is
+ *		worked out from where and when it started, as AIController does, so
+ *		that skip() can land on any step of it.
+*******************************************************************************/
+void PredictiveController::step()
+{
+	steps++;
+
+	if (ball != NULL)		// This is entirely a possibility
+	{
+		double to = target();
+		double y = paddle->getY();
+		double speed = paddle->getVerticalSpeed();
+		int direction = 0;
+
+		if (to - y > speed)
+		{
+			direction = 1;
+		}
+		else if (y - to > speed)
+		{
+			direction = -1;
+		}
+
+		if (direction == 0)
+		{
+			paddle->verticalPosition(to);
+		}
+		else
+		{
+			// Start a new run unless carrying on with the last one unchanged
+			if (direction != chase || y != chase_to || speed != chase_speed)
+			{
+				chase_y = y;
+				chase_step = steps - 1;
+				chase_speed = speed;
+			}
+			chase_to = chase_y
+				+ direction * speed * (double) (steps - chase_step);
+			paddle->verticalPosition(chase_to);
+		}
+		chase = direction;
+	}
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Counts how many of the coming steps the paddle surely
+ *		keeps doing what it did last step: waiting where the ball will be, or
+ *		running there at full speed. Assumes the ball carries on along its
+ *		path without bouncing for at least that many steps, so where the
+ *		paddle is headed stays put. Errs on the short side near the end of a
+ *		run, so that rounding can never make step() do something else.
+ *
+ * @param[in]	limit - Most steps to count.
+ *
+ * @returns Number of steps, up to limit, that skip() may be given.
+*******************************************************************************/
+long PredictiveController::quietSteps(long limit)
+{
+	if (ball == NULL) return limit;
+
+	const double margin = 1e-6;
+	double to = target();
+	double y = paddle->getY();
+	double speed = paddle->getVerticalSpeed();
+
+	if (chase == 0)
+	{
+		// Waiting, as long as it's already there
+		return y == to ? limit : 0;
+	}
+	if (speed != chase_speed || y != chase_to) return 0;
+
+	// Running at full speed, as long as it doesn't get within a step of it
+	double gap = chase * (to - y) - margin;
+	if (gap <= speed) return 0;
+	double steps = min((double) limit, floor(gap / speed));
+	return steps < 0 ? 0 : (long) steps;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Moves the paddle to where it would be after the given
+ *		number of steps, without taking them one at a time. Only valid for as
+ *		many steps as quietSteps() allows, and only once the ball has been
+ *		moved along to the same step.
+ *
+ * @param[in]	steps - Number of steps to skip.
+*******************************************************************************/
+void PredictiveController::skip(long steps)
+{
+	if (steps <= 0 || ball == NULL) return;
+	this -> steps += steps;
+
+	if (chase == 0)
+	{
+		paddle->verticalPosition(target());
+	}
+	else
+	{
+		chase_to = chase_y
+			+ chase * chase_speed * (double) (this -> steps - chase_step);
+		paddle->verticalPosition(chase_to);
+	}
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Copies everything the AI remembers from step to step
+ *		into a ControllerState. Where the ball will be isn't copied, since
+ *		it is worked out again from the ball.
+ *
+ * @param[out]	state - Where to copy it.
+*******************************************************************************/
+void PredictiveController::getState(ControllerState& state)
+{
+	state.offset = offset;
+	state.chase_y = chase_y;
+	state.chase_speed = chase_speed;
+	state.chase_to = chase_to;
+	state.steps = steps;
+	state.chase_step = chase_step;
+	state.chase = chase;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Puts back what getState() copied.
+ *
+ * @param[in]	state - What to put back.
+*******************************************************************************/
+void PredictiveController::setState(const ControllerState& state)
+{
+	offset = state.offset;
+	chase_y = state.chase_y;
+	chase_speed = state.chase_speed;
+	chase_to = state.chase_to;
+	steps = (long) state.steps;
+	chase_step = (long) state.chase_step;
+	chase = state.chase;
+	aimed = false;
+}
@@ -0,0 +1,135 @@
+/***************************************************************************//**
+ * @file File containing the declaration for the PredictiveController class.
+ *
+ * @brief Contains the declaration for the PredictiveController class.
+*******************************************************************************/
+#ifndef _PREDICTIVECONTROLLER_H_
+#define _PREDICTIVECONTROLLER_H_
+
+/*******************************************************************************
+ *                 DECLARATIONS, INCLUDES, AND NAMESPACES
+*******************************************************************************/
+class PredictiveController;
+
+#include "PaddleController.h"
+#include "Paddle.h"
+#include "Ball.h"
+#include "PongRandom.h"
+#include "Difficulty.h"
+
+/***************************************************************************//**
+ * @brief The PredictiveController class moves a pong paddle to where the ball
+ *		will cross it, rather than to where the ball is.
+ *
+ * @details Works out where the ball will reach the face of its paddle
+ *		straight from the ball's path, folding the ball's height back and
+ *		forth between the top and bottom walls instead of following it from
+ *		bounce to bounce, so it takes the same time however many bounces
+ *		there are. The answer only changes when the ball's path does, on a
+ *		serve or a bounce, so it is worked out then and kept until the next
+ *		one. While the ball heads the other way the paddle waits in the
+ *		middle. Like AIController, it picks a random offset every hit to
+ *		switch up the game.
+*******************************************************************************/
+class PredictiveController : public PaddleController
+{
+	private:
+		Paddle* paddle;		/*!< Pointer to paddle under AI control */
+		Ball* ball;			/*!< Pointer to ball to watch */
+		PongRandom* random;	/*!< Where random offsets are drawn from */
+		const Difficulty* difficulty;	/*!< How offsets are picked */
+		double offset;		/*!< Random offset to align the ball with */
+		long steps;			/*!< Number of steps taken */
+		int chase;			/*!< Direction the paddle was last moved at full
+								speed, 1 up, -1 down, 0 if it wasn't */
+		double chase_y;		/*!< Where the paddle started moving at full
+								speed from */
+		long chase_step;	/*!< Step it started moving at full speed on */
+		double chase_speed;	/*!< Speed it started moving at */
+		double chase_to;	/*!< Where the paddle was last sent at full
+								speed */
+		bool aimed;			/*!< True if aim_y goes with the ball's path */
+		double aim_path_x;	/*!< Start of the ball's path aim_y was worked
+								out from */
+		double aim_path_y;	/*!< Start of the ball's path aim_y was worked
+								out from */
+		double aim_path_t;	/*!< Step the ball's path aim_y was worked out
+								from starts on */
+		double aim_x_velocity;	/*!< Ball's x speed aim_y was worked out from */
+		double aim_y_velocity;	/*!< Ball's y speed aim_y was worked out from */
+		double aim_s_velocity;	/*!< Ball's speed modifier aim_y was worked
+									out from */
+		double aim_y;		/*!< Where to meet the ball, before the offset */
+
+		/*!
+		 * @brief Gets where the paddle is headed, working it out again only
+		 *		if the ball's path has changed.
+		 */
+		double target();
+
+	public:
+		/*!
+		 * @brief The constructor. Initializes variables.
+		 */
+		PredictiveController(Paddle* paddle, Ball* ball, PongRandom* random,
+			const Difficulty* difficulty);
+
+		/*!
+		 * @brief Works out where a ball will reach a paddle from its path.
+		 */
+		static double crossingHeight(Ball* ball, Paddle* paddle);
+
+		/*!
+		 * @brief Does nothing; fulfulls superclass requirements
+		 */
+		void keyDown(unsigned char key);
+
+		/*!
+		 * @brief Does nothing; fulfulls superclass requirements
+		 */
+		void keyUp(unsigned char key);
+
+		/*!
+		 * @brief Does nothing; fulfulls superclass requirements
+		 */
+		void keySpecialDown(int key);
+
+		/*!
+		 * @brief Does nothing; fulfulls superclass requirements
+		 */
+		void keySpecialUp(int key);
+
+		/*!
+		 * @brief Randomizes offset to align the ball with
+		 */
+		void ballHit();
+
+		/*!
+		 * @brief Moves the paddle a little closer to where the ball will be.
+		 */
+		void step();
+
+		/*!
+		 * @brief Counts the steps ahead in which the paddle surely keeps
+		 *		doing what it's doing.
+		 */
+		long quietSteps(long limit);
+
+		/*!
+		 * @brief Moves the paddle to where a number of steps would.
+		 */
+		void skip(long steps);
+
+		/*!
+		 * @brief Copies the offset and run at full speed into a
+		 *		ControllerState.
+		 */
+		void getState(ControllerState& state);
+
+		/*!
+		 * @brief Puts back what getState() copied.
+		 */
+		void setState(const ControllerState& state);
+};
+
+#endif
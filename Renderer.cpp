@@ -0,0 +1,343 @@
+/***************************************************************************//**
+ * @file File containing the implementation of the Renderer class.
+ *
+ * @brief Contains the implementation for the Renderer class.
+*******************************************************************************/
+
+/*******************************************************************************
+ *                 DECLARATIONS, INCLUDES, AND NAMESPACES
+*******************************************************************************/
+#define GL_GLEXT_PROTOTYPES
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+#include <cstddef>
+#include <GL/freeglut.h>
+#include <GL/glext.h>
+#include "Renderer.h"
+
+/*******************************************************************************
+ *                          FUNCTION DEFINITIONS
+*******************************************************************************/
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: The constructor. Starts out drawing in white, batching
+ *		shapes once init() finds vertex buffers, and printing nothing.
+*******************************************************************************/
+Renderer::Renderer() :
+red(1), green(1), blue(1), immediate(false), stats(false), buffer(0),
+calls(0), immediate_calls(0), total_calls(0), total_immediate_calls(0),
+frames(0), reported(chrono::steady_clock::now())
+{ }
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Chooses to draw every shape as it comes, the way the
+ *		game always has, to compare against. Takes effect at init().
+ *
+ * @param[in]	immediate - True to draw shapes as they come.
+*******************************************************************************/
+void Renderer::setImmediate(bool immediate)
+{
+	this -> immediate = immediate;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Chooses to print the calls made per frame, on average,
+ *		once a second.
+ *
+ * @param[in]	stats - True to print them.
+*******************************************************************************/
+void Renderer::setStats(bool stats)
+{
+	this -> stats = stats;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Makes the vertex buffer. Must be called once there is a
+ *		window to draw in. Falls back on drawing every shape as it comes if
+ *		the OpenGL in use is older than 1.5.
+*******************************************************************************/
+void Renderer::init()
+{
+	const char* version = (const char*) glGetString(GL_VERSION);
+	double number = version != NULL ? atof(version) : 0;
+	if (number < 1.5) immediate = true;
+	if (immediate) return;
+
+	glGenBuffers(1, &buffer);
+	if (buffer == 0) immediate = true;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Gets ready to draw a frame. Binds the vertex buffer and
+ *		points OpenGL at where corners and colors sit in it. The places stay
+ *		good however often flush() fills the buffer again.
+*******************************************************************************/
+void Renderer::beginFrame()
+{
+	calls = 0;
+	immediate_calls = 0;
+	red = green = blue = 1;
+	vertices.clear();
+	if (immediate) return;
+
+	glBindBuffer(GL_ARRAY_BUFFER, buffer);
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glEnableClientState(GL_COLOR_ARRAY);
+	glVertexPointer(2, GL_FLOAT, sizeof(RenderVertex),
+		(const GLvoid*) offsetof(RenderVertex, x));
+	glColorPointer(3, GL_FLOAT, sizeof(RenderVertex),
+		(const GLvoid*) offsetof(RenderVertex, red));
+	calls += 5;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Sets the color of the shapes that follow, as glColor3d()
+ *		does.
+ *
+ * @param[in]	red - Red part of the color, 0 to 1.
+ * @param[in]	green - Green part of the color, 0 to 1.
+ * @param[in]	blue - Blue part of the color, 0 to 1.
+*******************************************************************************/
+void Renderer::color(double red, double green, double blue)
+{
+	this -> red = (float) red;
+	this -> green = (float) green;
+	this -> blue = (float) blue;
+	immediate_calls++;
+	if (!immediate) return;
+
+	glColor3d(red, green, blue);
+	calls++;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Adds a rectangle between two opposite corners, as
+ *		glRectd() draws, as two triangles.
+ *
+ * @param[in]	x1 - Horizontal position of one corner.
+ * @param[in]	y1 - Vertical position of one corner.
+ * @param[in]	x2 - Horizontal position of the opposite corner.
+ * @param[in]	y2 - Vertical position of the opposite corner.
+*******************************************************************************/
+void Renderer::rect(double x1, double y1, double x2, double y2)
+{
+	immediate_calls++;
+	if (immediate)
+	{
+		glRectd(x1, y1, x2, y2);
+		calls++;
+		return;
+	}
+
+	RenderVertex a = { (float) x1, (float) y1, red, green, blue };
+	RenderVertex b = { (float) x2, (float) y1, red, green, blue };
+	RenderVertex c = { (float) x2, (float) y2, red, green, blue };
+	RenderVertex d = { (float) x1, (float) y2, red, green, blue };
+	vertices.push_back(a);
+	vertices.push_back(b);
+	vertices.push_back(c);
+	vertices.push_back(a);
+	vertices.push_back(c);
+	vertices.push_back(d);
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Adds rectangles worked out ahead of time, such as the
+ *		letters PongText lays out once, in the current color and in order.
+ *
+ * @param[in]	list - The rectangles.
+*******************************************************************************/
+void Renderer::rects(const vector<RenderRect>& list)
+{
+	for (const RenderRect& r : list)
+	{
+		rect(r.x1, r.y1, r.x2, r.y2);
+	}
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Gets the mesh for a disk of the given size, cutting it
+ *		into triangles the first time it's asked for. The corners go around
+ *		clockwise from the top, as gluDisk() puts them.
+ *
+ * @param[in]	radius - Radius of the disk.
+ * @param[in]	slices - Number of triangles around the center.
+ *
+ * @returns The mesh, good until the next new disk is cut.
+*******************************************************************************/
+DiskMesh& Renderer::diskMesh(double radius, int slices)
+{
+	for (DiskMesh& mesh : meshes)
+	{
+		if (mesh.radius == radius && mesh.slices == slices) return mesh;
+	}
+
+	DiskMesh mesh;
+	mesh.radius = radius;
+	mesh.slices = slices;
+	mesh.list = 0;
+	for (int i = 0; i <= slices; i++)
+	{
+		double angle = 2 * M_PI * (i % slices) / slices;
+		mesh.ring.push_back((float) (radius * sin(angle)));
+		mesh.ring.push_back((float) (radius * cos(angle)));
+	}
+	meshes.push_back(mesh);
+	return meshes.back();
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Adds a filled circle, as gluDisk() draws with no hole,
+ *		as a fan of triangles around its center. Every disk of the same size
+ *		is a copy of one mesh moved into place. Drawing one shape at a time,
+ *		the mesh is a display list made once, instead of a new quadric each
+ *		time. Either way the disk counts as the six calls the game always
+ *		drew it with toward getImmediateCalls().
+ *
+ * @param[in]	x - Horizontal position of the center.
+ * @param[in]	y - Vertical position of the center.
+ * @param[in]	radius - Radius of the circle.
+ * @param[in]	slices - Number of triangles around the center.
+*******************************************************************************/
+void Renderer::disk(double x, double y, double radius, int slices)
+{
+	// The way the game always drew one: push, translate, new quadric, disk,
+	// delete quadric, pop
+	immediate_calls += 6;
+	if (slices < 3) slices = 3;
+	DiskMesh& mesh = diskMesh(radius, slices);
+	if (immediate)
+	{
+		if (mesh.list == 0)
+		{
+			mesh.list = glGenLists(1);
+			GLUquadricObj* quadric = gluNewQuadric();
+			glNewList(mesh.list, GL_COMPILE);
+			gluDisk(quadric, 0, radius, slices, 1);
+			glEndList();
+			gluDeleteQuadric(quadric);
+			calls += 6;
+		}
+		glPushMatrix();
+		glTranslated(x, y, 0);
+		glCallList(mesh.list);
+		glPopMatrix();
+		calls += 4;		// Push, translate, call list, pop
+		return;
+	}
+
+	RenderVertex center = { (float) x, (float) y, red, green, blue };
+	RenderVertex corner = center;
+	const float* ring = &mesh.ring[0];
+	for (int i = 0; i < slices; i++)
+	{
+		vertices.push_back(center);
+		corner.x = center.x + ring[i * 2];
+		corner.y = center.y + ring[i * 2 + 1];
+		vertices.push_back(corner);
+		corner.x = center.x + ring[i * 2 + 2];
+		corner.y = center.y + ring[i * 2 + 3];
+		vertices.push_back(corner);
+	}
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Draws every shape added since the last flush, in the
+ *		order they were added, by filling the vertex buffer with them and
+ *		drawing all of its triangles. The array is kept for the next layer,
+ *		so it only grows until it holds the biggest layer.
+*******************************************************************************/
+void Renderer::flush()
+{
+	if (immediate || vertices.empty()) return;
+
+	glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(RenderVertex),
+		&vertices[0], GL_STREAM_DRAW);
+	glDrawArrays(GL_TRIANGLES, 0, (GLsizei) vertices.size());
+	calls += 2;
+	vertices.clear();
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Finishes a frame. Draws anything not yet flushed, puts
+ *		the buffer back, and, if asked to, prints the calls made per frame
+ *		once a second.
+*******************************************************************************/
+void Renderer::endFrame()
+{
+	if (!immediate)
+	{
+		flush();
+		glDisableClientState(GL_COLOR_ARRAY);
+		glDisableClientState(GL_VERTEX_ARRAY);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		calls += 3;
+	}
+
+	total_calls += calls;
+	total_immediate_calls += immediate_calls;
+	frames++;
+
+	chrono::steady_clock::time_point now = chrono::steady_clock::now();
+	if (now - reported < chrono::seconds(1)) return;
+	if (stats)
+	{
+		cerr << "GL calls per frame: " << total_calls / frames
+			<< (immediate ? " drawing shapes one at a time" : " batched")
+			<< ", " << total_immediate_calls / frames
+			<< " one at a time (" << frames << " frames)" << endl;
+	}
+	total_calls = 0;
+	total_immediate_calls = 0;
+	frames = 0;
+	reported = now;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Gets the calls made drawing the last frame.
+ *
+ * @returns Number of calls into OpenGL and GLU.
+*******************************************************************************/
+long Renderer::getCalls()
+{
+	return calls;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Gets the calls drawing the last frame one shape at a
+ *		time would have made.
+ *
+ * @returns Number of calls into OpenGL and GLU.
+*******************************************************************************/
+long Renderer::getImmediateCalls()
+{
+	return immediate_calls;
+}
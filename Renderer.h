@@ -0,0 +1,183 @@
+/***************************************************************************//**
+ * @file File containing the declaration for the Renderer class.
+ *
+ * @brief Contains the declaration for the Renderer class, which gathers up
+ *		the rectangles and disks a frame is drawn with and hands them to
+ *		OpenGL a layer at a time.
+*******************************************************************************/
+#ifndef _RENDERER_H_
+#define _RENDERER_H_
+
+/*******************************************************************************
+ *                 DECLARATIONS, INCLUDES, AND NAMESPACES
+*******************************************************************************/
+class Renderer;
+
+#include <vector>
+#include <chrono>
+#include <GL/gl.h>
+
+using namespace std;
+
+/*!
+ * @brief A corner of a triangle, as the vertex buffer holds it
+ */
+struct RenderVertex
+{
+	float x;		/*!< Horizontal position in the virtual space */
+	float y;		/*!< Vertical position in the virtual space */
+	float red;		/*!< Red part of the color, 0 to 1 */
+	float green;	/*!< Green part of the color, 0 to 1 */
+	float blue;		/*!< Blue part of the color, 0 to 1 */
+};
+
+/*!
+ * @brief A rectangle between two opposite corners, as glRectd() takes it
+ */
+struct RenderRect
+{
+	double x1;		/*!< Horizontal position of one corner */
+	double y1;		/*!< Vertical position of one corner */
+	double x2;		/*!< Horizontal position of the opposite corner */
+	double y2;		/*!< Vertical position of the opposite corner */
+};
+
+/*!
+ * @brief A disk cut into triangles once, for Renderer::disk() to reuse
+ */
+struct DiskMesh
+{
+	double radius;			/*!< Radius the disk was cut at */
+	int slices;				/*!< Triangles around the center */
+	vector<float> ring;		/*!< Corners around the edge from the center,
+								x then y, the first one again at the end */
+	GLuint list;			/*!< Display list drawing it at the origin, 0
+								until drawn one shape at a time */
+};
+
+/***************************************************************************//**
+ * @brief The Renderer class draws the solid shapes of a frame: the paddles,
+ *		the ball, the border of the board, and the menus and their blocky
+ *		letters.
+ *
+ * @details Drawn one at a time, every rectangle of every letter is a call
+ *		into OpenGL of its own, and so is every change of color; each of the
+ *		ball's three disks takes six more: push, translate, new quadric,
+ *		disk, delete quadric, and pop. Instead, rect() and disk() turn each
+ *		shape into triangles in the color last given to color() and add them
+ *		to an array kept in main memory, and flush() copies the array into a
+ *		vertex buffer and draws all of it at once. Pong::display() flushes
+ *		after each layer, so layers still cover the ones under them, and
+ *		shapes within a layer are drawn in the order they were added. A
+ *		frame takes two calls for each layer that has something in it, plus
+ *		eight to set up and put back the buffer.
+ *
+ *		A disk is cut into triangles the first time one of its radius is
+ *		drawn and kept, so the ball and the two blurred copies behind it
+ *		are all copies of the same mesh, moved into place, and drawing them
+ *		allocates nothing and works out no sines or cosines.
+ *
+ *		OpenGL before 1.5 has no vertex buffers, so there, or when asked to
+ *		with setImmediate(), every shape is drawn at once with calls of its
+ *		own; a disk then draws a display list made the first time, in four
+ *		calls instead of six. The Renderer counts the calls it really makes
+ *		each frame, and apart from them the calls the game always drew the
+ *		same shapes with, six for a disk, and with setStats() prints both
+ *		once a second. Text drawn with GLUT's stroke font and the net are
+ *		drawn the same either way and are left out of both counts.
+*******************************************************************************/
+class Renderer
+{
+	private:
+		vector<RenderVertex> vertices;	/*!< Triangles not yet flushed */
+		vector<DiskMesh> meshes;	/*!< Every disk cut so far */
+		float red;				/*!< Red part of the current color */
+		float green;			/*!< Green part of the current color */
+		float blue;				/*!< Blue part of the current color */
+		bool immediate;			/*!< True to draw shapes as they come */
+		bool stats;				/*!< True to print the counts */
+		GLuint buffer;			/*!< Vertex buffer, 0 if none */
+		long calls;				/*!< Calls made this frame */
+		long immediate_calls;	/*!< Calls drawing shapes one at a time
+									would have made this frame */
+		long total_calls;		/*!< Calls made since the last report */
+		long total_immediate_calls;	/*!< Calls drawing one at a time would
+										have made since the last report */
+		long frames;			/*!< Frames drawn since the last report */
+		chrono::steady_clock::time_point reported;	/*!< When the counts were
+														last printed */
+
+		/*!
+		 * @brief Gets the mesh for a disk, cutting it if it's new.
+		 */
+		DiskMesh& diskMesh(double radius, int slices);
+
+	public:
+		/*!
+		 * @brief The constructor. Starts out drawing in white.
+		 */
+		Renderer();
+
+		/*!
+		 * @brief Chooses to draw every shape as it comes.
+		 */
+		void setImmediate(bool immediate);
+
+		/*!
+		 * @brief Chooses to print the calls made per frame.
+		 */
+		void setStats(bool stats);
+
+		/*!
+		 * @brief Makes the vertex buffer, once there is a window.
+		 */
+		void init();
+
+		/*!
+		 * @brief Gets ready to draw a frame.
+		 */
+		void beginFrame();
+
+		/*!
+		 * @brief Sets the color of the shapes that follow.
+		 */
+		void color(double red, double green, double blue);
+
+		/*!
+		 * @brief Adds a rectangle between two opposite corners.
+		 */
+		void rect(double x1, double y1, double x2, double y2);
+
+		/*!
+		 * @brief Adds rectangles worked out ahead of time.
+		 */
+		void rects(const vector<RenderRect>& list);
+
+		/*!
+		 * @brief Adds a filled circle.
+		 */
+		void disk(double x, double y, double radius, int slices);
+
+		/*!
+		 * @brief Draws every shape added since the last flush.
+		 */
+		void flush();
+
+		/*!
+		 * @brief Finishes a frame and counts its calls.
+		 */
+		void endFrame();
+
+		/*!
+		 * @brief Gets the calls made drawing the last frame.
+		 */
+		long getCalls();
+
+		/*!
+		 * @brief Gets the calls drawing the last frame one shape at a time
+		 *		would have made.
+		 */
+		long getImmediateCalls();
+};
+
+#endif
@@ -0,0 +1,708 @@
+/***************************************************************************//**
+ * @file File containing the implementation of the Replay class.
+ *
+ * @brief Contains the implementation for the Replay class.
+*******************************************************************************/
+
+/*******************************************************************************
+ *                 DECLARATIONS, INCLUDES, AND NAMESPACES
+*******************************************************************************/
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "Replay.h"
+
+/*!
+ * @brief First bytes of every replay file; the last one is the format version
+ */
+static const unsigned char replay_magic[8] =
+	{ 'P', 'O', 'N', 'G', 'R', 'P', 'L', 2 };
+
+/*!
+ * @brief Last bytes of a replay file that ends with a keyframe index
+ */
+static const unsigned char index_magic[8] =
+	{ 'P', 'R', 'P', 'L', 'I', 'N', 'D', 'X' };
+
+/*!
+ * @brief Size of what follows the index entries: the length of the replay,
+ *		where the index starts, how many entries it has, and index_magic
+ */
+static const size_t index_trailer = 32;
+
+/*******************************************************************************
+ *                          FUNCTION DEFINITIONS
+*******************************************************************************/
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: The constructor. Makes an empty replay that is neither
+ *		recording nor being read.
+*******************************************************************************/
+Replay::Replay() :
+written(0), write_tick(0), write_base(0), bytes(NULL), size(0),
+mapping(NULL), events_end(0), index_at(0), index_count(0), length(0),
+position(0), read_tick(0)
+{ }
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: The destructor. Finishes any file being recorded, index
+ *		and all, and unmaps any file being read.
+*******************************************************************************/
+Replay::~Replay()
+{
+	close();
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Writes out anything recorded but not yet written and the
+ *		keyframe index, then closes the file. Unmaps any file being read.
+*******************************************************************************/
+void Replay::close()
+{
+	if (file.is_open())
+	{
+		writeIndex();
+		flush();
+		file.close();
+	}
+	if (mapping != NULL)
+	{
+		munmap(mapping, size);
+		mapping = NULL;
+	}
+	bytes = NULL;
+	size = 0;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Starts recording to a file. Anything already in the file
+ *		is lost.
+ *
+ * @param[in]	path - File to record to.
+ *
+ * @returns True if the file could be opened, false if not.
+*******************************************************************************/
+bool Replay::create(const string& path)
+{
+	close();
+	file.open(path.c_str(), ios::out | ios::binary | ios::trunc);
+	if (!file) return false;
+
+	data.assign(replay_magic, replay_magic + sizeof(replay_magic));
+	written = 0;
+	write_tick = 0;
+	write_base = 0;
+	keyframes.clear();
+	flush();
+	return (bool) file;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Maps a replay file into memory, ready to be read from the
+ *		first event. Only the parts of the file actually read are ever
+ *		loaded. If the file has no keyframe index, it is read through once
+ *		to make one.
+ *
+ * @param[in]	path - File to read.
+ *
+ * @returns True if the file was mapped and is a replay, false if not.
+*******************************************************************************/
+bool Replay::load(const string& path)
+{
+	close();
+
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0) return false;
+
+	struct stat info;
+	if (fstat(fd, &info) != 0 || info.st_size < (off_t) sizeof(replay_magic))
+	{
+		::close(fd);
+		return false;
+	}
+	void* map = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+	if (map == MAP_FAILED) return false;
+
+	mapping = map;
+	bytes = (const unsigned char*) map;
+	size = info.st_size;
+	if (memcmp(bytes, replay_magic, sizeof(replay_magic)) != 0)
+	{
+		close();
+		return false;
+	}
+
+	// Use the index at the end of the file if there is a sensible one
+	events_end = size;
+	index_count = 0;
+	index_at = 0;
+	uint64_t total, at, count;
+	size_t trailer = size - index_trailer;
+	if (size >= sizeof(replay_magic) + index_trailer
+		&& memcmp(bytes + size - sizeof(index_magic), index_magic,
+			sizeof(index_magic)) == 0
+		&& getFixed(trailer, total, 8) && getFixed(trailer, at, 8)
+		&& getFixed(trailer, count, 8)
+		&& at >= sizeof(replay_magic) && at <= size - index_trailer
+		&& (size - index_trailer - at) % 16 == 0
+		&& count == (size - index_trailer - at) / 16)
+	{
+		events_end = at;
+		index_at = at;
+		index_count = (long) count;
+		length = (long) total;
+	}
+	else
+	{
+		buildIndex();
+	}
+
+	position = sizeof(replay_magic);
+	read_tick = 0;
+	return true;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Writes everything recorded so far out to the file and
+ *		lets go of it. Does nothing if not recording to a file.
+*******************************************************************************/
+void Replay::flush()
+{
+	if (!file.is_open() || data.empty()) return;
+
+	file.write((const char*) &data[0], data.size());
+	file.flush();
+	written += data.size();
+	data.clear();
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Records the start of a game. Events after this are
+ *		counted in steps from here.
+ *
+ * @param[in]	match - How the game starts.
+*******************************************************************************/
+void Replay::beginMatch(const ReplayMatch& match)
+{
+	putNumber(REPLAY_MATCH);
+	putFixed(match.width, 2);
+	putFixed(match.height, 2);
+	// Games with the AI that follows the ball, the only one there once was,
+	// don't say which AI plays
+	bool kinds = match.left_ai_kind != 0 || match.right_ai_kind != 0;
+	// Nor do games played at the difficulty the game has always had
+	const Difficulty& standard = Difficulty::standard;
+	bool tuned = match.difficulty.base_speed != standard.base_speed
+		|| match.difficulty.speed_per_point != standard.speed_per_point
+		|| match.difficulty.offset_count != standard.offset_count
+		|| match.difficulty.offset_spread != standard.offset_spread;
+	putFixed((match.left_ai ? 1 : 0) | (match.right_ai ? 2 : 0)
+		| (match.score_demo ? 4 : 0) | (kinds ? 8 : 0) | (tuned ? 16 : 0), 1);
+	if (kinds)
+	{
+		putFixed((match.left_ai_kind & 15) | (match.right_ai_kind & 15) << 4,
+			1);
+	}
+	if (tuned)
+	{
+		putDouble(match.difficulty.base_speed);
+		putDouble(match.difficulty.speed_per_point);
+		putFixed(match.difficulty.offset_count, 1);
+		putDouble(match.difficulty.offset_spread);
+	}
+	putFixed(match.random_state, 8);
+	putFixed(match.random_increment, 8);
+	write_tick = 0;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Records something happening in the current game.
+ *		Events must be recorded in the order they happen.
+ *
+ * @param[in]	type - What happened, a ReplayEventType other than
+ *				REPLAY_MATCH or REPLAY_END.
+ * @param[in]	tick - Steps into the game it happened after.
+ * @param[in]	input - OPTIONAL. For REPLAY_INPUT, the keys now held.
+*******************************************************************************/
+void Replay::addEvent(int type, long tick, unsigned char input)
+{
+	putNumber(((uint64_t) (tick - write_tick) << 3) | type);
+	if (type == REPLAY_INPUT)
+	{
+		putFixed(input, 1);
+	}
+	write_tick = tick;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Records the end of the current game along with its score,
+ *		so that playing it back can tell whether it came out the same, and
+ *		writes the game out to the file.
+ *
+ * @param[in]	tick - Steps the game lasted.
+ * @param[in]	left_score - Final score of the left side.
+ * @param[in]	right_score - Final score of the right side.
+*******************************************************************************/
+void Replay::endMatch(long tick, int left_score, int right_score)
+{
+	putNumber(((uint64_t) (tick - write_tick) << 3) | REPLAY_END);
+	putNumber(left_score);
+	putNumber(right_score);
+	write_tick = tick;
+	write_base += tick;
+	flush();
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Records the whole state of the current game, so that
+ *		playing back can start from here, and adds it to the index.
+ *
+ * @param[in]	tick - Steps into the game it was saved after.
+ * @param[in]	state - The state, which must hold no pointers.
+ * @param[in]	size - Size of the state in bytes.
+*******************************************************************************/
+void Replay::addKeyframe(long tick, const void* state, size_t size)
+{
+	keyframes.push_back(write_base + tick);
+	keyframes.push_back(written + data.size());
+
+	putNumber(REPLAY_KEYFRAME);
+	putNumber(tick);
+	putNumber(size);
+	data.insert(data.end(), (const unsigned char*) state,
+		(const unsigned char*) state + size);
+	write_tick = tick;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Writes the keyframe index after the last event: the step
+ *		and offset of every keyframe, then the length of the replay, where the
+ *		index starts, how many keyframes there are, and index_magic.
+*******************************************************************************/
+void Replay::writeIndex()
+{
+	uint64_t at = written + data.size();
+	for (size_t i = 0; i < keyframes.size(); i++)
+	{
+		putFixed(keyframes[i], 8);
+	}
+	putFixed(write_base, 8);
+	putFixed(at, 8);
+	putFixed(keyframes.size() / 2, 8);
+	data.insert(data.end(), index_magic, index_magic + sizeof(index_magic));
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Looks at the next event of a loaded replay without moving
+ *		past it.
+ *
+ * @param[out]	event - The next event.
+ *
+ * @returns True if there is another event, false at the end of the replay or
+ *		if the rest of it is damaged.
+*******************************************************************************/
+bool Replay::peekEvent(ReplayEvent& event)
+{
+	size_t at = position;
+	return readEvent(at, event);
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Reads the next event of a loaded replay.
+ *
+ * @param[out]	event - The next event.
+ *
+ * @returns True if there was another event, false at the end of the replay
+ *		or if the rest of it is damaged.
+*******************************************************************************/
+bool Replay::nextEvent(ReplayEvent& event)
+{
+	if (!readEvent(position, event)) return false;
+	read_tick = event.tick;
+	return true;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Determines if a loaded replay has been read to the end.
+ *
+ * @returns True if there is nothing left to read.
+*******************************************************************************/
+bool Replay::atEnd()
+{
+	return position >= events_end;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Moves reading to the last keyframe at or before a step
+ *		of the replay, counted from the start of the first game, and reads
+ *		it. Reading carries on from just after it. Finding it takes a binary
+ *		search of the index, which touches a handful of pages of the file.
+ *
+ * @param[in]	tick - Step to seek to.
+ * @param[out]	keyframe - The keyframe found.
+ * @param[out]	base - Steps in the games before the keyframe's game.
+ *
+ * @returns True if a keyframe was found, false if the replay has none at or
+ *		before tick or the index is damaged.
+*******************************************************************************/
+bool Replay::seek(long tick, ReplayEvent& keyframe, long& base)
+{
+	// Last keyframe at or before tick
+	long low = 0, high = index_count;
+	while (low < high)
+	{
+		long middle = low + (high - low) / 2;
+		uint64_t at_tick, offset;
+		if (!getKeyframe(middle, at_tick, offset)) return false;
+		if ((long) at_tick <= tick)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+	if (low == 0) return false;
+
+	uint64_t at_tick, offset;
+	if (!getKeyframe(low - 1, at_tick, offset)) return false;
+	size_t at = (size_t) offset;
+	if (!readEvent(at, keyframe) || keyframe.type != REPLAY_KEYFRAME)
+	{
+		return false;
+	}
+
+	position = at;
+	read_tick = keyframe.tick;
+	base = (long) at_tick - keyframe.tick;
+	return true;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Gets the number of steps in all the games of a loaded
+ *		replay together.
+ *
+ * @returns The length of the replay in steps.
+*******************************************************************************/
+long Replay::getLength()
+{
+	return length;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Gets an entry of the keyframe index, from the file if it
+ *		had one or from the one built by buildIndex() if not.
+ *
+ * @param[in]	i - Entry to get.
+ * @param[out]	tick - Step count since the start of the replay.
+ * @param[out]	offset - Where the keyframe starts in the file.
+ *
+ * @returns True if the entry was read, false if it is past the end of the
+ *		file.
+*******************************************************************************/
+bool Replay::getKeyframe(long i, uint64_t& tick, uint64_t& offset)
+{
+	if (index_at != 0)
+	{
+		size_t at = index_at + (size_t) i * 16;
+		if (!getFixed(at, tick, 8)) return false;
+		if (!getFixed(at, offset, 8)) return false;
+	}
+	else
+	{
+		tick = keyframes[2 * i];
+		offset = keyframes[2 * i + 1];
+	}
+	return true;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Builds the keyframe index and finds the length of a
+ *		loaded replay that has no index, by reading every event. Stops at the
+ *		first damaged event.
+*******************************************************************************/
+void Replay::buildIndex()
+{
+	keyframes.clear();
+	length = 0;
+	read_tick = 0;
+
+	long base = 0;
+	size_t at = sizeof(replay_magic);
+	ReplayEvent event;
+	while (true)
+	{
+		size_t start = at;
+		if (!readEvent(at, event)) break;
+		read_tick = event.tick;
+
+		if (event.type == REPLAY_KEYFRAME)
+		{
+			keyframes.push_back(base + event.tick);
+			keyframes.push_back(start);
+		}
+		if (event.type == REPLAY_END)
+		{
+			base += event.tick;
+			length = base;
+		}
+		else
+		{
+			length = base + event.tick;
+		}
+	}
+	index_count = (long) keyframes.size() / 2;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Gets the size of the replay: the whole file when
+ *		reading, everything recorded so far when recording.
+ *
+ * @returns Size in bytes.
+*******************************************************************************/
+size_t Replay::getSize()
+{
+	return bytes != NULL ? size : (size_t) (written + data.size());
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Adds a number to the recording seven bits to a byte, low
+ *		bits first, with the top bit of each byte set if more follow. Small
+ *		numbers, which most are, take a single byte.
+ *
+ * @param[in]	value - The number to add.
+*******************************************************************************/
+void Replay::putNumber(uint64_t value)
+{
+	while (value >= 0x80)
+	{
+		data.push_back((unsigned char) (value | 0x80));
+		value >>= 7;
+	}
+	data.push_back((unsigned char) value);
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Adds a number to the recording in a fixed number of
+ *		bytes, low byte first.
+ *
+ * @param[in]	value - The number to add.
+ * @param[in]	bytes - Number of bytes to use.
+*******************************************************************************/
+void Replay::putFixed(uint64_t value, int bytes)
+{
+	for (int i = 0; i < bytes; i++)
+	{
+		data.push_back((unsigned char) (value >> (8 * i)));
+	}
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Adds a floating point number to the recording, all
+ *		eight bytes of it, so it reads back exactly the same.
+ *
+ * @param[in]	value - The number to add.
+*******************************************************************************/
+void Replay::putDouble(double value)
+{
+	uint64_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	putFixed(bits, 8);
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Reads a number written by putNumber().
+ *
+ * @param[in,out]	at - Byte to read from; moved past the number.
+ * @param[out]		value - The number read.
+ *
+ * @returns True if a whole number was read, false if the data ran out.
+*******************************************************************************/
+bool Replay::getNumber(size_t& at, uint64_t& value)
+{
+	value = 0;
+	for (int shift = 0; shift < 64; shift += 7)
+	{
+		if (at >= events_end) return false;
+		unsigned char byte = bytes[at++];
+		value |= (uint64_t) (byte & 0x7F) << shift;
+		if (!(byte & 0x80)) return true;
+	}
+	return false;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Reads a number written by putFixed().
+ *
+ * @param[in,out]	at - Byte to read from; moved past the number.
+ * @param[out]		value - The number read.
+ * @param[in]		count - Number of bytes it takes.
+ *
+ * @returns True if the number was read, false if the file ran out.
+*******************************************************************************/
+bool Replay::getFixed(size_t& at, uint64_t& value, int count)
+{
+	if (at + count > size) return false;
+
+	value = 0;
+	for (int i = 0; i < count; i++)
+	{
+		value |= (uint64_t) bytes[at++] << (8 * i);
+	}
+	return true;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Reads a floating point number written by putDouble().
+ *
+ * @param[in,out]	at - Byte to read from; moved past the number.
+ * @param[out]		value - The number read.
+ *
+ * @returns True if the number was read, false if the file ran out.
+*******************************************************************************/
+bool Replay::getDouble(size_t& at, double& value)
+{
+	uint64_t bits;
+	if (!getFixed(at, bits, 8)) return false;
+	memcpy(&value, &bits, sizeof(value));
+	return true;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Reads one event and whatever it carries.
+ *
+ * @param[in,out]	at - Byte the event starts at; moved past the event.
+ * @param[out]		event - The event read.
+ *
+ * @returns True if a whole, sensible event was read, false if not.
+*******************************************************************************/
+bool Replay::readEvent(size_t& at, ReplayEvent& event)
+{
+	uint64_t head, value, flags;
+	if (!getNumber(at, head)) return false;
+
+	event.type = (int) (head & 7);
+	event.tick = (event.type == REPLAY_MATCH) ? 0
+		: read_tick + (long) (head >> 3);
+	event.keyframe = NULL;
+	event.keyframe_size = 0;
+
+	switch (event.type)
+	{
+		case REPLAY_MATCH:
+			if (!getFixed(at, value, 2)) return false;
+			event.match.width = (int) value;
+			if (!getFixed(at, value, 2)) return false;
+			event.match.height = (int) value;
+			if (!getFixed(at, value, 1)) return false;
+			event.match.left_ai = (value & 1) != 0;
+			event.match.right_ai = (value & 2) != 0;
+			event.match.score_demo = (value & 4) != 0;
+			event.match.left_ai_kind = 0;
+			event.match.right_ai_kind = 0;
+			event.match.difficulty = Difficulty::standard;
+			flags = value;
+			if ((flags & 8) != 0)
+			{
+				if (!getFixed(at, value, 1)) return false;
+				event.match.left_ai_kind = (int) (value & 15);
+				event.match.right_ai_kind = (int) (value >> 4);
+			}
+			if ((flags & 16) != 0)
+			{
+				if (!getDouble(at, event.match.difficulty.base_speed)
+					|| !getDouble(at, event.match.difficulty.speed_per_point)
+					|| !getFixed(at, value, 1)
+					|| !getDouble(at, event.match.difficulty.offset_spread))
+				{
+					return false;
+				}
+				if (value < 1 || value > 64) return false;
+				event.match.difficulty.offset_count = (int) value;
+			}
+			if (!getFixed(at, event.match.random_state, 8)) return false;
+			return getFixed(at, event.match.random_increment, 8);
+
+		case REPLAY_INPUT:
+			if (!getFixed(at, value, 1)) return false;
+			event.input = (unsigned char) value;
+			return true;
+
+		case REPLAY_SLOWER:
+		case REPLAY_FASTER:
+			return true;
+
+		case REPLAY_END:
+			if (!getNumber(at, value)) return false;
+			event.left_score = (int) value;
+			if (!getNumber(at, value)) return false;
+			event.right_score = (int) value;
+			return true;
+
+		case REPLAY_KEYFRAME:
+			if (!getNumber(at, value)) return false;
+			event.tick = (long) value;
+			if (!getNumber(at, value) || value > events_end - at)
+			{
+				return false;
+			}
+			event.keyframe = bytes + at;
+			event.keyframe_size = (size_t) value;
+			at += (size_t) value;
+			return true;
+
+		default:
+			return false;
+	}
+}
@@ -0,0 +1,252 @@
+/***************************************************************************//**
+ * @file File containing the declaration for the Replay class.
+ *
+ * @brief Contains the declaration for the Replay class, which reads and writes
+ *		recordings of games.
+*******************************************************************************/
+#ifndef _REPLAY_H_
+#define _REPLAY_H_
+
+/*******************************************************************************
+ *                 DECLARATIONS, INCLUDES, AND NAMESPACES
+*******************************************************************************/
+class Replay;
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <stdint.h>
+#include "Difficulty.h"
+
+using namespace std;
+
+/*!
+ * @brief Kinds of things recorded in a replay
+ */
+enum ReplayEventType
+{
+	REPLAY_MATCH = 0,	/*!< A game starts */
+	REPLAY_INPUT = 1,	/*!< The paddle keys being held changed */
+	REPLAY_SLOWER = 2,	/*!< The ball was slowed down */
+	REPLAY_FASTER = 3,	/*!< The ball was sped up */
+	REPLAY_END = 4,		/*!< The game ended */
+	REPLAY_KEYFRAME = 5	/*!< The whole state of the game */
+};
+
+/*!
+ * @brief Everything needed to start a recorded game the same way again
+ */
+struct ReplayMatch
+{
+	int width;					/*!< Width of the playing field */
+	int height;					/*!< Height of the playing field */
+	bool left_ai;				/*!< True if the left paddle was the AI's */
+	bool right_ai;				/*!< True if the right paddle was the AI's */
+	bool score_demo;			/*!< Whether AI vs AI games kept score */
+	int left_ai_kind;			/*!< AIKind of the left AI */
+	int right_ai_kind;			/*!< AIKind of the right AI */
+	Difficulty difficulty;		/*!< How hard the AIs were to beat */
+	uint64_t random_state;		/*!< Random number generator at the start */
+	uint64_t random_increment;	/*!< Random number stream at the start */
+};
+
+/*!
+ * @brief One thing recorded in a replay
+ */
+struct ReplayEvent
+{
+	int type;			/*!< What happened, a ReplayEventType */
+	long tick;			/*!< Steps into the game it happened after */
+	unsigned char input;	/*!< REPLAY_INPUT: keys held, see PongGame */
+	int left_score;		/*!< REPLAY_END: final score of the left side */
+	int right_score;	/*!< REPLAY_END: final score of the right side */
+	ReplayMatch match;	/*!< REPLAY_MATCH: how the game started */
+	const unsigned char* keyframe;	/*!< REPLAY_KEYFRAME: the state saved,
+										pointing into the replay */
+	size_t keyframe_size;	/*!< REPLAY_KEYFRAME: size of the state */
+};
+
+/***************************************************************************//**
+ * @brief The Replay class holds a recording of one or more games.
+ *
+ * @details A game is fully decided by how it starts and what keys were held
+ *		on each step, so that is all that is kept. Each game starts with a
+ *		REPLAY_MATCH record; after that only changes are written, each as a
+ *		single variable-length number holding the event type in its low three
+ *		bits and the steps since the last event above them, followed by any
+ *		data the event carries. Held keys take one byte, a bit per key. A
+ *		game without players is a few dozen bytes; a player who changes keys
+ *		twice a second adds about two bytes a second.
+ *
+ *		So that a replay can be started from anywhere without playing all of
+ *		it, every so often the whole state of the game is written as a
+ *		REPLAY_KEYFRAME, and when recording stops an index of the keyframes
+ *		is added to the end of the file. Keyframe ticks count steps from the
+ *		start of the game rather than from the last event, so reading can
+ *		start at any of them.
+ *
+ *		Replays are written to a file as they are recorded, flushed at the
+ *		end of each game. They are read by mapping the file into memory, so
+ *		seeking only touches the index and the part of the file played.
+ *		Files without an index, cut off by a crash, are indexed by reading
+ *		them through once.
+*******************************************************************************/
+class Replay
+{
+	private:
+		vector<unsigned char> data;	/*!< Bytes recorded but not yet written
+										out */
+		ofstream file;		/*!< File being recorded to */
+		uint64_t written;	/*!< Bytes written to the file so far */
+		long write_tick;	/*!< Tick of the last event recorded */
+		long write_base;	/*!< Steps in the games recorded before this
+								one */
+		vector<uint64_t> keyframes;	/*!< Step count since the start of the
+										replay and offset in the file of
+										each keyframe, one after the
+										other */
+
+		const unsigned char* bytes;	/*!< The replay being read */
+		size_t size;		/*!< Size of the replay being read */
+		void* mapping;		/*!< Where the file is mapped, NULL if not */
+		size_t events_end;	/*!< Where the events end and the index begins */
+		size_t index_at;	/*!< Where the index starts in bytes, if it was
+								in the file */
+		long index_count;	/*!< Number of keyframes in the index */
+		long length;		/*!< Steps in all the games together */
+		size_t position;	/*!< Where the next event is read from */
+		long read_tick;		/*!< Tick of the last event read */
+
+		/*!
+		 * @brief Adds a number to the recording, 7 bits to a byte
+		 */
+		void putNumber(uint64_t value);
+
+		/*!
+		 * @brief Adds a number to the recording in a fixed number of bytes
+		 */
+		void putFixed(uint64_t value, int bytes);
+
+		/*!
+		 * @brief Adds a floating point number to the recording
+		 */
+		void putDouble(double value);
+
+		/*!
+		 * @brief Reads a number written by putNumber()
+		 */
+		bool getNumber(size_t& at, uint64_t& value);
+
+		/*!
+		 * @brief Reads a number written by putFixed()
+		 */
+		bool getFixed(size_t& at, uint64_t& value, int count);
+
+		/*!
+		 * @brief Reads a number written by putDouble()
+		 */
+		bool getDouble(size_t& at, double& value);
+
+		/*!
+		 * @brief Reads the event starting at a given byte
+		 */
+		bool readEvent(size_t& at, ReplayEvent& event);
+
+		/*!
+		 * @brief Builds the keyframe index by reading through every event
+		 */
+		void buildIndex();
+
+		/*!
+		 * @brief Gets an entry of the keyframe index
+		 */
+		bool getKeyframe(long i, uint64_t& tick, uint64_t& offset);
+
+		/*!
+		 * @brief Writes the keyframe index to the end of the file
+		 */
+		void writeIndex();
+
+		/*!
+		 * @brief Stops recording and unmaps any file being read
+		 */
+		void close();
+
+	public:
+		/*!
+		 * @brief The constructor. Makes an empty replay
+		 */
+		Replay();
+
+		/*!
+		 * @brief The destructor. Finishes the file being recorded or read
+		 */
+		~Replay();
+
+		/*!
+		 * @brief Starts recording to a file
+		 */
+		bool create(const string& path);
+
+		/*!
+		 * @brief Maps a replay file in for reading
+		 */
+		bool load(const string& path);
+
+		/*!
+		 * @brief Writes out everything recorded so far
+		 */
+		void flush();
+
+		/*!
+		 * @brief Records the start of a game
+		 */
+		void beginMatch(const ReplayMatch& match);
+
+		/*!
+		 * @brief Records something happening in a game
+		 */
+		void addEvent(int type, long tick, unsigned char input = 0);
+
+		/*!
+		 * @brief Records the end of a game
+		 */
+		void endMatch(long tick, int left_score, int right_score);
+
+		/*!
+		 * @brief Records the whole state of the game
+		 */
+		void addKeyframe(long tick, const void* state, size_t size);
+
+		/*!
+		 * @brief Looks at the next event without moving past it
+		 */
+		bool peekEvent(ReplayEvent& event);
+
+		/*!
+		 * @brief Reads the next event
+		 */
+		bool nextEvent(ReplayEvent& event);
+
+		/*!
+		 * @brief Determines if every event has been read
+		 */
+		bool atEnd();
+
+		/*!
+		 * @brief Moves reading to the last keyframe at or before a step
+		 */
+		bool seek(long tick, ReplayEvent& keyframe, long& base);
+
+		/*!
+		 * @brief Gets the number of steps in all the games together
+		 */
+		long getLength();
+
+		/*!
+		 * @brief Gets the size of the replay in bytes
+		 */
+		size_t getSize();
+};
+
+#endif
@@ -0,0 +1,456 @@
+/***************************************************************************//**
+ * @file File containing the implementation of the RollbackSession class.
+ *
+ * @brief Contains the implementation for the RollbackSession class.
+*******************************************************************************/
+
+/*******************************************************************************
+ *                 DECLARATIONS, INCLUDES, AND NAMESPACES
+*******************************************************************************/
+#include "RollbackSession.h"
+
+/*!
+ * @brief Most steps of keys sent in one packet
+ */
+static const long max_inputs = 64;
+
+/*!
+ * @brief Seconds between hellos while waiting for the host to answer
+ */
+static const double hello_interval = 0.1;
+
+/*******************************************************************************
+ *                          FUNCTION DEFINITIONS
+*******************************************************************************/
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Writes a number to a packet, least significant byte
+ *		first.
+ *
+ * @param[out]	at - Where to write it.
+ * @param[in]	value - The number.
+ * @param[in]	bytes - Number of bytes it takes.
+*******************************************************************************/
+static void put_number(unsigned char* at, uint64_t value, int bytes)
+{
+	for (int i = 0; i < bytes; i++)
+	{
+		at[i] = (unsigned char) (value >> (8 * i));
+	}
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Reads a number written by put_number().
+ *
+ * @param[in]	at - Where to read it from.
+ * @param[in]	bytes - Number of bytes it takes.
+ *
+ * @returns The number.
+*******************************************************************************/
+static uint64_t get_number(const unsigned char* at, int bytes)
+{
+	uint64_t value = 0;
+	for (int i = 0; i < bytes; i++)
+	{
+		value |= (uint64_t) at[i] << (8 * i);
+	}
+	return value;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: The constructor. Sets up a session on a link that is
+ *		already listening, for the host, or connected, for the side that
+ *		joins. Nothing is sent until the first call to poll() or advance().
+ *
+ * @param[in]	game - Game to play. Any game going is ended when the session
+ *				starts.
+ * @param[in]	link - Open link to the other side.
+ * @param[in]	host - True to host and play left, false to join and play
+ *				right.
+ * @param[in]	seed - OPTIONAL. Seed of the game, if hosting. The side that
+ *				joins gets the host's.
+ * @param[in]	window - OPTIONAL. Most steps to guess ahead of the other
+ *				side, 30 (half a second) by default.
+*******************************************************************************/
+RollbackSession::RollbackSession(PongGame* game, NetLink* link, bool host,
+	uint64_t seed, long window) :
+game(game), link(link), host(host), started(false), seed(seed),
+window(window > 1 ? window : 1), tick(0), confirmed(0), acked(0),
+rollback_from(0), remote_tick(0), remote_advantage(0), rollbacks(0),
+resimulated(0), longest_rollback(0), waits(0)
+{
+	states.resize(this -> window + 1);
+	last_received = chrono::steady_clock::now();
+	last_hello = last_received - chrono::seconds(1);
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Starts the game both sides play: a new versus game from
+ *		the seed the host picked.
+ *
+ * @param[in]	seed - Seed of the game.
+*******************************************************************************/
+void RollbackSession::startMatch(uint64_t seed)
+{
+	this -> seed = seed;
+	started = true;
+	game->quitGame();
+	game->setSeed(seed);
+	game->startGame(false, false);
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Keeps up with the other side while not playing steps:
+ *		reads what has arrived, rolls back if it needs to, and sends the
+ *		other side what it is missing.
+*******************************************************************************/
+void RollbackSession::poll()
+{
+	update();
+	if (started) sendInputs();
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Reads everything that has arrived from the other side.
+ *		If any of the other player's keys turn out not to be what was
+ *		guessed, the game is put back to the first step that was wrong and
+ *		played forward again to where it was. Until the game starts, keeps
+ *		asking the host to start it.
+*******************************************************************************/
+void RollbackSession::update()
+{
+	unsigned char packet[256];
+	long size;
+	while ((size = link->receive(packet, sizeof(packet))) >= 0)
+	{
+		readPacket(packet, size);
+	}
+
+	if (!started)
+	{
+		chrono::steady_clock::time_point now = chrono::steady_clock::now();
+		if (!host && chrono::duration<double>(now - last_hello).count()
+			>= hello_interval)
+		{
+			unsigned char hello[] = { NET_HELLO, 'P', 'N', 'G', 1 };
+			link->send(hello, sizeof(hello));
+			last_hello = now;
+		}
+		return;
+	}
+
+	// Play again from the first step that was guessed wrong
+	if (rollback_from < tick)
+	{
+		long depth = tick - rollback_from;
+		game->restoreState(states[rollback_from % states.size()]);
+		for (long step = rollback_from; step < tick; step++)
+		{
+			simulate(step);
+		}
+		rollbacks++;
+		resimulated += depth;
+		if (depth > longest_rollback) longest_rollback = depth;
+	}
+	rollback_from = tick;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Plays the next step with the keys the local player is
+ *		holding, guessing at the other player's. Waits instead if the other
+ *		side is too far behind to guess for, or further behind than this
+ *		side is from its point of view.
+ *
+ * @returns True if a step was played, false if waiting.
+*******************************************************************************/
+bool RollbackSession::advance()
+{
+	// The keys held now, before rolling back puts older ones on the paddles
+	unsigned char input = game->getInput();
+	unsigned char keys = host ? (input & 15) : (input >> 4);
+
+	update();
+	if (!started) return false;
+
+	// Wait when too far ahead to guess, or further ahead than the other side
+	long advantage = tick - remote_tick;
+	if (tick - confirmed >= window
+		|| (advantage - remote_advantage >= 2 && tick % 4 == 0))
+	{
+		waits++;
+		sendInputs();
+		return false;
+	}
+
+	local_keys.push_back(keys);
+	simulate(tick);
+	tick++;
+	rollback_from = tick;
+	sendInputs();
+	return true;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Saves the game as it is before a step, then plays the
+ *		step with the local player's keys and the other player's, or the
+ *		last keys they were known to hold if theirs haven't arrived yet.
+ *
+ * @param[in]	step - The step to play. The game must be just before it.
+*******************************************************************************/
+void RollbackSession::simulate(long step)
+{
+	game->saveState(states[step % states.size()]);
+
+	unsigned char remote = 0;
+	if (step < confirmed)
+		remote = remote_keys[step];
+	else if (confirmed > 0)
+		remote = remote_keys[confirmed - 1];
+	if (step < (long) used_keys.size())
+		used_keys[step] = remote;
+	else
+		used_keys.push_back(remote);
+
+	unsigned char local = local_keys[step];
+	game->setInput(host ? (local | remote << 4) : (remote | local << 4));
+	game->step();
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Reads one packet from the other side. The host answers
+ *		hellos with the seed, starting the game the first time; the side
+ *		that joins starts when the answer comes. Keys are taken in step
+ *		order, and the first step whose keys were guessed wrong is noted for
+ *		poll() to roll back to.
+ *
+ * @param[in]	packet - The packet.
+ * @param[in]	size - Size of the packet in bytes.
+*******************************************************************************/
+void RollbackSession::readPacket(const unsigned char* packet, long size)
+{
+	if (size < 1) return;
+	last_received = chrono::steady_clock::now();
+
+	if (packet[0] == NET_HELLO && host)
+	{
+		if (!started) startMatch(seed);
+
+		unsigned char start[9];
+		start[0] = NET_START;
+		put_number(start + 1, seed, 8);
+		link->send(start, sizeof(start));
+		return;
+	}
+	if (packet[0] == NET_START && !host && size >= 9)
+	{
+		if (!started) startMatch(get_number(packet + 1, 8));
+		return;
+	}
+	if (packet[0] != NET_INPUT || !started || size < 14) return;
+
+	long ack = (long) get_number(packet + 1, 4);
+	long first = (long) get_number(packet + 5, 4);
+	long count = (long) packet[13];
+	if (ack > acked) acked = ack;
+	if (first + count > remote_tick)
+	{
+		remote_tick = first + count;
+		remote_advantage = (int32_t) get_number(packet + 9, 4);
+	}
+	if (size < 14 + count) return;
+
+	for (long i = 0; i < count; i++)
+	{
+		long step = first + i;
+		if (step < confirmed) continue;
+		if (step > confirmed) break;
+
+		unsigned char keys = packet[14 + i] & 15;
+		remote_keys.push_back(keys);
+		confirmed++;
+		if (step < tick && used_keys[step] != keys && step < rollback_from)
+		{
+			rollback_from = step;
+		}
+	}
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Sends the other side the local player's keys on every
+ *		step it hasn't said it has, along with how many of its steps have
+ *		arrived here and how far ahead this side is.
+*******************************************************************************/
+void RollbackSession::sendInputs()
+{
+	unsigned char packet[14 + max_inputs];
+	long count = tick - acked;
+	if (count > max_inputs) count = max_inputs;
+
+	packet[0] = NET_INPUT;
+	put_number(packet + 1, confirmed, 4);
+	put_number(packet + 5, acked, 4);
+	put_number(packet + 9, (uint32_t) (int32_t) (tick - remote_tick), 4);
+	packet[13] = (unsigned char) count;
+	for (long i = 0; i < count; i++)
+	{
+		packet[14 + i] = local_keys[acked + i];
+	}
+	link->send(packet, 14 + count);
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Determines if both sides have started the game.
+ *
+ * @returns True once the seed is agreed on.
+*******************************************************************************/
+bool RollbackSession::isStarted()
+{
+	return started;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Determines if both sides have each other's keys for
+ *		every step played here and this side has been rolled back to match.
+ *		Once both sides are synchronized at the same step, their games are
+ *		the same to the bit.
+ *
+ * @returns True if nothing played here was guessed.
+*******************************************************************************/
+bool RollbackSession::isSynchronized()
+{
+	return started && confirmed >= tick && acked >= tick
+		&& rollback_from == tick;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Determines if nothing has arrived from the other side
+ *		for a while.
+ *
+ * @param[in]	seconds - OPTIONAL. How long is too long, 5 by default.
+ *
+ * @returns True if the other side has been quiet that long.
+*******************************************************************************/
+bool RollbackSession::hasTimedOut(double seconds)
+{
+	return chrono::duration<double>(chrono::steady_clock::now()
+		- last_received).count() > seconds;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Determines which paddle this side plays.
+ *
+ * @returns True for the right paddle, false for the left.
+*******************************************************************************/
+bool RollbackSession::isRight()
+{
+	return !host;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Gets the number of steps played.
+ *
+ * @returns Number of steps.
+*******************************************************************************/
+long RollbackSession::getTick()
+{
+	return tick;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Gets the keys both players held on a step whose keys
+ *		have arrived from the other side, packed like PongGame::getInput().
+ *
+ * @param[in]	step - The step.
+ *
+ * @returns The keys, or 0 if the step isn't confirmed.
+*******************************************************************************/
+unsigned char RollbackSession::getInput(long step)
+{
+	if (step < 0 || step >= confirmed || step >= tick) return 0;
+
+	unsigned char local = local_keys[step];
+	unsigned char remote = remote_keys[step];
+	return host ? (local | remote << 4) : (remote | local << 4);
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Gets the number of times the game was rolled back to
+ *		fix a wrong guess.
+ *
+ * @returns Number of rollbacks.
+*******************************************************************************/
+long RollbackSession::getRollbacks()
+{
+	return rollbacks;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Gets the number of steps played over again after
+ *		rolling back, all rollbacks together.
+ *
+ * @returns Number of steps.
+*******************************************************************************/
+long RollbackSession::getResimulated()
+{
+	return resimulated;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Gets the most steps rolled back at once.
+ *
+ * @returns Number of steps.
+*******************************************************************************/
+long RollbackSession::getLongestRollback()
+{
+	return longest_rollback;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Gets the number of times advance() waited for the other
+ *		side instead of playing a step.
+ *
+ * @returns Number of steps waited.
+*******************************************************************************/
+long RollbackSession::getWaits()
+{
+	return waits;
+}
@@ -0,0 +1,187 @@
+/***************************************************************************//**
+ * @file File containing the declaration for the RollbackSession class.
+ *
+ * @brief Contains the declaration for the RollbackSession class, which plays
+ *		a versus game against a player on another machine.
+*******************************************************************************/
+#ifndef _ROLLBACKSESSION_H_
+#define _ROLLBACKSESSION_H_
+
+/*******************************************************************************
+ *                 DECLARATIONS, INCLUDES, AND NAMESPACES
+*******************************************************************************/
+class RollbackSession;
+
+#include <vector>
+#include <chrono>
+#include <stdint.h>
+#include "PongGame.h"
+#include "PongState.h"
+#include "NetLink.h"
+
+using namespace std;
+
+/*!
+ * @brief Kinds of packets sent between the two sides of a session
+ */
+enum NetPacketType
+{
+	NET_HELLO = 1,	/*!< The joining side asks to play */
+	NET_START = 2,	/*!< The hosting side says to start, and with what seed */
+	NET_INPUT = 3	/*!< Keys held on a run of steps, and what has arrived */
+};
+
+/***************************************************************************//**
+ * @brief The RollbackSession class plays a versus game over a NetLink, one
+ *		player on each side.
+ *
+ * @details The host plays the left paddle and the side that joins plays
+ *		the right. Both run the same game from the same seed, and a game
+ *		only depends on the keys held on each step, so the only thing sent
+ *		is the keys each player holds, one step at a time.
+ *
+ *		Neither side waits for the other. Each step uses the local player's
+ *		keys right away and guesses that the other player is still holding
+ *		whatever they held last. The game is saved before every step. When
+ *		the other player's keys for a step arrive and aren't what was
+ *		guessed, the game is restored to that step and played forward again
+ *		to the present with the right keys, all within the one step. Only
+ *		the window most recent steps are kept, so a side that gets that far
+ *		ahead of what it has heard from the other waits for it. A side
+ *		that is ahead of the other also waits a step now and then, so that
+ *		neither side does all the rolling back.
+ *
+ *		Every packet repeats all the keys the other side hasn't said it
+ *		has, so lost packets cost nothing but a longer rollback.
+*******************************************************************************/
+class RollbackSession
+{
+	private:
+		PongGame* game;		/*!< The game being played */
+		NetLink* link;		/*!< Connection to the other side */
+		bool host;			/*!< True for the side that hosts; it plays left */
+		bool started;		/*!< True once both sides have the seed */
+		uint64_t seed;		/*!< Seed of the game */
+		long window;		/*!< Most steps to guess ahead */
+
+		long tick;			/*!< Steps played */
+		long confirmed;		/*!< Steps the other side's keys have arrived
+								for, in order */
+		long acked;			/*!< Steps the other side has our keys for */
+		long rollback_from;	/*!< First step to play again, tick if none */
+		long remote_tick;	/*!< Steps the other side had played, as of its
+								last packet */
+		long remote_advantage;	/*!< How far the other side was ahead of
+									what it had heard from us */
+		vector<unsigned char> local_keys;	/*!< Our keys on every step */
+		vector<unsigned char> remote_keys;	/*!< Their keys on every step
+												confirmed */
+		vector<unsigned char> used_keys;	/*!< Their keys as played on
+												every step, guessed or not */
+		vector<PongState> states;	/*!< The game before each of the last
+										window steps */
+
+		chrono::steady_clock::time_point last_hello;	/*!< When the last
+															hello was sent */
+		chrono::steady_clock::time_point last_received;	/*!< When the last
+															packet arrived */
+
+		long rollbacks;		/*!< Times the game was rolled back */
+		long resimulated;	/*!< Steps played again after rolling back */
+		long longest_rollback;	/*!< Most steps rolled back at once */
+		long waits;			/*!< Steps waited for the other side */
+
+		/*!
+		 * @brief Starts the game both sides play
+		 */
+		void startMatch(uint64_t seed);
+
+		/*!
+		 * @brief Saves the game and plays one step with the keys for it
+		 */
+		void simulate(long step);
+
+		/*!
+		 * @brief Reads everything that has arrived and rolls back if needed
+		 */
+		void update();
+
+		/*!
+		 * @brief Reads one packet from the other side
+		 */
+		void readPacket(const unsigned char* packet, long size);
+
+		/*!
+		 * @brief Sends the other side every step of keys it doesn't have
+		 */
+		void sendInputs();
+
+	public:
+		/*!
+		 * @brief The constructor. Sets up a session on an open link
+		 */
+		RollbackSession(PongGame* game, NetLink* link, bool host,
+			uint64_t seed = 0, long window = 30);
+
+		/*!
+		 * @brief Keeps up with the other side without playing a step
+		 */
+		void poll();
+
+		/*!
+		 * @brief Plays the next step, if the other side isn't too far behind
+		 */
+		bool advance();
+
+		/*!
+		 * @brief Determines if both sides have started the game
+		 */
+		bool isStarted();
+
+		/*!
+		 * @brief Determines if both sides have every step's keys
+		 */
+		bool isSynchronized();
+
+		/*!
+		 * @brief Determines if the other side has gone quiet
+		 */
+		bool hasTimedOut(double seconds = 5);
+
+		/*!
+		 * @brief Determines if this side plays the right paddle
+		 */
+		bool isRight();
+
+		/*!
+		 * @brief Gets the number of steps played
+		 */
+		long getTick();
+
+		/*!
+		 * @brief Gets the keys both players held on a confirmed step
+		 */
+		unsigned char getInput(long step);
+
+		/*!
+		 * @brief Gets the number of times the game was rolled back
+		 */
+		long getRollbacks();
+
+		/*!
+		 * @brief Gets the number of steps played again after rolling back
+		 */
+		long getResimulated();
+
+		/*!
+		 * @brief Gets the most steps rolled back at once
+		 */
+		long getLongestRollback();
+
+		/*!
+		 * @brief Gets the number of steps spent waiting for the other side
+		 */
+		long getWaits();
+};
+
+#endif
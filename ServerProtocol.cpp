@@ -0,0 +1,146 @@
+/***************************************************************************//**
+ * @file File containing the implementation of the game server's messages.
+ *
+ * @brief Contains the functions that turn server messages into packets and
+ *		back. Numbers are written least significant byte first whatever the
+ *		machine.
+*******************************************************************************/
+
+/*******************************************************************************
+ *                 DECLARATIONS, INCLUDES, AND NAMESPACES
+*******************************************************************************/
+#include <cstring>
+#include "ServerProtocol.h"
+
+/*******************************************************************************
+ *                          FUNCTION DEFINITIONS
+*******************************************************************************/
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Writes a 32 bit number to a packet.
+ *
+ * @param[out]	at - Where to write it.
+ * @param[in]	value - The number.
+*******************************************************************************/
+static void put32(unsigned char* at, uint32_t value)
+{
+	at[0] = (unsigned char) value;
+	at[1] = (unsigned char) (value >> 8);
+	at[2] = (unsigned char) (value >> 16);
+	at[3] = (unsigned char) (value >> 24);
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Reads a 32 bit number written by put32().
+ *
+ * @param[in]	at - Where to read it from.
+ *
+ * @returns The number.
+*******************************************************************************/
+static uint32_t get32(const unsigned char* at)
+{
+	return (uint32_t) at[0] | (uint32_t) at[1] << 8
+		| (uint32_t) at[2] << 16 | (uint32_t) at[3] << 24;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Writes a message into a packet.
+ *
+ * @param[in]	message - The message.
+ * @param[out]	packet - Where to write it; must have room for
+ *				server_packet_size bytes.
+ *
+ * @returns Size of the packet in bytes, 0 if the message type is unknown.
+*******************************************************************************/
+size_t encodeMessage(const ServerMessage& message, unsigned char* packet)
+{
+	packet[0] = (unsigned char) message.type;
+	switch (message.type)
+	{
+		case CLIENT_JOIN:
+			packet[1] = message.mode;
+			return 2;
+
+		case CLIENT_INPUT:
+			put32(packet + 1, message.seq);
+			packet[5] = message.keys;
+			put32(packet + 6, message.ack);
+			return 10;
+
+		case CLIENT_LEAVE:
+		case SERVER_FULL:
+			return 1;
+
+		case SERVER_WELCOME:
+			put32(packet + 1, message.match);
+			packet[5] = message.side;
+			return 6;
+
+		case SERVER_STATE:
+		case SERVER_END:
+			if (message.snapshot_size > snapshot_max_size) return 0;
+			put32(packet + 1, message.seq);
+			put32(packet + 5, message.base);
+			memcpy(packet + 9, message.snapshot, message.snapshot_size);
+			return 9 + message.snapshot_size;
+	}
+	return 0;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Reads a message from a packet written by
+ *		encodeMessage().
+ *
+ * @param[in]	packet - The packet.
+ * @param[in]	size - Size of the packet in bytes.
+ * @param[out]	message - The message.
+ *
+ * @returns True if the packet held a whole message, false if not.
+*******************************************************************************/
+bool decodeMessage(const unsigned char* packet, size_t size,
+	ServerMessage& message)
+{
+	if (size < 1) return false;
+	message.type = packet[0];
+	switch (message.type)
+	{
+		case CLIENT_JOIN:
+			if (size < 2) return false;
+			message.mode = packet[1];
+			return true;
+
+		case CLIENT_INPUT:
+			if (size < 10) return false;
+			message.seq = get32(packet + 1);
+			message.keys = packet[5];
+			message.ack = get32(packet + 6);
+			return true;
+
+		case CLIENT_LEAVE:
+		case SERVER_FULL:
+			return true;
+
+		case SERVER_WELCOME:
+			if (size < 6) return false;
+			message.match = get32(packet + 1);
+			message.side = packet[5];
+			return true;
+
+		case SERVER_STATE:
+		case SERVER_END:
+			if (size < 9 || size > 9 + snapshot_max_size) return false;
+			message.seq = get32(packet + 1);
+			message.base = get32(packet + 5);
+			message.snapshot_size = size - 9;
+			memcpy(message.snapshot, packet + 9, message.snapshot_size);
+			return true;
+	}
+	return false;
+}
@@ -0,0 +1,85 @@
+/***************************************************************************//**
+ * @file File containing the declarations of the game server's messages.
+ *
+ * @brief Contains the messages sent between pong-server and its clients and
+ *		the functions that turn them into packets and back.
+*******************************************************************************/
+#ifndef _SERVERPROTOCOL_H_
+#define _SERVERPROTOCOL_H_
+
+/*******************************************************************************
+ *                 DECLARATIONS, INCLUDES, AND NAMESPACES
+*******************************************************************************/
+#include <stddef.h>
+#include <stdint.h>
+#include "Snapshot.h"
+
+/*!
+ * @brief Largest packet either side ever sends
+ */
+static const size_t server_packet_size = 96;
+
+/*!
+ * @brief Kinds of messages. Clients send the ones below 16, the server the
+ *		rest.
+ */
+enum ServerMessageType
+{
+	CLIENT_JOIN = 1,	/*!< Asks for a match */
+	CLIENT_INPUT = 2,	/*!< Keys the client's player is holding */
+	CLIENT_LEAVE = 3,	/*!< The client is done with its match */
+	SERVER_WELCOME = 16,	/*!< The client has a match */
+	SERVER_STATE = 17,	/*!< A snapshot of the client's match */
+	SERVER_END = 18,	/*!< The client's match is over */
+	SERVER_FULL = 19	/*!< There is no room for another match */
+};
+
+/*!
+ * @brief Kinds of matches a client can ask for
+ */
+enum ServerMatchMode
+{
+	MATCH_VS_AI = 0,		/*!< Against the AI, starting right away */
+	MATCH_VS_PLAYER = 1		/*!< Against the next client to ask for one */
+};
+
+/*!
+ * @brief One message, of any kind. Only the fields of its type are used.
+ *
+ * SERVER_STATE and SERVER_END carry a snapshot of the match packed against
+ * the one the client last acknowledged in a CLIENT_INPUT (see Snapshot.h),
+ * which the client must still have to unpack it.
+ */
+struct ServerMessage
+{
+	int type;			/*!< What kind of message, a ServerMessageType */
+	uint8_t mode;		/*!< CLIENT_JOIN: a ServerMatchMode */
+	uint32_t seq;		/*!< CLIENT_INPUT: counts up with every input sent;
+							SERVER_STATE and SERVER_END: the last one
+							played */
+	uint8_t keys;		/*!< CLIENT_INPUT: up, down, left, right in the low
+							four bits */
+	uint32_t ack;		/*!< CLIENT_INPUT: step of the newest snapshot the
+							client has, 0 if none */
+	uint32_t match;		/*!< SERVER_WELCOME: number of the match */
+	uint8_t side;		/*!< SERVER_WELCOME: 0 for left, 1 for right */
+	uint32_t base;		/*!< SERVER_STATE and SERVER_END: step of the
+							snapshot packed against, 0 for an empty one */
+	size_t snapshot_size;	/*!< SERVER_STATE and SERVER_END: bytes packed */
+	unsigned char snapshot[snapshot_max_size];	/*!< SERVER_STATE and
+													SERVER_END: the packed
+													snapshot */
+};
+
+/*!
+ * @brief Writes a message into a packet
+ */
+size_t encodeMessage(const ServerMessage& message, unsigned char* packet);
+
+/*!
+ * @brief Reads a message from a packet
+ */
+bool decodeMessage(const unsigned char* packet, size_t size,
+	ServerMessage& message);
+
+#endif
@@ -0,0 +1,322 @@
+/***************************************************************************//**
+ * @file File containing the implementation of game snapshots.
+ *
+ * @brief Contains the functions that capture snapshots from games and pack
+ *		them into bits.
+ *
+ * @details A snapshot is packed against an earlier one the other side is
+ *		known to have, or against an empty one when there is none. Every
+ *		field gets one bit saying whether it differs from what the earlier
+ *		snapshot says, and the fields that do differ are written as a signed
+ *		difference in 4, 8, 16, or 32 bits, whichever is enough. The ball
+ *		is predicted to have kept going at the speed it had, so between
+ *		bounces its position costs only the rounding error.
+*******************************************************************************/
+
+/*******************************************************************************
+ *                 DECLARATIONS, INCLUDES, AND NAMESPACES
+*******************************************************************************/
+#include <cmath>
+#include "Snapshot.h"
+
+/*!
+ * @brief Fields of a snapshot packed as differences, in the order packed.
+ *		The ball's position comes last, as it is predicted from the rest.
+ */
+static int32_t Snapshot::* const snapshot_fields[] =
+{
+	&Snapshot::ball_dx, &Snapshot::ball_dy,
+	&Snapshot::left_x, &Snapshot::left_y,
+	&Snapshot::right_x, &Snapshot::right_y,
+	&Snapshot::left_height, &Snapshot::right_height,
+	&Snapshot::left_score, &Snapshot::right_score,
+	&Snapshot::flags,
+	&Snapshot::ball_x, &Snapshot::ball_y
+};
+
+/*!
+ * @brief Number of fields in snapshot_fields
+ */
+static const int field_count = sizeof(snapshot_fields)
+	/ sizeof(snapshot_fields[0]);
+
+/***************************************************************************//**
+ * @brief Writes numbers of any number of bits one after another into bytes,
+ *		lowest bits first.
+*******************************************************************************/
+class BitWriter
+{
+	private:
+		unsigned char* data;	/*!< Where to write */
+		size_t capacity;		/*!< Bytes there is room for */
+		size_t size;			/*!< Bytes written */
+		uint64_t bits;			/*!< Bits not yet written out */
+		int count;				/*!< Number of bits not yet written out */
+		bool overflow;			/*!< True if there wasn't room */
+
+	public:
+		BitWriter(unsigned char* data, size_t capacity) : data(data),
+			capacity(capacity), size(0), bits(0), count(0), overflow(false)
+		{ }
+
+		/*!
+		 * @brief Writes the low bits of a number
+		 */
+		void write(uint32_t value, int width)
+		{
+			bits |= (uint64_t) value << count;
+			count += width;
+			while (count >= 8)
+			{
+				if (size < capacity) data[size] = (unsigned char) bits;
+				else overflow = true;
+				size++;
+				bits >>= 8;
+				count -= 8;
+			}
+		}
+
+		/*!
+		 * @brief Writes out the last byte, if part full
+		 * @returns Bytes written, 0 if there wasn't room
+		 */
+		size_t finish()
+		{
+			if (count > 0) write(0, 8 - count);
+			return overflow ? 0 : size;
+		}
+};
+
+/***************************************************************************//**
+ * @brief Reads numbers written by a BitWriter.
+*******************************************************************************/
+class BitReader
+{
+	private:
+		const unsigned char* data;	/*!< Where to read */
+		size_t size;				/*!< Bytes there are */
+		size_t position;			/*!< Bytes read */
+		uint64_t bits;				/*!< Bits read but not used */
+		int count;					/*!< Number of bits read but not used */
+		bool underflow;				/*!< True if the bytes ran out */
+
+	public:
+		BitReader(const unsigned char* data, size_t size) : data(data),
+			size(size), position(0), bits(0), count(0), underflow(false)
+		{ }
+
+		/*!
+		 * @brief Reads a number of the given width
+		 */
+		uint32_t read(int width)
+		{
+			while (count < width)
+			{
+				if (position < size)
+					bits |= (uint64_t) data[position] << count;
+				else
+					underflow = true;
+				position++;
+				count += 8;
+			}
+			uint32_t value = (uint32_t) (bits
+				& (((uint64_t) 1 << width) - 1));
+			bits >>= width;
+			count -= width;
+			return value;
+		}
+
+		/*!
+		 * @brief Determines if every number read was there
+		 */
+		bool good()
+		{
+			return !underflow;
+		}
+};
+
+/*******************************************************************************
+ *                          FUNCTION DEFINITIONS
+*******************************************************************************/
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Writes a signed difference in as few bits as will hold
+ *		it: two bits saying how wide, then the difference folded so small
+ *		numbers of either sign stay small.
+ *
+ * @param[in,out]	writer - Where to write it.
+ * @param[in]	difference - The difference.
+*******************************************************************************/
+static void writeDifference(BitWriter& writer, int32_t difference)
+{
+	uint32_t folded = ((uint32_t) difference << 1)
+		^ (uint32_t) (difference >> 31);
+	if (folded < (1u << 4))
+	{
+		writer.write(0, 2);
+		writer.write(folded, 4);
+	}
+	else if (folded < (1u << 8))
+	{
+		writer.write(1, 2);
+		writer.write(folded, 8);
+	}
+	else if (folded < (1u << 16))
+	{
+		writer.write(2, 2);
+		writer.write(folded, 16);
+	}
+	else
+	{
+		writer.write(3, 2);
+		writer.write(folded, 32);
+	}
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Reads a difference written by writeDifference().
+ *
+ * @param[in,out]	reader - Where to read it from.
+ *
+ * @returns The difference.
+*******************************************************************************/
+static int32_t readDifference(BitReader& reader)
+{
+	static const int widths[] = { 4, 8, 16, 32 };
+	uint32_t folded = reader.read(widths[reader.read(2)]);
+	return (int32_t) (folded >> 1) ^ -(int32_t) (folded & 1);
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Works out what a field of a snapshot is expected to be
+ *		from the earlier one it is packed against. The ball is expected to
+ *		have moved on at its old speed; everything else to have stayed put.
+ *
+ * @param[in]	base - The earlier snapshot.
+ * @param[in]	field - Which field, an index into snapshot_fields.
+ * @param[in]	steps - Steps since the earlier snapshot.
+ *
+ * @returns What the field is expected to be.
+*******************************************************************************/
+static int32_t predict(const Snapshot& base, int field, uint32_t steps)
+{
+	int32_t value = base.*snapshot_fields[field];
+	if (steps > 1024 || (base.flags & 1) == 0) return value;
+
+	const int scale = snapshot_speed_grid / snapshot_grid;
+	if (snapshot_fields[field] == &Snapshot::ball_x)
+		value += (int32_t) ((int64_t) base.ball_dx * steps / scale);
+	else if (snapshot_fields[field] == &Snapshot::ball_y)
+		value += (int32_t) ((int64_t) base.ball_dy * steps / scale);
+	return value;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Rounds what a game looks like on a step into a
+ *		snapshot.
+ *
+ * @param[in]	game - The game.
+ * @param[in]	tick - The step, as the snapshot's sender counts them.
+ * @param[out]	snapshot - The snapshot.
+*******************************************************************************/
+void captureSnapshot(PongGame* game, uint32_t tick, Snapshot& snapshot)
+{
+	const double position = (double) snapshot_grid / PongGame::unit;
+	const double speed = (double) snapshot_speed_grid / PongGame::unit;
+	Ball* ball = game->getBall();
+	Paddle* left = game->getLeftPaddle();
+	Paddle* right = game->getRightPaddle();
+
+	snapshot.tick = tick;
+	if (ball != NULL)
+	{
+		snapshot.ball_x = (int32_t) lround(ball->center_x * position);
+		snapshot.ball_y = (int32_t) lround(ball->center_y * position);
+		snapshot.ball_dx = (int32_t) lround(ball->x_velocity
+			* ball->s_velocity * speed);
+		snapshot.ball_dy = (int32_t) lround(ball->y_velocity
+			* ball->s_velocity * speed);
+	}
+	else
+	{
+		snapshot.ball_x = snapshot.ball_y = 0;
+		snapshot.ball_dx = snapshot.ball_dy = 0;
+	}
+	snapshot.left_x = (int32_t) lround(left->getX() * position);
+	snapshot.left_y = (int32_t) lround(left->getY() * position);
+	snapshot.right_x = (int32_t) lround(right->getX() * position);
+	snapshot.right_y = (int32_t) lround(right->getY() * position);
+	snapshot.left_height = left->getHeight();
+	snapshot.right_height = right->getHeight();
+	snapshot.left_score = game->getLeftScore();
+	snapshot.right_score = game->getRightScore();
+	snapshot.flags = (ball != NULL ? 1 : 0) | (game->isRunning() ? 2 : 0);
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Packs a snapshot into bits as changes from an earlier
+ *		one. The other side must unpack it against the same earlier one; a
+ *		zeroed snapshot serves when the other side has none.
+ *
+ * @param[in]	base - The earlier snapshot.
+ * @param[in]	snapshot - The snapshot to pack.
+ * @param[out]	data - Where to pack it.
+ * @param[in]	capacity - Bytes there is room for; snapshot_max_size is
+ *				always enough.
+ *
+ * @returns Bytes packed, 0 if there wasn't room.
+*******************************************************************************/
+size_t encodeSnapshot(const Snapshot& base, const Snapshot& snapshot,
+	unsigned char* data, size_t capacity)
+{
+	BitWriter writer(data, capacity);
+	uint32_t steps = snapshot.tick - base.tick;
+	writeDifference(writer, (int32_t) steps);
+
+	for (int i = 0; i < field_count; i++)
+	{
+		int32_t difference = snapshot.*snapshot_fields[i]
+			- predict(base, i, steps);
+		writer.write(difference != 0, 1);
+		if (difference != 0) writeDifference(writer, difference);
+	}
+	return writer.finish();
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Unpacks a snapshot packed by encodeSnapshot() against
+ *		the same earlier one.
+ *
+ * @param[in]	base - The earlier snapshot.
+ * @param[in]	data - The packed snapshot.
+ * @param[in]	size - Bytes packed.
+ * @param[out]	snapshot - The snapshot.
+ *
+ * @returns True if the bytes held a whole snapshot, false if not.
+*******************************************************************************/
+bool decodeSnapshot(const Snapshot& base, const unsigned char* data,
+	size_t size, Snapshot& snapshot)
+{
+	BitReader reader(data, size);
+	uint32_t steps = (uint32_t) readDifference(reader);
+	snapshot.tick = base.tick + steps;
+
+	for (int i = 0; i < field_count; i++)
+	{
+		int32_t value = predict(base, i, steps);
+		if (reader.read(1) != 0) value += readDifference(reader);
+		snapshot.*snapshot_fields[i] = value;
+	}
+	return reader.good();
+}
@@ -0,0 +1,83 @@
+/***************************************************************************//**
+ * @file File containing the declarations of game snapshots.
+ *
+ * @brief Contains the Snapshot structure, which holds what a game looks like
+ *		on a step rounded to a fine grid, and the functions that capture one
+ *		from a game and pack it into a few bytes against an earlier one.
+*******************************************************************************/
+#ifndef _SNAPSHOT_H_
+#define _SNAPSHOT_H_
+
+/*******************************************************************************
+ *                 DECLARATIONS, INCLUDES, AND NAMESPACES
+*******************************************************************************/
+#include <stddef.h>
+#include <stdint.h>
+#include "PongGame.h"
+
+/*!
+ * @brief Steps of the grid positions are rounded to, in each unit
+ */
+static const int snapshot_grid = 64;
+
+/*!
+ * @brief Steps of the grid speeds are rounded to, in each unit a step
+ */
+static const int snapshot_speed_grid = 1024;
+
+/*!
+ * @brief Most bytes a packed snapshot takes
+ */
+static const size_t snapshot_max_size = 64;
+
+/*!
+ * @brief What a game looks like on one step, everything rounded to a grid
+ *		so that it packs into few bits. Positions are in steps of
+ *		snapshot_grid to a unit and speeds in steps of snapshot_speed_grid to
+ *		a unit a step.
+ */
+struct Snapshot
+{
+	uint32_t tick;			/*!< Step the snapshot was taken on */
+	int32_t ball_x;			/*!< x coordinate of the ball */
+	int32_t ball_y;			/*!< y coordinate of the ball */
+	int32_t ball_dx;		/*!< Distance the ball moves along x each step */
+	int32_t ball_dy;		/*!< Distance the ball moves along y each step */
+	int32_t left_x;			/*!< x coordinate of the left paddle */
+	int32_t left_y;			/*!< y coordinate of the left paddle */
+	int32_t right_x;		/*!< x coordinate of the right paddle */
+	int32_t right_y;		/*!< y coordinate of the right paddle */
+	int32_t left_height;	/*!< Height of the left paddle, in pixels */
+	int32_t right_height;	/*!< Height of the right paddle, in pixels */
+	int32_t left_score;		/*!< Points made by the left side */
+	int32_t right_score;	/*!< Points made by the right side */
+	int32_t flags;			/*!< 1 if a ball is in play, 2 if the game is
+								running */
+};
+
+/*!
+ * @brief Rounds what a game looks like into a snapshot
+ */
+void captureSnapshot(PongGame* game, uint32_t tick, Snapshot& snapshot);
+
+/*!
+ * @brief Packs a snapshot into bits as changes from an earlier one
+ */
+size_t encodeSnapshot(const Snapshot& base, const Snapshot& snapshot,
+	unsigned char* data, size_t capacity);
+
+/*!
+ * @brief Unpacks a snapshot packed against the same earlier one
+ */
+bool decodeSnapshot(const Snapshot& base, const unsigned char* data,
+	size_t size, Snapshot& snapshot);
+
+/*!
+ * @brief Turns a position in a snapshot back into pixels
+ */
+inline double snapshotPixels(int32_t position)
+{
+	return position * (double) PongGame::unit / snapshot_grid;
+}
+
+#endif
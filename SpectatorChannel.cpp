@@ -0,0 +1,307 @@
+/***************************************************************************//**
+ * @file File containing the implementation of the SpectatorChannel class.
+ *
+ * @brief Contains the implementation for the SpectatorChannel class.
+*******************************************************************************/
+
+/*******************************************************************************
+ *                 DECLARATIONS, INCLUDES, AND NAMESPACES
+*******************************************************************************/
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "SpectatorChannel.h"
+
+/*!
+ * @brief Marks a channel that has been set up
+ */
+static const char spectator_magic[8] = { 'P', 'O', 'N', 'G', 'S', 'P', 'E',
+	'C' };
+
+/*******************************************************************************
+ *                          FUNCTION DEFINITIONS
+*******************************************************************************/
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Turns a channel name into the name of its shared
+ *		memory.
+ *
+ * @param[in]	name - Name of the channel.
+ *
+ * @returns Name of the shared memory.
+*******************************************************************************/
+static string sharedName(const char* name)
+{
+	return string("/pong-") + name;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: The constructor. Makes a channel that isn't open yet.
+*******************************************************************************/
+SpectatorChannel::SpectatorChannel() :
+header(NULL), slots(NULL), mapped_size(0), publisher(false), cursor(0),
+max_lag(8), received(0), skipped(0)
+{ }
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: The destructor. Closes the channel.
+*******************************************************************************/
+SpectatorChannel::~SpectatorChannel()
+{
+	close();
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Opens a channel to publish a game on, replacing any left
+ *		under the same name.
+ *
+ * @param[in]	name - Name of the channel; viewers watch it by this name.
+ * @param[in]	slot_count - Steps the ring holds; viewers can fall no further
+ *				behind than this.
+ *
+ * @returns True if the channel was opened, false if not.
+*******************************************************************************/
+bool SpectatorChannel::publish(const char* name, long slot_count)
+{
+	close();
+	if (slot_count < 2) return false;
+
+	this -> name = sharedName(name);
+	shm_unlink(this -> name.c_str());
+	int fd = shm_open(this -> name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+	if (fd < 0) return false;
+
+	size_t size = sizeof(SpectatorHeader)
+		+ (size_t) slot_count * sizeof(SpectatorSlot);
+	void* memory = MAP_FAILED;
+	if (ftruncate(fd, (off_t) size) == 0)
+	{
+		memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	}
+	::close(fd);
+	if (memory == MAP_FAILED)
+	{
+		shm_unlink(this -> name.c_str());
+		return false;
+	}
+
+	// Fresh shared memory is zeroed, so every slot already reads as empty
+	header = (SpectatorHeader*) memory;
+	slots = (SpectatorSlot*) (header + 1);
+	mapped_size = size;
+	publisher = true;
+	header->slot_count = (uint32_t) slot_count;
+	header->state_size = sizeof(PongState);
+	header->published.store(0, memory_order_relaxed);
+	header->finished.store(0, memory_order_relaxed);
+	atomic_thread_fence(memory_order_release);
+	memcpy(header->magic, spectator_magic, sizeof(header->magic));
+	return true;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Opens a channel another process publishes, read only,
+ *		starting from the newest step in it.
+ *
+ * @param[in]	name - Name of the channel.
+ * @param[in]	max_lag - Most steps to let pile up before skipping ahead to
+ *				the newest.
+ *
+ * @returns True if the channel was found, false if not.
+*******************************************************************************/
+bool SpectatorChannel::watch(const char* name, long max_lag)
+{
+	close();
+
+	this -> name = sharedName(name);
+	int fd = shm_open(this -> name.c_str(), O_RDONLY, 0);
+	if (fd < 0) return false;
+
+	void* memory = MAP_FAILED;
+	off_t size = lseek(fd, 0, SEEK_END);
+	if (size >= (off_t) sizeof(SpectatorHeader))
+	{
+		memory = mmap(NULL, (size_t) size, PROT_READ, MAP_SHARED, fd, 0);
+	}
+	::close(fd);
+	if (memory == MAP_FAILED) return false;
+
+	header = (SpectatorHeader*) memory;
+	slots = (SpectatorSlot*) (header + 1);
+	mapped_size = (size_t) size;
+	publisher = false;
+
+	// Only watch a channel that is set up and was built the same way
+	atomic_thread_fence(memory_order_acquire);
+	if (memcmp(header->magic, spectator_magic, sizeof(header->magic)) != 0
+		|| header->state_size != sizeof(PongState)
+		|| sizeof(SpectatorHeader) + header->slot_count
+			* sizeof(SpectatorSlot) > mapped_size)
+	{
+		close();
+		return false;
+	}
+
+	this -> max_lag = max_lag < 1 ? 1 : max_lag;
+	uint64_t published = header->published.load(memory_order_acquire);
+	cursor = published > 0 ? published - 1 : 0;
+	received = 0;
+	skipped = 0;
+	return true;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Closes the channel. A publisher tells its viewers it is
+ *		done and removes the name; viewers that still have the channel open
+ *		can read what is left in it.
+*******************************************************************************/
+void SpectatorChannel::close()
+{
+	if (header == NULL) return;
+
+	if (publisher)
+	{
+		header->finished.store(1, memory_order_release);
+		shm_unlink(name.c_str());
+	}
+	munmap(header, mapped_size);
+	header = NULL;
+	slots = NULL;
+	mapped_size = 0;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Publishes the game on one step. Never waits: the oldest
+ *		step in the ring is overwritten whether or not every viewer has
+ *		read it.
+ *
+ * @param[in]	state - The game on the step.
+*******************************************************************************/
+void SpectatorChannel::send(const PongState& state)
+{
+	if (header == NULL || !publisher) return;
+
+	uint64_t step = header->published.load(memory_order_relaxed);
+	SpectatorSlot& slot = slots[step % header->slot_count];
+
+	slot.sequence.store(2 * step + 1, memory_order_relaxed);
+	atomic_thread_fence(memory_order_release);
+	memcpy(&slot.state, &state, sizeof(state));
+	slot.sequence.store(2 * step + 2, memory_order_release);
+	header->published.store(step + 1, memory_order_release);
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Reads the next step for a viewer to show, in order. If
+ *		more than the viewer's lag have piled up, or the publisher has lapped
+ *		it, skips to the newest step instead.
+ *
+ * @param[out]	state - The game on the step.
+ *
+ * @returns True if there was a step to read, false if the viewer is caught
+ *		up.
+*******************************************************************************/
+bool SpectatorChannel::receive(PongState& state)
+{
+	if (header == NULL || publisher) return false;
+
+	for (int tries = 0; tries < 4; tries++)
+	{
+		uint64_t published = header->published.load(memory_order_acquire);
+		if (cursor >= published) return false;
+
+		uint64_t behind = published - cursor;
+		if (behind > (uint64_t) max_lag || behind >= header->slot_count)
+		{
+			skipped += (long) (behind - 1);
+			cursor = published - 1;
+		}
+
+		// Copy it out, then make sure it wasn't being overwritten meanwhile
+		const SpectatorSlot& slot = slots[cursor % header->slot_count];
+		uint64_t expected = 2 * cursor + 2;
+		if (slot.sequence.load(memory_order_acquire) == expected)
+		{
+			memcpy(&state, &slot.state, sizeof(state));
+			atomic_thread_fence(memory_order_acquire);
+			if (slot.sequence.load(memory_order_relaxed) == expected)
+			{
+				cursor++;
+				received++;
+				return true;
+			}
+		}
+
+		// Overwritten before it could be read; move on
+		skipped++;
+		cursor++;
+	}
+	return false;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Determines if the publisher has closed the channel.
+ *
+ * @returns True if the publisher is done, false if it may publish more.
+*******************************************************************************/
+bool SpectatorChannel::isFinished()
+{
+	return header == NULL
+		|| header->finished.load(memory_order_acquire) != 0;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Gets the number of steps published.
+ *
+ * @returns Steps published so far.
+*******************************************************************************/
+long SpectatorChannel::getPublished()
+{
+	if (header == NULL) return 0;
+	return (long) header->published.load(memory_order_acquire);
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Gets the number of steps this viewer has read.
+ *
+ * @returns Steps read.
+*******************************************************************************/
+long SpectatorChannel::getReceived()
+{
+	return received;
+}
+
+/***************************************************************************//**
+ * @author Daniel Andrus
+ *
+ * @par Description: Gets the number of steps this viewer skipped over, by
+ *		falling behind or being lapped.
+ *
+ * @returns Steps skipped.
+*******************************************************************************/
+long SpectatorChannel::getSkipped()
+{
+	return skipped;
+}
@@ -0,0 +1,134 @@
+/***************************************************************************//**
+ * @file File containing the declaration for the SpectatorChannel class.
+ *
+ * @brief Contains the declaration for the SpectatorChannel class, which
+ *		shares every step of one running game with any number of viewers on
+ *		the same machine.
+*******************************************************************************/
+#ifndef _SPECTATORCHANNEL_H_
+#define _SPECTATORCHANNEL_H_
+
+/*******************************************************************************
+ *                 DECLARATIONS, INCLUDES, AND NAMESPACES
+*******************************************************************************/
+class SpectatorChannel;
+
+#include <atomic>
+#include <string>
+#include <stddef.h>
+#include <stdint.h>
+#include "PongState.h"
+
+using namespace std;
+
+/*!
+ * @brief One step of the game in a channel. The sequence is odd while the
+ *		state is being written and 2n + 2 once it holds step n.
+ */
+struct SpectatorSlot
+{
+	atomic<uint64_t> sequence;	/*!< Which step the slot holds */
+	PongState state;			/*!< The game on that step */
+};
+
+/*!
+ * @brief Start of a channel's shared memory, followed by its slots
+ */
+struct SpectatorHeader
+{
+	char magic[8];					/*!< "PONGSPEC" once set up */
+	uint32_t slot_count;			/*!< Number of slots */
+	uint32_t state_size;			/*!< sizeof(PongState) of the publisher */
+	atomic<uint64_t> published;		/*!< Steps published */
+	atomic<uint32_t> finished;		/*!< Nonzero once the publisher is done */
+};
+
+/***************************************************************************//**
+ * @brief The SpectatorChannel class publishes every step of one game to
+ *		shared memory, where any number of viewer processes read it.
+ *
+ * @details The publisher writes each step's PongState once, into a ring of
+ *		slots in shared memory, and never waits for or even knows about its
+ *		viewers. Viewers map the ring read only and copy states straight
+ *		out of it, so a hundred viewers cost the publisher no more than one
+ *		and can't disturb it.
+ *
+ *		Each viewer keeps its own place in the ring. A viewer that falls
+ *		more than its lag behind the publisher, or is lapped by it, skips
+ *		ahead to the newest step rather than playing a backlog, so a slow
+ *		viewer only ever loses steps of its own. Each slot carries a
+ *		sequence number that the publisher makes odd while writing it, so a
+ *		viewer can tell a state it copied while it was being overwritten
+ *		and throw it away.
+*******************************************************************************/
+class SpectatorChannel
+{
+	private:
+		string name;			/*!< Name of the shared memory */
+		SpectatorHeader* header;	/*!< The shared memory, NULL if not open */
+		SpectatorSlot* slots;	/*!< The ring of steps */
+		size_t mapped_size;		/*!< Bytes of shared memory mapped */
+		bool publisher;			/*!< True for the side that publishes */
+		uint64_t cursor;		/*!< Next step to read, for viewers */
+		long max_lag;			/*!< Most steps a viewer lets pile up */
+		long received;			/*!< Steps read */
+		long skipped;			/*!< Steps skipped over */
+
+	public:
+		/*!
+		 * @brief The constructor. Makes a channel that isn't open
+		 */
+		SpectatorChannel();
+
+		/*!
+		 * @brief The destructor. Closes the channel
+		 */
+		~SpectatorChannel();
+
+		/*!
+		 * @brief Opens a channel under a name to publish a game on
+		 */
+		bool publish(const char* name, long slot_count = 256);
+
+		/*!
+		 * @brief Opens a channel another process publishes, to watch
+		 */
+		bool watch(const char* name, long max_lag = 8);
+
+		/*!
+		 * @brief Closes the channel, telling viewers if publishing
+		 */
+		void close();
+
+		/*!
+		 * @brief Publishes the game on one step
+		 */
+		void send(const PongState& state);
+
+		/*!
+		 * @brief Reads the next step to show, if there is one
+		 */
+		bool receive(PongState& state);
+
+		/*!
+		 * @brief Determines if the publisher has closed the channel
+		 */
+		bool isFinished();
+
+		/*!
+		 * @brief Gets the number of steps published
+		 */
+		long getPublished();
+
+		/*!
+		 * @brief Gets the number of steps this viewer has read
+		 */
+		long getReceived();
+
+		/*!
+		 * @brief Gets the number of steps this viewer skipped over
+		 */
+		long getSkipped();
+};
+
+#endif
@@ -42,24 +42,83 @@
  * 
  * @par Build:
    @verbatim
-   > g++ -std=c++11 -lGL -lglut -lGLU -o pong AIController.cpp Ball.cpp \
-   Board.cpp main.cpp Paddle.cpp PlayerController.cpp Pong.cpp PongGame.cpp \
-   Menu.cpp MenuItem.cpp PongText.cpp PongTextDraw.cpp
+   > g++ -std=c++11 -o pong AIController.cpp Ball.cpp Board.cpp main.cpp \
+   Paddle.cpp PlayerController.cpp Pong.cpp PongGame.cpp Menu.cpp \
+   MenuItem.cpp PongText.cpp PongTextDraw.cpp BallDraw.cpp BoardDraw.cpp \
+   PaddleDraw.cpp -lGL -lglut -lGLU
    @endverbatim
  * 
  * @par Make:
    @vertbatim
    > make pong
    @endverbatim
+ *
+ * The game logic (PongGame, Ball, Paddle, Board, and the controllers) is also
+ * built into libpong_core.a, which needs no OpenGL. "make pong-sim" builds a
+ * headless simulator on top of it; see PongSim.cpp. "make pong-tournament"
+ * builds a multi-threaded tournament runner; see PongTournament.cpp. "make
+ * pong-server" builds a server that plays thousands of matches at once for
+ * clients over UDP; see PongServer.cpp and ServerProtocol.h. "make
+ * pong-loadgen" builds bot clients to load test it with; see PongLoadgen.cpp.
  * 
  * @par Usage: 
    @verbatim  
-   > ./pong
+   > ./pong [--tick-rate N] [--frame-rate N] [--seed N] [--ai KIND]
+            [--policy FILE] [--net FILE] [--difficulty FILE]
+            [--record FILE | --replay FILE | --host PORT | --join HOST:PORT]
+            [--latency MS] [--jitter MS] [--loss FRACTION]
+            [--publish NAME | --watch NAME] [--immediate] [--gl-stats]
    @endverbatim 
  *
+ * The game steps at a fixed --tick-rate (default 60 per second) regardless of
+ * how often frames are drawn (--frame-rate, default 120 per second). Moving
+ * objects are drawn between their last two positions to keep motion smooth.
+ * Serves and AI moves are random; --seed (default the current time) picks
+ * which random numbers a session gets, so a session can be played again.
+ * --ai picks the AI: "follow" (the default) chases the ball, "predict" goes
+ * straight to where the ball will cross its paddle, "lookahead", the
+ * hardest, tries moves out on a copy of the game before making one,
+ * "policy" plays the policy --policy loads from a file "pong-train" wrote,
+ * and "neural" the network --net loads from one "pong-train --mlp" wrote.
+ * "make pong-train" builds the trainer that learns them; see PongTrain.cpp.
+ * How fast the AI's paddle moves, and how it speeds up when behind, comes
+ * from pong.difficulty in the current directory if there is one, or from
+ * --difficulty; "make pong-tune" builds the tuner that writes it, see
+ * PongTune.cpp. Replays keep the difficulty each game was played at and
+ * play back at it, whatever difficulty is loaded.
+ * --record saves every game of the session to a replay file as it is
+ * played; --replay plays the games of a replay file back in real time
+ * instead of starting the demo. While a replay plays, the left and right
+ * arrow keys jump back and forward five seconds, page up and page down a
+ * minute, and home and end to the start and end of the replay. "pong-sim
+ * --replay" plays them back without a window, as fast as it can.
+ *
+ * --host and --join play versus against another player over the network:
+ * one player hosts on a port and plays the left paddle with W, A, S, and D,
+ * and the other joins the host's address and port and plays the right
+ * paddle with the arrow keys. Each side sees its own keys take effect at
+ * once; when the other player's keys arrive late, the game is rolled back
+ * and played forward again (see RollbackSession). --latency, --jitter, and
+ * --loss make packets late and lost on purpose, to try it out on one
+ * machine; "make pong-net" builds a headless tester for the same thing.
+ *
+ * --publish shares every step of the session, whatever is being played,
+ * with any number of viewers on the same machine under a name, and --watch
+ * shows the session published under a name instead of playing. Viewers
+ * read the game straight out of shared memory, so they never slow the
+ * publisher down; a viewer that falls behind skips ahead to the newest step
+ * (see SpectatorChannel). "make pong-spectate" builds a headless publisher
+ * and viewer, and a tester that watches with a crowd of viewers at once.
+ *
+ * Each frame, the paddles, the ball, the border, and the menus are gathered
+ * up into one array of triangles per layer and drawn with a couple of calls
+ * into OpenGL per layer (see Renderer). --immediate draws every shape with
+ * calls of its own instead, as the game used to, and --gl-stats prints how
+ * many calls a frame takes each way once a second.
+ *
  * @section todo_bugs_modification_section Todo, Bugs, and Modifications
  * 
- * @bugs	Rarely - ball will go through a paddle thats moving forward
+ * @bugs	None known.
  * 
  * @par Modifications and Development Timeline: 
    @verbatim 